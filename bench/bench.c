@@ -0,0 +1,547 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE BENCHMARK HARNESS (make bench) */
+
+/* MICRO BENCHMARKS TIME THE HOT KERNELS IN ISOLATION AND REPORT NANOSECONDS */
+/* PER OPERATION, MACRO BENCHMARKS RUN WHOLE ROMS HEADLESS AND REPORT FRAMES */
+/* PER SECOND - BOTH AS THE MEAN AND STANDARD DEVIATION ACROSS SEVERAL SAMPLES */
+
+/* THE RESULTS ARE WRITTEN AS JSON SO THAT A RUN CAN BE COMPARED AGAINST A BASELINE */
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "md.h"
+#include "cartridge.h"
+#include "rom.h"
+#include "vdp.h"
+#include "psg.h"
+#include "profile.h"
+
+/* SYSTEM INCLUDES */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define     BENCH_DEFAULT_SAMPLES       11
+#define     BENCH_MAX_SAMPLES           64
+#define     BENCH_DEFAULT_FRAMES        600
+#define     BENCH_WARMUP_FRAMES         60
+#define     BENCH_MAX_ROMS              16
+#define     BENCH_SYNTHETIC_SIZE        0x20000
+#define     BENCH_CHECKSUM_SIZE         0x100000
+
+typedef struct BENCH_RESULT
+{
+    const char* NAME;
+    const char* UNIT;
+    const char* CORE;
+    F64 MEAN;
+    F64 STDDEV;
+    unsigned SAMPLES;
+    U64 OPS;
+
+} BENCH_RESULT;
+
+typedef struct BENCH_MICRO
+{
+    const char* NAME;
+    U64 OPS;
+    void(*RUN)(U64 OPS);
+
+} BENCH_MICRO;
+
+typedef struct BENCH_OPTIONS
+{
+    unsigned SAMPLES;
+    unsigned FRAMES;
+    const char* OUT_PATH;
+    char* ROMS[BENCH_MAX_ROMS];
+    unsigned ROM_COUNT;
+
+} BENCH_OPTIONS;
+
+/* KEEPS THE COMPILER FROM DISCARDING THE WORK BEING MEASURED */
+
+static volatile U32 BENCH_SINK;
+
+static U8* BENCH_CHECKSUM_DATA;
+static U8* BENCH_STATE;
+static UNK BENCH_STATE_SIZE;
+static PSG_BASE BENCH_PSG;
+
+//================================================
+//              SYNTHETIC TEST ROM
+//================================================
+
+static void BENCH_PUT16(U8* DATA, unsigned OFFSET, U16 VALUE)
+{
+    DATA[OFFSET] = VALUE >> 8;
+    DATA[OFFSET + 1] = VALUE & 0xFF;
+}
+
+static void BENCH_PUT32(U8* DATA, unsigned OFFSET, U32 VALUE)
+{
+    BENCH_PUT16(DATA, OFFSET, VALUE >> 16);
+    BENCH_PUT16(DATA, OFFSET + 2, VALUE & 0xFFFF);
+}
+
+/* A MINIMAL CARTRIDGE WHICH ENABLES DMA, POINTS THE VDP AT VRAM AND THEN */
+/* STREAMS WORDS INTO THE DATA PORT FOREVER - ENOUGH TO KEEP THE CPU AND */
+/* VDP PATHS BUSY WITHOUT SHIPPING A COMMERCIAL ROM */
+
+static U8* BENCH_SYNTHETIC_ROM(void)
+{
+    static const U16 PROGRAM[] =
+    {
+        0x33FC, 0x8114, 0x00C0, 0x0004,     /* MOVE.W #$8114,$C00004    */
+        0x33FC, 0x8F02, 0x00C0, 0x0004,     /* MOVE.W #$8F02,$C00004    */
+        0x33FC, 0x4000, 0x00C0, 0x0004,     /* MOVE.W #$4000,$C00004    */
+        0x33FC, 0x0000, 0x00C0, 0x0004,     /* MOVE.W #$0000,$C00004    */
+        0x33FC, 0x1234, 0x00C0, 0x0000,     /* LOOP: MOVE.W #$1234,$C00000 */
+        0x60F6,                             /* BRA.S LOOP               */
+    };
+
+    U8* ROM = calloc(1, BENCH_SYNTHETIC_SIZE);
+    unsigned INDEX;
+
+    if(ROM == NULL)
+        return NULL;
+
+    BENCH_PUT32(ROM, 0x000, 0x00FFFE00);
+    BENCH_PUT32(ROM, 0x004, 0x00000200);
+
+    memcpy(ROM + 0x100, "SEGA MEGA DRIVE ", 16);
+    memcpy(ROM + ROM_DOMESTIC, "MDEMU BENCHMARK", 15);
+    memcpy(ROM + ROM_INTERNATIONAL, "MDEMU BENCHMARK", 15);
+    memcpy(ROM + ROM_SERIAL, "GM 00000000-00", 14);
+    memcpy(ROM + ROM_PERIPHERALS, "J", 1);
+    memcpy(ROM + ROM_REGION, "JUE", 3);
+    BENCH_PUT32(ROM, ROM_START, 0);
+    BENCH_PUT32(ROM, ROM_END, BENCH_SYNTHETIC_SIZE - 1);
+
+    for (INDEX = 0; INDEX < sizeof(PROGRAM) / sizeof(PROGRAM[0]); INDEX++)
+        BENCH_PUT16(ROM, 0x200 + INDEX * 2, PROGRAM[INDEX]);
+
+    BENCH_PUT16(ROM, ROM_CHECKSUM, GET_CHECKSUM(ROM + 0x200, BENCH_SYNTHETIC_SIZE - 0x200, NULL));
+    return ROM;
+}
+
+//================================================
+//              MICRO BENCHMARKS
+//================================================
+
+static void BENCH_CHECKSUM(U64 OPS)
+{
+    while (OPS--)
+        BENCH_SINK += GET_CHECKSUM(BENCH_CHECKSUM_DATA, BENCH_CHECKSUM_SIZE, NULL);
+}
+
+/* WALK THE CARTRIDGE AND WORK RAM THROUGH THE 68K'S MEMORY MAP */
+
+static void BENCH_MEMORY_MAP(U64 OPS)
+{
+    U32 ADDRESS = 0;
+
+    while (OPS--)
+    {
+        BENCH_SINK += M68K_READ_16(ADDRESS & 0x1FFFE);
+        BENCH_SINK += M68K_READ_16(0xFF0000 | (ADDRESS & 0xFFFE));
+        ADDRESS += 2;
+    }
+}
+
+static void BENCH_VDP_LINE(U64 OPS)
+{
+    while (OPS--)
+        VDP_LINE((int)(OPS % VDP_ACTIVE_HEIGHT));
+}
+
+static void BENCH_REMAP_LINE(U64 OPS)
+{
+    while (OPS--)
+        REMAP_LINE((int)(OPS % VDP_ACTIVE_HEIGHT));
+}
+
+static void BENCH_DMA_SETUP(unsigned CODE)
+{
+    VDP->ADDRESS = 0;
+    VDP->CODE = CODE;
+    VDP->VDP_REG[15] = 2;
+    VDP->VDP_REG[21] = 0;
+    VDP->VDP_REG[22] = 0;
+    VDP->VDP_REG[23] = 0x7F;
+}
+
+static void BENCH_DMA_FILL(U64 OPS)
+{
+    while (OPS--)
+    {
+        BENCH_DMA_SETUP(VDP_CODE_VRAM_WRITE);
+        VDP->VDP_REG[15] = 1;
+        VDP->FILL_DATA = 0xA5A5;
+        VDP_DMA_FILL(0x10000);
+    }
+}
+
+static void BENCH_DMA_COPY(U64 OPS)
+{
+    while (OPS--)
+    {
+        BENCH_DMA_SETUP(VDP_CODE_VRAM_WRITE);
+        VDP->ADDRESS = 0x8000;
+        VDP->VDP_REG[15] = 1;
+        VDP_DMA_COPY(0x8000);
+    }
+}
+
+static void BENCH_DMA_68K_RAM(U64 OPS)
+{
+    while (OPS--)
+    {
+        BENCH_DMA_SETUP(VDP_CODE_VRAM_WRITE);
+        VDP_DMA_68K_RAM(0x8000);
+    }
+}
+
+static void BENCH_PSG_UPDATE(U64 OPS)
+{
+    while (OPS--)
+        PSG_UPDATE(&BENCH_PSG);
+
+    BENCH_SINK += BENCH_PSG.SAMPLE_BUFFER;
+}
+
+static void BENCH_SAVE_STATE(U64 OPS)
+{
+    while (OPS--)
+        BENCH_SINK += MD_SAVE_STATE(BENCH_STATE, BENCH_STATE_SIZE);
+}
+
+static void BENCH_LOAD_STATE(U64 OPS)
+{
+    while (OPS--)
+        BENCH_SINK += MD_LOAD_STATE(BENCH_STATE, BENCH_STATE_SIZE);
+}
+
+static const BENCH_MICRO BENCH_MICROS[] =
+{
+    { "get_checksum_1mb",       8,      BENCH_CHECKSUM },
+    { "memory_map_read16",      65536,  BENCH_MEMORY_MAP },
+    { "vdp_line",               4096,   BENCH_VDP_LINE },
+    { "remap_line",             4096,   BENCH_REMAP_LINE },
+    { "dma_fill_64k",           16,     BENCH_DMA_FILL },
+    { "dma_copy_32k",           16,     BENCH_DMA_COPY },
+    { "dma_68k_ram_32k_words",  16,     BENCH_DMA_68K_RAM },
+    { "psg_update",             65536,  BENCH_PSG_UPDATE },
+    { "save_state",             256,    BENCH_SAVE_STATE },
+    { "load_state",             256,    BENCH_LOAD_STATE },
+};
+
+//================================================
+//              STATISTICS AND REPORTING
+//================================================
+
+static void BENCH_STATS(const F64* VALUES, unsigned COUNT, BENCH_RESULT* RESULT)
+{
+    F64 SUM = 0.0;
+    F64 VARIANCE = 0.0;
+    unsigned INDEX;
+
+    for (INDEX = 0; INDEX < COUNT; INDEX++)
+        SUM += VALUES[INDEX];
+
+    RESULT->MEAN = SUM / COUNT;
+
+    for (INDEX = 0; INDEX < COUNT; INDEX++)
+        VARIANCE += (VALUES[INDEX] - RESULT->MEAN) * (VALUES[INDEX] - RESULT->MEAN);
+
+    RESULT->STDDEV = COUNT > 1 ? sqrt(VARIANCE / (COUNT - 1)) : 0.0;
+    RESULT->SAMPLES = COUNT;
+}
+
+static void BENCH_RUN_MICRO(const BENCH_MICRO* MICRO, unsigned SAMPLES, BENCH_RESULT* RESULT)
+{
+    F64 VALUES[BENCH_MAX_SAMPLES];
+    unsigned INDEX;
+    U64 START;
+
+    /* ONE UNTIMED PASS TO WARM THE CACHES */
+
+    MICRO->RUN(MICRO->OPS);
+
+    for (INDEX = 0; INDEX < SAMPLES; INDEX++)
+    {
+        START = PROFILE_CLOCK_NS();
+        MICRO->RUN(MICRO->OPS);
+        VALUES[INDEX] = (F64)(PROFILE_CLOCK_NS() - START) / (F64)MICRO->OPS;
+    }
+
+    RESULT->NAME = MICRO->NAME;
+    RESULT->UNIT = "ns_per_op";
+    RESULT->CORE = NULL;
+    RESULT->OPS = MICRO->OPS;
+
+    BENCH_STATS(VALUES, SAMPLES, RESULT);
+}
+
+/* BRING UP A FRESH CONSOLE FOR THE GIVEN ROM, READY TO RUN FRAMES */
+/* A NULL PATH SELECTS THE SYNTHETIC ROM */
+
+static U8* BENCH_BOOT(const char* PATH)
+{
+    MD* CONSOLE;
+    U8* ROM;
+
+    MD_INIT();
+    CONSOLE = MD_GET_CONSOLE();
+
+    if(PATH == NULL)
+    {
+        ROM = BENCH_SYNTHETIC_ROM();
+        if(ROM == NULL)
+            return NULL;
+
+        MD_CART_ATTACH(CONSOLE->MD_CART, ROM, BENCH_SYNTHETIC_SIZE);
+    }
+
+    else
+    {
+        if(MD_CART_LOAD((char*)PATH, CONSOLE->MD_CART) != 0)
+            return NULL;
+
+        ROM = (U8*)CONSOLE->MD_CART->ROM_DATA;
+    }
+
+    MD_RESET(MODE_HARD);
+    return ROM;
+}
+
+/* EVERY ROM IS RUN UNDER EACH 68K CORE, SO THE CACHED INTERPRETER AND THE */
+/* RECOMPILER CAN BE COMPARED AGAINST lib68k ON THE SAME WORKLOAD */
+
+static const char* BENCH_CORE_NAME[] = { "interp", "cached", "jit" };
+
+static int BENCH_RUN_MACRO(const char* PATH, MD_CPU_CORE CORE, unsigned FRAMES, unsigned SAMPLES, BENCH_RESULT* RESULT)
+{
+    U8* ROM = BENCH_BOOT(PATH);
+    F64 VALUES[BENCH_MAX_SAMPLES];
+    unsigned PER_SAMPLE = FRAMES / SAMPLES ? FRAMES / SAMPLES : 1;
+    unsigned INDEX, FRAME;
+    U64 START;
+
+    if(ROM == NULL)
+    {
+        MD_FREE();
+        return -1;
+    }
+
+    MD_SET_CPU_CORE(CORE);
+    MD_SEAL();
+
+    for (FRAME = 0; FRAME < BENCH_WARMUP_FRAMES; FRAME++)
+        MD_RUN_FRAME();
+
+    for (INDEX = 0; INDEX < SAMPLES; INDEX++)
+    {
+        START = PROFILE_CLOCK_NS();
+
+        for (FRAME = 0; FRAME < PER_SAMPLE; FRAME++)
+            MD_RUN_FRAME();
+
+        VALUES[INDEX] = (F64)PER_SAMPLE * 1.0e9 / (F64)(PROFILE_CLOCK_NS() - START);
+    }
+
+    RESULT->NAME = PATH != NULL ? PATH : "synthetic";
+    RESULT->UNIT = "fps";
+    RESULT->CORE = BENCH_CORE_NAME[CORE];
+    RESULT->OPS = (U64)PER_SAMPLE * SAMPLES;
+
+    BENCH_STATS(VALUES, SAMPLES, RESULT);
+
+    ROM_RELEASE(ROM);
+    MD_FREE();
+    return 0;
+}
+
+/* ROM PATHS END UP AS NAMES - QUOTES, BACKSLASHES AND CONTROL CHARACTERS */
+/* WOULD OTHERWISE BREAK THE JSON */
+
+static void BENCH_WRITE_STRING(FILE* OUT, const char* TEXT)
+{
+    const unsigned char* CHAR;
+
+    fputc('"', OUT);
+
+    for (CHAR = (const unsigned char*)TEXT; *CHAR != '\0'; CHAR++)
+    {
+        if (*CHAR == '"' || *CHAR == '\\')
+            fprintf(OUT, "\\%c", *CHAR);
+
+        else if (*CHAR < 0x20)
+            fprintf(OUT, "\\u%04X", *CHAR);
+
+        else
+            fputc(*CHAR, OUT);
+    }
+
+    fputc('"', OUT);
+}
+
+static void BENCH_WRITE_RESULTS(FILE* OUT, const char* KEY, const BENCH_RESULT* RESULTS, unsigned COUNT, bool LAST)
+{
+    unsigned INDEX;
+
+    fprintf(OUT, "  \"%s\": [", KEY);
+
+    for (INDEX = 0; INDEX < COUNT; INDEX++)
+    {
+        fprintf(OUT, "%s\n    {\"name\": ", INDEX ? "," : "");
+        BENCH_WRITE_STRING(OUT, RESULTS[INDEX].NAME);
+        fprintf(OUT, ", \"unit\": \"%s\", \"mean\": %.4f, \"stddev\": %.4f, \"samples\": %u, \"ops\": %llu",
+                RESULTS[INDEX].UNIT, RESULTS[INDEX].MEAN,
+                RESULTS[INDEX].STDDEV, RESULTS[INDEX].SAMPLES, (unsigned long long)RESULTS[INDEX].OPS);
+
+        if (RESULTS[INDEX].CORE != NULL)
+            fprintf(OUT, ", \"core\": \"%s\"", RESULTS[INDEX].CORE);
+
+        fprintf(OUT, "}");
+
+        fprintf(stderr, "%-28s %-6s %14.3f %-10s +/- %.3f\n", RESULTS[INDEX].NAME,
+                RESULTS[INDEX].CORE != NULL ? RESULTS[INDEX].CORE : "", RESULTS[INDEX].MEAN,
+                RESULTS[INDEX].UNIT, RESULTS[INDEX].STDDEV);
+    }
+
+    fprintf(OUT, "\n  ]%s\n", LAST ? "" : ",");
+}
+
+static int BENCH_PARSE_OPTIONS(int argc, char* argv[], BENCH_OPTIONS* OPTIONS)
+{
+    int INDEX;
+
+    memset(OPTIONS, 0, sizeof(*OPTIONS));
+    OPTIONS->SAMPLES = BENCH_DEFAULT_SAMPLES;
+    OPTIONS->FRAMES = BENCH_DEFAULT_FRAMES;
+
+    for (INDEX = 1; INDEX < argc; INDEX++)
+    {
+        if (strcmp(argv[INDEX], "--frames") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->FRAMES = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+        }
+
+        else if (strcmp(argv[INDEX], "--samples") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->SAMPLES = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+        }
+
+        else if (strcmp(argv[INDEX], "--out") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->OUT_PATH = argv[++INDEX];
+        }
+
+        else if (argv[INDEX][0] == '-' || OPTIONS->ROM_COUNT == BENCH_MAX_ROMS)
+        {
+            return -1;
+        }
+
+        else
+        {
+            OPTIONS->ROMS[OPTIONS->ROM_COUNT++] = argv[INDEX];
+        }
+    }
+
+    /* SAMPLES ARE HELD ON THE STACK, SO NOTHING IS ALLOCATED WHILE TIMING */
+
+    if (OPTIONS->SAMPLES > BENCH_MAX_SAMPLES)
+        OPTIONS->SAMPLES = BENCH_MAX_SAMPLES;
+
+    return OPTIONS->SAMPLES ? 0 : -1;
+}
+
+int main(int argc, char* argv[])
+{
+    BENCH_OPTIONS OPTIONS;
+    BENCH_RESULT MICRO[sizeof(BENCH_MICROS) / sizeof(BENCH_MICROS[0])];
+    BENCH_RESULT MACRO[(BENCH_MAX_ROMS + 1) * 3];
+    unsigned MICRO_COUNT = sizeof(BENCH_MICROS) / sizeof(BENCH_MICROS[0]);
+    unsigned MACRO_COUNT = 0;
+    unsigned INDEX;
+    MD_CPU_CORE CORE;
+    U8* ROM;
+    FILE* OUT = stdout;
+
+    if (BENCH_PARSE_OPTIONS(argc, argv, &OPTIONS) != 0)
+    {
+        fprintf(stderr, "Usage: %s [--frames N] [--samples N] [--out FILE] [ROM...]\n", argv[0]);
+        return -1;
+    }
+
+    /* MICRO BENCHMARKS SHARE ONE CONSOLE BOOTED FROM THE SYNTHETIC ROM */
+    /* EVERY BUFFER THEY NEED IS ALLOCATED BEFORE THE ARENA IS SEALED */
+
+    ROM = BENCH_BOOT(NULL);
+    BENCH_CHECKSUM_DATA = malloc(BENCH_CHECKSUM_SIZE);
+    BENCH_STATE_SIZE = MD_STATE_SIZE();
+    BENCH_STATE = malloc(BENCH_STATE_SIZE);
+
+    if (ROM == NULL || BENCH_CHECKSUM_DATA == NULL || BENCH_STATE == NULL)
+    {
+        fprintf(stderr, "Failed to set up the benchmark console\n");
+        return -1;
+    }
+
+    for (INDEX = 0; INDEX < BENCH_CHECKSUM_SIZE; INDEX++)
+        BENCH_CHECKSUM_DATA[INDEX] = (U8)(INDEX * 31);
+
+    PSG_CONST_INIT(&BENCH_PSG);
+    PSG_STATE_INIT(&BENCH_PSG);
+    MD_SAVE_STATE(BENCH_STATE, BENCH_STATE_SIZE);
+    MD_SEAL();
+
+    for (INDEX = 0; INDEX < MICRO_COUNT; INDEX++)
+        BENCH_RUN_MICRO(&BENCH_MICROS[INDEX], OPTIONS.SAMPLES, &MICRO[INDEX]);
+
+    free(BENCH_STATE);
+    free(BENCH_CHECKSUM_DATA);
+    ROM_RELEASE(ROM);
+    MD_FREE();
+
+    /* MACRO BENCHMARKS - THE SYNTHETIC ROM, THEN ANY ROMS PASSED IN */
+
+    for (CORE = MD_CORE_INTERPRETER; CORE <= MD_CORE_JIT; CORE++)
+    {
+        if (BENCH_RUN_MACRO(NULL, CORE, OPTIONS.FRAMES, OPTIONS.SAMPLES, &MACRO[MACRO_COUNT]) == 0)
+            MACRO_COUNT++;
+
+        for (INDEX = 0; INDEX < OPTIONS.ROM_COUNT; INDEX++)
+        {
+            if (BENCH_RUN_MACRO(OPTIONS.ROMS[INDEX], CORE, OPTIONS.FRAMES, OPTIONS.SAMPLES, &MACRO[MACRO_COUNT]) == 0)
+                MACRO_COUNT++;
+        }
+    }
+
+    if (OPTIONS.OUT_PATH != NULL)
+    {
+        OUT = fopen(OPTIONS.OUT_PATH, "w");
+        if (OUT == NULL)
+        {
+            fprintf(stderr, "Failed to open %s\n", OPTIONS.OUT_PATH);
+            return -1;
+        }
+    }
+
+    fprintf(OUT, "{\n");
+    BENCH_WRITE_RESULTS(OUT, "micro", MICRO, MICRO_COUNT, false);
+    BENCH_WRITE_RESULTS(OUT, "macro", MACRO, MACRO_COUNT, true);
+    fprintf(OUT, "}\n");
+
+    if (OUT != stdout)
+        fclose(OUT);
+
+    return 0;
+}
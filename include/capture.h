@@ -0,0 +1,119 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE LOSSLESS CAPTURE OF GAMEPLAY */
+/* EVERY EMULATED FRAME IS RECORDED ALONGSIDE THE SAMPLES PRODUCED DURING IT, */
+/* SUCH THAT TWO RUNS CAN BE DIFFED FRAME FOR FRAME */
+
+/* THE EMULATION THREAD ONLY EVER COPIES THE FINISHED FRAME AND IT'S AUDIO INTO */
+/* A BOUNDED QUEUE - ENCODING AND DISK I/O ARE LEFT TO A WRITER THREAD OF IT'S OWN */
+
+/* A FULL QUEUE MEANS THE DISK CAN'T KEEP UP - THE EMULATOR WAITS FOR A FREE */
+/* ENTRY RATHER THAN DROPPING A FRAME, SINCE A CAPTURE WITH HOLES IN IT CAN'T */
+/* BE DIFFED AGAINST ANYTHING */
+
+#ifndef MD_CAPTURE_H
+#define MD_CAPTURE_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#if defined(USE_CAPTURE)
+    #define USE_CAPTURE
+#else
+    #define USE_CAPTURE
+
+    #define     CAPTURE_MAGIC               "MDCV"
+    #define     CAPTURE_VERSION             1
+
+    /* A LITTLE OVER A TENTH OF A SECOND OF FRAMES IN FLIGHT */
+
+    #define     CAPTURE_QUEUE_SIZE          8
+
+    /* ONE SAMPLE IS PRODUCED PER SCANLINE, AND A PAL FRAME HAS 313 OF THEM */
+
+    #define     CAPTURE_MAX_SAMPLES         512
+
+    /* A KEY FRAME EVERY TEN SECONDS, SO A DAMAGED FILE CAN STILL BE DECODED FROM THE NEXT ONE */
+
+    #define     CAPTURE_KEY_INTERVAL        600
+    #define     CAPTURE_FRAME_KEY           0x01
+
+    #define     CAPTURE_MAX_RUN             0xFFFF
+
+/* THE VIDEO FILE IS A HEADER FOLLOWED BY ONE RECORD PER FRAME - ALL VALUES */
+/* ARE STORED LITTLE ENDIAN, AS WITH MOVIES */
+
+/* EACH FRAME IS THE XOR OF IT'S PIXELS WITH THOSE OF THE FRAME BEFORE IT (OR */
+/* WITH NOTHING, FOR A KEY FRAME) - UNCHANGED PIXELS BECOME ZERO, AND THE RESULT */
+/* IS STORED AS PAIRS OF RUNS: HOW MANY ZEROES TO SKIP, THEN HOW MANY PIXELS */
+/* FOLLOW VERBATIM */
+
+/* THE AUDIO IS A PLAIN 16 BIT MONO WAV AT THE LINE RATE (SEE audio.h) */
+
+typedef struct CAPTURE_ENTRY
+{
+    U32* PIXELS;
+    int WIDTH;
+    int HEIGHT;
+
+    S16 SAMPLES[CAPTURE_MAX_SAMPLES];
+    UNK SAMPLE_COUNT;
+
+} CAPTURE_ENTRY;
+
+typedef struct CAPTURE_BASE
+{
+    bool ACTIVE;
+    FILE* VIDEO;
+    FILE* AUDIO;
+
+    /* THE QUEUE - HEAD IS ONLY ADVANCED BY THE EMULATION THREAD AND TAIL BY */
+    /* THE WRITER, BOTH UNDER THE LOCK */
+
+    CAPTURE_ENTRY QUEUE[CAPTURE_QUEUE_SIZE];
+    U32 HEAD;
+    U32 TAIL;
+    bool STOP;
+
+    pthread_t THREAD;
+    pthread_mutex_t LOCK;
+    pthread_cond_t READY;
+    pthread_cond_t SPACE;
+
+    /* EMULATION THREAD: THE SAMPLES OF THE FRAME BEING RUN */
+
+    S16 PENDING[CAPTURE_MAX_SAMPLES];
+    UNK PENDING_COUNT;
+    U32 STALLS;
+
+    /* WRITER THREAD: THE LAST FRAME WRITTEN AND THE ENCODED RECORD */
+
+    U32* PREVIOUS;
+    int PREVIOUS_WIDTH;
+    int PREVIOUS_HEIGHT;
+    U8* CODE;
+
+    bool FAILED;
+    U32 FRAMES;
+    U32 SAMPLES;
+    U64 BYTES;
+
+} CAPTURE_BASE;
+
+int CAPTURE_OPEN(const char* PATH);
+void CAPTURE_AUDIO(S16 SAMPLE);
+void CAPTURE_FRAME(void);
+bool CAPTURE_ACTIVE(void);
+void CAPTURE_CLOSE(void);
+
+#endif
+#endif
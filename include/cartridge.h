@@ -37,7 +37,7 @@ typedef struct ROM_INFO
     unsigned int END;
     unsigned char REGION[18];
 
-    S16* PERIPHERALS;
+    S16 PERIPHERALS;
 
 } ROM_INFO;
 
@@ -50,15 +50,30 @@ typedef struct ROM_INFO
 #define         ROM_INTERNATIONAL   336
 #define         ROM_SERIAL          386
 #define         ROM_CHECKSUM        398
+#define         ROM_PERIPHERALS     400
 #define         ROM_START           416
-#define         ROM_END             440
+#define         ROM_END             420
 #define         ROM_REGION          496
 #define         MD_ROM_NAME_LEN      256
 
+/* BITS STORED IN ROM_INFO.PERIPHERALS, DECODED FROM THE I/O SUPPORT STRING */
+
+#define         ROM_PERIPHERAL_PAD3         (1 << 0)        /* 'J' */
+#define         ROM_PERIPHERAL_PAD6         (1 << 1)        /* '6' */
+#define         ROM_PERIPHERAL_MULTITAP     (1 << 2)        /* '4' */
+#define         ROM_PERIPHERAL_MOUSE        (1 << 3)        /* 'M' */
+#define         ROM_PERIPHERAL_KEYBOARD     (1 << 4)        /* 'K' */
+#define         ROM_PERIPHERAL_LIGHTGUN     (1 << 5)        /* 'L' */
+#define         ROM_PERIPHERAL_LEN          16
+
 U16 GET_CHECKSUM(U8* ROM, unsigned LENGTH, char* FILENAME);
 void MD_ROM_CHECKER(U8* SRC);
 void MD_GET_ROM_INFO(char* HEADER);
+const ROM_INFO* MD_ROM_HEADER(void);
 int MD_LOAD_ROM(char* FILENAME);
+void MD_CART_ATTACH(MD_CART* CART, U8* DATA, UNK SIZE);
+void MD_CART_ATTACH_INFO(MD_CART* CART, U8* DATA, UNK SIZE, const ROM_INFO* INFO);
+int MD_CART_LOAD(char* FILENAME, MD_CART* CART);
 
 #endif
 #endif
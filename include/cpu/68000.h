@@ -24,6 +24,7 @@
 /* NESTED INCLUDES */
 
 #include "common.h"
+#include "mem.h"
 
 /*===============================================================================*/
 /*							68000 DEBUG											 */
@@ -82,13 +83,11 @@
 #else
 #define USE_CPU
 
-#define 	READ_BYTE(BASE, ADDR) 			(BASE)[(ADDR)^1]
-#define 	READ_WORD(BASE, ADDR) 			(((BASE)[ADDR]<<8) | (BASE)[(ADDR)+1])
+/* MEMORY BEHIND THE BUS IS HELD IN HOST WORD ORDER - SEE mem.h */
 
-#define 	READ_WORD_LONG(BASE, ADDR) 		(((BASE)[(ADDR)+1]<<24) |       \
-                                    		((BASE)[(ADDR)]<<16) |  		\
-                                    		((BASE)[(ADDR)+3]<<8) |   		\
-                                    		(BASE)[(ADDR)+2])
+#define 	READ_BYTE(BASE, ADDR) 			MD_READ_BYTE(BASE, ADDR)
+#define 	READ_WORD(BASE, ADDR) 			MD_READ_WORD(BASE, ADDR)
+#define 	READ_WORD_LONG(BASE, ADDR) 		MD_READ_LONG(BASE, ADDR)
 
 /*===============================================================================*/
 /*							68000 MAIN CPU FUNCTIONALIY							 */
@@ -98,10 +97,10 @@
 /* MORE SPECIFICALLY, THIS IS TO AVOID ARRAY INDEXXING ISSUES WHEN IT COMES TO */
 /* REGISTERS */
 
-#define 	M68K_GET_DB 			CPU_68K.REGISTER_BASE
+#define 	M68K_GET_DB 			CPU_68K.DATA_REGISTER
 #define 	M68K_GET_DR(VALUE) 		CPU_68K->DATA_REGISTER[VALUE]
 #define 	M68K_GET_AR(VALUE) 		CPU_68K->ADDRESS_REGISTER[VALUE]
-#define		M68K_GET_SP(VALUE)		CPU_68K->STACK_POINTER += ((VALUE))
+#define		M68K_GET_SP(VALUE)		CPU_68K->ADDRESS_REGISTER[7] += ((VALUE))
 
 #define 	M68K_MASK_OUT_ABOVE_8(A) ((A) & 0xFF)
 #define 	M68K_MASK_OUT_ABOVE_16(A) ((A) & 0xFFFF)
@@ -180,72 +179,65 @@ extern void CTRL_WRITE_WORD(unsigned int ADDRESS, unsigned int DATA);
 #define 	EXCEPTION_INTERRUPT_AUTOVECTOR    24
 #define 	EXCEPTION_TRAP_BASE               32
 
+/* A BANK IS READ AND WRITTEN STRAIGHT THROUGH MEMORY_BASE, UNLESS IT HAS A */
+/* HANDLER FOR THAT KIND OF ACCESS - THEN THE ACCESS IS ROUTED THROUGH IT */
+
 typedef struct CPU_68K_MEMORY
 {
     unsigned(*MEMORY_BASE);
-    U8* MEMORY_READ_8;
-    U16*  MEMORY_READ_16;
-    U8* MEMORY_WRITE_8;
-    U16* MEMORY_WRITE_16;
+    unsigned(*MEMORY_READ_8)(unsigned ADDRESS);
+    unsigned(*MEMORY_READ_16)(unsigned ADDRESS);
+    void(*MEMORY_WRITE_8)(unsigned ADDRESS, unsigned DATA);
+    void(*MEMORY_WRITE_16)(unsigned ADDRESS, unsigned DATA);
 
 } CPU_68K_MEMORY;
 
+/* THE 68K'S BUS TABLES LIVE APART FROM THE REGISTER FILE - ONE ENTRY PER */
+/* 64KB BANK, INDEXED BY BITS 23-16 OF THE ADDRESS */
+
+/* THE Z80'S OWN BANKING SITS WITH THE REST OF IT'S MEMORY (SEE mem.h) */
+
+extern CPU_68K_MEMORY M68K_MEMORY_MAP[256];
+
+/* EVERYTHING TOUCHED ON EVERY INSTRUCTION IS HELD BY VALUE AND PACKED INTO */
+/* THE FIRST TWO CACHE LINES - D0-D7 AND A0-A7 BACK TO BACK (SUCH THAT AN */
+/* ADDRESS REGISTER IS ALSO DATA_REGISTER[8 + N]), FOLLOWED BY PC, SR AND */
+/* THE CYCLE COUNT */
+
+/* THE CONDITION CODES AND SUPERVISOR/TRACE BITS LIVE IN SR ALONE */
+/* SEE flags.h FOR HOW THEY ARE KEPT UP TO DATE */
+
 typedef struct CPU_68K
 {
-    
-
-    /* PUTTING THE Z80 MEMORY BANK FUNCTIONALITY */
-    /* IN HERE FOR NOW UNTIL MODULARISATION WOULD BETTER SUIT */
-
-    union Z80_MEM
-    {
-        unsigned(*READ)(unsigned ADDRESS);
-        unsigned(*WRITE)(unsigned ADDRESS);
-
-        unsigned int CYCLES;
-		U8 ZRAM[0x2000];
-
-    } Z80_MEM[256];
-
-	CPU_68K_MEMORY MEMORY_MAP[256];
-
-	/* VERY UNORGANISED TMSS MAPPER */
-	/* TO:DO - FIX THE ORGANISATION */
-
-	union TMSS
-	{
-		void(*ROM)(void);
-		U32 READ_BANK;
-		U8 ROM_MAPPER;
-		bool IS_MAPPED;
-		void(*RESET)(void);
-
-	} TMSS;
-
-
-	U16* STATUS_REGISTER;
-	U32* INDEX_REGISTER;
-    U32* REGISTER_BASE[16];
-	U32* DATA_REGISTER[8];
-	U32* ADDRESS_REGISTER[8];
-    U32* PREVIOUS_PC;
-    U32* STACK_POINTER;
-	U32* INTERRUPT_SP;
-	U32* MASTER_SP;
-	U32* USER_STACK;
-	U32* ADDRESS_STACK_POINTER;
-    U32* INSTRUCTION_REGISTER;
-	U32* SOURCE_FUNCTION_COUNTER;
-	U32* DEST_FUNCTION_COUNTER;
-	U32* VBR;
-	U32* FPR[8];
-	U32* FPIAR;
-	U32* FPCR;
-	U32* FPSR;
-	U32* CACHE_CONTROL;
-	U32* CACHE_ADDRESS;
-
-	U32 TMSS_BASE[4];
+	U32 DATA_REGISTER[8];
+	U32 ADDRESS_REGISTER[8];
+	U32 PC;
+	U32 PREVIOUS_PC;
+	U16 STATUS_REGISTER;
+	U16 INSTRUCTION_REGISTER;
+	int INSTRUCTION_CYCLES;
+	unsigned INT_LEVEL;
+	unsigned CPU_STOPPED;
+
+	/* WHICHEVER STACK POINTERS AREN'T CURRENTLY IN A7 */
+
+	U32 USER_STACK;
+	U32 INTERRUPT_SP;
+	U32 MASTER_SP;
+
+	/* CONTROL REGISTERS - NEVER TOUCHED BY THE 68000 ITSELF */
+
+	U32 VBR;
+	U32 SOURCE_FUNCTION_COUNTER;
+	U32 DEST_FUNCTION_COUNTER;
+	U32 CACHE_CONTROL;
+	U32 CACHE_ADDRESS;
+	U32 FPR[8];
+	U32 FPIAR;
+	U32 FPCR;
+	U32 FPSR;
+
+	/* EVERYTHING BELOW IS ONLY REACHED FOR ON EXCEPTIONS AND CALLBACKS */
 
     char* INSTRUCTION_MODE;
     char* TRACE_FLAG;
@@ -261,21 +253,6 @@ typedef struct CPU_68K
     S32(*INTERRUPT_CALLBACK)(unsigned INTERRUPT);
     S32(*RESET_INTERRUPT)(void);
     S32(*CPU_FUNC_CALLBACK)(unsigned FUNCTION);
-	unsigned int* INT_LEVEL;
-
-	unsigned* CPU_STOPPED;
-
-	unsigned S_FLAG;
-	unsigned* X_FLAG;
-	unsigned* N_FLAG;
-	unsigned* V_FLAG;
-	unsigned* Z_FLAG;
-	unsigned* C_FLAG;
-	unsigned M_FLAG;
-
-	unsigned* T0_FLAG;
-	unsigned* T1_FLAG;
-
 
 } CPU_68K;
 
@@ -332,36 +309,36 @@ typedef enum CPU_68K_FLAGS
 #define			M68K_REG_SR				CPU->STATUS_REGISTER
 #define			M68K_REG_PPC			CPU->PREVIOUS_PC
 #define			M68K_REG_PC				CPU->PC
-#define			M68K_REG_SP				CPU->STACK_POINTER
-#define			M68K_REG_USP			CPU->USER_STACK[0]
-#define			M68K_REG_ISP			CPU->INTERRUPT_SP[4]
-#define			M68K_REG_MSP			CPU->MASTER_SP[6]
-#define			M68K_REG_SP_FULL		CPU->REGISTER_BASE[15]
+#define			M68K_REG_SP				CPU->ADDRESS_REGISTER[7]
+#define			M68K_REG_USP			CPU->USER_STACK
+#define			M68K_REG_ISP			CPU->INTERRUPT_SP
+#define			M68K_REG_MSP			CPU->MASTER_SP
+#define			M68K_REG_SP_FULL		CPU->ADDRESS_REGISTER[7]
 #define			M68K_REG_VBR			CPU->VBR
 #define			M68K_REG_SFC			CPU->SOURCE_FUNCTION_COUNTER
 #define			M68K_REG_DFC			CPU->DEST_FUNCTION_COUNTER
 #define			M68K_REG_CACR			CPU->CACHE_CONTROL
 #define			M68K_REG_CAAR			CPU->CACHE_ADDRESS
-#define			M68K_REG_IR				CPU->INDEX_REGISTER
+#define			M68K_REG_IR				CPU->INSTRUCTION_REGISTER
 #define 		M68K_REG_FPR			CPU->FPR
 #define			M68K_REG_FPCR			CPU->FPCR
 #define			M68K_REG_FPSR			CPU->FPSR
 #define			M68K_REG_FPIAR			CPU->FPIAR
 
-#define  		M68K_FLAG_T0			CPU->T0_FLAG
-#define			M68K_FLAG_T1			CPU->T1_FLAG
-#define			M68K_FLAG_S				CPU->S_FLAG
-#define			M68K_FLAG_M				CPU->M_FLAG
-#define			M68K_FLAG_X				CPU->X_FLAG
-#define			M68K_FLAG_N				CPU->N_FLAG
-#define			M68K_FLAG_Z				CPU->Z_FLAG
-#define			M68K_FLAG_V				CPU->V_FLAG
-#define			M68K_FLAG_C				CPU->C_FLAG
+#define  		M68K_FLAG_T0			((CPU->STATUS_REGISTER >> 14) & 1)
+#define			M68K_FLAG_T1			((CPU->STATUS_REGISTER >> 15) & 1)
+#define			M68K_FLAG_S				((CPU->STATUS_REGISTER >> 13) & 1)
+#define			M68K_FLAG_M				((CPU->STATUS_REGISTER >> 12) & 1)
+#define			M68K_FLAG_X				((CPU->STATUS_REGISTER >> EXTENDED_BIT) & 1)
+#define			M68K_FLAG_N				((CPU->STATUS_REGISTER >> NEGATIVE_BIT) & 1)
+#define			M68K_FLAG_Z				((CPU->STATUS_REGISTER >> ZERO_BIT) & 1)
+#define			M68K_FLAG_V				((CPU->STATUS_REGISTER >> OVERFLOW_BIT) & 1)
+#define			M68K_FLAG_C				((CPU->STATUS_REGISTER >> CARRY_BIT) & 1)
 #define			M68K_FLAG_INT_LVL		CPU->INT_LEVEL
 #define			M68K_CPU_STOPPED		CPU->CPU_STOPPED
 
 #define			M68K_CYC_EXCE			CPU->CYCLE_EXCEPTION
-#define 		M68K_CYCLE				CPU->INSTRUCTION_CYCLES[16]
+#define 		M68K_CYCLE				CPU->INSTRUCTION_CYCLES
 
 #define M68K_SAVE_INSTR(IDENTIFIER, VALUE) 					(*((char*)(IDENTIFIER)) = (char)((VALUE)))
 #define	M68K_INT_LEVEL										CPU->INT_LEVEL
@@ -0,0 +1,194 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE CACHED INTERPRETER FOR THE 68000 */
+
+/* RATHER THAN FETCHING AND DECODING EVERY INSTRUCTION AS IT IS EXECUTED, */
+/* STRAIGHT LINE RUNS OF CODE (BASIC BLOCKS) ARE DECODED ONCE INTO AN ARRAY OF */
+/* OPERATIONS - EACH HOLDING IT'S HANDLER, SIZE, CYCLE COST AND FULLY RESOLVED */
+/* OPERANDS - WHICH ARE THEN RUN BACK TO BACK THROUGH THREADED DISPATCH */
+
+/* ANY INSTRUCTION THE DECODER DOES NOT HANDLE ENDS THE BLOCK, AND IS STEPPED */
+/* THROUGH lib68k'S OWN INTERPRETER BEFORE THE NEXT BLOCK IS LOOKED UP */
+
+#ifndef M68K_CACHE_H
+#define M68K_CACHE_H
+
+/* NESTED INCLUDES */
+
+#include <68K.h>
+#include "common.h"
+#include "flags.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_M68K_CACHE)
+    #define USE_M68K_CACHE
+#else
+    #define USE_M68K_CACHE
+
+    #define     M68K_CACHE_BLOCKS           1024                /* DIRECT MAPPED, KEYED ON PC */
+    #define     M68K_CACHE_MAX_OPS          16                  /* INCLUDING THE TERMINATOR */
+    #define     M68K_CACHE_PAGE_SHIFT       8                   /* 256 BYTE PAGES OF WORK RAM */
+    #define     M68K_CACHE_RAM_PAGES        (0x10000 >> M68K_CACHE_PAGE_SHIFT)
+
+    /* CODE IS ONLY CACHED FROM THE CARTRIDGE AND WORK RAM */
+    /* CARTRIDGE ROM NEVER CHANGES, WORK RAM IS WATCHED FOR WRITES */
+
+    #define     M68K_CACHE_ROM_END          0x400000
+    #define     M68K_CACHE_RAM_START        0xE00000
+
+    /* REGISTER ACCESS USED BY THE CACHED INTERPRETER */
+
+    #define     M68K_CACHE_D(N)             CPU.DATA_REGISTER[(N)]
+    #define     M68K_CACHE_A(N)             CPU.ADDRESS_REGISTER[(N)]
+    #define     M68K_CACHE_SR               CPU.STATUS_REGISTER
+    #define     M68K_CACHE_PC               CPU.PC
+
+/* EFFECTIVE ADDRESSES ARE RESOLVED AT DECODE TIME INTO ONE OF THESE FORMS */
+/* PC RELATIVE AND ABSOLUTE SHORT ADDRESSES BOTH BECOME M68K_EA_ABS */
+
+typedef enum M68K_CACHE_EA_MODE
+{
+    M68K_EA_DN,
+    M68K_EA_AN,
+    M68K_EA_IND,
+    M68K_EA_POST,
+    M68K_EA_PRE,
+    M68K_EA_DISP,
+    M68K_EA_ABS,
+    M68K_EA_IMM,
+
+} M68K_CACHE_EA_MODE;
+
+typedef struct M68K_CACHE_EA
+{
+    U8 MODE;
+    U8 REG;
+    U32 EXT;
+
+} M68K_CACHE_EA;
+
+/* THE HANDLERS A DECODED OPERATION CAN DISPATCH TO */
+
+typedef enum M68K_CACHE_KIND
+{
+    M68K_OP_END,
+    M68K_OP_NOP,
+    M68K_OP_MOVEQ,
+    M68K_OP_MOVE_RR,
+    M68K_OP_MOVE,
+    M68K_OP_MOVEA,
+    M68K_OP_LEA,
+    M68K_OP_CLR,
+    M68K_OP_TST,
+    M68K_OP_ADDQ,
+    M68K_OP_SUBQ,
+    M68K_OP_ADDQ_A,
+    M68K_OP_ADD,
+    M68K_OP_SUB,
+    M68K_OP_CMP,
+    M68K_OP_AND,
+    M68K_OP_OR,
+    M68K_OP_ADDA,
+    M68K_OP_SUBA,
+    M68K_OP_CMPA,
+    M68K_OP_BCC,
+    M68K_OP_BSR,
+    M68K_OP_DBCC,
+    M68K_OP_JMP,
+    M68K_OP_JSR,
+    M68K_OP_RTS,
+    M68K_OP_COUNT,
+
+} M68K_CACHE_KIND;
+
+typedef struct M68K_CACHE_OP
+{
+    U8 KIND;
+    U8 SIZE;
+    U8 CYCLES;
+    U8 COND;
+    M68K_CACHE_EA SRC;
+    M68K_CACHE_EA DST;
+
+    /* THE ADDRESS OF THE FOLLOWING INSTRUCTION */
+
+    U32 NEXT_PC;
+
+} M68K_CACHE_OP;
+
+typedef struct M68K_CACHE_BLOCK
+{
+    U32 START;
+    U32 GENERATION;
+    U16 OP_COUNT;
+    bool VALID;
+    M68K_CACHE_OP OPS[M68K_CACHE_MAX_OPS];
+
+} M68K_CACHE_BLOCK;
+
+typedef struct M68K_CACHE
+{
+    M68K_CACHE_BLOCK* BLOCKS;
+
+    /* BLOCKS BUILT FROM WORK RAM RECORD THE GENERATION THEY WERE BUILT IN */
+    /* A WRITE TO A PAGE HOLDING CODE BUMPS THE GENERATION, RETIRING THEM ALL */
+
+    U32 RAM_GENERATION;
+    U8 RAM_CODE_PAGES[M68K_CACHE_RAM_PAGES];
+
+    /* THE SAME PAGES AS A LIST - lib68k'S OWN WRITES NEVER PASS THROUGH THE */
+    /* WATCH, SO AFTER IT STEPS AN INSTRUCTION THEY ARE CHECKED AGAINST THE */
+    /* COPY TAKEN WHEN THEY WERE DECODED INSTEAD */
+
+    U8 RAM_CODE_LIST[M68K_CACHE_RAM_PAGES];
+    unsigned RAM_CODE_COUNT;
+
+    /* CONDITION CODES LEFT PENDING BY THE LAST FLAG SETTING OPERATION */
+    /* SEE flags.h - THESE ARE FOLDED INTO SR WHENEVER CONTROL LEAVES THE CACHE */
+
+    M68K_FLAGS FLAGS;
+
+    /* SET WHEN SOMETHING MID-SLICE NEEDS THE SCHEDULER TO LOOK AT IT BEFORE */
+    /* THE DEADLINE - THE SLICE STOPS AT THE END OF THE CURRENT BLOCK */
+
+    bool END_SLICE;
+
+    /* A FLUSH ASKED FOR BY A BUS WRITE WHILE A SLICE IS RUNNING - THE BLOCK */
+    /* BEING RUN CAN'T BE TORN DOWN UNDER IT, SO IT WAITS FOR THE SLICE TO END */
+
+    bool RUNNING;
+    bool FLUSH_PENDING;
+
+    U32 HITS;
+    U32 MISSES;
+
+} M68K_CACHE;
+
+void M68K_CACHE_INIT(void);
+void M68K_CACHE_FLUSH(void);
+int M68K_CACHE_EXEC(int CYCLES);
+int M68K_CACHE_STEP(void);
+const M68K_CACHE_BLOCK* M68K_CACHE_DECODE(U32 PC);
+bool M68K_CACHE_CONDITION(unsigned COND);
+void M68K_CACHE_SYNC(void);
+void M68K_CACHE_END_SLICE(bool END);
+void M68K_CACHE_ENTER(void);
+void M68K_CACHE_LEAVE(void);
+void M68K_CACHE_INVALIDATE(U32 ADDRESS);
+const M68K_CACHE* M68K_CACHE_STATE(void);
+
+/* CALLED ON EVERY WORK RAM WRITE - ONLY PAGES KNOWN TO HOLD CODE COST ANYTHING */
+
+static inline void M68K_CACHE_WATCH_WRITE(const M68K_CACHE* CACHE, U32 ADDRESS)
+{
+    if(CACHE->RAM_CODE_PAGES[(ADDRESS & 0xFFFF) >> M68K_CACHE_PAGE_SHIFT])
+        M68K_CACHE_INVALIDATE(ADDRESS);
+}
+
+#endif
+#endif
@@ -0,0 +1,189 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS LAZY CONDITION CODE EVALUATION FOR THE 68000 */
+
+/* MOST FLAG RESULTS ARE OVERWRITTEN BY THE NEXT ALU OPERATION BEFORE ANYTHING */
+/* LOOKS AT THEM - SO RATHER THAN MATERIALISING N, Z, V, C AND X EVERY TIME, ONLY */
+/* THE LAST OPERATION'S KIND, SIZE, OPERANDS AND RESULT ARE RECORDED */
+
+/* THE FLAGS ARE THEN WORKED OUT ON DEMAND - WHEN A CONDITION IS TESTED, OR FOLDED */
+/* INTO THE STATUS REGISTER BEFORE ANYTHING ELSE (lib68k, AN EXCEPTION, A SAVE */
+/* STATE) CAN READ IT */
+
+#ifndef M68K_FLAGS_H
+#define M68K_FLAGS_H
+
+/* NESTED INCLUDES */
+
+#include <68K.h>
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_M68K_FLAGS)
+    #define USE_M68K_FLAGS
+#else
+    #define USE_M68K_FLAGS
+
+    /* CONDITION CODE BITS WITHIN THE STATUS REGISTER */
+
+    #define     M68K_CCR_C                  0x01
+    #define     M68K_CCR_V                  0x02
+    #define     M68K_CCR_Z                  0x04
+    #define     M68K_CCR_N                  0x08
+    #define     M68K_CCR_X                  0x10
+
+    #define     M68K_CCR_NZVC               (M68K_CCR_N | M68K_CCR_Z | M68K_CCR_V | M68K_CCR_C)
+
+    #define     M68K_FLAGS_MASK(SIZE)       ((SIZE) == 1 ? 0xFFu : (SIZE) == 2 ? 0xFFFFu : 0xFFFFFFFFu)
+    #define     M68K_FLAGS_MSB(SIZE)        ((SIZE) == 1 ? 0x80u : (SIZE) == 2 ? 0x8000u : 0x80000000u)
+
+/* WHAT PRODUCED THE PENDING FLAGS - EVERYTHING FROM M68K_FLAGS_ADD ONWARDS */
+/* ALSO SETS THE EXTEND FLAG, THE REST LEAVE IT AS IT WAS */
+
+typedef enum M68K_FLAGS_KIND
+{
+    M68K_FLAGS_NONE,                /* THE STATUS REGISTER IS UP TO DATE */
+    M68K_FLAGS_LOGIC,               /* N AND Z FROM THE RESULT, V AND C CLEARED */
+    M68K_FLAGS_CMP,                 /* RESULT = DST - SRC, X UNTOUCHED */
+    M68K_FLAGS_ADD,                 /* RESULT = DST + SRC */
+    M68K_FLAGS_SUB,                 /* RESULT = DST - SRC */
+
+} M68K_FLAGS_KIND;
+
+typedef struct M68K_FLAGS
+{
+    U8 KIND;
+    U8 SIZE;
+    U32 SRC;
+    U32 DST;
+    U32 RESULT;
+
+} M68K_FLAGS;
+
+/* WORK OUT THE CONDITION CODES THE PENDING OPERATION WOULD HAVE SET */
+/* X IS ONLY MEANINGFUL FOR M68K_FLAGS_ADD AND M68K_FLAGS_SUB */
+
+static inline U16 M68K_FLAGS_CCR(const M68K_FLAGS* FLAGS)
+{
+    U32 MSB = M68K_FLAGS_MSB(FLAGS->SIZE);
+    U32 RESULT = FLAGS->RESULT & M68K_FLAGS_MASK(FLAGS->SIZE);
+    U32 SRC = FLAGS->SRC;
+    U32 DST = FLAGS->DST;
+    U16 CCR = 0;
+
+    if(RESULT == 0)         CCR |= M68K_CCR_Z;
+    if(RESULT & MSB)        CCR |= M68K_CCR_N;
+
+    switch (FLAGS->KIND)
+    {
+        case M68K_FLAGS_ADD:
+            if((SRC ^ RESULT) & (DST ^ RESULT) & MSB)               CCR |= M68K_CCR_V;
+            if(((SRC & DST) | (~RESULT & (SRC | DST))) & MSB)       CCR |= M68K_CCR_C | M68K_CCR_X;
+            break;
+
+        case M68K_FLAGS_SUB:
+        case M68K_FLAGS_CMP:
+            if((SRC ^ DST) & (RESULT ^ DST) & MSB)                  CCR |= M68K_CCR_V;
+            if(((SRC & ~DST) | (RESULT & ~DST) | (SRC & RESULT)) & MSB)
+                CCR |= FLAGS->KIND == M68K_FLAGS_SUB ? (M68K_CCR_C | M68K_CCR_X) : M68K_CCR_C;
+            break;
+
+        default:
+            break;
+    }
+
+    return CCR;
+}
+
+/* WRITE THE PENDING FLAGS BACK INTO THE STATUS REGISTER */
+
+static inline void M68K_FLAGS_FOLD(M68K_FLAGS* FLAGS, U16* SR)
+{
+    U16 MASK;
+
+    if(FLAGS->KIND == M68K_FLAGS_NONE)
+        return;
+
+    MASK = FLAGS->KIND >= M68K_FLAGS_ADD ? (M68K_CCR_NZVC | M68K_CCR_X) : M68K_CCR_NZVC;
+
+    *SR = (*SR & ~MASK) | M68K_FLAGS_CCR(FLAGS);
+    FLAGS->KIND = M68K_FLAGS_NONE;
+}
+
+/* RECORD A NEW FLAG SETTING OPERATION IN PLACE OF THE PENDING ONE */
+
+/* AN OPERATION WHICH LEAVES X ALONE CAN'T SIMPLY REPLACE ONE WHICH SET IT - */
+/* THAT X IS STILL LIVE, SO IT'S WRITTEN BACK BEFORE THE RECORD IS REPLACED */
+
+static inline void M68K_FLAGS_SET(M68K_FLAGS* FLAGS, U16* SR, M68K_FLAGS_KIND KIND, U32 SRC, U32 DST, U32 RESULT, unsigned SIZE)
+{
+    if(KIND < M68K_FLAGS_ADD && FLAGS->KIND >= M68K_FLAGS_ADD)
+        *SR = (*SR & ~M68K_CCR_X) | (M68K_FLAGS_CCR(FLAGS) & M68K_CCR_X);
+
+    FLAGS->KIND = KIND;
+    FLAGS->SIZE = SIZE;
+    FLAGS->SRC = SRC;
+    FLAGS->DST = DST;
+    FLAGS->RESULT = RESULT;
+}
+
+/* TEST A 68K CONDITION AGAINST THE PENDING FLAGS, OR THE STATUS REGISTER */
+/* IF NOTHING IS PENDING - EQUALITY AND SIGN ONLY EVER NEED THE RESULT */
+
+static inline bool M68K_FLAGS_CONDITION(const M68K_FLAGS* FLAGS, U16 SR, unsigned COND)
+{
+    U16 CCR;
+    bool C, V, Z, N;
+
+    if(FLAGS->KIND != M68K_FLAGS_NONE)
+    {
+        switch (COND)
+        {
+            case CONDITION_NOT_EQUAL:   return (FLAGS->RESULT & M68K_FLAGS_MASK(FLAGS->SIZE)) != 0;
+            case CONDITION_EQUAL:       return (FLAGS->RESULT & M68K_FLAGS_MASK(FLAGS->SIZE)) == 0;
+            case CONDITION_PLUS:        return (FLAGS->RESULT & M68K_FLAGS_MSB(FLAGS->SIZE)) == 0;
+            case CONDITION_MINUS:       return (FLAGS->RESULT & M68K_FLAGS_MSB(FLAGS->SIZE)) != 0;
+            default:                    break;
+        }
+
+        CCR = M68K_FLAGS_CCR(FLAGS);
+    }
+
+    else
+    {
+        CCR = SR;
+    }
+
+    C = CCR & M68K_CCR_C;
+    V = CCR & M68K_CCR_V;
+    Z = CCR & M68K_CCR_Z;
+    N = CCR & M68K_CCR_N;
+
+    switch (COND)
+    {
+        case CONDITION_TRUE:                return true;
+        case CONDITION_FALSE:               return false;
+        case CONDITION_HIGHER:              return !C && !Z;
+        case CONDITION_LOWER_OR_SAME:       return C || Z;
+        case CONDITION_CARRY_CLEAR:         return !C;
+        case CONDITION_CARRY_SET:           return C;
+        case CONDITION_NOT_EQUAL:           return !Z;
+        case CONDITION_EQUAL:               return Z;
+        case CONDITION_OVERFLOW_CLEAR:      return !V;
+        case CONDITION_OVERFLOW_SET:        return V;
+        case CONDITION_PLUS:                return !N;
+        case CONDITION_MINUS:               return N;
+        case CONDITION_GREATER_OR_EQUAL:    return N == V;
+        case CONDITION_LESS_THAN:           return N != V;
+        case CONDITION_GREATER_THAN:        return !Z && N == V;
+        default:                            return Z || N != V;
+    }
+}
+
+#endif
+#endif
@@ -0,0 +1,100 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE X86-64 DYNAMIC RECOMPILER FOR THE 68000 */
+
+/* BLOCKS WHICH THE CACHED INTERPRETER HAS ALREADY DECODED (SEE cache.h) ARE */
+/* TRANSLATED INTO NATIVE CODE ONCE THEY HAVE RUN OFTEN ENOUGH TO BE CONSIDERED HOT */
+
+/* CONDITION CODES ARE EVALUATED LAZILY - THE HOST'S OWN FLAGS CARRY THE RESULT */
+/* OF THE LAST FLAG SETTING OPERATION, AND ARE ONLY FOLDED BACK INTO THE STATUS */
+/* REGISTER WHEN SOMETHING OUTSIDE OF THE BLOCK COULD OBSERVE THEM */
+
+#ifndef M68K_JIT_H
+#define M68K_JIT_H
+
+/* NESTED INCLUDES */
+
+#include "cache.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_M68K_JIT)
+    #define USE_M68K_JIT
+#else
+    #define USE_M68K_JIT
+
+    /* THE RECOMPILER IS ONLY AVAILABLE ON X86-64 HOSTS WHICH CAN MAP */
+    /* EXECUTABLE MEMORY - EVERYWHERE ELSE IT DEFERS TO THE CACHED INTERPRETER */
+
+    #if defined(__x86_64__) && defined(__linux__)
+        #define     M68K_JIT_SUPPORTED          1
+    #else
+        #define     M68K_JIT_SUPPORTED          0
+    #endif
+
+    #define     M68K_JIT_ENTRIES            4096                /* DIRECT MAPPED, KEYED ON PC AND BANK */
+    #define     M68K_JIT_CODE_SIZE          (4 * 1024 * 1024)
+    #define     M68K_JIT_BLOCK_MAX_BYTES    (M68K_CACHE_MAX_OPS * 512)
+    #define     M68K_JIT_THRESHOLD          16                  /* EXECUTIONS BEFORE A BLOCK IS COMPILED */
+
+    /* ONLY CARTRIDGE ROM IS COMPILED, WORK RAM STAYS WITH THE CACHED INTERPRETER */
+
+    #define     M68K_JIT_ROM_END            M68K_CACHE_ROM_END
+
+    /* READS FROM CARTRIDGE ROM AT A FIXED ADDRESS ARE FOLDED INTO THE CODE */
+    /* NOTHING AT OR ABOVE HERE IS FOLDED, AS SRAM MAY BE MAPPED OVER IT */
+
+    #define     M68K_JIT_FOLD_END           0x200000
+
+/* COMPILED BLOCKS HAND BACK WHERE EXECUTION CONTINUES AND WHAT THEY COST */
+/* THE PAIR FITS WITHIN A SINGLE REGISTER UNDER THE SYSTEM V ABI */
+
+typedef struct M68K_JIT_EXIT
+{
+    U32 PC;
+    U32 CYCLES;
+
+} M68K_JIT_EXIT;
+
+typedef M68K_JIT_EXIT(*M68K_JIT_CODE)(CPU_68K* CPU);
+
+typedef struct M68K_JIT_ENTRY
+{
+    U32 START;
+    U32 BANK;
+    U16 HEAT;
+    U16 OP_COUNT;
+    M68K_JIT_CODE CODE;
+
+} M68K_JIT_ENTRY;
+
+typedef struct M68K_JIT
+{
+    M68K_JIT_ENTRY* ENTRIES;
+
+    U8* CODE_BASE;
+    UNK CODE_USED;
+
+    /* AS WITH THE CACHE, A FLUSH ASKED FOR BY A BUS WRITE WHILE COMPILED CODE */
+    /* IS RUNNING WAITS FOR THE SLICE TO END */
+
+    bool RUNNING;
+    bool FLUSH_PENDING;
+
+    U32 COMPILED;
+    U32 FLUSHES;
+
+} M68K_JIT;
+
+bool M68K_JIT_INIT(void);
+void M68K_JIT_FLUSH(void);
+void M68K_JIT_SHUTDOWN(void);
+int M68K_JIT_EXEC(int CYCLES);
+const M68K_JIT* M68K_JIT_STATE(void);
+
+#endif
+#endif
@@ -0,0 +1,87 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS HASHING THE CONSOLE'S OUTPUT FOR REGRESSION CHECKS */
+
+/* EVERY INTERVAL FRAMES, A LINE OF HASHES IS WRITTEN OUT - THE FRAMEBUFFER, THE */
+/* AUDIO PRODUCED SINCE THE LAST LINE AND, OPTIONALLY, THE VDP'S MEMORIES AND WORK */
+/* RAM - SO TWO BUILDS CAN BE COMPARED BY DIFFING A TEXT FILE, WITH THE FIRST LINE */
+/* WHICH DIFFERS NAMING THE FRAME THEY DIVERGED ON */
+
+/* THE HASH IS XXH64, WHICH KEEPS FOUR INDEPENDENT LANES IN FLIGHT AND RUNS AT */
+/* SEVERAL BYTES PER CYCLE - A WHOLE FRAME COSTS A FEW MICROSECONDS */
+
+#ifndef MD_HASH_H
+#define MD_HASH_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#if defined(USE_HASH)
+    #define USE_HASH
+#else
+    #define USE_HASH
+
+    #define     HASH_SEED                   0
+    #define     HASH_MAX_SAMPLES            512
+
+typedef enum HASH_STREAM
+{
+    HASH_FRAMEBUFFER,
+    HASH_AUDIO,
+    HASH_VRAM,
+    HASH_CRAM,
+    HASH_VSRAM,
+    HASH_WORK_RAM,
+    HASH_STREAM_COUNT,
+
+} HASH_STREAM;
+
+/* AN XXH64 IN PROGRESS - INPUT IS CONSUMED IN 32 BYTE STRIPES, WITH ANY */
+/* REMAINDER HELD BACK UNTIL THE NEXT UPDATE OR THE DIGEST */
+
+typedef struct HASH_STATE
+{
+    U64 TOTAL;
+    U64 LANE[4];
+    U8 BUFFER[32];
+    U32 SIZE;
+
+} HASH_STATE;
+
+typedef struct HASH_BASE
+{
+    FILE* FILE;
+    unsigned INTERVAL;
+    bool MEMORY;
+
+    /* THE SAMPLES OF THE FRAME BEING RUN, FOLDED INTO THE AUDIO HASH AT IT'S END */
+
+    S16 SAMPLES[HASH_MAX_SAMPLES];
+    UNK SAMPLE_COUNT;
+    HASH_STATE AUDIO;
+
+    U32 LINES;
+
+} HASH_BASE;
+
+void HASH_RESET(HASH_STATE* STATE, U64 SEED);
+void HASH_UPDATE(HASH_STATE* STATE, const void* DATA, UNK LENGTH);
+U64 HASH_DIGEST(const HASH_STATE* STATE);
+U64 HASH_XXH64(const void* DATA, UNK LENGTH, U64 SEED);
+
+int HASH_OPEN(const char* PATH, unsigned INTERVAL, bool MEMORY);
+void HASH_SAMPLE(S16 SAMPLE);
+bool HASH_DUE(void);
+void HASH_FRAME(void);
+void HASH_CLOSE(void);
+
+#endif
+#endif
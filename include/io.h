@@ -0,0 +1,152 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE FUNCTIONALITY OF THE I/O BLOCK AT $A10000 */
+/* ENCOMPASSING THE VERSION REGISTER, THE THREE CONTROL PORTS AND THE */
+/* PERIPHERALS WHICH CAN BE PLUGGED INTO THEM */
+
+/* SEE: https://plutiedev.com/io-ports */
+/* SEE: https://md.railgun.works/index.php?title=IO_Registers */
+
+#ifndef MD_IO_H
+#define MD_IO_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_IO)
+    #define USE_IO
+#else
+    #define USE_IO
+
+    #define     IO_PORT_COUNT               3
+    #define     IO_MAX_PLAYERS              8
+    #define     IO_REG_COUNT                0x10
+
+    /* VERSION REGISTER BITS ($A10001) */
+
+    #define     IO_VERSION_OVERSEAS         0x80
+    #define     IO_VERSION_PAL              0x40
+    #define     IO_VERSION_NO_EXPANSION     0x20
+    #define     IO_VERSION_HW_REVISION      0x01
+
+    /* DATA PORT LINES - TH AND TR ARE USED AS THE HANDSHAKE LINES */
+
+    #define     IO_LINE_TH                  0x40
+    #define     IO_LINE_TR                  0x20
+    #define     IO_LINE_TL                  0x10
+
+    /* BUTTON BITS AS THEY ARE STORED IN THE INPUT SNAPSHOT (ACTIVE HIGH) */
+
+    #define     IO_PAD_UP                   0x0001
+    #define     IO_PAD_DOWN                 0x0002
+    #define     IO_PAD_LEFT                 0x0004
+    #define     IO_PAD_RIGHT                0x0008
+    #define     IO_PAD_B                    0x0010
+    #define     IO_PAD_C                    0x0020
+    #define     IO_PAD_A                    0x0040
+    #define     IO_PAD_START                0x0080
+    #define     IO_PAD_Z                    0x0100
+    #define     IO_PAD_Y                    0x0200
+    #define     IO_PAD_X                    0x0400
+    #define     IO_PAD_MODE                 0x0800
+
+    /* THE SIX BUTTON PAD RESETS IT'S TH COUNTER IF TH HASN'T TOGGLED */
+    /* FOR ROUGHLY 1.5MS - EXPRESSED HERE IN SCANLINES */
+
+    #define     IO_PAD6_TIMEOUT_LINES       25
+
+typedef enum IO_DEVICE_TYPE
+{
+    IO_DEVICE_NONE,
+    IO_DEVICE_PAD3,
+    IO_DEVICE_PAD6,
+    IO_DEVICE_MULTITAP,
+    IO_DEVICE_MOUSE,
+    IO_DEVICE_COUNT,
+
+} IO_DEVICE_TYPE;
+
+/* THE HOST SIDE FILLS ONE OF THESE EVERY TIME IT POLLS INPUT */
+/* THE EMULATION THREAD LATCHES THE MOST RECENT ONE AT THE START OF EACH FRAME */
+
+typedef struct IO_INPUT_SNAPSHOT
+{
+    U16 PAD[IO_MAX_PLAYERS];
+    S16 MOUSE_X;
+    S16 MOUSE_Y;
+    U8 MOUSE_BUTTONS;
+
+} IO_INPUT_SNAPSHOT;
+
+struct IO_PORT;
+
+typedef struct IO_DEVICE
+{
+    IO_DEVICE_TYPE TYPE;
+
+    U8(*READ)(struct IO_PORT* PORT);
+    void(*WRITE)(struct IO_PORT* PORT, U8 DATA, U8 MASK);
+    void(*RESET)(struct IO_PORT* PORT);
+
+} IO_DEVICE;
+
+typedef struct IO_PORT
+{
+    const IO_DEVICE* DEVICE;
+
+    U8 DATA;
+    U8 CTRL;
+    U8 TX_DATA;
+    U8 RX_DATA;
+    U8 S_CTRL;
+
+    /* LINE STATE AS LAST DRIVEN BY THE CONSOLE */
+
+    U8 LINES;
+
+    /* HANDSHAKE COUNTERS FOR THE 6 BUTTON PAD, MULTITAP AND MOUSE */
+
+    U8 PHASE;
+    U8 TH_TIMEOUT;
+    U8 PLAYER;
+
+    S16 MOUSE_X;
+    S16 MOUSE_Y;
+
+} IO_PORT;
+
+typedef struct IO_BASE
+{
+    U8 VERSION;
+    IO_PORT PORT[IO_PORT_COUNT];
+    IO_INPUT_SNAPSHOT INPUT;
+
+} IO_BASE;
+
+void IO_INIT(void);
+void IO_RESET(void);
+IO_BASE* IO_GET_STATE(void);
+void IO_SET_VERSION(bool OVERSEAS, bool PAL);
+void IO_SET_DEVICE(unsigned PORT, IO_DEVICE_TYPE TYPE);
+void IO_SELECT_PERIPHERALS(S16 PERIPHERALS);
+
+unsigned IO_READ_BYTE(unsigned ADDRESS);
+void IO_WRITE_BYTE(unsigned ADDRESS, unsigned DATA);
+void IO_END_LINE(void);
+
+/* LOCK-FREE INPUT HAND OFF BETWEEN THE HOST AND THE EMULATION THREAD */
+
+void IO_PUBLISH_INPUT(const IO_INPUT_SNAPSHOT* INPUT);
+void IO_LATCH_INPUT(void);
+const IO_INPUT_SNAPSHOT* IO_CURRENT_INPUT(void);
+void IO_OVERRIDE_INPUT(const IO_INPUT_SNAPSHOT* INPUT);
+
+#endif
+#endif
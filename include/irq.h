@@ -0,0 +1,94 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE DELIVERY OF INTERRUPTS TO THE 68000 */
+
+/* THE VDP RAISES THE HORIZONTAL (LEVEL 4) AND VERTICAL (LEVEL 6) INTERRUPTS, */
+/* AND THE I/O BLOCK THE EXTERNAL (LEVEL 2) INTERRUPT */
+
+/* RATHER THAN THE CPU LOOKING FOR AN INTERRUPT AFTER EVERY INSTRUCTION, EACH */
+/* ONE IS SCHEDULED AT IT'S MASTER CYCLE WITHIN THE LINE - THE CPU IS HANDED THE */
+/* NEXT DEADLINE, RUNS UNINTERRUPTED UP TO IT, AND THE INTERRUPT IS PRESENTED THERE */
+
+/* SEE: https://plutiedev.com/vdp-registers */
+
+#ifndef MD_IRQ_H
+#define MD_IRQ_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_IRQ)
+    #define USE_IRQ
+#else
+    #define USE_IRQ
+
+    #define     IRQ_LEVEL_EXTERNAL          2
+    #define     IRQ_LEVEL_HINT              4
+    #define     IRQ_LEVEL_VINT              6
+
+    /* A LINE IS TAKEN TO BEGIN AS HBLANK DOES, WHICH IS WHEN THE H-INT FIRES */
+    /* THE V-INT FOLLOWS PART WAY INTO THE FIRST LINE OF VBLANK */
+
+    #define     IRQ_HINT_MCYCLE             0
+    #define     IRQ_VINT_MCYCLE_H32         788
+    #define     IRQ_VINT_MCYCLE_H40         770
+
+    #define     IRQ_NO_DEADLINE             0x7FFFFFFF
+
+    /* ENABLE BITS WITHIN THE VDP'S REGISTERS */
+
+    #define     IRQ_HINT_ENABLE             0x10        /* REGISTER 0 */
+    #define     IRQ_VINT_ENABLE             0x20        /* REGISTER 1 */
+    #define     IRQ_EXTERNAL_ENABLE         0x08        /* REGISTER 11 */
+
+    /* VDP STATUS BITS OWNED BY THE INTERRUPT LOGIC */
+
+    #define     IRQ_STATUS_VINT_PENDING     0x80
+    #define     IRQ_STATUS_VBLANK           0x08
+
+typedef struct IRQ_BASE
+{
+    /* 68K CYCLES INTO THE CURRENT LINE - A SLICE WHICH OVERSHOOTS THE END */
+    /* OF THE LINE CARRIES THE EXCESS INTO THE NEXT */
+
+    int CYCLE;
+
+    /* WHEN THIS LINE'S INTERRUPTS FALL DUE, OR IRQ_NO_DEADLINE */
+
+    int HINT_CYCLE;
+    int VINT_CYCLE;
+
+    /* RELOADED FROM REGISTER 10, COUNTED DOWN ONCE PER ACTIVE LINE */
+
+    int HINT_COUNTER;
+
+    /* SET WHEN AN INTERRUPT WAS ENABLED WHILE ALREADY PENDING - THE 68K */
+    /* GETS ONE MORE INSTRUCTION IN BEFORE IT IS TAKEN */
+
+    bool DELAYED;
+    bool EXTERNAL;
+
+    U8 LEVEL;
+    U32 DELIVERED;
+
+} IRQ_BASE;
+
+void IRQ_INIT(void);
+void IRQ_RESET(void);
+void IRQ_BEGIN_LINE(int LINE);
+int IRQ_NEXT_DEADLINE(int LIMIT);
+void IRQ_ADVANCE(int CYCLES);
+void IRQ_END_LINE(int LINE_CYCLES);
+void IRQ_EXTERNAL(bool ASSERTED);
+unsigned IRQ_VDP_LEVEL(void);
+IRQ_BASE* IRQ_GET_STATE(void);
+
+#endif
+#endif
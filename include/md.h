@@ -13,6 +13,7 @@
 #include <68K.h>
 #include "vdp.h"
 #include "common.h"
+#include "mem.h"
 
 /* SYSTEM INCLUDES */
 
@@ -30,6 +31,19 @@
 #define     ZBANK_MAX_RAM       4096
 #define     CART_MAX_SIZE       32 * 1024 * 1024
 
+/* THE 68K AND Z80 ARE BOTH CLOCKED FROM THE MASTER CLOCK THROUGH A DIVIDER */
+
+#define     MD_M68K_DIVIDER             7
+#define     MD_Z80_DIVIDER              15
+#define     MD_M68K_CYCLES_PER_LINE     (VDP_MAX_CYCLES_PER_LINE / MD_M68K_DIVIDER)
+
+/* SAVE STATES ARE A RAW SNAPSHOT OF THE RUNNING CONSOLE, TAGGED WITH */
+/* A MAGIC AND VERSION SO THAT A STALE BUFFER IS REJECTED ON LOAD - WORK */
+/* RAM AND VRAM ARE SAVED AS THEY ARE HELD, IN HOST WORD ORDER */
+
+#define     MD_STATE_MAGIC              0x4D445354      /* "MDST" */
+#define     MD_STATE_VERSION            4
+
 #define     MD_CART_BANK_DEFAULT        0
 #define     MD_CART_BANK_UNUSED         0xFF
 #define     MD_CART_BANK_RO             1
@@ -65,7 +79,7 @@ typedef struct MD_CART
 typedef struct MD
 {
     MD_CART* MD_CART;
-    U8* BOOT_ROM[0x800];
+    U8 BOOT_ROM[0x800];
     U8* BOOT_RAM[0x10000];
     U8* SYS_ROM;
     U8* SYS_RAM;
@@ -74,10 +88,11 @@ typedef struct MD
     U8 SYSTEM_BIOS;
     U32* ZBANK[ZBANK_MAX_RAM];
     U8 MEMORY_CUR_PAGE;
-    U8* TMSS[4];
+    U8 TMSS[4];
     U8* SYSTEM_TYPE;
 
     bool IS_TMSS;
+    U32 FRAME_COUNT;
 
 } MD; 
 
@@ -89,6 +104,18 @@ typedef enum MD_RESET_MODE
 
 } MD_RESET_MODE;
 
+/* WHICH CORE RUNS THE 68K - lib68k STEPPING EVERY INSTRUCTION, THE CACHED */
+/* INTERPRETER RUNNING PRE-DECODED BLOCKS (SEE cpu/cache.h), OR THE X86-64 */
+/* RECOMPILER LAYERED ON TOP OF IT (SEE cpu/jit.h) */
+
+typedef enum MD_CPU_CORE
+{
+    MD_CORE_INTERPRETER,
+    MD_CORE_CACHED,
+    MD_CORE_JIT,
+
+} MD_CPU_CORE;
+
 typedef enum MD_CART_MAP_MODE
 {
     MAPPER_NORMAL,
@@ -99,11 +126,21 @@ typedef enum MD_CART_MAP_MODE
 
 void MD_MAKE(void);
 void MD_INIT(void);
-void MD_RESET(void);
+void* MD_ALLOC(UNK SIZE);
+MD* MD_GET_CONSOLE(void);
+U8* MD_GET_WORK_RAM(void);
+void MD_SEAL(void);
+void MD_FREE(void);
+void MD_RESET(MD_RESET_MODE MODE);
+void MD_RUN_FRAME(void);
+void MD_SET_CPU_CORE(MD_CPU_CORE CORE);
+void MD_END_SLICE(void);
+UNK MD_STATE_SIZE(void);
+UNK MD_SAVE_STATE(U8* BUFFER, UNK SIZE);
+int MD_LOAD_STATE(const U8* BUFFER, UNK SIZE);
 void MD_ADDRESS_BANK_WRITE(unsigned DATA);
 void MD_ADDRESS_BANK_READ(void);
 void MD_BUS_REQ(unsigned STATE, unsigned CYCLES);
-int MD_CART_INIT(struct MD_CART* CART, unsigned char* DATA, unsigned long* SIZE);
 void MD_CART_RESET(int const RESET_TYPE);
 S32(*MD_CART_CONTEXT(U8* STATE))(void);
 U32(*MD_BANKSWITCH());
@@ -11,6 +11,15 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+#include <stddef.h>
+
 typedef struct ZBANK_MEM
 {
     unsigned(*READ)(unsigned ADDRESS);
@@ -52,4 +61,92 @@ typedef struct ZBANK_MEM
 
 extern ZBANK_MEM ZBANK_MEM_MAP[256];
 
+/*===============================================================================*/
+/*                          CONSOLE MEMORY ARENA                                 */
+/*===============================================================================*/
+
+/* EVERY PIECE OF RUNTIME STATE OWNED BY A CONSOLE IS CARVED OUT OF ONE */
+/* CONTIGUOUS BLOCK WHICH IS ALLOCATED ONCE DURING MD_INIT */
+
+/* ONCE THE ARENA HAS BEEN SEALED, NO FURTHER ALLOCATIONS ARE PERMITTED */
+/* WHICH GUARANTEES THAT THE BUS AND PER-INSTRUCTION PATHS NEVER TOUCH THE HEAP */
+
+#if defined(USE_MD_ARENA)
+    #define USE_MD_ARENA
+#else
+    #define USE_MD_ARENA
+
+    #define     MD_ARENA_ALIGN          64
+    #define     MD_ARENA_DEFAULT_SIZE   (4 * 1024 * 1024)
+
+typedef struct MD_ARENA
+{
+    U8* BASE;
+    UNK SIZE;
+    UNK OFFSET;
+    bool SEALED;
+
+} MD_ARENA;
+
+int MD_ARENA_INIT(MD_ARENA* ARENA, UNK SIZE);
+void* MD_ARENA_ALLOC(MD_ARENA* ARENA, UNK SIZE);
+void MD_ARENA_SEAL(MD_ARENA* ARENA);
+void MD_ARENA_FREE(MD_ARENA* ARENA);
+
+/* DEBUG BUILDS (make HEAP_GUARD=1) LINK WITH --wrap=malloc SUCH THAT */
+/* ANY HEAP ALLOCATION MADE BY THE EMULATOR AFTER THE ARENA IS SEALED ABORTS */
+
+void MD_HEAP_GUARD_ARM(bool ARMED);
+
+#endif
+
+/*===============================================================================*/
+/*                          HOST WORD ORDER                                      */
+/*===============================================================================*/
+
+/* ROM, WORK RAM AND VRAM ARE ALL HELD AS 16 BIT WORDS IN THE HOST'S OWN BYTE */
+/* ORDER - THEY ARE SWAPPED ONCE AS THEY'RE LOADED, AND FROM THEN ON A WORD IS */
+/* A SINGLE LOAD AND A LONG IS A SINGLE LOAD AND A ROTATE */
+
+/* A BYTE ACCESS FLIPS THE BOTTOM BIT OF IT'S ADDRESS ON LITTLE ENDIAN HOSTS, */
+/* WHICH IS WHERE THE 68K'S EVEN (HIGH) BYTE OF EACH WORD ENDS UP */
+
+#if defined(USE_MD_WORD_ORDER)
+    #define USE_MD_WORD_ORDER
+#else
+    #define USE_MD_WORD_ORDER
+
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        #define     MD_BYTE_XOR             0
+    #else
+        #define     MD_BYTE_XOR             1
+    #endif
+
+    /* THE WORD SWAP KERNEL USES SSE2 WHERE THE HOST HAS IT, PLAIN C ELSEWHERE */
+
+    #if defined(__SSE2__)
+        #define     MD_SWAP_SIMD            1
+    #else
+        #define     MD_SWAP_SIMD            0
+    #endif
+
+    #define     MD_READ_BYTE(BASE, ADDR)            (((U8*)(BASE))[(ADDR) ^ MD_BYTE_XOR])
+    #define     MD_READ_WORD(BASE, ADDR)            (*(U16*)((U8*)(BASE) + (ADDR)))
+    #define     MD_WRITE_BYTE(BASE, ADDR, DATA)     (((U8*)(BASE))[(ADDR) ^ MD_BYTE_XOR] = (U8)(DATA))
+    #define     MD_WRITE_WORD(BASE, ADDR, DATA)     (*(U16*)((U8*)(BASE) + (ADDR)) = (U16)(DATA))
+
+    #if MD_BYTE_XOR
+        #define     MD_READ_LONG(BASE, ADDR)        MD_ROTATE_LONG(*(U32*)((U8*)(BASE) + (ADDR)))
+        #define     MD_WRITE_LONG(BASE, ADDR, DATA) (*(U32*)((U8*)(BASE) + (ADDR)) = MD_ROTATE_LONG((U32)(DATA)))
+    #else
+        #define     MD_READ_LONG(BASE, ADDR)        (*(U32*)((U8*)(BASE) + (ADDR)))
+        #define     MD_WRITE_LONG(BASE, ADDR, DATA) (*(U32*)((U8*)(BASE) + (ADDR)) = (U32)(DATA))
+    #endif
+
+    #define     MD_ROTATE_LONG(VALUE)               (((VALUE) << 16) | ((VALUE) >> 16))
+
+void MD_SWAP_WORDS(void* DATA, UNK SIZE);
+
+#endif
+
 #endif
@@ -0,0 +1,87 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE FUNCTIONALITY OF INPUT MOVIES */
+/* A MOVIE RECORDS THE CONTROLLER STATE OF EVERY FRAME ALONGSIDE ANY RESET */
+/* EVENTS, SUCH THAT A RUN CAN BE REPLAYED DETERMINISTICALLY FROM POWER ON */
+
+#ifndef MD_MOVIE_H
+#define MD_MOVIE_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "io.h"
+#include "md.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#if defined(USE_MOVIE)
+    #define USE_MOVIE
+#else
+    #define USE_MOVIE
+
+    #define     MOVIE_MAGIC             "MDMV"
+    #define     MOVIE_VERSION           1
+    #define     MOVIE_MAX_RUN           0xFFFF
+
+    /* EVENT BITS STORED ALONGSIDE EACH RUN */
+
+    #define     MOVIE_EVENT_SOFT_RESET  0x01
+    #define     MOVIE_EVENT_HARD_RESET  0x02
+
+/* THE FILE IS A HEADER FOLLOWED BY A SEQUENCE OF RUNS */
+/* EACH RUN IS A FRAME COUNT, AN EVENT BYTE AND THE INPUT SNAPSHOT WHICH */
+/* WAS HELD FOR THAT MANY FRAMES - ALL VALUES ARE STORED LITTLE ENDIAN */
+
+/* A NEW RUN IS ONLY STARTED WHEN THE INPUT CHANGES OR AN EVENT OCCURS */
+/* SO IDLE STRETCHES OF GAMEPLAY COST A HANDFUL OF BYTES */
+
+typedef enum MOVIE_MODE
+{
+    MOVIE_OFF,
+    MOVIE_RECORD,
+    MOVIE_PLAYBACK,
+
+} MOVIE_MODE;
+
+typedef struct MOVIE_RUN
+{
+    U16 COUNT;
+    U8 EVENT;
+    IO_INPUT_SNAPSHOT INPUT;
+
+} MOVIE_RUN;
+
+typedef struct MOVIE
+{
+    MOVIE_MODE MODE;
+    FILE* FILE;
+
+    U16 CART_CHECKSUM;
+    U32 FRAME;
+    U32 FRAME_COUNT;
+
+    /* RECORDING: THE RUN CURRENTLY BEING EXTENDED */
+    /* PLAYBACK: THE DECODED RUNS AND THE POSITION WITHIN THEM */
+
+    MOVIE_RUN CURRENT;
+    MOVIE_RUN* RUNS;
+    U32 RUN_COUNT;
+    U32 RUN_INDEX;
+    U32 RUN_FRAME;
+
+} MOVIE;
+
+int MOVIE_RECORD_OPEN(const char* PATH, U16 CART_CHECKSUM);
+int MOVIE_PLAY_OPEN(const char* PATH, U16 CART_CHECKSUM);
+MD_RESET_MODE MOVIE_UPDATE(MD_RESET_MODE REQUEST);
+bool MOVIE_FINISHED(void);
+void MOVIE_CLOSE(void);
+
+#endif
+#endif
@@ -0,0 +1,103 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE BUILT-IN PERFORMANCE COUNTERS */
+/* EVERY FRAME COLLECTS EVENT COUNTS (INSTRUCTIONS, VDP WRITES, DMA BYTES...) */
+/* AND THE TIME SPENT WITHIN EACH SUBSYSTEM, MEASURED WITH THE TIMESTAMP COUNTER */
+
+/* THE INSTRUMENTATION MACROS COMPILE TO NOTHING UNLESS THE BUILD */
+/* DEFINES MD_PROFILE (make PROFILE=1) */
+
+#ifndef MD_PROFILE_H
+#define MD_PROFILE_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_PROFILE)
+    #define USE_PROFILE
+#else
+    #define USE_PROFILE
+
+typedef enum PROFILE_COUNTER
+{
+    PROFILE_M68K_INSTRUCTIONS,
+    PROFILE_M68K_CYCLES,
+    PROFILE_VDP_WRITES,
+    PROFILE_DMA_BYTES,
+    PROFILE_AUDIO_SAMPLES,
+    PROFILE_VDP_LINES_DRAWN,
+    PROFILE_COUNTER_COUNT,
+
+} PROFILE_COUNTER;
+
+typedef enum PROFILE_SECTION
+{
+    PROFILE_CPU,
+    PROFILE_VDP,
+    PROFILE_AUDIO,
+    PROFILE_PRESENT,
+    PROFILE_CAPTURE,
+    PROFILE_SECTION_COUNT,
+
+} PROFILE_SECTION;
+
+typedef struct PROFILE_FRAME
+{
+    U32 FRAME;
+    U64 COUNTER[PROFILE_COUNTER_COUNT];
+    U64 TICKS[PROFILE_SECTION_COUNT];
+    U64 FRAME_TICKS;
+
+} PROFILE_FRAME;
+
+/* READ THE TIMESTAMP COUNTER - RDTSC ON X86, A MONOTONIC CLOCK ELSEWHERE */
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define     PROFILE_TICKS()         ((U64)__rdtsc())
+#else
+    #define     PROFILE_TICKS()         PROFILE_CLOCK_NS()
+#endif
+
+#if defined(MD_PROFILE)
+
+    extern PROFILE_FRAME PROFILE_CURRENT;
+
+    #define     PROFILE_COUNT(INDEX, VALUE)     (PROFILE_CURRENT.COUNTER[(INDEX)] += (U64)(VALUE))
+    #define     PROFILE_BEGIN(SECTION)          U64 PROFILE_START_##SECTION = PROFILE_TICKS()
+    #define     PROFILE_END(SECTION)            (PROFILE_CURRENT.TICKS[(SECTION)] += PROFILE_TICKS() - PROFILE_START_##SECTION)
+    #define     PROFILE_FRAME_BEGIN()           PROFILE_FRAME_START()
+    #define     PROFILE_FRAME_END()             PROFILE_FRAME_FINISH()
+
+#else
+
+    #define     PROFILE_COUNT(INDEX, VALUE)     ((void)(VALUE))
+    #define     PROFILE_BEGIN(SECTION)          ((void)0)
+    #define     PROFILE_END(SECTION)            ((void)0)
+    #define     PROFILE_FRAME_BEGIN()           ((void)0)
+    #define     PROFILE_FRAME_END()             ((void)0)
+
+#endif
+
+bool PROFILE_ENABLED(void);
+void PROFILE_INIT(void);
+U64 PROFILE_CLOCK_NS(void);
+F64 PROFILE_TICKS_TO_MS(U64 TICKS);
+
+void PROFILE_FRAME_START(void);
+void PROFILE_FRAME_FINISH(void);
+const PROFILE_FRAME* PROFILE_LAST_FRAME(void);
+
+void PROFILE_SET_REPORT_INTERVAL(unsigned FRAMES);
+int PROFILE_OPEN_DUMP(const char* PATH);
+void PROFILE_CLOSE(void);
+
+#endif
+#endif
@@ -0,0 +1,134 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS READING ROM IMAGES OFF OF THE DISK */
+
+/* A ROM MAY BE A PLAIN IMAGE, GZIP COMPRESSED, THE FIRST FILE OF A ZIP */
+/* ARCHIVE, OR AN SMD DUMP (A 512 BYTE HEADER FOLLOWED BY 16KB BLOCKS, EACH */
+/* HOLDING IT'S ODD BYTES AHEAD OF IT'S EVEN ONES) - OR ANY MIX OF THE THREE */
+
+/* WHATEVER THE FORMAT, THE IMAGE IS WRITTEN ONCE, STRAIGHT INTO THE BUFFER */
+/* THE CARTRIDGE KEEPS. COMPRESSED INPUT IS INFLATED INTO IT A CHUNK AT A */
+/* TIME, AND SMD BLOCKS ARE INFLATED INTO ONE SMALL BLOCK WHICH STAYS IN */
+/* CACHE WHILE IT'S DE-INTERLEAVED - THE ARCHIVE AND THE RAW IMAGE ARE NEVER */
+/* STAGED IN FULL */
+
+/* AN UNPACKED IMAGE CAN ALSO BE KEPT IN A CACHE DIRECTORY ON SHARED MEMORY, */
+/* NAMED BY THE XXH64 OF THE FILE IT CAME FROM AND STORED, ALREADY IN HOST */
+/* WORD ORDER, ALONGSIDE IT'S CHECKSUM AND PARSED HEADER. ANY LATER INSTANCE */
+/* LOADING THE SAME FILE MAPS THE ENTRY READ ONLY - NO UNPACKING, SWAPPING, */
+/* CHECKSUMMING OR PARSING, AND EVERY INSTANCE SHARES THE SAME PHYSICAL PAGES */
+
+/* NOTHING IS EVER EVICTED - THE DIRECTORY GROWS BY ONE UNPACKED IMAGE (UP TO */
+/* ROM_MAX_SIZE) PER DISTINCT ROM FILE LOADED, AND ON /dev/shm THAT IS MEMORY */
+/* UNTIL THE ENTRIES ARE DELETED OR THE MACHINE RESTARTS. IT IS ONLY USED WHEN */
+/* ASKED FOR (--rom-cache), AND ANY ENTRY MAY BE REMOVED AT ANY TIME */
+
+#ifndef MD_ROM_H
+#define MD_ROM_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "cartridge.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <zlib.h>
+
+#if defined(USE_ROM_INPUT)
+    #define USE_ROM_INPUT
+#else
+    #define USE_ROM_INPUT
+
+    /* THE SMD BLOCK KERNEL USES SSE2 WHERE THE HOST HAS IT, PLAIN C ELSEWHERE */
+
+    #if defined(__SSE2__)
+        #define     ROM_SIMD                    1
+    #else
+        #define     ROM_SIMD                    0
+    #endif
+
+    #define     ROM_MAX_SIZE                0x1000000
+    #define     ROM_CHUNK_SIZE              0x10000
+
+    #define     ROM_SMD_HEADER              0x200
+    #define     ROM_SMD_BLOCK               0x4000
+    #define     ROM_SMD_HALF                0x2000
+
+    /* THE VERSION MUST BE BUMPED WHENEVER ROM_INFO OR THE UNPACKING CHANGES, */
+    /* SO STALE ENTRIES ARE NEVER PICKED UP */
+
+    #define     ROM_CACHE_DEFAULT_DIR       "/dev/shm/mdemu-rom"
+    #define     ROM_CACHE_MAGIC             "MDRC"
+    #define     ROM_CACHE_VERSION           3
+    #define     ROM_CACHE_DATA_OFFSET       0x1000
+
+typedef enum ROM_FORMAT
+{
+    ROM_FORMAT_RAW,
+    ROM_FORMAT_GZIP,
+    ROM_FORMAT_ZIP_STORED,
+    ROM_FORMAT_ZIP_DEFLATE,
+
+} ROM_FORMAT;
+
+typedef struct ROM_STREAM
+{
+    FILE* FILE;
+    ROM_FORMAT FORMAT;
+
+    /* HOW LARGE THE IMAGE IS ONCE DECOMPRESSED, AND HOW MUCH OF THE FILE */
+    /* IS LEFT TO BE READ FOR IT */
+
+    UNK SIZE;
+    UNK REMAINING;
+
+    z_stream ZLIB;
+    bool INFLATING;
+    U8 INPUT[ROM_CHUNK_SIZE];
+
+} ROM_STREAM;
+
+/* THE FIRST PAGE OF A CACHE ENTRY - THE IMAGE FOLLOWS, PAGE ALIGNED */
+
+typedef struct ROM_CACHE_HEADER
+{
+    char MAGIC[4];
+    U32 VERSION;
+    U64 KEY;
+    U32 SIZE;
+    U16 CHECKSUM;
+    ROM_INFO INFO;
+
+} ROM_CACHE_HEADER;
+
+typedef struct ROM_CACHE_BASE
+{
+    const char* DIR;
+
+    /* THE KEY OF THE FILE BEING LOADED, FOR STORING IT ON A MISS */
+
+    U64 KEY;
+    bool KEYED;
+
+    /* THE ENTRY CURRENTLY MAPPED, IF THE CARTRIDGE CAME FROM THE CACHE */
+
+    U8* MAPPING;
+    UNK MAPPING_SIZE;
+
+} ROM_CACHE_BASE;
+
+int ROM_LOAD(const char* PATH, U8** DATA, UNK* SIZE);
+void ROM_SMD_DEINTERLEAVE(U8* DST, const U8* SRC);
+void ROM_RELEASE(U8* DATA);
+
+void ROM_CACHE_SET_DIR(const char* DIR);
+int ROM_CACHE_ATTACH(const char* PATH, U8** DATA, UNK* SIZE, U16* CHECKSUM, ROM_INFO* INFO);
+void ROM_CACHE_STORE(const U8* DATA, UNK SIZE, U16 CHECKSUM, const ROM_INFO* INFO);
+
+#endif
+#endif
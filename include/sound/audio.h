@@ -0,0 +1,73 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE HAND OFF OF SAMPLES FROM THE SOUND CHIPS TO THE HOST */
+
+/* THE EMULATION LOOP PUSHES ONE SAMPLE PER SCANLINE INTO A FIXED SIZE RING, AND THE */
+/* HOST'S AUDIO CALLBACK PULLS THEM BACK OUT ON IT'S OWN THREAD - THERE IS ONLY EVER */
+/* ONE PRODUCER AND ONE CONSUMER, SO NEITHER SIDE TAKES A LOCK */
+
+/* WHEN FAST FORWARDING, THE LOOP PRODUCES SAMPLES SEVERAL TIMES FASTER THAN THE HOST */
+/* PLAYS THEM - THESE ARE DECIMATED BY THE SAME FACTOR BEFORE REACHING THE RING, AND */
+/* ANYTHING WHICH STILL DOESN'T FIT IS DROPPED RATHER THAN OVERWRITING UNPLAYED AUDIO */
+
+#ifndef MD_AUDIO_H
+#define MD_AUDIO_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_AUDIO)
+    #define USE_AUDIO
+#else
+    #define USE_AUDIO
+
+    /* MUST BE A POWER OF TWO - A LITTLE OVER A QUARTER OF A SECOND AT THE LINE RATE */
+
+    #define     AUDIO_RING_SIZE             4096
+    #define     AUDIO_RING_MASK             (AUDIO_RING_SIZE - 1)
+
+    #define     AUDIO_MAX_DECIMATION        16
+
+typedef struct AUDIO_BASE
+{
+    S16* RING;
+
+    /* HEAD IS ONLY EVER WRITTEN BY THE PRODUCER, TAIL BY THE CONSUMER */
+
+    U32 HEAD;
+    U32 TAIL;
+
+    /* SAMPLES ARE AVERAGED IN GROUPS OF DECIMATION, WHICH DOUBLES AS A */
+    /* CRUDE LOW PASS SO THE SPED UP AUDIO DOESN'T ALIAS */
+
+    unsigned DECIMATION;
+    unsigned PENDING;
+    S32 ACCUMULATOR;
+
+    /* THE LAST SAMPLE HANDED TO THE HOST - HELD ON AN UNDERRUN IN PLACE OF SILENCE */
+
+    S16 LAST;
+
+    U32 DROPPED;
+    U32 UNDERRUNS;
+
+} AUDIO_BASE;
+
+void AUDIO_INIT(void);
+void AUDIO_RESET(void);
+void AUDIO_SET_DECIMATION(unsigned FACTOR);
+void AUDIO_PUSH(S16 SAMPLE);
+UNK AUDIO_PULL(S16* BUFFER, UNK COUNT);
+UNK AUDIO_AVAILABLE(void);
+unsigned AUDIO_SAMPLE_RATE(void);
+AUDIO_BASE* AUDIO_GET_STATE(void);
+
+#endif
+#endif
@@ -33,14 +33,29 @@
 #define     PSG_CLOCKS              240       
 #define     PSG_STATE_COUNT(VALUE)      (sizeof(VALUE) / sizeof(VALUE)[0])  
 
+#define     PSG_TONE_COUNT          4
+
+/* THE PER-CHANNEL STATE OF EACH TONE GENERATOR (3 SQUARE + 1 NOISE) */
+/* THESE LIVE INLINE WITHIN THE PSG SUCH THAT UPDATING THEM NEVER TOUCHES THE HEAP */
+
+typedef struct PSG_TONE
+{
+    U16 COUNTDOWN;
+    U16 COUNTDOWN_MASTER_CONTROL;
+    U8 ATTENUATION;
+    U8 OUTPUT;
+
+} PSG_TONE;
+
 typedef struct PSG_BASE
 {
-    bool TONE_DISABLED[3];
+    bool TONE_DISABLED[PSG_TONE_COUNT];
     bool NOISE_DISABLED;
     bool VOLUME_CONTROL;
     S16 VOLUME[PSG_VOLUME][2];
     S16 SAMPLE_BUFFER;
     UNK TOTAL_SAMPLES;
+    PSG_TONE TONES[PSG_TONE_COUNT];
 
     union PSG_STATE
     {
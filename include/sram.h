@@ -0,0 +1,132 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS BATTERY BACKED CARTRIDGE SAVES */
+
+/* A CARTRIDGE DECLARES IT'S SAVE MEMORY IN THE HEADER AT $1B0 - EITHER */
+/* PARALLEL SRAM SITTING ON THE BUS (USUALLY AT $200000, ON ODD OR EVEN BYTES) */
+/* OR A SERIAL I2C EEPROM WHICH IS BIT BANGED THROUGH A SINGLE ADDRESS */
+
+/* THE SAVE FILE IS MAPPED STRAIGHT INTO MEMORY, AND THE CARTRIDGE WINDOW'S */
+/* PAGES ROUTE EVERY ACCESS THROUGH THE MAPPER. THE FILE IS THEREFORE KEPT */
+/* AS THE BUS SEES IT, BIG ENDIAN, AS OTHER EMULATORS EXPECT - NOT IN THE */
+/* HOST WORD ORDER OF THE ROM (SEE mem.h) */
+
+/* A WRITE MARKS THE SAVE DIRTY - ONCE THE WRITES HAVE GONE QUIET, THE PAGES */
+/* ARE HANDED TO THE KERNEL TO WRITE BACK IN IT'S OWN TIME, SO THE EMULATION */
+/* LOOP NEVER WAITS ON THE DISK */
+
+/* SEE: https://plutiedev.com/saving-sram */
+
+#ifndef MD_SRAM_H
+#define MD_SRAM_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_SRAM)
+    #define USE_SRAM
+#else
+    #define USE_SRAM
+
+    #define     SRAM_HEADER                 0x1B0
+    #define     SRAM_HEADER_SIZE            12
+    #define     SRAM_KIND_SRAM              0x20
+    #define     SRAM_KIND_EEPROM            0x40
+
+    #define     SRAM_PAGE_SIZE              0x10000
+    #define     SRAM_MAX_SIZE               0x200000
+
+    /* $A130F1 - BIT 0 SWAPS THE SRAM IN OVER THE ROM, BIT 1 WRITE PROTECTS IT */
+
+    #define     SRAM_CONTROL_ENABLE         0x01
+    #define     SRAM_CONTROL_PROTECT        0x02
+
+    /* HOW MANY FRAMES WITHOUT A WRITE BEFORE THE SAVE IS HANDED OFF */
+
+    #define     SRAM_QUIET_FRAMES           30
+
+    /* SEGA'S OWN EEPROM WIRING - SDA IN AND OUT ON BIT 0 AND SCL ON BIT 1 */
+    /* OF $200001, DRIVING AN X24C01 (128 BYTES, 7 BIT ADDRESSES) */
+
+    #define     SRAM_EEPROM_SDA_BIT         0
+    #define     SRAM_EEPROM_SCL_BIT         1
+    #define     SRAM_EEPROM_SIZE            0x80
+    #define     SRAM_EEPROM_PAGE_MASK       0x03
+
+typedef enum SRAM_TYPE
+{
+    SRAM_NONE,
+    SRAM_PARALLEL,
+    SRAM_EEPROM,
+
+} SRAM_TYPE;
+
+typedef enum SRAM_I2C_STATE
+{
+    SRAM_I2C_STANDBY,
+    SRAM_I2C_ADDRESS,
+    SRAM_I2C_WRITE,
+    SRAM_I2C_READ,
+    SRAM_I2C_WAIT_STOP,
+
+} SRAM_I2C_STATE;
+
+typedef struct SRAM_I2C
+{
+    SRAM_I2C_STATE STATE;
+    U8 SCL;
+    U8 SDA;
+    U8 SDA_OUT;
+    int CYCLE;
+    bool ACK;
+    U8 BUFFER;
+    U32 ADDRESS;
+
+} SRAM_I2C;
+
+typedef struct SRAM_BASE
+{
+    SRAM_TYPE TYPE;
+    U32 START;
+    U32 END;
+
+    /* THE SAVE, AS AN IMAGE OF THE WHOLE PAGES IT SPANS ON THE BUS */
+
+    U8* DATA;
+    UNK SIZE;
+    U32 BASE;
+    int FILE;
+
+    /* WHAT THE EEPROM'S PAGE READS BACK AS - ONLY SDA EVER CHANGES */
+
+    U8* LATCH;
+    SRAM_I2C EEPROM;
+
+    bool ENABLED;
+    bool PROTECTED;
+
+    bool DIRTY;
+    U32 LAST_WRITE;
+
+} SRAM_BASE;
+
+void SRAM_INIT(void);
+int SRAM_OPEN(const char* ROM_PATH);
+void SRAM_MAP(void);
+void SRAM_RESET(void);
+void SRAM_CONTROL(unsigned DATA);
+unsigned SRAM_READ_BYTE(unsigned ADDRESS);
+void SRAM_WRITE_BYTE(unsigned ADDRESS, unsigned DATA);
+void SRAM_FRAME(U32 FRAME);
+void SRAM_CLOSE(void);
+SRAM_BASE* SRAM_GET_STATE(void);
+
+#endif
+#endif
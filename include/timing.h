@@ -0,0 +1,119 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE REGION OF THE CONSOLE AND IT'S VIDEO TIMING */
+
+/* AN NTSC CONSOLE (JAPAN OR THE AMERICAS) RUNS 262 LINES A FRAME OFF A */
+/* 53.69MHZ MASTER CLOCK, A PAL ONE (EUROPE) 313 LINES OFF 53.20MHZ - EVERY */
+/* LINE IS 3420 MASTER CYCLES EITHER WAY. THE CARTRIDGE HEADER LISTS THE */
+/* REGIONS A GAME WILL RUN IN AT $1F0, WHICH PICKS THE CONSOLE IT'S RUN ON */
+/* UNLESS ONE IS ASKED FOR OUTRIGHT */
+
+/* EVERYTHING WHICH DIFFERS BETWEEN THE TWO STANDARDS IS GATHERED INTO ONE */
+/* PROFILE, WORKED OUT AT COMPILE TIME (OR ONCE AT START UP FOR THE V COUNTER */
+/* TABLES) - THE REST OF THE CONSOLE ONLY EVER READS IT'S FIELDS, NOTHING IS */
+/* DERIVED FROM THE CLOCKS AS THE LINES GO BY */
+
+/* SEE: https://plutiedev.com/rom-header#region */
+
+#ifndef MD_TIMING_H
+#define MD_TIMING_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "cartridge.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_TIMING)
+    #define USE_TIMING
+#else
+    #define USE_TIMING
+
+    /* THE CLOCKS AND LINE COUNTS THEMSELVES LIVE WITH THE VDP (SEE vdp.h) */
+
+    #define     TIMING_MAX_LINES            313
+
+    /* THE V COUNTER IS ONLY 9 BITS WIDE, SO PART WAY THROUGH THE BLANKING */
+    /* IT JUMPS BACK SUCH THAT IT ENDS THE FRAME ON $1FF - THESE ARE THE LAST */
+    /* LINES BEFORE THE JUMP, FOR 28 AND 30 CELL TALL DISPLAYS */
+
+    #define     TIMING_V_JUMP_NTSC_V28      0xEA
+    #define     TIMING_V_JUMP_NTSC_V30      0x1FF
+    #define     TIMING_V_JUMP_PAL_V28       0x102
+    #define     TIMING_V_JUMP_PAL_V30       0x10A
+
+    /* THE NEW STYLE REGION CODE IS A SINGLE HEX DIGIT, ONE BIT PER MARKET */
+
+    #define     TIMING_CODE_JP              0x01
+    #define     TIMING_CODE_ASIA_PAL        0x02
+    #define     TIMING_CODE_US              0x04
+    #define     TIMING_CODE_EU              0x08
+
+    #define     TIMING_REGION_LEN           3
+
+typedef enum TIMING_REGION
+{
+    TIMING_REGION_AUTO,
+    TIMING_REGION_JP,
+    TIMING_REGION_US,
+    TIMING_REGION_EU,
+
+} TIMING_REGION;
+
+typedef enum TIMING_STANDARD
+{
+    TIMING_NTSC,
+    TIMING_PAL,
+    TIMING_STANDARD_COUNT,
+
+} TIMING_STANDARD;
+
+typedef struct TIMING_PROFILE
+{
+    const char* NAME;
+    bool PAL;
+
+    U32 MASTER_CLOCK;
+    U16 LINES_PER_FRAME;
+
+    /* THE NOMINAL RATE (50 OR 60), AND THE REAL ONE AS THE LENGTH OF A */
+    /* FRAME IN MASTER CYCLES - THE HOST PACES ITSELF OFF THE LATTER */
+
+    U16 FRAME_RATE;
+    U32 FRAME_MCYCLES;
+
+    /* ONE AUDIO SAMPLE IS PRODUCED PER LINE, SO THE LINE RATE IS THE SAMPLE RATE */
+
+    U32 SAMPLE_RATE;
+
+    /* WHAT THE V COUNTER READS ON EACH LINE, INDEXED BY WHETHER THE */
+    /* DISPLAY IS 30 CELLS TALL */
+
+    U16 V_JUMP[2];
+    U16 V_COUNTER[2][TIMING_MAX_LINES];
+
+} TIMING_PROFILE;
+
+typedef struct TIMING_BASE
+{
+    TIMING_REGION OVERRIDE;
+    TIMING_REGION REGION;
+    const TIMING_PROFILE* PROFILE;
+
+} TIMING_BASE;
+
+void TIMING_INIT(void);
+void TIMING_SET_REGION(TIMING_REGION REGION);
+TIMING_REGION TIMING_DETECT_REGION(const ROM_INFO* INFO);
+void TIMING_APPLY(void);
+const TIMING_PROFILE* TIMING_GET_PROFILE(void);
+TIMING_REGION TIMING_GET_REGION(void);
+const char* TIMING_REGION_NAME(TIMING_REGION REGION);
+
+#endif
+#endif
@@ -0,0 +1,73 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE TRADEMARK SECURITY SYSTEM (TMSS) */
+
+/* ON LATER CONSOLES, A 2KB BOOT ROM SITS OVER THE CARTRIDGE AT POWER ON - IT */
+/* SHOWS THE LICENSING SCREEN, THEN HANDS OVER BY WRITING 1 TO $A14101. THE */
+/* CARTRIDGE IN TURN MUST WRITE "SEGA" TO $A14000 BEFORE TOUCHING THE VDP */
+
+/* THE OVERLAY IS DONE ENTIRELY THROUGH THE 68K'S PAGE TABLE - THE CARTRIDGE */
+/* WINDOW'S PAGES POINT AT THE BOOT ROM UNTIL THE HANDOVER, WHICH PATCHES THEM */
+/* BACK ONCE. NOTHING ON THE READ PATH EVER ASKS WHICH OF THE TWO IS MAPPED */
+
+/* SEE: https://plutiedev.com/tmss */
+
+#ifndef MD_TMSS_H
+#define MD_TMSS_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_TMSS)
+    #define USE_TMSS
+#else
+    #define USE_TMSS
+
+    #define     TMSS_BOOT_ROM_SIZE          0x800
+    #define     TMSS_SIGNATURE              "SEGA"
+
+    /* THE BOOT ROM IS MIRRORED ACROSS THE WHOLE $000000 - $3FFFFF WINDOW */
+
+    #define     TMSS_PAGE_SIZE              0x10000
+    #define     TMSS_PAGES                  0x40
+
+    #define     TMSS_CART_ENABLE            0x01
+
+typedef struct TMSS_BASE
+{
+    /* THE BOOT ROM REPEATED OUT TO A WHOLE PAGE, AND WHERE EACH PAGE */
+    /* OF THE CARTRIDGE LIVES - THE TWO SETS OF PAGES THE WINDOW SWAPS BETWEEN */
+
+    U8* MIRROR;
+    U8* CART[TMSS_PAGES];
+
+    /* AN IMAGE WHICH DOESN'T FILL IT'S LAST PAGE HAS THAT PAGE COPIED IN */
+    /* HERE, THE REST OF IT READING BACK AS AN EMPTY BUS ($FF) */
+
+    U8* TAIL;
+
+    bool SKIP;
+    bool BOOT_MAPPED;
+    bool UNLOCKED;
+
+} TMSS_BASE;
+
+void TMSS_INIT(void);
+int TMSS_LOAD_BOOT_ROM(const char* PATH);
+void TMSS_SET_SKIP(bool SKIP);
+void TMSS_RESET(bool HARD);
+void TMSS_RESTORE(bool BOOT_MAPPED);
+void TMSS_WRITE_BYTE(unsigned ADDRESS, unsigned DATA);
+void TMSS_WRITE_WORD(unsigned ADDRESS, unsigned DATA);
+void TMSS_ROM_WRITE(unsigned ADDRESS, unsigned DATA);
+TMSS_BASE* TMSS_GET_STATE(void);
+
+#endif
+#endif
@@ -0,0 +1,67 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS HANDING FINISHED FRAMES FROM THE EMULATION THREAD */
+/* TO THE HOST'S PRESENTER */
+
+/* EACH LINE THE VDP DRAWS IS SCALED (SEE scale.h) INTO ONE OF THREE FRAMEBUFFERS - */
+/* THE EMULATION THREAD OWNS THE BACK SLOT, THE PRESENTER OWNS THE FRONT SLOT, AND THE */
+/* MIDDLE SLOT IS HANDED BETWEEN THEM BY AN ATOMIC EXCHANGE (THE SAME SCHEME AS */
+/* THE INPUT SNAPSHOTS) */
+
+/* NEITHER SIDE EVER WAITS ON THE OTHER - THE EMULATOR NEVER BLOCKS ON VSYNC, */
+/* AND THE PRESENTER ONLY EVER SEES A FRAME ONCE IT HAS BEEN FINISHED */
+
+#ifndef MD_PRESENT_H
+#define MD_PRESENT_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "vdp.h"
+#include "scale.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_PRESENT)
+    #define USE_PRESENT
+#else
+    #define USE_PRESENT
+
+    #define     PRESENT_SLOTS               3
+    #define     PRESENT_FRESH               0x04
+    #define     PRESENT_INDEX               0x03
+
+/* EVERY VDP ROW REMEMBERS THE FRAME IT LAST CHANGED ON - THE PRESENTER ONLY */
+/* UPLOADS ROWS NEWER THAN WHAT IT'S TEXTURE ALREADY HOLDS, HOWEVER MANY */
+/* FRAMES IT MISSED IN BETWEEN */
+
+typedef struct PRESENT_SLOT
+{
+    U8* DATA;
+    U32 FRAME;
+    U32 ROW_FRAME[VDP_SCREEN_HEIGHT];
+
+} PRESENT_SLOT;
+
+typedef struct PRESENT_BASE
+{
+    PRESENT_SLOT SLOT[PRESENT_SLOTS];
+
+    U32 READY;
+    U32 BACK;
+    U32 FRONT;
+    U32 FRAME;
+
+} PRESENT_BASE;
+
+UNK PRESENT_ARENA_SIZE(void);
+void PRESENT_INIT(void);
+void PRESENT_PUBLISH(void);
+const PRESENT_SLOT* PRESENT_ACQUIRE(void);
+
+#endif
+#endif
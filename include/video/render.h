@@ -0,0 +1,102 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS DRAWING THE VDP'S DISPLAY A LINE AT A TIME */
+
+/* EACH LINE IS BUILT IN LINE BUFFERS OF ONE BYTE PER PIXEL - PLANE B, THEN */
+/* PLANE A (OR THE WINDOW) MERGED OVER IT, THEN THE SPRITES MERGED OVER BOTH - */
+/* AND ONLY THEN REMAPPED THROUGH THE PALETTE INTO THE FRAMEBUFFER */
+
+/* THE BACKGROUND AND SPRITE PASSES EACH HAVE ONE VARIANT PER COMBINATION OF */
+/* THE DISPLAY MODES THEY DEPEND ON (H32 OR H40, THE WINDOW, INTERLACE MODE 2 */
+/* AND SHADOW/HIGHLIGHT), WITH THE MODE FOLDED IN AS A CONSTANT. RENDER_BG AND */
+/* RENDER_OBJ ARE ONLY RE-POINTED WHEN A MODE REGISTER IS WRITTEN, SO A LINE */
+/* NEVER TESTS FOR A FEATURE WHICH ISN'T SWITCHED ON */
+
+#ifndef MD_RENDER_H
+#define MD_RENDER_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_RENDER)
+    #define USE_RENDER
+#else
+    #define USE_RENDER
+
+    /* EACH LINE BUFFER HAS A BORDER EITHER SIDE, WIDE ENOUGH FOR THE PART OF */
+    /* A SCROLLED TILE OR A SPRITE WHICH HANGS OFF THE EDGE OF THE DISPLAY */
+
+    #define     RENDER_LINE_SIZE            0x200
+    #define     RENDER_BORDER               0x20
+
+    #define     RENDER_BUFFER_OUT           0       /* PLANE B, THEN THE FINISHED LINE */
+    #define     RENDER_BUFFER_OBJ           1
+    #define     RENDER_BUFFER_A             2
+    #define     RENDER_BUFFERS              3
+
+    /* A LAYER'S PIXEL - THE PRIORITY BIT AND PALETTE OF IT'S ENTRY ALONGSIDE */
+    /* IT'S COLOUR, WHICH IS TRANSPARENT WHEN ZERO */
+
+    #define     RENDER_PRIORITY             0x40
+    #define     RENDER_INDEX                0x3F
+    #define     RENDER_OPAQUE               0x0F
+
+    /* ONCE THE PLANES ARE MERGED, BIT 7 HOLDS WHETHER EITHER OF THEM HAD IT'S */
+    /* PRIORITY BIT SET, WHICH DECIDES SHADOWING */
+
+    #define     RENDER_EITHER_HIGH          0x80
+
+    /* A FINISHED PIXEL - IT'S INTENSITY IN THE TOP TWO BITS, OVER A CRAM */
+    /* INDEX. INDEX 0 IS NEVER DRAWN AS ITSELF, SO IT STANDS FOR THE BACKDROP */
+
+    #define     RENDER_SHADOW               0x00
+    #define     RENDER_NORMAL               0x40
+    #define     RENDER_HIGHLIGHT            0x80
+    #define     RENDER_BACKDROP             0x00
+
+    /* THE MERGE TABLES - EACH IS INDEXED BY THE PIXEL BENEATH (8 BITS) AND */
+    /* THE LAYER PIXEL ABOVE IT (7 BITS), AND HOLDS THE PIXEL WHICH RESULTS */
+
+    #define     RENDER_LUT_BG               0       /* PLANE A OVER PLANE B */
+    #define     RENDER_LUT_OBJ              1       /* SPRITES OVER THE PLANES */
+    #define     RENDER_LUT_SH               2       /* THE SAME, UNDER SHADOW/HIGHLIGHT */
+    #define     RENDER_LUT_COUNT            3
+    #define     RENDER_LUT_SIZE             0x8000
+
+    #define     RENDER_LUT_INDEX(BELOW, ABOVE)      (((BELOW) << 7) | (ABOVE))
+
+    /* THE MODES A VARIANT IS SPECIALISED FOR */
+
+    #define     RENDER_MODE_H40             0x01
+    #define     RENDER_MODE_WINDOW          0x02
+    #define     RENDER_MODE_IM2             0x04
+    #define     RENDER_MODE_SH              0x08
+    #define     RENDER_MODE_BLANK           0x10
+
+    /* THE ODD FIELD FLAG OF THE STATUS REGISTER, FOR INTERLACED DISPLAYS */
+
+    #define     RENDER_STATUS_ODD           0x10
+
+void RENDER_INIT(void);
+void RENDER_RESET(void);
+void PALETTE_INIT(void);
+void RENDER_PALETTE_WRITE(unsigned INDEX);
+void RENDER_BACKDROP_WRITE(void);
+void RENDER_SELECT(void);
+void RENDER_SYNC(void);
+unsigned RENDER_GET_MODE(void);
+U32 RENDER_LINE(int LINE);
+void REMAP_LINE(int LINE);
+
+extern void(*RENDER_BG)(int LINE);
+extern U32(*RENDER_OBJ)(int LINE);
+
+#endif
+#endif
@@ -0,0 +1,66 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS UPSCALING THE VDP'S OUTPUT FOR THE HOST */
+
+/* EACH LINE IS SCALED THE MOMENT IT HAS BEEN REMAPPED, WHILE IT IS STILL IN */
+/* CACHE - SO AN ENLARGED FRAME NEVER NEEDS A SEPARATE PASS OVER THE WHOLE THING */
+
+/* THE SCALE IS ALWAYS A WHOLE NUMBER, WITH AN OPTIONAL FILTER LAID OVER THE */
+/* NEAREST NEIGHBOUR RESULT */
+
+#ifndef MD_SCALE_H
+#define MD_SCALE_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_SCALE)
+    #define USE_SCALE
+#else
+    #define USE_SCALE
+
+    /* THE ROW KERNELS USE SSE2 WHERE THE HOST HAS IT, PLAIN C ELSEWHERE */
+
+    #if defined(__SSE2__)
+        #define     SCALE_SIMD                  1
+    #else
+        #define     SCALE_SIMD                  0
+    #endif
+
+    #define     SCALE_MAX_FACTOR            4
+
+typedef enum SCALE_FILTER
+{
+    SCALE_FILTER_NONE,              /* NEAREST NEIGHBOUR */
+    SCALE_FILTER_SCANLINE,          /* THE LAST ROW OF EACH LINE DIMMED TO THREE QUARTERS */
+    SCALE_FILTER_SMOOTH,            /* THE LAST COPY OF EACH PIXEL BLENDED WITH IT'S RIGHT HAND NEIGHBOUR */
+
+} SCALE_FILTER;
+
+/* THE TARGET IS WHICHEVER FRAMEBUFFER THE PRESENTER HAS HANDED BACK (SEE present.h) */
+
+typedef struct SCALE_BASE
+{
+    unsigned FACTOR;
+    SCALE_FILTER FILTER;
+
+    U8* DATA;
+    int WIDTH;
+    int HEIGHT;
+    int PITCH;
+
+} SCALE_BASE;
+
+void SCALE_INIT(unsigned FACTOR, SCALE_FILTER FILTER);
+void SCALE_LINE(const U32* SOURCE, int WIDTH, int ROW);
+SCALE_BASE* SCALE_GET_STATE(void);
+
+#endif
+#endif
@@ -0,0 +1,81 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS SCROLLING THE VDP'S BACKGROUND PLANES */
+
+/* EACH PLANE IS SCROLLED HORIZONTALLY BY A WORD OF VRAM - ONE FOR THE WHOLE */
+/* SCREEN, ONE PER 8 LINES OR ONE PER LINE, AS REGISTER $0B PICKS - AND */
+/* VERTICALLY BY A WORD OF VSRAM, EITHER ONE FOR THE WHOLE SCREEN OR ONE PER */
+/* 2 CELL COLUMN */
+
+/* AT THE START OF EACH LINE, THOSE ARE RESOLVED ONCE INTO A FETCH PLAN PER */
+/* PLANE - THE NAME TABLE ENTRY AND PATTERN ROW OF EVERY TILE THE LINE CROSSES, */
+/* LEFT TO RIGHT - SO THE RENDERER ONLY EVER WALKS THE PLAN, AND NO SCROLL */
+/* MATHS IS DONE PER TILE */
+
+/* SEE: https://plutiedev.com/scrolling */
+
+#ifndef MD_SCROLL_H
+#define MD_SCROLL_H
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdbool.h>
+
+#if defined(USE_SCROLL)
+    #define USE_SCROLL
+#else
+    #define USE_SCROLL
+
+    #define     SCROLL_PLANE_A              0
+    #define     SCROLL_PLANE_B              1
+    #define     SCROLL_PLANES               2
+
+    /* A FINE SCROLL LEAVES ONE TILE PART WAY OFF EACH EDGE, SO A LINE CROSSES */
+    /* ONE MORE TILE THAN THE DISPLAY IS CELLS WIDE */
+
+    #define     SCROLL_MAX_FETCH            41
+
+    /* THE 2 CELL COLUMNS ACROSS AN H40 DISPLAY - VSRAM HOLDS ONE ENTRY FOR */
+    /* EACH, WITH PLANE A AND B'S INTERLEAVED */
+
+    #define     SCROLL_COLUMNS              20
+
+typedef struct SCROLL_FETCH
+{
+    U16 ADDRESS;            /* THE NAME TABLE ENTRY IN VRAM */
+    U8 ROW;                 /* THE ROW OF IT'S PATTERN, BEFORE ANY FLIP */
+
+} SCROLL_FETCH;
+
+typedef struct SCROLL_PLAN
+{
+    int X;                  /* WHERE THE FIRST TILE STARTS - 0 TO -7 */
+    unsigned COUNT;
+    SCROLL_FETCH FETCH[SCROLL_MAX_FETCH];
+
+} SCROLL_PLAN;
+
+typedef struct SCROLL_BASE
+{
+    /* WHAT THE LINE WAS RESOLVED FROM */
+
+    U16 HSCROLL[SCROLL_PLANES];
+    U16 VSCROLL[SCROLL_PLANES][SCROLL_COLUMNS];
+    bool COLUMN;
+
+    SCROLL_PLAN PLAN[SCROLL_PLANES];
+
+} SCROLL_BASE;
+
+unsigned SCROLL_HSCROLL_ADDRESS(int LINE);
+void SCROLL_LINE(int LINE, int ROW, bool H40, bool IM2);
+const SCROLL_PLAN* SCROLL_GET_PLAN(unsigned PLANE);
+
+#endif
+#endif
@@ -20,6 +20,7 @@
 /* SYSTEM INCLUDES */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -35,17 +36,50 @@
 		#define USE_VDP_UTIL
 
 		#define		VDP_MAX_SPRITE_LINE		20
+		#define		VDP_MAX_SPRITE_LINE_H32	16
+		#define		VDP_MAX_SPRITES			80
+		#define		VDP_MAX_SPRITES_H32		64
+		#define		VDP_SPRITE_SIGNATURE	0x811C9DC5		// FNV-1A OFFSET BASIS - A LINE WITH NO SPRITES
 		#define		VDP_TMSS_MAX_LINE		4
 
 		#define		VDP_LINE_BUFFER			0x200 * 2
 
-		#define		VDP_NTSC_TIMING			313
-		#define 	VDP_PAL_TIMING			252
+		#define		VDP_NTSC_TIMING			262
+		#define 	VDP_PAL_TIMING			313
 
 		#define		VDP_MAX_CYCLES_PER_LINE			3420
+
+		#define		VDP_SCREEN_WIDTH		320
+		#define		VDP_SCREEN_HEIGHT		240
+		#define		VDP_ACTIVE_HEIGHT		224
 		#define		VDP_CLOCK_NTSC					53693175
 		#define		VDP_CLOCK_PAL					53203424
 
+		// ACCESS CODES LATCHED FROM THE SECOND CONTROL PORT WORD
+
+		#define		VDP_CODE_VRAM_WRITE		0x01
+		#define		VDP_CODE_CRAM_WRITE		0x03
+		#define		VDP_CODE_VSRAM_WRITE	0x05
+		#define		VDP_CODE_DMA			0x20
+
+		#define		VDP_DMA_ENABLED			0x10
+
+		// STATUS BITS RAISED BY THE SPRITE LOGIC, CLEARED ON A STATUS READ
+		// (SEE VDP_CTRL_READ)
+
+		#define		VDP_STATUS_SPRITE_OVERFLOW		0x40
+		#define		VDP_STATUS_SPRITE_COLLISION		0x20
+
+		// DIRTY TRACKING GRANULARITY - ONE BLOCK PER 32 BYTE PATTERN
+
+		#define		VDP_DIRTY_BLOCK_SHIFT	5
+		#define		VDP_DIRTY_BLOCKS		(0x10000 >> VDP_DIRTY_BLOCK_SHIFT)
+
+		// REGISTERS WHOSE VALUE CHANGES WHAT A LINE LOOKS LIKE - THE HINT
+		// COUNTER, AUTO-INCREMENT AND DMA REGISTERS DON'T
+
+		#define		VDP_DIRTY_REG_MASK		0x00077BFF
+
 		// DEFINE AN ENDIANESS PARSER FOR READING 
 		// AND WRITING CONTENTS TO THE VDP
 
@@ -149,6 +183,12 @@
 			U32 FIFO_CYCLES[4];
 			U32 VDP_CYCLES;
 
+			U16 ADDRESS;
+			U8 CODE;
+			U8 PENDING;
+			U8 DMA_FILL;
+			U16 FILL_DATA;
+
 			U8* H_COUNTER_TABLE; 
 			
 			void(*SET_IRQ)(unsigned LEVEL);
@@ -171,8 +211,31 @@
 			int PREV_H;
 			int CHANGED;
 
+			// ROWS REDRAWN SINCE THE HOST LAST UPLOADED THEM
+
+			U8 DIRTY[VDP_SCREEN_HEIGHT];
+
 		} VDP_BITMAP;
 
+		// EACH LINE REMEMBERS WHEN IT WAS LAST DRAWN, AND EACH INPUT WHEN IT WAS
+		// LAST WRITTEN - A LINE WHOSE INPUTS ARE ALL OLDER THAN IT IS CLEAN
+
+		// STAMPS ADVANCE AS LINES ARE DRAWN, SO A WRITE LANDING AFTER A LINE WAS
+		// DRAWN (EVEN WITHIN THE SAME FRAME) IS ALWAYS SEEN BY THE NEXT ONE
+
+		// SPRITES MOVE TOO OFTEN FOR STAMPS ON THE ATTRIBUTE TABLE TO HELP, SO
+		// EACH LINE INSTEAD KEEPS A SIGNATURE OF THE ENTRIES WHICH LANDED ON IT
+
+		typedef struct VDP_DIRTY
+		{
+			U32 STAMP;
+			U32 GLOBAL;
+			U32 BLOCK[VDP_DIRTY_BLOCKS];
+			U32 LINE[VDP_SCREEN_HEIGHT];
+			U32 SPRITES[VDP_SCREEN_HEIGHT];
+
+		} VDP_DIRTY;
+
 		typedef struct VDP_PLANE
 		{
 			U8 LEFT;
@@ -185,12 +248,16 @@
 		//						GLOBAL DEFINITIONS
 		//===============================================================
 
-		void RENDER_INIT(void);
-		void RENDER_RESET(void);
-		void PALETTE_INIT(void);
 		void VDP_INIT(void);
 		void VDP_RESET(void);
-		void REMAP_LINE(int LINE);
+		void VDP_LINE(int LINE);
+		void VDP_SET_RENDER(bool ENABLED);
+		U32 VDP_SPRITE_STATUS(int LINE, U32* SIGNATURE);
+		void VDP_INVALIDATE(void);
+		VDP_BITMAP* VDP_GET_BITMAP(void);
+
+		extern VDP_BASE* VDP;
+		extern const U8 VDP_PLANE_CELLS[4];
 
 		// ASSUME THAT THESE READ FUNCTIONS WILL BE MODE 5 BY DEFAULT
 
@@ -208,7 +275,9 @@
 		int VDP_HV_READ(unsigned CYCLES);
 
 		void VDP_BUS_WRITE(unsigned DATA);
-		void VDP_REG_WRITE(unsigned REG, unsigned DEST, unsigned CYCLES);
+		unsigned VDP_CTRL_READ(unsigned CYCLES);
+		void VDP_CTRL_WRITE(unsigned DATA);
+		void VDP_REG_WRITE(unsigned REG, unsigned DATA, unsigned CYCLES);
 
 		void VDP_DMA_68K_EXT(unsigned LEN);
 		void VDP_DMA_68K_RAM(unsigned LEN);
@@ -0,0 +1,400 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE LOSSLESS CAPTURE OF GAMEPLAY */
+/* SEE capture.h FOR AN OVERVIEW */
+
+#define _POSIX_C_SOURCE 200112L
+
+/* NESTED INCLUDES */
+
+#include "capture.h"
+#include "audio.h"
+#include "vdp.h"
+#include "timing.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_CAPTURE
+
+#define     CAPTURE_HEADER_SIZE         16
+#define     CAPTURE_FRAME_HEADER_SIZE   12
+#define     CAPTURE_WAV_HEADER_SIZE     44
+
+#define     CAPTURE_MAX_PIXELS          (VDP_SCREEN_WIDTH * VDP_SCREEN_HEIGHT)
+
+/* EVERY RUN PAIR COVERS AT LEAST ONE PIXEL, SO THE WORST CASE IS A PAIR PER PIXEL */
+
+#define     CAPTURE_MAX_CODE            (CAPTURE_FRAME_HEADER_SIZE + CAPTURE_MAX_PIXELS * 8 + 4)
+
+static CAPTURE_BASE MD_CAPTURE;
+
+/*===============================================================================*/
+/*                          SERIALISATION                                        */
+/*===============================================================================*/
+
+static void CAPTURE_PUT_16(U8* DEST, U16 VALUE)
+{
+    DEST[0] = VALUE & 0xFF;
+    DEST[1] = VALUE >> 8;
+}
+
+static void CAPTURE_PUT_32(U8* DEST, U32 VALUE)
+{
+    CAPTURE_PUT_16(DEST, VALUE & 0xFFFF);
+    CAPTURE_PUT_16(DEST + 2, VALUE >> 16);
+}
+
+static void CAPTURE_WRITE_HEADER(CAPTURE_BASE* CAPTURE)
+{
+    U8 HEADER[CAPTURE_HEADER_SIZE];
+
+    memcpy(HEADER, CAPTURE_MAGIC, 4);
+    CAPTURE_PUT_16(HEADER + 4, CAPTURE_VERSION);
+    CAPTURE_PUT_16(HEADER + 6, TIMING_GET_PROFILE()->FRAME_RATE);
+    CAPTURE_PUT_32(HEADER + 8, CAPTURE->FRAMES);
+    CAPTURE_PUT_32(HEADER + 12, 0);
+
+    fwrite(HEADER, 1, sizeof(HEADER), CAPTURE->VIDEO);
+}
+
+static void CAPTURE_WRITE_WAV_HEADER(CAPTURE_BASE* CAPTURE)
+{
+    U8 HEADER[CAPTURE_WAV_HEADER_SIZE];
+    U32 RATE = AUDIO_SAMPLE_RATE();
+    U32 DATA_SIZE = CAPTURE->SAMPLES * 2;
+
+    memcpy(HEADER, "RIFF", 4);
+    CAPTURE_PUT_32(HEADER + 4, 36 + DATA_SIZE);
+    memcpy(HEADER + 8, "WAVEfmt ", 8);
+    CAPTURE_PUT_32(HEADER + 16, 16);
+    CAPTURE_PUT_16(HEADER + 20, 1);
+    CAPTURE_PUT_16(HEADER + 22, 1);
+    CAPTURE_PUT_32(HEADER + 24, RATE);
+    CAPTURE_PUT_32(HEADER + 28, RATE * 2);
+    CAPTURE_PUT_16(HEADER + 32, 2);
+    CAPTURE_PUT_16(HEADER + 34, 16);
+    memcpy(HEADER + 36, "data", 4);
+    CAPTURE_PUT_32(HEADER + 40, DATA_SIZE);
+
+    fwrite(HEADER, 1, sizeof(HEADER), CAPTURE->AUDIO);
+}
+
+/*===============================================================================*/
+/*                          WRITER THREAD                                        */
+/*===============================================================================*/
+
+/* XOR EACH PIXEL WITH THE PREVIOUS FRAME AND STORE THE RESULT AS SKIP AND */
+/* COPY RUNS - A LONE UNCHANGED PIXEL IS CHEAPER TO COPY THAN TO END A RUN ON */
+
+static UNK CAPTURE_ENCODE(U8* DEST, const U32* PIXELS, const U32* PREVIOUS, UNK COUNT)
+{
+    U8* PTR = DEST;
+    UNK INDEX = 0;
+    UNK START;
+    UNK SKIP;
+
+    while (INDEX < COUNT)
+    {
+        for (SKIP = 0; INDEX < COUNT && SKIP < CAPTURE_MAX_RUN && PIXELS[INDEX] == PREVIOUS[INDEX]; SKIP++)
+        {
+            INDEX++;
+        }
+
+        for (START = INDEX; INDEX < COUNT && INDEX - START < CAPTURE_MAX_RUN; INDEX++)
+        {
+            if(PIXELS[INDEX] == PREVIOUS[INDEX] && (INDEX + 1 >= COUNT || PIXELS[INDEX + 1] == PREVIOUS[INDEX + 1]))
+                break;
+        }
+
+        CAPTURE_PUT_16(PTR, (U16)SKIP); PTR += 2;
+        CAPTURE_PUT_16(PTR, (U16)(INDEX - START)); PTR += 2;
+
+        for (; START < INDEX; START++, PTR += 4)
+        {
+            CAPTURE_PUT_32(PTR, PIXELS[START] ^ PREVIOUS[START]);
+        }
+    }
+
+    return (UNK)(PTR - DEST);
+}
+
+static void CAPTURE_WRITE_ENTRY(CAPTURE_BASE* CAPTURE, const CAPTURE_ENTRY* ENTRY)
+{
+    U8 AUDIO[CAPTURE_MAX_SAMPLES * 2];
+    UNK COUNT = (UNK)ENTRY->WIDTH * ENTRY->HEIGHT;
+    UNK LENGTH;
+    UNK INDEX;
+    U8 FLAGS = 0;
+
+    if(CAPTURE->FAILED)
+        return;
+
+    /* A CHANGE OF RESOLUTION LEAVES NOTHING TO TAKE THE DIFFERENCE FROM */
+
+    if(CAPTURE->FRAMES % CAPTURE_KEY_INTERVAL == 0 ||
+       ENTRY->WIDTH != CAPTURE->PREVIOUS_WIDTH || ENTRY->HEIGHT != CAPTURE->PREVIOUS_HEIGHT)
+    {
+        FLAGS |= CAPTURE_FRAME_KEY;
+        memset(CAPTURE->PREVIOUS, 0, COUNT * sizeof(U32));
+    }
+
+    LENGTH = CAPTURE_ENCODE(CAPTURE->CODE + CAPTURE_FRAME_HEADER_SIZE, ENTRY->PIXELS, CAPTURE->PREVIOUS, COUNT);
+
+    CAPTURE->CODE[0] = FLAGS;
+    CAPTURE->CODE[1] = 0;
+    CAPTURE_PUT_16(CAPTURE->CODE + 2, (U16)ENTRY->WIDTH);
+    CAPTURE_PUT_16(CAPTURE->CODE + 4, (U16)ENTRY->HEIGHT);
+    CAPTURE_PUT_16(CAPTURE->CODE + 6, 0);
+    CAPTURE_PUT_32(CAPTURE->CODE + 8, (U32)LENGTH);
+
+    LENGTH += CAPTURE_FRAME_HEADER_SIZE;
+
+    for (INDEX = 0; INDEX < ENTRY->SAMPLE_COUNT; INDEX++)
+    {
+        CAPTURE_PUT_16(AUDIO + INDEX * 2, (U16)ENTRY->SAMPLES[INDEX]);
+    }
+
+    if(fwrite(CAPTURE->CODE, 1, LENGTH, CAPTURE->VIDEO) != LENGTH ||
+       fwrite(AUDIO, 2, ENTRY->SAMPLE_COUNT, CAPTURE->AUDIO) != ENTRY->SAMPLE_COUNT)
+    {
+        fprintf(stderr, "Capture write failed after %u frames, the rest will be discarded\n", CAPTURE->FRAMES);
+        CAPTURE->FAILED = true;
+        return;
+    }
+
+    memcpy(CAPTURE->PREVIOUS, ENTRY->PIXELS, COUNT * sizeof(U32));
+    CAPTURE->PREVIOUS_WIDTH = ENTRY->WIDTH;
+    CAPTURE->PREVIOUS_HEIGHT = ENTRY->HEIGHT;
+
+    CAPTURE->FRAMES++;
+    CAPTURE->SAMPLES += (U32)ENTRY->SAMPLE_COUNT;
+    CAPTURE->BYTES += LENGTH + ENTRY->SAMPLE_COUNT * 2;
+}
+
+/* THE ENTRY BEING WRITTEN STAYS IN THE QUEUE UNTIL IT'S DONE WITH, SO THE */
+/* EMULATION THREAD CAN'T REUSE IT PART WAY THROUGH */
+
+static void* CAPTURE_WRITER(void* DATA)
+{
+    CAPTURE_BASE* CAPTURE = DATA;
+    CAPTURE_ENTRY* ENTRY;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&CAPTURE->LOCK);
+
+        while (CAPTURE->TAIL == CAPTURE->HEAD && !CAPTURE->STOP)
+        {
+            pthread_cond_wait(&CAPTURE->READY, &CAPTURE->LOCK);
+        }
+
+        if(CAPTURE->TAIL == CAPTURE->HEAD)
+        {
+            pthread_mutex_unlock(&CAPTURE->LOCK);
+            break;
+        }
+
+        ENTRY = &CAPTURE->QUEUE[CAPTURE->TAIL % CAPTURE_QUEUE_SIZE];
+        pthread_mutex_unlock(&CAPTURE->LOCK);
+
+        CAPTURE_WRITE_ENTRY(CAPTURE, ENTRY);
+
+        pthread_mutex_lock(&CAPTURE->LOCK);
+        CAPTURE->TAIL++;
+        pthread_cond_signal(&CAPTURE->SPACE);
+        pthread_mutex_unlock(&CAPTURE->LOCK);
+    }
+
+    return NULL;
+}
+
+/*===============================================================================*/
+/*                          EMULATION THREAD                                     */
+/*===============================================================================*/
+
+/* EVERYTHING THE CAPTURE NEEDS IS ALLOCATED HERE, SO THIS MUST BE CALLED */
+/* BEFORE THE CONSOLE ARENA IS SEALED - PATH IS THE NAME SHARED BY BOTH FILES */
+
+int CAPTURE_OPEN(const char* PATH)
+{
+    CAPTURE_BASE* CAPTURE = &MD_CAPTURE;
+    UNK LENGTH = strlen(PATH) + 6;
+    char* NAME = malloc(LENGTH);
+    int INDEX;
+
+    memset(CAPTURE, 0, sizeof(*CAPTURE));
+
+    if(NAME == NULL)
+        return -1;
+
+    snprintf(NAME, LENGTH, "%s.mdcv", PATH);
+    CAPTURE->VIDEO = fopen(NAME, "wb");
+
+    snprintf(NAME, LENGTH, "%s.wav", PATH);
+    CAPTURE->AUDIO = fopen(NAME, "wb");
+
+    free(NAME);
+
+    if(CAPTURE->VIDEO == NULL || CAPTURE->AUDIO == NULL)
+    {
+        fprintf(stderr, "Failed to open capture: %s\n", PATH);
+        CAPTURE_CLOSE();
+        return -1;
+    }
+
+    CAPTURE->PREVIOUS = malloc(CAPTURE_MAX_PIXELS * sizeof(U32));
+    CAPTURE->CODE = malloc(CAPTURE_MAX_CODE);
+
+    for (INDEX = 0; INDEX < CAPTURE_QUEUE_SIZE; INDEX++)
+    {
+        CAPTURE->QUEUE[INDEX].PIXELS = malloc(CAPTURE_MAX_PIXELS * sizeof(U32));
+
+        if(CAPTURE->QUEUE[INDEX].PIXELS == NULL)
+            break;
+    }
+
+    if(CAPTURE->PREVIOUS == NULL || CAPTURE->CODE == NULL || INDEX < CAPTURE_QUEUE_SIZE)
+    {
+        fprintf(stderr, "Memory Allocation failed for capture\n");
+        CAPTURE_CLOSE();
+        return -1;
+    }
+
+    CAPTURE_WRITE_HEADER(CAPTURE);
+    CAPTURE_WRITE_WAV_HEADER(CAPTURE);
+
+    pthread_mutex_init(&CAPTURE->LOCK, NULL);
+    pthread_cond_init(&CAPTURE->READY, NULL);
+    pthread_cond_init(&CAPTURE->SPACE, NULL);
+
+    if(pthread_create(&CAPTURE->THREAD, NULL, CAPTURE_WRITER, CAPTURE) != 0)
+    {
+        fprintf(stderr, "Failed to start the capture writer\n");
+        pthread_mutex_destroy(&CAPTURE->LOCK);
+        pthread_cond_destroy(&CAPTURE->READY);
+        pthread_cond_destroy(&CAPTURE->SPACE);
+        CAPTURE_CLOSE();
+        return -1;
+    }
+
+    CAPTURE->ACTIVE = true;
+
+    printf("Capturing to: %s.mdcv, %s.wav\n", PATH, PATH);
+    return 0;
+}
+
+/* CALLED FOR EVERY SAMPLE, AHEAD OF ANY FAST FORWARD DECIMATION */
+
+void CAPTURE_AUDIO(S16 SAMPLE)
+{
+    CAPTURE_BASE* CAPTURE = &MD_CAPTURE;
+
+    if(!CAPTURE->ACTIVE || CAPTURE->PENDING_COUNT >= CAPTURE_MAX_SAMPLES)
+        return;
+
+    CAPTURE->PENDING[CAPTURE->PENDING_COUNT++] = SAMPLE;
+}
+
+/* CALLED ONCE EVERY FRAME HAS BEEN RUN - THE FRAME MUST HAVE BEEN DRAWN */
+/* (SEE VDP_SET_RENDER), OTHERWISE THE LAST ONE WHICH WAS IS CAPTURED AGAIN */
+
+void CAPTURE_FRAME(void)
+{
+    CAPTURE_BASE* CAPTURE = &MD_CAPTURE;
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    CAPTURE_ENTRY* ENTRY;
+    int ROW;
+
+    if(!CAPTURE->ACTIVE)
+        return;
+
+    pthread_mutex_lock(&CAPTURE->LOCK);
+
+    if(CAPTURE->HEAD - CAPTURE->TAIL >= CAPTURE_QUEUE_SIZE)
+    {
+        CAPTURE->STALLS++;
+
+        while (CAPTURE->HEAD - CAPTURE->TAIL >= CAPTURE_QUEUE_SIZE)
+        {
+            pthread_cond_wait(&CAPTURE->SPACE, &CAPTURE->LOCK);
+        }
+    }
+
+    ENTRY = &CAPTURE->QUEUE[CAPTURE->HEAD % CAPTURE_QUEUE_SIZE];
+    pthread_mutex_unlock(&CAPTURE->LOCK);
+
+    ENTRY->WIDTH = BMP->WIDTH;
+    ENTRY->HEIGHT = BMP->HEIGHT;
+
+    for (ROW = 0; ROW < BMP->HEIGHT; ROW++)
+    {
+        memcpy(ENTRY->PIXELS + ROW * BMP->WIDTH, BMP->DATA + ROW * BMP->PITCH, (UNK)BMP->WIDTH * sizeof(U32));
+    }
+
+    memcpy(ENTRY->SAMPLES, CAPTURE->PENDING, CAPTURE->PENDING_COUNT * sizeof(S16));
+    ENTRY->SAMPLE_COUNT = CAPTURE->PENDING_COUNT;
+    CAPTURE->PENDING_COUNT = 0;
+
+    pthread_mutex_lock(&CAPTURE->LOCK);
+    CAPTURE->HEAD++;
+    pthread_cond_signal(&CAPTURE->READY);
+    pthread_mutex_unlock(&CAPTURE->LOCK);
+}
+
+bool CAPTURE_ACTIVE(void)
+{
+    return MD_CAPTURE.ACTIVE;
+}
+
+/* DRAIN WHAT'S LEFT IN THE QUEUE, THEN PATCH BOTH HEADERS WITH THE TOTALS */
+
+void CAPTURE_CLOSE(void)
+{
+    CAPTURE_BASE* CAPTURE = &MD_CAPTURE;
+    int INDEX;
+
+    if(CAPTURE->ACTIVE)
+    {
+        pthread_mutex_lock(&CAPTURE->LOCK);
+        CAPTURE->STOP = true;
+        pthread_cond_signal(&CAPTURE->READY);
+        pthread_mutex_unlock(&CAPTURE->LOCK);
+
+        pthread_join(CAPTURE->THREAD, NULL);
+
+        pthread_mutex_destroy(&CAPTURE->LOCK);
+        pthread_cond_destroy(&CAPTURE->READY);
+        pthread_cond_destroy(&CAPTURE->SPACE);
+
+        rewind(CAPTURE->VIDEO);
+        CAPTURE_WRITE_HEADER(CAPTURE);
+
+        rewind(CAPTURE->AUDIO);
+        CAPTURE_WRITE_WAV_HEADER(CAPTURE);
+
+        printf("Capture finished: %u frames, %u samples, %llu bytes, %u stalls\n",
+               CAPTURE->FRAMES, CAPTURE->SAMPLES, (unsigned long long)CAPTURE->BYTES, CAPTURE->STALLS);
+    }
+
+    if(CAPTURE->VIDEO != NULL)
+        fclose(CAPTURE->VIDEO);
+
+    if(CAPTURE->AUDIO != NULL)
+        fclose(CAPTURE->AUDIO);
+
+    for (INDEX = 0; INDEX < CAPTURE_QUEUE_SIZE; INDEX++)
+    {
+        free(CAPTURE->QUEUE[INDEX].PIXELS);
+    }
+
+    free(CAPTURE->PREVIOUS);
+    free(CAPTURE->CODE);
+    memset(CAPTURE, 0, sizeof(*CAPTURE));
+}
+
+#endif
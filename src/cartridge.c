@@ -7,9 +7,17 @@
 /* NESTED INCLUDES */
 
 #include "cartridge.h"
+#include "io.h"
+#include "mem.h"
+#include "rom.h"
 
 #ifdef LOAD_MD_ROM
 
+/* THE MOST RECENTLY PARSED HEADER, KEPT AROUND FOR THE SUBSYSTEMS */
+/* WHICH CONFIGURE THEMSELVES FROM IT (I/O PORTS, REGION, SAVE MEMORY) */
+
+static ROM_INFO MD_ROM_INFO;
+
 /* RETURN THE VALUE OF THE DESIGNATED CHECKSUM FROM THE PROVIDED ROM FILE */
 /* A PRINT UTILITY WILL BE PROVIDED TO DEBUG THIS UTILIY */
 
@@ -23,7 +31,11 @@ U16 GET_CHECKSUM(U8* ROM, unsigned LENGTH, char* FILENAME)
         CHECKSUM += ((ROM[INDEX] << 8) + ROM[INDEX + 1]); 
     }
 
-    printf("Checksum for ROM: %s, 0x%x\n", FILENAME, CHECKSUM);
+    /* CALLERS WHICH ONLY WANT THE VALUE (SUCH AS THE BENCHMARKS) PASS NO NAME */
+
+    if(FILENAME != NULL)
+        printf("Checksum for ROM: %s, 0x%x\n", FILENAME, CHECKSUM);
+
     return CHECKSUM;
 }
 
@@ -33,7 +45,7 @@ U16 GET_CHECKSUM(U8* ROM, unsigned LENGTH, char* FILENAME)
 
 void MD_GET_ROM_INFO(char* HEADER)
 {
-    struct ROM_INFO* ROM = malloc(sizeof(struct ROM_INFO));
+    struct ROM_INFO* ROM = &MD_ROM_INFO;
 
     int INDEX = 0;
     int ITERATOR = 0;
@@ -46,12 +58,6 @@ void MD_GET_ROM_INFO(char* HEADER)
 
     memset(ROM, 0, sizeof(struct ROM_INFO));
 
-    if(ROM == NULL)
-    {
-        fprintf(stderr, "Could not evaluate space for the ROM Header");
-        exit(1);
-    }
-
     if(SYSTEM_TYPE == SYSTEM_MD)
     {
         /* EVALUATE THE PRE-REQUISITES FROM THE ENTRY POINT */
@@ -73,49 +79,77 @@ void MD_GET_ROM_INFO(char* HEADER)
 
     memcpy(ROM->TYPE, HEADER + ROM_TYPE, 2);
     memcpy(ROM->SERIAL, HEADER + ROM_SERIAL, 12);
-    memcpy(ROM->CHECKSUM, HEADER + ROM_CHECKSUM, 2);
-    memcpy(ROM->START, HEADER + ROM_START, 4);
-    memcpy(ROM->END, HEADER + ROM_END, 4);
     memcpy(ROM->INTERNATIONAL, HEADER + ROM_INTERNATIONAL, 16);
+    memcpy(ROM->REGION, HEADER + ROM_REGION, 16);
+
+    ROM->CHECKSUM = ((U8)HEADER[ROM_CHECKSUM] << 8) | (U8)HEADER[ROM_CHECKSUM + 1];
+    ROM->START = ((U32)(U8)HEADER[ROM_START] << 24) | ((U8)HEADER[ROM_START + 1] << 16) |
+                 ((U8)HEADER[ROM_START + 2] << 8) | (U8)HEADER[ROM_START + 3];
+    ROM->END = ((U32)(U8)HEADER[ROM_END] << 24) | ((U8)HEADER[ROM_END + 1] << 16) |
+               ((U8)HEADER[ROM_END + 2] << 8) | (U8)HEADER[ROM_END + 3];
+
+    /* THE I/O SUPPORT STRING LISTS EVERY PERIPHERAL THE GAME UNDERSTANDS */
+    /* FOLD IT DOWN INTO A BITMASK SUCH THAT THE PORTS CAN PICK THEIR DEVICES */
+
+    for(INDEX = 0; INDEX < ROM_PERIPHERAL_LEN; INDEX++)
+    {
+        switch(HEADER[ROM_PERIPHERALS + INDEX])
+        {
+            case 'J': ROM->PERIPHERALS |= ROM_PERIPHERAL_PAD3; break;
+            case '6': ROM->PERIPHERALS |= ROM_PERIPHERAL_PAD6; break;
+            case '4': ROM->PERIPHERALS |= ROM_PERIPHERAL_MULTITAP; break;
+            case 'M': ROM->PERIPHERALS |= ROM_PERIPHERAL_MOUSE; break;
+            case 'K': ROM->PERIPHERALS |= ROM_PERIPHERAL_KEYBOARD; break;
+            case 'L': ROM->PERIPHERALS |= ROM_PERIPHERAL_LIGHTGUN; break;
+            default: break;
+        }
+    }
 
     /* FROM THERE, WE WILL BEGIN TO EVALUATE THE MEMORY ADDRESSES */\
     /* OF EACH RESPECTIVE ENTITY */
 
     /* THIS WILL BE DONE BASED ON A BIT MASK BETWEEN 0 AND 15  (16 BIT CHECKSUM) */
 
-    ROM->START = 0;
-    switch(HEADER[OFFSET - 0x0F])
+    if(SYSTEM_TYPE == SYSTEM_MISC)
     {
-        case 0x00:
-          ROM->END = 0x3FFFF;
-          break;
-        case 0x01:
-          ROM->END = 0x7FFFF;
-          break;
-        case 0x02:
-          ROM->END = 0xFFFFF;
-          break;
-        case 0x0A:
-          ROM->END = 0x1FFF;
-          break;
-        case 0x0B:
-          ROM->END = 0x3FFF;
-          break;
-        case 0x0C:
-          ROM->END = 0x7FFF;
-          break;
-        case 0x0D:
-          ROM->END = 0xBFFF;
-          break;
-        case 0x0E:
-          ROM->END = 0xFFFF;
-          break;
-        case 0x0F:
-          ROM->END = 0x1FFFF;
-          break;
+        OFFSET = 0x7FFF;
+        ROM->START = 0;
+        switch(HEADER[OFFSET] & 0x0F)
+        {
+            case 0x00:
+              ROM->END = 0x3FFFF;
+              break;
+            case 0x01:
+              ROM->END = 0x7FFFF;
+              break;
+            case 0x02:
+              ROM->END = 0xFFFFF;
+              break;
+            case 0x0A:
+              ROM->END = 0x1FFF;
+              break;
+            case 0x0B:
+              ROM->END = 0x3FFF;
+              break;
+            case 0x0C:
+              ROM->END = 0x7FFF;
+              break;
+            case 0x0D:
+              ROM->END = 0xBFFF;
+              break;
+            case 0x0E:
+              ROM->END = 0xFFFF;
+              break;
+            case 0x0F:
+              ROM->END = 0x1FFFF;
+              break;
+        }
     }
+}
 
-    free(ROM);
+const ROM_INFO* MD_ROM_HEADER(void)
+{
+    return &MD_ROM_INFO;
 }
 
 /* LOAD ROM INTO THE CURRENT BUFFER BASED ON THE SIZE OF THE CURRENT STRUCT */
@@ -142,4 +176,84 @@ int MD_LOAD_ROM(char* FILENAME)
     return 0;
 }
 
+/* HAND A ROM IMAGE WHICH IS ALREADY IN MEMORY TO THE CARTRIDGE */
+/* THE HEADER IS PARSED AND THE I/O PORTS PICK THEIR PERIPHERALS FROM IT */
+
+/* THE IMAGE IS THEN SWAPPED INTO HOST WORD ORDER (SEE mem.h), WHICH IS */
+/* HOW THE CARTRIDGE HOLDS IT FROM HERE ON OUT */
+
+void MD_CART_ATTACH(MD_CART* CART, U8* DATA, UNK SIZE)
+{
+    CART->ROM_SIZE = SIZE;
+    CART->ROM_DATA = (U32*)DATA;
+
+    MD_GET_ROM_INFO((char*)DATA);
+    IO_SELECT_PERIPHERALS(MD_ROM_HEADER()->PERIPHERALS);
+
+    MD_SWAP_WORDS(DATA, SIZE);
+}
+
+/* AS ABOVE, FOR AN IMAGE WHOSE HEADER HAS ALREADY BEEN PARSED ELSEWHERE */
+/* AND WHICH IS ALREADY IN HOST WORD ORDER */
+
+void MD_CART_ATTACH_INFO(MD_CART* CART, U8* DATA, UNK SIZE, const ROM_INFO* INFO)
+{
+    CART->ROM_SIZE = SIZE;
+    CART->ROM_DATA = (U32*)DATA;
+
+    MD_ROM_INFO = *INFO;
+    IO_SELECT_PERIPHERALS(MD_ROM_INFO.PERIPHERALS);
+}
+
+/* A MASTER FUNCTION TO LOAD THE CARTRIDGE INFORMATION */
+/* THIS IS DONE BY SEEKING INTO THE CONTENTS OF THE HEADER */
+/* THEN EVALUATING SUCH */
+
+/* ALLOCATING THE APPROPRIATE SIZE FOR EACH */
+
+int MD_CART_LOAD(char* FILENAME, MD_CART* CART) 
+{
+    UNK SIZE;
+    U8* DATA;
+    U16 CHECKSUM;
+    ROM_INFO INFO;
+
+    printf("Opening ROM file: %s\n", FILENAME);
+
+    /* AN IMAGE ANOTHER INSTANCE HAS ALREADY UNPACKED AND PARSED IS MAPPED */
+    /* AS IT IS - OTHERWISE GZIP, ZIP AND SMD DUMPS ARE UNPACKED ON THE WAY */
+    /* IN (SEE rom.h), AND THE RESULT OFFERED BACK TO THE CACHE */
+
+    if (ROM_CACHE_ATTACH(FILENAME, &DATA, &SIZE, &CHECKSUM, &INFO) == 0)
+    {
+        printf("Checksum for ROM: %s, 0x%x\n", FILENAME, CHECKSUM);
+        MD_CART_ATTACH_INFO(CART, DATA, SIZE, &INFO);
+    }
+
+    else
+    {
+        if (ROM_LOAD(FILENAME, &DATA, &SIZE) != 0) 
+        {
+            printf("Failed to open ROM file: %s\n", FILENAME);
+            return -1;
+        }
+
+        CHECKSUM = GET_CHECKSUM(DATA, SIZE, FILENAME);
+        MD_CART_ATTACH(CART, DATA, SIZE);
+        ROM_CACHE_STORE(DATA, SIZE, CHECKSUM, MD_ROM_HEADER());
+    }
+
+    printf("ROM Loaded Successfully. Size: %lu bytes\n", SIZE);
+
+    printf("First 16 bytes of ROM:\n");
+    for (int i = 0; i < 16; i++) 
+    {
+        printf("%02X ", DATA[i]);
+    }
+    
+    printf("\n");
+
+    return 0;
+}
+
 #endif
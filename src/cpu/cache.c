@@ -0,0 +1,1061 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE CACHED INTERPRETER FOR THE 68000 */
+/* SEE cache.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "cache.h"
+#include "md.h"
+#include "profile.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+static M68K_CACHE CACHE;
+
+/* HANDED OUT FOR ANY PC THAT ISN'T CACHEABLE - IT HOLDS NO OPERATIONS */
+/* SO EXECUTION ALWAYS FALLS BACK TO lib68k */
+
+static M68K_CACHE_BLOCK CACHE_UNCACHED;
+
+/* WORK RAM AS IT WAS WHEN EACH PAGE HOLDING CODE WAS DECODED */
+
+static U8 CACHE_RAM_SHADOW[0x10000];
+
+#define     CACHE_MASK(SIZE)        M68K_FLAGS_MASK(SIZE)
+
+//================================================
+//              MEMORY AND FLAG HELPERS
+//================================================
+
+static inline U32 CACHE_READ(U32 ADDRESS, unsigned SIZE)
+{
+    switch (SIZE)
+    {
+        case 1:     return M68K_READ_8(ADDRESS) & 0xFF;
+        case 2:     return M68K_READ_16(ADDRESS) & 0xFFFF;
+        default:    return M68K_READ_32(ADDRESS);
+    }
+}
+
+/* WRITES TO WORK RAM ARE CHECKED AGAINST THE PAGES HOLDING CACHED CODE */
+
+static inline void CACHE_WRITE(U32 ADDRESS, U32 DATA, unsigned SIZE)
+{
+    switch (SIZE)
+    {
+        case 1:     M68K_WRITE_8(ADDRESS, DATA & 0xFF); break;
+        case 2:     M68K_WRITE_16(ADDRESS, DATA & 0xFFFF); break;
+        default:    M68K_WRITE_32(ADDRESS, DATA); break;
+    }
+
+    if((ADDRESS & 0xFFFFFF) >= M68K_CACHE_RAM_START)
+    {
+        M68K_CACHE_WATCH_WRITE(&CACHE, ADDRESS);
+
+        if(SIZE == 4)
+            M68K_CACHE_WATCH_WRITE(&CACHE, ADDRESS + 2);
+    }
+}
+
+/* BYTE ACCESSES THROUGH THE STACK POINTER KEEP IT WORD ALIGNED */
+
+static inline U32 CACHE_EA_STEP(const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    return (SIZE == 1 && EA->REG == 7) ? 2 : SIZE;
+}
+
+static inline U32 CACHE_EA_ADDRESS(const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    U32 ADDRESS;
+
+    switch (EA->MODE)
+    {
+        case M68K_EA_IND:
+            return M68K_CACHE_A(EA->REG);
+
+        case M68K_EA_POST:
+            ADDRESS = M68K_CACHE_A(EA->REG);
+            M68K_CACHE_A(EA->REG) += CACHE_EA_STEP(EA, SIZE);
+            return ADDRESS;
+
+        case M68K_EA_PRE:
+            M68K_CACHE_A(EA->REG) -= CACHE_EA_STEP(EA, SIZE);
+            return M68K_CACHE_A(EA->REG);
+
+        case M68K_EA_DISP:
+            return M68K_CACHE_A(EA->REG) + EA->EXT;
+
+        default:
+            return EA->EXT;
+    }
+}
+
+static inline U32 CACHE_EA_READ(const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    switch (EA->MODE)
+    {
+        case M68K_EA_DN:    return M68K_CACHE_D(EA->REG) & CACHE_MASK(SIZE);
+        case M68K_EA_AN:    return M68K_CACHE_A(EA->REG) & CACHE_MASK(SIZE);
+        case M68K_EA_IMM:   return EA->EXT;
+        default:            return CACHE_READ(CACHE_EA_ADDRESS(EA, SIZE), SIZE);
+    }
+}
+
+static inline void CACHE_EA_WRITE(const M68K_CACHE_EA* EA, unsigned SIZE, U32 DATA)
+{
+    if(EA->MODE == M68K_EA_DN)
+    {
+        M68K_CACHE_D(EA->REG) = (M68K_CACHE_D(EA->REG) & ~CACHE_MASK(SIZE)) | (DATA & CACHE_MASK(SIZE));
+        return;
+    }
+
+    CACHE_WRITE(CACHE_EA_ADDRESS(EA, SIZE), DATA, SIZE);
+}
+
+static inline U32 CACHE_SIGN_EXTEND(U32 VALUE, unsigned SIZE)
+{
+    switch (SIZE)
+    {
+        case 1:     return (U32)(S32)(S8)VALUE;
+        case 2:     return (U32)(S32)(S16)VALUE;
+        default:    return VALUE;
+    }
+}
+
+/* FLAG SETTING OPERATIONS ONLY RECORD WHAT THEY DID - SEE flags.h */
+
+#define     CACHE_FLAGS(KIND, SRC, DST, RESULT, SIZE)   \
+            M68K_FLAGS_SET(&CACHE.FLAGS, &CPU.STATUS_REGISTER, KIND, SRC, DST, RESULT, SIZE)
+
+static inline bool CACHE_CONDITION(unsigned COND)
+{
+    return M68K_FLAGS_CONDITION(&CACHE.FLAGS, M68K_CACHE_SR, COND);
+}
+
+/* BRING THE STATUS REGISTER UP TO DATE BEFORE ANYTHING OUTSIDE OF THE CACHE */
+/* - lib68k, AN EXCEPTION, OR A SAVE STATE - GETS TO SEE IT */
+
+static inline void CACHE_SYNC(void)
+{
+    M68K_FLAGS_FOLD(&CACHE.FLAGS, &CPU.STATUS_REGISTER);
+}
+
+static inline void CACHE_PUSH_32(U32 DATA)
+{
+    M68K_CACHE_A(7) -= 4;
+    CACHE_WRITE(M68K_CACHE_A(7), DATA, 4);
+}
+
+//================================================
+//                  DECODER
+//================================================
+
+static inline U32 CACHE_FETCH(U32* PC)
+{
+    U32 WORD = M68K_READ_16(*PC) & 0xFFFF;
+    *PC += 2;
+    return WORD;
+}
+
+static unsigned CACHE_SIZE_FIELD(unsigned FIELD)
+{
+    return FIELD == 0 ? 1 : FIELD == 1 ? 2 : 4;
+}
+
+/* RESOLVE THE MODE AND REGISTER FIELDS OF AN EFFECTIVE ADDRESS, CONSUMING */
+/* IT'S EXTENSION WORDS - RETURNS THE CYCLES THE ADDRESSING MODE COSTS, OR -1 */
+/* IF THE MODE ISN'T HANDLED BY THE CACHED INTERPRETER */
+
+static int CACHE_DECODE_EA(U32* PC, unsigned MODE, unsigned REG, unsigned SIZE, M68K_CACHE_EA* EA)
+{
+    U32 BASE;
+    int LONG = SIZE == 4 ? 4 : 0;
+
+    EA->REG = REG;
+    EA->EXT = 0;
+
+    switch (MODE)
+    {
+        case 0: EA->MODE = M68K_EA_DN; return 0;
+        case 1: EA->MODE = M68K_EA_AN; return 0;
+        case 2: EA->MODE = M68K_EA_IND; return 4 + LONG;
+        case 3: EA->MODE = M68K_EA_POST; return 4 + LONG;
+        case 4: EA->MODE = M68K_EA_PRE; return 6 + LONG;
+
+        case 5:
+            EA->MODE = M68K_EA_DISP;
+            EA->EXT = CACHE_SIGN_EXTEND(CACHE_FETCH(PC), 2);
+            return 8 + LONG;
+
+        case 7:
+            switch (REG)
+            {
+                case 0:
+                    EA->MODE = M68K_EA_ABS;
+                    EA->EXT = CACHE_SIGN_EXTEND(CACHE_FETCH(PC), 2);
+                    return 8 + LONG;
+
+                case 1:
+                    EA->MODE = M68K_EA_ABS;
+                    EA->EXT = CACHE_FETCH(PC) << 16;
+                    EA->EXT |= CACHE_FETCH(PC);
+                    return 12 + LONG;
+
+                case 2:
+                    BASE = *PC;
+                    EA->MODE = M68K_EA_ABS;
+                    EA->EXT = BASE + CACHE_SIGN_EXTEND(CACHE_FETCH(PC), 2);
+                    return 8 + LONG;
+
+                case 4:
+                    EA->MODE = M68K_EA_IMM;
+
+                    if(SIZE == 4)
+                    {
+                        EA->EXT = CACHE_FETCH(PC) << 16;
+                        EA->EXT |= CACHE_FETCH(PC);
+                    }
+
+                    else
+                    {
+                        EA->EXT = CACHE_FETCH(PC) & CACHE_MASK(SIZE);
+                    }
+
+                    return 4 + LONG;
+
+                default:
+                    return -1;
+            }
+
+        default:
+            return -1;
+    }
+}
+
+/* DESTINATIONS MUST BE ALTERABLE - NEITHER PC RELATIVE NOR IMMEDIATE */
+
+static bool CACHE_ALTERABLE(unsigned MODE, unsigned REG)
+{
+    return MODE != 7 || REG < 2;
+}
+
+/* CONTROL ADDRESSING MODES, AS USED BY LEA, JMP AND JSR */
+
+static int CACHE_DECODE_CONTROL(U32* PC, unsigned MODE, unsigned REG, M68K_CACHE_EA* EA)
+{
+    if(MODE != 2 && MODE != 5 && !(MODE == 7 && REG <= 2))
+        return -1;
+
+    return CACHE_DECODE_EA(PC, MODE, REG, 4, EA);
+}
+
+static bool CACHE_DECODE_ALU(M68K_CACHE_OP* OP, U32* PC, unsigned OPCODE)
+{
+    static const U8 LINE_KIND[16] =
+    {
+        [0x8] = M68K_OP_OR, [0x9] = M68K_OP_SUB, [0xB] = M68K_OP_CMP,
+        [0xC] = M68K_OP_AND, [0xD] = M68K_OP_ADD,
+    };
+
+    static const U8 LINE_KIND_A[16] =
+    {
+        [0x9] = M68K_OP_SUBA, [0xB] = M68K_OP_CMPA, [0xD] = M68K_OP_ADDA,
+    };
+
+    unsigned LINE = OPCODE >> 12;
+    unsigned OPMODE = (OPCODE >> 6) & 7;
+    unsigned MODE = (OPCODE >> 3) & 7;
+    int CYCLES;
+
+    OP->DST.MODE = M68K_EA_DN;
+    OP->DST.REG = (OPCODE >> 9) & 7;
+
+    /* <EA>,DN */
+
+    if(OPMODE < 3)
+    {
+        OP->KIND = LINE_KIND[LINE];
+        OP->SIZE = CACHE_SIZE_FIELD(OPMODE);
+
+        if(MODE == 1 && (OP->SIZE == 1 || OP->KIND == M68K_OP_AND || OP->KIND == M68K_OP_OR))
+            return false;
+
+        CYCLES = CACHE_DECODE_EA(PC, MODE, OPCODE & 7, OP->SIZE, &OP->SRC);
+        if(CYCLES < 0)
+            return false;
+
+        /* A LONG ADD, SUB, AND OR OR FROM A REGISTER OR IMMEDIATE TAKES TWO MORE */
+        /* CYCLES THAN FROM MEMORY - A LONG CMP IS 6 PLUS THE EA EITHER WAY */
+
+        if(OP->SIZE != 4)
+            OP->CYCLES = CYCLES + 4;
+
+        else if(OP->KIND == M68K_OP_CMP)
+            OP->CYCLES = CYCLES + 6;
+
+        else
+            OP->CYCLES = CYCLES + (CYCLES == 0 || OP->SRC.MODE == M68K_EA_IMM ? 8 : 6);
+
+        return true;
+    }
+
+    /* <EA>,AN - ADDA, SUBA AND CMPA */
+
+    if((OPMODE == 3 || OPMODE == 7) && LINE_KIND_A[LINE])
+    {
+        OP->KIND = LINE_KIND_A[LINE];
+        OP->SIZE = OPMODE == 3 ? 2 : 4;
+        OP->DST.MODE = M68K_EA_AN;
+
+        CYCLES = CACHE_DECODE_EA(PC, MODE, OPCODE & 7, OP->SIZE, &OP->SRC);
+        if(CYCLES < 0)
+            return false;
+
+        /* A LONG ADDA OR SUBA TAKES 8 FROM A REGISTER BUT 6 PLUS THE EA FROM */
+        /* MEMORY OR AN IMMEDIATE - CMPA IS 6 PLUS THE EA, AND THE WORD FORMS 8 */
+
+        if(OP->KIND == M68K_OP_CMPA)
+            OP->CYCLES = CYCLES + 6;
+
+        else if(OP->SIZE != 4)
+            OP->CYCLES = CYCLES + 8;
+
+        else
+            OP->CYCLES = CYCLES + (CYCLES == 0 ? 8 : 6);
+
+        return true;
+    }
+
+    return false;
+}
+
+/* DECODE A SINGLE INSTRUCTION INTO THE OPERATION - RETURNS FALSE FOR */
+/* ANYTHING WHICH MUST BE LEFT TO lib68k */
+
+static bool CACHE_DECODE(M68K_CACHE_OP* OP, U32* PC)
+{
+    unsigned OPCODE = CACHE_FETCH(PC);
+    unsigned MODE = (OPCODE >> 3) & 7;
+    unsigned REG = OPCODE & 7;
+    unsigned SIZE_FIELD = (OPCODE >> 6) & 3;
+    int SRC_CYCLES, DST_CYCLES;
+    U32 BASE;
+    S32 DISP;
+
+    switch (OPCODE >> 12)
+    {
+        /* MOVE AND MOVEA */
+
+        case 0x1:
+        case 0x2:
+        case 0x3:
+        {
+            unsigned DST_MODE = (OPCODE >> 6) & 7;
+            unsigned DST_REG = (OPCODE >> 9) & 7;
+
+            OP->SIZE = (OPCODE >> 12) == 1 ? 1 : (OPCODE >> 12) == 3 ? 2 : 4;
+
+            if(MODE == 1 && OP->SIZE == 1)
+                return false;
+
+            SRC_CYCLES = CACHE_DECODE_EA(PC, MODE, REG, OP->SIZE, &OP->SRC);
+            if(SRC_CYCLES < 0 || !CACHE_ALTERABLE(DST_MODE, DST_REG))
+                return false;
+
+            if(DST_MODE == 1)
+            {
+                if(OP->SIZE == 1)
+                    return false;
+
+                OP->KIND = M68K_OP_MOVEA;
+                OP->DST.MODE = M68K_EA_AN;
+                OP->DST.REG = DST_REG;
+                OP->CYCLES = 4 + SRC_CYCLES;
+                return true;
+            }
+
+            DST_CYCLES = CACHE_DECODE_EA(PC, DST_MODE, DST_REG, OP->SIZE, &OP->DST);
+            if(DST_CYCLES < 0)
+                return false;
+
+            OP->KIND = (OP->SRC.MODE == M68K_EA_DN && OP->DST.MODE == M68K_EA_DN) ? M68K_OP_MOVE_RR : M68K_OP_MOVE;
+            OP->CYCLES = 4 + SRC_CYCLES + DST_CYCLES;
+            return true;
+        }
+
+        case 0x4:
+        {
+            if(OPCODE == 0x4E71)
+            {
+                OP->KIND = M68K_OP_NOP;
+                OP->CYCLES = 4;
+                return true;
+            }
+
+            if(OPCODE == 0x4E75)
+            {
+                OP->KIND = M68K_OP_RTS;
+                OP->CYCLES = 16;
+                return true;
+            }
+
+            /* LEA */
+
+            if((OPCODE & 0xF1C0) == 0x41C0)
+            {
+                SRC_CYCLES = CACHE_DECODE_CONTROL(PC, MODE, REG, &OP->SRC);
+                if(SRC_CYCLES < 0)
+                    return false;
+
+                OP->KIND = M68K_OP_LEA;
+                OP->SIZE = 4;
+                OP->DST.MODE = M68K_EA_AN;
+                OP->DST.REG = (OPCODE >> 9) & 7;
+                OP->CYCLES = SRC_CYCLES - 4;
+                return true;
+            }
+
+            /* JMP AND JSR */
+
+            if((OPCODE & 0xFF80) == 0x4E80)
+            {
+                SRC_CYCLES = CACHE_DECODE_CONTROL(PC, MODE, REG, &OP->DST);
+                if(SRC_CYCLES < 0)
+                    return false;
+
+                OP->KIND = (OPCODE & 0x40) ? M68K_OP_JMP : M68K_OP_JSR;
+                OP->CYCLES = (MODE == 2 ? 8 : (MODE == 7 && REG == 1) ? 12 : 10) + (OP->KIND == M68K_OP_JSR ? 8 : 0);
+                return true;
+            }
+
+            /* CLR AND TST */
+
+            if(((OPCODE & 0xFF00) == 0x4200 || (OPCODE & 0xFF00) == 0x4A00) && SIZE_FIELD != 3 && MODE != 1)
+            {
+                bool CLEAR = (OPCODE & 0xFF00) == 0x4200;
+
+                OP->SIZE = CACHE_SIZE_FIELD(SIZE_FIELD);
+
+                if(CLEAR && !CACHE_ALTERABLE(MODE, REG))
+                    return false;
+
+                SRC_CYCLES = CACHE_DECODE_EA(PC, MODE, REG, OP->SIZE, CLEAR ? &OP->DST : &OP->SRC);
+                if(SRC_CYCLES < 0)
+                    return false;
+
+                OP->KIND = CLEAR ? M68K_OP_CLR : M68K_OP_TST;
+
+                if(CLEAR)
+                    OP->CYCLES = MODE == 0 ? (OP->SIZE == 4 ? 6 : 4) : (OP->SIZE == 4 ? 12 : 8) + SRC_CYCLES;
+                else
+                    OP->CYCLES = 4 + SRC_CYCLES;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        /* ADDQ, SUBQ AND DBCC */
+
+        case 0x5:
+        {
+            if((OPCODE & 0xF0F8) == 0x50C8)
+            {
+                BASE = *PC;
+                OP->KIND = M68K_OP_DBCC;
+                OP->COND = (OPCODE >> 8) & 0xF;
+                OP->DST.MODE = M68K_EA_DN;
+                OP->DST.REG = REG;
+                OP->SRC.EXT = BASE + CACHE_SIGN_EXTEND(CACHE_FETCH(PC), 2);
+                OP->CYCLES = 10;
+                return true;
+            }
+
+            if(SIZE_FIELD == 3 || !CACHE_ALTERABLE(MODE, REG))
+                return false;
+
+            OP->SIZE = CACHE_SIZE_FIELD(SIZE_FIELD);
+            OP->SRC.MODE = M68K_EA_IMM;
+            OP->SRC.EXT = ((OPCODE >> 9) & 7) ? ((OPCODE >> 9) & 7) : 8;
+
+            /* ADDRESS REGISTERS ARE UPDATED AS A WHOLE AND LEAVE THE FLAGS ALONE */
+
+            if(MODE == 1)
+            {
+                if(OP->SIZE == 1)
+                    return false;
+
+                OP->KIND = M68K_OP_ADDQ_A;
+                OP->DST.MODE = M68K_EA_AN;
+                OP->DST.REG = REG;
+                OP->SRC.EXT = (OPCODE & 0x100) ? (U32)-(S32)OP->SRC.EXT : OP->SRC.EXT;
+                OP->CYCLES = 8;
+                return true;
+            }
+
+            DST_CYCLES = CACHE_DECODE_EA(PC, MODE, REG, OP->SIZE, &OP->DST);
+            if(DST_CYCLES < 0)
+                return false;
+
+            OP->KIND = (OPCODE & 0x100) ? M68K_OP_SUBQ : M68K_OP_ADDQ;
+            OP->CYCLES = MODE == 0 ? (OP->SIZE == 4 ? 8 : 4) : (OP->SIZE == 4 ? 12 : 8) + DST_CYCLES;
+            return true;
+        }
+
+        /* BRA, BSR AND BCC */
+
+        case 0x6:
+        {
+            BASE = *PC;
+            DISP = (S8)(OPCODE & 0xFF);
+
+            if((OPCODE & 0xFF) == 0xFF)
+                return false;
+
+            if(DISP == 0)
+                DISP = (S16)CACHE_FETCH(PC);
+
+            OP->COND = (OPCODE >> 8) & 0xF;
+            OP->DST.EXT = BASE + DISP;
+
+            switch (OP->COND)
+            {
+                case CONDITION_TRUE:
+                    OP->KIND = M68K_OP_BCC;
+                    OP->CYCLES = 10;
+                    break;
+
+                case CONDITION_FALSE:
+                    OP->KIND = M68K_OP_BSR;
+                    OP->CYCLES = 18;
+                    break;
+
+                /* THE STORED COST IS THE BRANCH NOT BEING TAKEN */
+
+                default:
+                    OP->KIND = M68K_OP_BCC;
+                    OP->CYCLES = (OPCODE & 0xFF) ? 8 : 12;
+                    break;
+            }
+
+            return true;
+        }
+
+        case 0x7:
+        {
+            if(OPCODE & 0x100)
+                return false;
+
+            OP->KIND = M68K_OP_MOVEQ;
+            OP->SIZE = 4;
+            OP->DST.MODE = M68K_EA_DN;
+            OP->DST.REG = (OPCODE >> 9) & 7;
+            OP->SRC.EXT = CACHE_SIGN_EXTEND(OPCODE & 0xFF, 1);
+            OP->CYCLES = 4;
+            return true;
+        }
+
+        case 0x8:
+        case 0x9:
+        case 0xB:
+        case 0xC:
+        case 0xD:
+            return CACHE_DECODE_ALU(OP, PC, OPCODE);
+
+        default:
+            return false;
+    }
+}
+
+static bool CACHE_TERMINATOR(unsigned KIND)
+{
+    return KIND >= M68K_OP_BCC;
+}
+
+static void CACHE_MARK_PAGE(unsigned PAGE)
+{
+    if(CACHE.RAM_CODE_PAGES[PAGE])
+        return;
+
+    CACHE.RAM_CODE_PAGES[PAGE] = 1;
+    CACHE.RAM_CODE_LIST[CACHE.RAM_CODE_COUNT++] = PAGE;
+
+    memcpy(&CACHE_RAM_SHADOW[PAGE << M68K_CACHE_PAGE_SHIFT], MD_GET_WORK_RAM() + (PAGE << M68K_CACHE_PAGE_SHIFT), 1u << M68K_CACHE_PAGE_SHIFT);
+}
+
+/* AN INSTRUCTION STEPPED BY lib68k MAY HAVE WRITTEN OVER CACHED CODE */
+
+static void CACHE_CHECK_RAM(void)
+{
+    const U8* RAM = MD_GET_WORK_RAM();
+    unsigned INDEX, OFFSET;
+
+    for (INDEX = 0; INDEX < CACHE.RAM_CODE_COUNT; INDEX++)
+    {
+        OFFSET = (unsigned)CACHE.RAM_CODE_LIST[INDEX] << M68K_CACHE_PAGE_SHIFT;
+
+        if(memcmp(&CACHE_RAM_SHADOW[OFFSET], RAM + OFFSET, 1u << M68K_CACHE_PAGE_SHIFT) != 0)
+        {
+            M68K_CACHE_INVALIDATE(M68K_CACHE_RAM_START | OFFSET);
+            return;
+        }
+    }
+}
+
+/* DECODE A BLOCK STARTING AT THE GIVEN PC, STOPPING AT THE FIRST BRANCH, */
+/* THE FIRST INSTRUCTION WHICH ISN'T HANDLED, OR ONCE THE BLOCK IS FULL */
+
+static void CACHE_BUILD(M68K_CACHE_BLOCK* BLOCK, U32 START)
+{
+    M68K_CACHE_OP* OP;
+    U32 PC = START;
+    U32 INSTR_PC;
+    U32 PAGE;
+
+    BLOCK->START = START;
+    BLOCK->GENERATION = CACHE.RAM_GENERATION;
+    BLOCK->OP_COUNT = 0;
+    BLOCK->VALID = true;
+
+    while (BLOCK->OP_COUNT < M68K_CACHE_MAX_OPS - 1)
+    {
+        OP = &BLOCK->OPS[BLOCK->OP_COUNT];
+        memset(OP, 0, sizeof(*OP));
+        INSTR_PC = PC;
+
+        if(!CACHE_DECODE(OP, &PC))
+        {
+            PC = INSTR_PC;
+            break;
+        }
+
+        OP->NEXT_PC = PC;
+        BLOCK->OP_COUNT++;
+
+        if(CACHE_TERMINATOR(OP->KIND))
+            goto MARK;
+    }
+
+    /* FALL THROUGH TO WHATEVER FOLLOWS THE BLOCK */
+
+    OP = &BLOCK->OPS[BLOCK->OP_COUNT];
+    memset(OP, 0, sizeof(*OP));
+    OP->KIND = M68K_OP_END;
+    OP->NEXT_PC = PC;
+
+MARK:
+    if(START >= M68K_CACHE_RAM_START && PC > START)
+    {
+        for (PAGE = START >> M68K_CACHE_PAGE_SHIFT; PAGE <= (PC - 1) >> M68K_CACHE_PAGE_SHIFT; PAGE++)
+            CACHE_MARK_PAGE(PAGE & (M68K_CACHE_RAM_PAGES - 1));
+    }
+}
+
+static M68K_CACHE_BLOCK* CACHE_LOOKUP(U32 PC)
+{
+    M68K_CACHE_BLOCK* BLOCK;
+
+    if(PC >= M68K_CACHE_ROM_END && PC < M68K_CACHE_RAM_START)
+        return &CACHE_UNCACHED;
+
+    BLOCK = &CACHE.BLOCKS[(PC >> 1) & (M68K_CACHE_BLOCKS - 1)];
+
+    if(BLOCK->VALID && BLOCK->START == PC &&
+      (PC < M68K_CACHE_ROM_END || BLOCK->GENERATION == CACHE.RAM_GENERATION))
+    {
+        CACHE.HITS++;
+        return BLOCK;
+    }
+
+    CACHE.MISSES++;
+    CACHE_BUILD(BLOCK, PC);
+    return BLOCK;
+}
+
+//================================================
+//                  EXECUTION
+//================================================
+
+/* RUN A DECODED BLOCK THROUGH THREADED DISPATCH - EACH HANDLER JUMPS */
+/* STRAIGHT TO THE NEXT, WITHOUT RETURNING TO A CENTRAL SWITCH */
+
+static int CACHE_RUN(const M68K_CACHE_BLOCK* BLOCK)
+{
+    static const void* const DISPATCH[M68K_OP_COUNT] =
+    {
+        [M68K_OP_END]       = &&OP_END,
+        [M68K_OP_NOP]       = &&OP_NOP,
+        [M68K_OP_MOVEQ]     = &&OP_MOVEQ,
+        [M68K_OP_MOVE_RR]   = &&OP_MOVE_RR,
+        [M68K_OP_MOVE]      = &&OP_MOVE,
+        [M68K_OP_MOVEA]     = &&OP_MOVEA,
+        [M68K_OP_LEA]       = &&OP_LEA,
+        [M68K_OP_CLR]       = &&OP_CLR,
+        [M68K_OP_TST]       = &&OP_TST,
+        [M68K_OP_ADDQ]      = &&OP_ADDQ,
+        [M68K_OP_SUBQ]      = &&OP_SUBQ,
+        [M68K_OP_ADDQ_A]    = &&OP_ADDQ_A,
+        [M68K_OP_ADD]       = &&OP_ADD,
+        [M68K_OP_SUB]       = &&OP_SUB,
+        [M68K_OP_CMP]       = &&OP_CMP,
+        [M68K_OP_AND]       = &&OP_AND,
+        [M68K_OP_OR]        = &&OP_OR,
+        [M68K_OP_ADDA]      = &&OP_ADDA,
+        [M68K_OP_SUBA]      = &&OP_SUBA,
+        [M68K_OP_CMPA]      = &&OP_CMPA,
+        [M68K_OP_BCC]       = &&OP_BCC,
+        [M68K_OP_BSR]       = &&OP_BSR,
+        [M68K_OP_DBCC]      = &&OP_DBCC,
+        [M68K_OP_JMP]       = &&OP_JMP,
+        [M68K_OP_JSR]       = &&OP_JSR,
+        [M68K_OP_RTS]       = &&OP_RTS,
+    };
+
+    const M68K_CACHE_OP* OP = BLOCK->OPS;
+    int CYCLES = OP->CYCLES;
+    U32 SRC, DST, RESULT, ADDRESS;
+
+    #define     CACHE_NEXT()        OP++; CYCLES += OP->CYCLES; goto *DISPATCH[OP->KIND]
+
+    goto *DISPATCH[OP->KIND];
+
+OP_END:
+    M68K_CACHE_PC = OP->NEXT_PC;
+    return CYCLES;
+
+OP_NOP:
+    CACHE_NEXT();
+
+OP_MOVEQ:
+    M68K_CACHE_D(OP->DST.REG) = OP->SRC.EXT;
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, OP->SRC.EXT, 4);
+    CACHE_NEXT();
+
+OP_MOVE_RR:
+    SRC = M68K_CACHE_D(OP->SRC.REG) & CACHE_MASK(OP->SIZE);
+    M68K_CACHE_D(OP->DST.REG) = (M68K_CACHE_D(OP->DST.REG) & ~CACHE_MASK(OP->SIZE)) | SRC;
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, SRC, OP->SIZE);
+    CACHE_NEXT();
+
+OP_MOVE:
+    SRC = CACHE_EA_READ(&OP->SRC, OP->SIZE);
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, SRC);
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, SRC, OP->SIZE);
+    CACHE_NEXT();
+
+OP_MOVEA:
+    M68K_CACHE_A(OP->DST.REG) = CACHE_SIGN_EXTEND(CACHE_EA_READ(&OP->SRC, OP->SIZE), OP->SIZE);
+    CACHE_NEXT();
+
+OP_LEA:
+    M68K_CACHE_A(OP->DST.REG) = CACHE_EA_ADDRESS(&OP->SRC, 4);
+    CACHE_NEXT();
+
+OP_CLR:
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, 0);
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, 0, OP->SIZE);
+    CACHE_NEXT();
+
+OP_TST:
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, CACHE_EA_READ(&OP->SRC, OP->SIZE), OP->SIZE);
+    CACHE_NEXT();
+
+    /* READ-MODIFY-WRITE OPERANDS RESOLVE THEIR ADDRESS ONCE, SUCH THAT */
+    /* POST-INCREMENT AND PRE-DECREMENT ONLY STEP THE REGISTER ONCE */
+
+OP_ADDQ:
+OP_SUBQ:
+    SRC = OP->SRC.EXT;
+
+    if(OP->DST.MODE == M68K_EA_DN)
+    {
+        DST = M68K_CACHE_D(OP->DST.REG) & CACHE_MASK(OP->SIZE);
+        RESULT = OP->KIND == M68K_OP_ADDQ ? DST + SRC : DST - SRC;
+        M68K_CACHE_D(OP->DST.REG) = (M68K_CACHE_D(OP->DST.REG) & ~CACHE_MASK(OP->SIZE)) | (RESULT & CACHE_MASK(OP->SIZE));
+    }
+
+    else
+    {
+        ADDRESS = CACHE_EA_ADDRESS(&OP->DST, OP->SIZE);
+        DST = CACHE_READ(ADDRESS, OP->SIZE);
+        RESULT = OP->KIND == M68K_OP_ADDQ ? DST + SRC : DST - SRC;
+        CACHE_WRITE(ADDRESS, RESULT, OP->SIZE);
+    }
+
+    CACHE_FLAGS(OP->KIND == M68K_OP_ADDQ ? M68K_FLAGS_ADD : M68K_FLAGS_SUB, SRC, DST, RESULT, OP->SIZE);
+
+    CACHE_NEXT();
+
+OP_ADDQ_A:
+    M68K_CACHE_A(OP->DST.REG) += OP->SRC.EXT;
+    CACHE_NEXT();
+
+OP_ADD:
+    SRC = CACHE_EA_READ(&OP->SRC, OP->SIZE);
+    DST = M68K_CACHE_D(OP->DST.REG) & CACHE_MASK(OP->SIZE);
+    RESULT = DST + SRC;
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, RESULT);
+    CACHE_FLAGS(M68K_FLAGS_ADD, SRC, DST, RESULT, OP->SIZE);
+    CACHE_NEXT();
+
+OP_SUB:
+    SRC = CACHE_EA_READ(&OP->SRC, OP->SIZE);
+    DST = M68K_CACHE_D(OP->DST.REG) & CACHE_MASK(OP->SIZE);
+    RESULT = DST - SRC;
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, RESULT);
+    CACHE_FLAGS(M68K_FLAGS_SUB, SRC, DST, RESULT, OP->SIZE);
+    CACHE_NEXT();
+
+OP_CMP:
+    SRC = CACHE_EA_READ(&OP->SRC, OP->SIZE);
+    DST = M68K_CACHE_D(OP->DST.REG) & CACHE_MASK(OP->SIZE);
+    CACHE_FLAGS(M68K_FLAGS_CMP, SRC, DST, DST - SRC, OP->SIZE);
+    CACHE_NEXT();
+
+OP_AND:
+    RESULT = CACHE_EA_READ(&OP->SRC, OP->SIZE) & M68K_CACHE_D(OP->DST.REG);
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, RESULT);
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, RESULT, OP->SIZE);
+    CACHE_NEXT();
+
+OP_OR:
+    RESULT = CACHE_EA_READ(&OP->SRC, OP->SIZE) | M68K_CACHE_D(OP->DST.REG);
+    CACHE_EA_WRITE(&OP->DST, OP->SIZE, RESULT);
+    CACHE_FLAGS(M68K_FLAGS_LOGIC, 0, 0, RESULT, OP->SIZE);
+    CACHE_NEXT();
+
+OP_ADDA:
+    M68K_CACHE_A(OP->DST.REG) += CACHE_SIGN_EXTEND(CACHE_EA_READ(&OP->SRC, OP->SIZE), OP->SIZE);
+    CACHE_NEXT();
+
+OP_SUBA:
+    M68K_CACHE_A(OP->DST.REG) -= CACHE_SIGN_EXTEND(CACHE_EA_READ(&OP->SRC, OP->SIZE), OP->SIZE);
+    CACHE_NEXT();
+
+OP_CMPA:
+    SRC = CACHE_SIGN_EXTEND(CACHE_EA_READ(&OP->SRC, OP->SIZE), OP->SIZE);
+    DST = M68K_CACHE_A(OP->DST.REG);
+    CACHE_FLAGS(M68K_FLAGS_CMP, SRC, DST, DST - SRC, 4);
+    CACHE_NEXT();
+
+    /* BRANCHES END THE BLOCK, LEAVING THE PC AT THEIR DESTINATION */
+
+OP_BCC:
+    if(CACHE_CONDITION(OP->COND))
+    {
+        CYCLES += 10 - OP->CYCLES;
+        M68K_CACHE_PC = OP->DST.EXT;
+    }
+
+    else
+    {
+        M68K_CACHE_PC = OP->NEXT_PC;
+    }
+
+    return CYCLES;
+
+OP_BSR:
+    CACHE_PUSH_32(OP->NEXT_PC);
+    M68K_CACHE_PC = OP->DST.EXT;
+    return CYCLES;
+
+OP_DBCC:
+    if(CACHE_CONDITION(OP->COND))
+    {
+        CYCLES += 2;
+        M68K_CACHE_PC = OP->NEXT_PC;
+        return CYCLES;
+    }
+
+    DST = (M68K_CACHE_D(OP->DST.REG) - 1) & 0xFFFF;
+    M68K_CACHE_D(OP->DST.REG) = (M68K_CACHE_D(OP->DST.REG) & 0xFFFF0000) | DST;
+
+    if(DST != 0xFFFF)
+    {
+        M68K_CACHE_PC = OP->SRC.EXT;
+        return CYCLES;
+    }
+
+    CYCLES += 4;
+    M68K_CACHE_PC = OP->NEXT_PC;
+    return CYCLES;
+
+OP_JMP:
+    M68K_CACHE_PC = CACHE_EA_ADDRESS(&OP->DST, 4);
+    return CYCLES;
+
+OP_JSR:
+    ADDRESS = CACHE_EA_ADDRESS(&OP->DST, 4);
+    CACHE_PUSH_32(OP->NEXT_PC);
+    M68K_CACHE_PC = ADDRESS;
+    return CYCLES;
+
+OP_RTS:
+    M68K_CACHE_PC = CACHE_READ(M68K_CACHE_A(7), 4);
+    M68K_CACHE_A(7) += 4;
+    return CYCLES;
+
+    #undef CACHE_NEXT
+}
+
+/* RUN A SINGLE BLOCK FROM THE CURRENT PC, OR SINGLE STEP lib68k WHEN THERE */
+/* IS NOTHING CACHED - RETURNS THE CYCLES CONSUMED, ZERO IF THE CPU IS STOPPED */
+
+int M68K_CACHE_STEP(void)
+{
+    M68K_CACHE_BLOCK* BLOCK = CACHE_LOOKUP(M68K_CACHE_PC & 0xFFFFFF);
+    U16 MASK;
+    int STEP;
+
+    if(BLOCK->OP_COUNT == 0)
+    {
+        CACHE_SYNC();
+        MASK = CPU.STATUS_REGISTER & 0x0700;
+        STEP = M68K_EXEC(&CPU, 1);
+        PROFILE_COUNT(PROFILE_M68K_INSTRUCTIONS, 1);
+
+        if(CACHE.RAM_CODE_COUNT)
+            CACHE_CHECK_RAM();
+
+        /* ONLY lib68k EVER WRITES SR - SHOULD IT HAVE MOVED THE INTERRUPT MASK, */
+        /* HAND BACK TO THE SCHEDULER SO THE LEVEL IS CHECKED AGAINST IT AGAIN */
+
+        if((CPU.STATUS_REGISTER & 0x0700) != MASK)
+            CACHE.END_SLICE = true;
+
+        return STEP > 0 ? STEP : 0;
+    }
+
+    PROFILE_COUNT(PROFILE_M68K_INSTRUCTIONS, BLOCK->OP_COUNT);
+    return CACHE_RUN(BLOCK);
+}
+
+/* RUN THE 68K FOR AT LEAST THE GIVEN NUMBER OF CYCLES, RETURNING HOW MANY */
+/* WERE ACTUALLY CONSUMED - A BLOCK IS NEVER SPLIT, SO THIS MAY OVERSHOOT */
+
+/* FLAGS MAY STAY PENDING FROM ONE BLOCK TO THE NEXT, BUT NEVER BEYOND THE SLICE */
+
+int M68K_CACHE_EXEC(int CYCLES)
+{
+    int USED = 0;
+    int STEP;
+
+    M68K_CACHE_ENTER();
+
+    while (USED < CYCLES && !CACHE.END_SLICE)
+    {
+        STEP = M68K_CACHE_STEP();
+
+        /* A STOPPED OR HALTED CPU CONSUMES THE REST OF THE SLICE */
+
+        if(STEP == 0)
+        {
+            M68K_CACHE_LEAVE();
+            return CYCLES;
+        }
+
+        USED += STEP;
+    }
+
+    M68K_CACHE_LEAVE();
+    return USED;
+}
+
+/* HAND OUT THE DECODED BLOCK AT THE GIVEN PC, DECODING IT IF NEED BE */
+
+const M68K_CACHE_BLOCK* M68K_CACHE_DECODE(U32 PC)
+{
+    return CACHE_LOOKUP(PC & 0xFFFFFF);
+}
+
+bool M68K_CACHE_CONDITION(unsigned COND)
+{
+    return CACHE_CONDITION(COND);
+}
+
+void M68K_CACHE_SYNC(void)
+{
+    CACHE_SYNC();
+}
+
+void M68K_CACHE_END_SLICE(bool END)
+{
+    CACHE.END_SLICE = END;
+}
+
+/* BRACKET A SLICE OF EITHER CACHED CORE - ON THE WAY OUT THE PENDING FLAGS */
+/* ARE FOLDED INTO SR, AND ANY FLUSH ASKED FOR MEANWHILE IS CARRIED OUT */
+
+void M68K_CACHE_ENTER(void)
+{
+    CACHE.END_SLICE = false;
+    CACHE.RUNNING = true;
+}
+
+void M68K_CACHE_LEAVE(void)
+{
+    CACHE_SYNC();
+    CACHE.RUNNING = false;
+
+    if(CACHE.FLUSH_PENDING)
+        M68K_CACHE_FLUSH();
+}
+
+//================================================
+//              CACHE MANAGEMENT
+//================================================
+
+void M68K_CACHE_INIT(void)
+{
+    CACHE.BLOCKS = MD_ALLOC(sizeof(M68K_CACHE_BLOCK) * M68K_CACHE_BLOCKS);
+    M68K_CACHE_FLUSH();
+}
+
+/* A BUS WRITE CAN ASK FOR THIS IN THE MIDDLE OF A BLOCK - CLEARING THE BLOCKS */
+/* THEN WOULD LEAVE CACHE_RUN DISPATCHING A ZEROED OP, SO IT ONLY ENDS THE */
+/* SLICE, AND M68K_CACHE_LEAVE FLUSHES ONCE THE BLOCK HAS RETURNED */
+
+void M68K_CACHE_FLUSH(void)
+{
+    if(CACHE.RUNNING)
+    {
+        CACHE.FLUSH_PENDING = true;
+        MD_END_SLICE();
+        return;
+    }
+
+    memset(CACHE.BLOCKS, 0, sizeof(M68K_CACHE_BLOCK) * M68K_CACHE_BLOCKS);
+    memset(CACHE.RAM_CODE_PAGES, 0, sizeof(CACHE.RAM_CODE_PAGES));
+
+    CACHE.RAM_CODE_COUNT = 0;
+    CACHE.RAM_GENERATION = 0;
+    CACHE.FLAGS.KIND = M68K_FLAGS_NONE;
+    CACHE.FLUSH_PENDING = false;
+    CACHE.HITS = 0;
+    CACHE.MISSES = 0;
+
+    memset(&CACHE_UNCACHED, 0, sizeof(CACHE_UNCACHED));
+}
+
+/* A WRITE LANDED ON A PAGE OF WORK RAM HOLDING DECODED CODE */
+/* RETIRE EVERY RAM BLOCK - THEY ARE REBUILT ON THEIR NEXT EXECUTION */
+
+void M68K_CACHE_INVALIDATE(U32 ADDRESS)
+{
+    (void)ADDRESS;
+
+    CACHE.RAM_GENERATION++;
+    CACHE.RAM_CODE_COUNT = 0;
+    memset(CACHE.RAM_CODE_PAGES, 0, sizeof(CACHE.RAM_CODE_PAGES));
+}
+
+const M68K_CACHE* M68K_CACHE_STATE(void)
+{
+    return &CACHE;
+}
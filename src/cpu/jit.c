@@ -0,0 +1,1185 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE X86-64 DYNAMIC RECOMPILER FOR THE 68000 */
+/* SEE jit.h FOR AN OVERVIEW */
+
+#define _DEFAULT_SOURCE
+
+/* NESTED INCLUDES */
+
+#include "jit.h"
+#include "md.h"
+#include "mem.h"
+#include "profile.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if M68K_JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+static M68K_JIT JIT;
+
+static void JIT_RESET(void)
+{
+    if(JIT.ENTRIES != NULL)
+        memset(JIT.ENTRIES, 0, sizeof(M68K_JIT_ENTRY) * M68K_JIT_ENTRIES);
+
+    JIT.CODE_USED = 0;
+    JIT.FLUSH_PENDING = false;
+}
+
+#if M68K_JIT_SUPPORTED
+
+//================================================
+//              X86-64 EMITTER
+//================================================
+
+/* HOST REGISTERS, NUMBERED AS THEY ARE ENCODED */
+
+/* RBX HOLDS THE CPU STRUCTURE, R12 WORK RAM AND R13 THE PAGES OF WORK RAM */
+/* HOLDING CACHED CODE - R14 AND R15 CARRY VALUES ACROSS CALLS INTO C */
+
+enum
+{
+    JIT_RAX, JIT_RCX, JIT_RDX, JIT_RBX, JIT_RSP, JIT_RBP, JIT_RSI, JIT_RDI,
+    JIT_R8, JIT_R9, JIT_R10, JIT_R11, JIT_R12, JIT_R13, JIT_R14, JIT_R15,
+    JIT_NONE = 0xFF,
+};
+
+/* BASE OPCODES OF THE ALU OPERATIONS - THE GROUP ENCODING IS THE OPCODE >> 3 */
+
+#define     JIT_ADD         0x00
+#define     JIT_OR          0x08
+#define     JIT_AND         0x20
+#define     JIT_SUB         0x28
+#define     JIT_XOR         0x30
+#define     JIT_CMP         0x38
+
+#define     JIT_ROL         0
+#define     JIT_SHL         4
+#define     JIT_SHR         5
+
+/* CONDITION CODES, AS USED BY SETCC AND JCC */
+
+#define     JIT_CC_B        0x2
+#define     JIT_CC_NE       0x5
+#define     JIT_CC_A        0x7
+
+#define     JIT_BYTE_REG(R)     ((R) >= JIT_RSP && (R) <= JIT_RDI)
+
+#define     JIT_OFFSET_D(N)     ((S32)(offsetof(CPU_68K, DATA_REGISTER) + (N) * sizeof(U32)))
+#define     JIT_OFFSET_A(N)     ((S32)(offsetof(CPU_68K, ADDRESS_REGISTER) + (N) * sizeof(U32)))
+#define     JIT_OFFSET_SR       ((S32)offsetof(CPU_68K, STATUS_REGISTER))
+
+/* THE HOST CONDITION WHICH MATCHES EACH 68K CONDITION ONCE THE HOST FLAGS */
+/* HOLD THE RESULT OF THE EQUIVALENT OPERATION - TRUE AND FALSE NEVER GET HERE */
+
+static const U8 JIT_CONDITION_CODE[16] =
+{
+    0x0, 0x0, 0x7, 0x6, 0x3, 0x2, 0x5, 0x4,
+    0x1, 0x0, 0x9, 0x8, 0xD, 0xC, 0xF, 0xE,
+};
+
+typedef struct JIT_EMITTER
+{
+    U8* CODE;
+    U8* LIMIT;
+    bool OVERFLOW;
+
+    /* LAZY FLAGS - WHETHER THE HOST FLAGS HOLD THE 68K CONDITION CODES, */
+    /* AND IF SO, WHETHER EXTEND SHOULD FOLLOW CARRY WHEN THEY ARE FOLDED */
+
+    bool FLAGS_LIVE;
+    bool FLAGS_EXTEND;
+
+} JIT_EMITTER;
+
+static void JIT_BYTE(JIT_EMITTER* E, U8 VALUE)
+{
+    if(E->CODE < E->LIMIT)
+        *E->CODE++ = VALUE;
+    else
+        E->OVERFLOW = true;
+}
+
+static void JIT_DWORD(JIT_EMITTER* E, U32 VALUE)
+{
+    JIT_BYTE(E, VALUE);
+    JIT_BYTE(E, VALUE >> 8);
+    JIT_BYTE(E, VALUE >> 16);
+    JIT_BYTE(E, VALUE >> 24);
+}
+
+static void JIT_QWORD(JIT_EMITTER* E, U64 VALUE)
+{
+    JIT_DWORD(E, (U32)VALUE);
+    JIT_DWORD(E, (U32)(VALUE >> 32));
+}
+
+static void JIT_IMMEDIATE(JIT_EMITTER* E, unsigned SIZE, U32 VALUE)
+{
+    JIT_BYTE(E, VALUE);
+
+    if(SIZE >= 2)   JIT_BYTE(E, VALUE >> 8);
+    if(SIZE == 4)
+    {
+        JIT_BYTE(E, VALUE >> 16);
+        JIT_BYTE(E, VALUE >> 24);
+    }
+}
+
+static void JIT_REX(JIT_EMITTER* E, bool W, unsigned REG, unsigned INDEX, unsigned BASE, bool BYTE)
+{
+    U8 REX = 0x40;
+
+    if(W)                                   REX |= 0x08;
+    if(REG & 8)                             REX |= 0x04;
+    if(INDEX != JIT_NONE && (INDEX & 8))    REX |= 0x02;
+    if(BASE & 8)                            REX |= 0x01;
+
+    if(REX != 0x40 || BYTE)
+        JIT_BYTE(E, REX);
+}
+
+static void JIT_OPCODE(JIT_EMITTER* E, unsigned OPCODE)
+{
+    if(OPCODE > 0xFF)
+        JIT_BYTE(E, OPCODE >> 8);
+
+    JIT_BYTE(E, OPCODE);
+}
+
+/* [BASE + INDEX + DISP] */
+
+static void JIT_MEM(JIT_EMITTER* E, bool P66, bool W, bool BYTE, unsigned OPCODE, unsigned REG, unsigned BASE, unsigned INDEX, S32 DISP)
+{
+    unsigned MOD = (DISP == 0 && (BASE & 7) != JIT_RBP) ? 0 : (DISP >= -128 && DISP <= 127) ? 1 : 2;
+
+    if(P66)
+        JIT_BYTE(E, 0x66);
+
+    JIT_REX(E, W, REG, INDEX, BASE, BYTE);
+    JIT_OPCODE(E, OPCODE);
+
+    if(INDEX == JIT_NONE && (BASE & 7) != JIT_RSP)
+    {
+        JIT_BYTE(E, (MOD << 6) | ((REG & 7) << 3) | (BASE & 7));
+    }
+
+    else
+    {
+        JIT_BYTE(E, (MOD << 6) | ((REG & 7) << 3) | 4);
+        JIT_BYTE(E, ((INDEX == JIT_NONE ? 4 : (INDEX & 7)) << 3) | (BASE & 7));
+    }
+
+    if(MOD == 1)        JIT_BYTE(E, (U8)DISP);
+    else if(MOD == 2)   JIT_DWORD(E, (U32)DISP);
+}
+
+static void JIT_RR(JIT_EMITTER* E, bool P66, bool W, bool BYTE, unsigned OPCODE, unsigned REG, unsigned RM)
+{
+    if(P66)
+        JIT_BYTE(E, 0x66);
+
+    JIT_REX(E, W, REG, JIT_NONE, RM, BYTE);
+    JIT_OPCODE(E, OPCODE);
+    JIT_BYTE(E, 0xC0 | ((REG & 7) << 3) | (RM & 7));
+}
+
+/* ZERO EXTENDING LOADS AND PLAIN STORES OF 1, 2, 4 OR 8 BYTES */
+
+static void JIT_LOAD(JIT_EMITTER* E, unsigned SIZE, unsigned DST, unsigned BASE, unsigned INDEX, S32 DISP)
+{
+    switch (SIZE)
+    {
+        case 1:     JIT_MEM(E, false, false, false, 0x0FB6, DST, BASE, INDEX, DISP); break;
+        case 2:     JIT_MEM(E, false, false, false, 0x0FB7, DST, BASE, INDEX, DISP); break;
+        case 4:     JIT_MEM(E, false, false, false, 0x8B, DST, BASE, INDEX, DISP); break;
+        default:    JIT_MEM(E, false, true, false, 0x8B, DST, BASE, INDEX, DISP); break;
+    }
+}
+
+static void JIT_STORE(JIT_EMITTER* E, unsigned SIZE, unsigned SRC, unsigned BASE, unsigned INDEX, S32 DISP)
+{
+    JIT_MEM(E, SIZE == 2, SIZE == 8, SIZE == 1 && JIT_BYTE_REG(SRC), SIZE == 1 ? 0x88 : 0x89, SRC, BASE, INDEX, DISP);
+}
+
+/* OP [BASE], SRC */
+
+static void JIT_ALU_MEM(JIT_EMITTER* E, unsigned OP, unsigned SIZE, unsigned BASE, S32 DISP, unsigned SRC)
+{
+    JIT_MEM(E, SIZE == 2, false, SIZE == 1 && JIT_BYTE_REG(SRC), OP + (SIZE == 1 ? 0 : 1), SRC, BASE, JIT_NONE, DISP);
+}
+
+/* OP [BASE], IMM */
+
+static void JIT_ALU_MEM_IMM(JIT_EMITTER* E, unsigned OP, unsigned SIZE, unsigned BASE, S32 DISP, U32 IMM)
+{
+    JIT_MEM(E, SIZE == 2, false, false, SIZE == 1 ? 0x80 : 0x81, OP >> 3, BASE, JIT_NONE, DISP);
+    JIT_IMMEDIATE(E, SIZE, IMM);
+}
+
+/* OP DST, IMM32 */
+
+static void JIT_ALU_IMM(JIT_EMITTER* E, unsigned OP, unsigned DST, U32 IMM)
+{
+    JIT_RR(E, false, false, false, 0x81, OP >> 3, DST);
+    JIT_DWORD(E, IMM);
+}
+
+static void JIT_SHIFT(JIT_EMITTER* E, unsigned KIND, unsigned SIZE, unsigned REG, U8 COUNT)
+{
+    JIT_RR(E, SIZE == 2, false, false, 0xC1, KIND, REG);
+    JIT_BYTE(E, COUNT);
+}
+
+static void JIT_TEST(JIT_EMITTER* E, unsigned SIZE, unsigned REG)
+{
+    JIT_RR(E, SIZE == 2, false, SIZE == 1 && JIT_BYTE_REG(REG), SIZE == 1 ? 0x84 : 0x85, REG, REG);
+}
+
+static void JIT_MOV(JIT_EMITTER* E, unsigned DST, unsigned SRC)
+{
+    JIT_RR(E, false, false, false, 0x89, SRC, DST);
+}
+
+static void JIT_MOV_IMM(JIT_EMITTER* E, unsigned DST, U32 IMM)
+{
+    JIT_REX(E, false, 0, JIT_NONE, DST, false);
+    JIT_BYTE(E, 0xB8 + (DST & 7));
+    JIT_DWORD(E, IMM);
+}
+
+static void JIT_MOV_IMM64(JIT_EMITTER* E, unsigned DST, U64 IMM)
+{
+    JIT_REX(E, true, 0, JIT_NONE, DST, false);
+    JIT_BYTE(E, 0xB8 + (DST & 7));
+    JIT_QWORD(E, IMM);
+}
+
+static void JIT_SETCC(JIT_EMITTER* E, unsigned CC, unsigned REG)
+{
+    JIT_REX(E, false, 0, JIT_NONE, REG, JIT_BYTE_REG(REG));
+    JIT_BYTE(E, 0x0F);
+    JIT_BYTE(E, 0x90 + CC);
+    JIT_BYTE(E, 0xC0 | (REG & 7));
+}
+
+static void JIT_PUSH(JIT_EMITTER* E, unsigned REG)
+{
+    JIT_REX(E, false, 0, JIT_NONE, REG, false);
+    JIT_BYTE(E, 0x50 + (REG & 7));
+}
+
+static void JIT_POP(JIT_EMITTER* E, unsigned REG)
+{
+    JIT_REX(E, false, 0, JIT_NONE, REG, false);
+    JIT_BYTE(E, 0x58 + (REG & 7));
+}
+
+static void JIT_CALL(JIT_EMITTER* E, const void* TARGET)
+{
+    JIT_MOV_IMM64(E, JIT_RAX, (U64)(uintptr_t)TARGET);
+    JIT_BYTE(E, 0xFF);
+    JIT_BYTE(E, 0xD0);
+}
+
+/* FORWARD BRANCHES ARE EMITTED WITH AN EMPTY DISPLACEMENT, WHICH IS */
+/* PATCHED ONCE THE DESTINATION IS KNOWN */
+
+static U8* JIT_JCC(JIT_EMITTER* E, unsigned CC)
+{
+    JIT_BYTE(E, 0x0F);
+    JIT_BYTE(E, 0x80 + CC);
+    JIT_DWORD(E, 0);
+    return E->CODE - 4;
+}
+
+static U8* JIT_JMP(JIT_EMITTER* E)
+{
+    JIT_BYTE(E, 0xE9);
+    JIT_DWORD(E, 0);
+    return E->CODE - 4;
+}
+
+static void JIT_PATCH(JIT_EMITTER* E, U8* AT)
+{
+    S32 REL = (S32)(E->CODE - (AT + 4));
+
+    if(!E->OVERFLOW)
+        memcpy(AT, &REL, sizeof(REL));
+}
+
+//================================================
+//              68K STATE ACCESS
+//================================================
+
+/* THE REGISTER FILE SITS AT THE HEAD OF CPU_68K, SO EVERY ACCESS IS A */
+/* SINGLE DISPLACEMENT OFF OF RBX */
+
+static void JIT_LOAD_REG(JIT_EMITTER* E, unsigned SIZE, unsigned DST, S32 OFFSET)
+{
+    JIT_LOAD(E, SIZE, DST, JIT_RBX, JIT_NONE, OFFSET);
+}
+
+static void JIT_STORE_REG(JIT_EMITTER* E, unsigned SIZE, S32 OFFSET, unsigned SRC)
+{
+    JIT_STORE(E, SIZE, SRC, JIT_RBX, JIT_NONE, OFFSET);
+}
+
+/* FOLD THE HOST FLAGS BACK INTO THE CONDITION CODES OF THE STATUS REGISTER */
+/* CARRY SITS AT BIT 0, ZERO AT 6, SIGN AT 7 AND OVERFLOW AT 11 OF RFLAGS */
+
+static void JIT_FLUSH_FLAGS(JIT_EMITTER* E)
+{
+    U32 MASK = E->FLAGS_EXTEND ? 0x1F : 0x0F;
+
+    if(!E->FLAGS_LIVE)
+        return;
+
+    JIT_BYTE(E, 0x9C);
+    JIT_POP(E, JIT_RAX);
+
+    JIT_MOV(E, JIT_RCX, JIT_RAX);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RCX, M68K_CCR_C);
+
+    JIT_MOV(E, JIT_RDX, JIT_RAX);
+    JIT_SHIFT(E, JIT_SHR, 4, JIT_RDX, 10);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RDX, M68K_CCR_V);
+    JIT_RR(E, false, false, false, JIT_OR + 1, JIT_RDX, JIT_RCX);
+
+    JIT_MOV(E, JIT_RDX, JIT_RAX);
+    JIT_SHIFT(E, JIT_SHR, 4, JIT_RDX, 4);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RDX, M68K_CCR_Z | M68K_CCR_N);
+    JIT_RR(E, false, false, false, JIT_OR + 1, JIT_RDX, JIT_RCX);
+
+    if(E->FLAGS_EXTEND)
+    {
+        JIT_MOV(E, JIT_RDX, JIT_RAX);
+        JIT_ALU_IMM(E, JIT_AND, JIT_RDX, 1);
+        JIT_SHIFT(E, JIT_SHL, 4, JIT_RDX, 4);
+        JIT_RR(E, false, false, false, JIT_OR + 1, JIT_RDX, JIT_RCX);
+    }
+
+    JIT_LOAD(E, 2, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_SR);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RAX, ~MASK);
+    JIT_RR(E, false, false, false, JIT_OR + 1, JIT_RCX, JIT_RAX);
+    JIT_STORE(E, 2, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_SR);
+
+    E->FLAGS_LIVE = false;
+}
+
+static void JIT_SET_FLAGS(JIT_EMITTER* E, bool EXTEND)
+{
+    E->FLAGS_LIVE = true;
+    E->FLAGS_EXTEND = EXTEND;
+}
+
+//================================================
+//              MEMORY ACCESS
+//================================================
+
+static U32 JIT_READ_8(U32 ADDRESS)     { return M68K_READ_8(ADDRESS) & 0xFF; }
+static U32 JIT_READ_16(U32 ADDRESS)    { return M68K_READ_16(ADDRESS) & 0xFFFF; }
+static U32 JIT_READ_32(U32 ADDRESS)    { return M68K_READ_32(ADDRESS); }
+
+static void JIT_WRITE(U32 ADDRESS, U32 DATA, unsigned SIZE)
+{
+    switch (SIZE)
+    {
+        case 1:     M68K_WRITE_8(ADDRESS, DATA & 0xFF); break;
+        case 2:     M68K_WRITE_16(ADDRESS, DATA & 0xFFFF); break;
+        default:    M68K_WRITE_32(ADDRESS, DATA); break;
+    }
+
+    if((ADDRESS & 0xFFFFFF) >= M68K_CACHE_RAM_START)
+    {
+        M68K_CACHE_WATCH_WRITE(M68K_CACHE_STATE(), ADDRESS);
+
+        if(SIZE == 4)
+            M68K_CACHE_WATCH_WRITE(M68K_CACHE_STATE(), ADDRESS + 2);
+    }
+}
+
+static void JIT_WRITE_8(U32 ADDRESS, U32 DATA)     { JIT_WRITE(ADDRESS, DATA, 1); }
+static void JIT_WRITE_16(U32 ADDRESS, U32 DATA)    { JIT_WRITE(ADDRESS, DATA, 2); }
+static void JIT_WRITE_32(U32 ADDRESS, U32 DATA)    { JIT_WRITE(ADDRESS, DATA, 4); }
+
+static U32 JIT_CONDITION(U32 COND)
+{
+    return M68K_CACHE_CONDITION(COND);
+}
+
+/* BRANCH TO SLOW IF THE ADDRESS IN EDI ISN'T WITHIN WORK RAM, LEAVING */
+/* THE OFFSET INTO WORK RAM IN EAX OTHERWISE - WORK RAM IS IN HOST WORD */
+/* ORDER (SEE mem.h), SO A WORD IS LOADED AS IT IS, A LONG HAS IT'S HALVES */
+/* ROTATED AND A BYTE FLIPS THE BOTTOM BIT OF IT'S OFFSET */
+
+static void JIT_RAM_CHECK(JIT_EMITTER* E, unsigned SIZE, U8** SLOW)
+{
+    JIT_MOV(E, JIT_RAX, JIT_RDI);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RAX, 0xFFFFFF);
+    JIT_ALU_IMM(E, JIT_CMP, JIT_RAX, M68K_CACHE_RAM_START);
+    SLOW[0] = JIT_JCC(E, JIT_CC_B);
+    JIT_ALU_IMM(E, JIT_AND, JIT_RAX, 0xFFFF);
+
+    /* ACCESSES WHICH WOULD RUN OFF THE END OF WORK RAM TAKE THE SLOW PATH */
+
+    if(SIZE > 1)
+    {
+        JIT_ALU_IMM(E, JIT_CMP, JIT_RAX, 0x10000 - SIZE);
+        SLOW[1] = JIT_JCC(E, JIT_CC_A);
+    }
+
+    else
+    {
+        JIT_ALU_IMM(E, JIT_XOR, JIT_RAX, MD_BYTE_XOR);
+    }
+}
+
+/* READ FROM THE ADDRESS IN EDI INTO EAX - WORK RAM IS READ INLINE, */
+/* EVERYTHING ELSE GOES THROUGH THE MEMORY MAP */
+
+static void JIT_EMIT_READ(JIT_EMITTER* E, unsigned SIZE)
+{
+    static const void* const READ[] = { NULL, JIT_READ_8, JIT_READ_16, NULL, JIT_READ_32 };
+
+    U8* SLOW[2] = { NULL, NULL };
+    U8* DONE;
+
+    JIT_RAM_CHECK(E, SIZE, SLOW);
+    JIT_LOAD(E, SIZE, JIT_RAX, JIT_R12, JIT_RAX, 0);
+
+    if(SIZE == 4)   JIT_SHIFT(E, JIT_ROL, 4, JIT_RAX, 16);
+
+    DONE = JIT_JMP(E);
+
+    JIT_PATCH(E, SLOW[0]);
+    if(SLOW[1]) JIT_PATCH(E, SLOW[1]);
+
+    JIT_CALL(E, READ[SIZE]);
+    JIT_PATCH(E, DONE);
+}
+
+/* WRITE ESI TO THE ADDRESS IN EDI - WORK RAM IS WRITTEN INLINE UNLESS THE */
+/* PAGE HOLDS CACHED CODE, WHICH THE SLOW PATH WILL INVALIDATE */
+
+static void JIT_EMIT_WRITE(JIT_EMITTER* E, unsigned SIZE)
+{
+    static const void* const WRITE[] = { NULL, JIT_WRITE_8, JIT_WRITE_16, NULL, JIT_WRITE_32 };
+
+    U8* SLOW[4] = { NULL, NULL, NULL, NULL };
+    U8* DONE;
+    int INDEX;
+
+    JIT_RAM_CHECK(E, SIZE, SLOW);
+
+    JIT_MOV(E, JIT_RCX, JIT_RAX);
+    JIT_SHIFT(E, JIT_SHR, 4, JIT_RCX, M68K_CACHE_PAGE_SHIFT);
+    JIT_MEM(E, false, false, false, 0x80, JIT_CMP >> 3, JIT_R13, JIT_RCX, 0);
+    JIT_BYTE(E, 0);
+    SLOW[2] = JIT_JCC(E, JIT_CC_NE);
+
+    if(SIZE == 4)
+    {
+        JIT_MEM(E, false, false, false, 0x8D, JIT_RCX, JIT_RAX, JIT_NONE, 3);
+        JIT_SHIFT(E, JIT_SHR, 4, JIT_RCX, M68K_CACHE_PAGE_SHIFT);
+        JIT_MEM(E, false, false, false, 0x80, JIT_CMP >> 3, JIT_R13, JIT_RCX, 0);
+        JIT_BYTE(E, 0);
+        SLOW[3] = JIT_JCC(E, JIT_CC_NE);
+    }
+
+    JIT_MOV(E, JIT_RCX, JIT_RSI);
+
+    if(SIZE == 4)   JIT_SHIFT(E, JIT_ROL, 4, JIT_RCX, 16);
+
+    JIT_STORE(E, SIZE, JIT_RCX, JIT_R12, JIT_RAX, 0);
+    DONE = JIT_JMP(E);
+
+    for (INDEX = 0; INDEX < 4; INDEX++)
+    {
+        if(SLOW[INDEX])
+            JIT_PATCH(E, SLOW[INDEX]);
+    }
+
+    JIT_CALL(E, WRITE[SIZE]);
+    JIT_PATCH(E, DONE);
+}
+
+//================================================
+//              EFFECTIVE ADDRESSES
+//================================================
+
+static bool JIT_EA_MEMORY(const M68K_CACHE_EA* EA)
+{
+    return EA->MODE != M68K_EA_DN && EA->MODE != M68K_EA_AN && EA->MODE != M68K_EA_IMM;
+}
+
+/* CARTRIDGE ROM AT A FIXED ADDRESS CAN BE READ ONCE, AT COMPILE TIME */
+
+static bool JIT_EA_FOLDABLE(const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    const MD_CART* CART = MD_GET_CONSOLE()->MD_CART;
+
+    return EA->MODE == M68K_EA_ABS && EA->EXT < M68K_JIT_FOLD_END &&
+           EA->EXT + SIZE <= M68K_JIT_FOLD_END && EA->EXT + SIZE <= CART->ROM_SIZE;
+}
+
+static bool JIT_OP_MEMORY(const M68K_CACHE_OP* OP)
+{
+    switch (OP->KIND)
+    {
+        case M68K_OP_LEA:
+        case M68K_OP_JMP:
+            return false;
+
+        case M68K_OP_BSR:
+        case M68K_OP_JSR:
+        case M68K_OP_RTS:
+            return true;
+
+        default:
+            return (JIT_EA_MEMORY(&OP->SRC) && !JIT_EA_FOLDABLE(&OP->SRC, OP->SIZE)) || JIT_EA_MEMORY(&OP->DST);
+    }
+}
+
+/* OPERATIONS WHICH SET THE CONDITION CODES BUT LEAVE EXTEND ALONE */
+
+static bool JIT_OP_KEEPS_EXTEND(const M68K_CACHE_OP* OP)
+{
+    switch (OP->KIND)
+    {
+        case M68K_OP_MOVEQ:
+        case M68K_OP_MOVE_RR:
+        case M68K_OP_MOVE:
+        case M68K_OP_CLR:
+        case M68K_OP_TST:
+        case M68K_OP_CMP:
+        case M68K_OP_AND:
+        case M68K_OP_OR:
+        case M68K_OP_CMPA:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* RESOLVE A MEMORY OPERAND'S ADDRESS INTO EDI, STEPPING ANY ADDRESS REGISTER */
+
+static void JIT_EMIT_ADDRESS(JIT_EMITTER* E, const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    U32 STEP = (SIZE == 1 && EA->REG == 7) ? 2 : SIZE;
+
+    switch (EA->MODE)
+    {
+        case M68K_EA_IND:
+            JIT_LOAD_REG(E, 4, JIT_RDI, JIT_OFFSET_A(EA->REG));
+            break;
+
+        case M68K_EA_POST:
+            JIT_LOAD_REG(E, 4, JIT_RDI, JIT_OFFSET_A(EA->REG));
+            JIT_ALU_MEM_IMM(E, JIT_ADD, 4, JIT_RBX, JIT_OFFSET_A(EA->REG), STEP);
+            break;
+
+        case M68K_EA_PRE:
+            JIT_ALU_MEM_IMM(E, JIT_SUB, 4, JIT_RBX, JIT_OFFSET_A(EA->REG), STEP);
+            JIT_LOAD(E, 4, JIT_RDI, JIT_RBX, JIT_NONE, JIT_OFFSET_A(EA->REG));
+            break;
+
+        case M68K_EA_DISP:
+            JIT_LOAD_REG(E, 4, JIT_RDI, JIT_OFFSET_A(EA->REG));
+            JIT_MEM(E, false, false, false, 0x8D, JIT_RDI, JIT_RDI, JIT_NONE, (S32)EA->EXT);
+            break;
+
+        default:
+            JIT_MOV_IMM(E, JIT_RDI, EA->EXT);
+            break;
+    }
+}
+
+/* LOAD A SOURCE OPERAND, ZERO EXTENDED, INTO R15D */
+
+static void JIT_EMIT_SOURCE(JIT_EMITTER* E, const M68K_CACHE_EA* EA, unsigned SIZE)
+{
+    switch (EA->MODE)
+    {
+        case M68K_EA_DN:
+            JIT_LOAD_REG(E, SIZE, JIT_R15, JIT_OFFSET_D(EA->REG));
+            return;
+
+        case M68K_EA_AN:
+            JIT_LOAD_REG(E, SIZE, JIT_R15, JIT_OFFSET_A(EA->REG));
+            return;
+
+        case M68K_EA_IMM:
+            JIT_MOV_IMM(E, JIT_R15, EA->EXT);
+            return;
+
+        default:
+            break;
+    }
+
+    if(JIT_EA_FOLDABLE(EA, SIZE))
+    {
+        JIT_MOV_IMM(E, JIT_R15, SIZE == 1 ? JIT_READ_8(EA->EXT) : SIZE == 2 ? JIT_READ_16(EA->EXT) : JIT_READ_32(EA->EXT));
+        return;
+    }
+
+    JIT_EMIT_ADDRESS(E, EA, SIZE);
+    JIT_EMIT_READ(E, SIZE);
+    JIT_MOV(E, JIT_R15, JIT_RAX);
+}
+
+static void JIT_SIGN_EXTEND(JIT_EMITTER* E, unsigned SIZE, unsigned REG)
+{
+    if(SIZE == 2)
+        JIT_RR(E, false, false, false, 0x0FBF, REG, REG);
+}
+
+//================================================
+//              BLOCK EXITS
+//================================================
+
+static void JIT_EPILOGUE(JIT_EMITTER* E)
+{
+    JIT_POP(E, JIT_R15);
+    JIT_POP(E, JIT_R14);
+    JIT_POP(E, JIT_R13);
+    JIT_POP(E, JIT_R12);
+    JIT_POP(E, JIT_RBX);
+    JIT_BYTE(E, 0xC3);
+}
+
+static void JIT_EXIT(JIT_EMITTER* E, U32 PC, U32 CYCLES)
+{
+    JIT_MOV_IMM64(E, JIT_RAX, ((U64)CYCLES << 32) | PC);
+    JIT_EPILOGUE(E);
+}
+
+static void JIT_EXIT_DYNAMIC(JIT_EMITTER* E, unsigned REG, U32 CYCLES)
+{
+    JIT_MOV(E, JIT_RAX, REG);
+    JIT_MOV_IMM64(E, JIT_RDX, (U64)CYCLES << 32);
+    JIT_RR(E, false, true, false, JIT_OR + 1, JIT_RDX, JIT_RAX);
+    JIT_EPILOGUE(E);
+}
+
+/* EVALUATE A CONDITION INTO R15B - STRAIGHT FROM THE HOST FLAGS WHEN THEY ARE */
+/* LIVE, OTHERWISE FROM THE STATUS REGISTER - LEAVING THE FLAGS FOLDED */
+
+static void JIT_EMIT_CONDITION(JIT_EMITTER* E, unsigned COND)
+{
+    if(COND == CONDITION_TRUE || COND == CONDITION_FALSE)
+    {
+        JIT_MOV_IMM(E, JIT_R15, COND == CONDITION_TRUE);
+    }
+
+    else if(E->FLAGS_LIVE)
+    {
+        JIT_SETCC(E, JIT_CONDITION_CODE[COND], JIT_R15);
+    }
+
+    else
+    {
+        JIT_MOV_IMM(E, JIT_RDI, COND);
+        JIT_CALL(E, JIT_CONDITION);
+        JIT_MOV(E, JIT_R15, JIT_RAX);
+    }
+
+    JIT_FLUSH_FLAGS(E);
+    JIT_TEST(E, 1, JIT_R15);
+}
+
+static void JIT_EMIT_PUSH_PC(JIT_EMITTER* E, U32 PC)
+{
+    JIT_ALU_MEM_IMM(E, JIT_SUB, 4, JIT_RBX, JIT_OFFSET_A(7), 4);
+    JIT_LOAD(E, 4, JIT_RDI, JIT_RBX, JIT_NONE, JIT_OFFSET_A(7));
+    JIT_MOV_IMM(E, JIT_RSI, PC);
+    JIT_EMIT_WRITE(E, 4);
+}
+
+//================================================
+//              OPERATIONS
+//================================================
+
+/* EMIT A SINGLE DECODED OPERATION - CYCLES IS THE COST OF THE BLOCK UP TO */
+/* AND INCLUDING IT, WHICH TERMINATORS FOLD INTO THEIR EXITS */
+
+static void JIT_EMIT_OP(JIT_EMITTER* E, const M68K_CACHE_OP* OP, U32 CYCLES)
+{
+    static const U8 ALU[M68K_OP_COUNT] =
+    {
+        [M68K_OP_ADD] = JIT_ADD, [M68K_OP_SUB] = JIT_SUB, [M68K_OP_CMP] = JIT_CMP,
+        [M68K_OP_AND] = JIT_AND, [M68K_OP_OR] = JIT_OR,
+    };
+
+    U8* BRANCH;
+
+    /* ANYTHING TOUCHING MEMORY MAY CALL INTO C, SO THE FLAGS ARE FOLDED FIRST */
+
+    /* AS WILL ANY PENDING CARRY WHICH EXTEND IS STILL WAITING ON */
+
+    if(JIT_OP_MEMORY(OP) || (E->FLAGS_EXTEND && JIT_OP_KEEPS_EXTEND(OP)))
+        JIT_FLUSH_FLAGS(E);
+
+    switch (OP->KIND)
+    {
+        case M68K_OP_NOP:
+            break;
+
+        case M68K_OP_MOVEQ:
+            JIT_MOV_IMM(E, JIT_R15, OP->SRC.EXT);
+            JIT_STORE_REG(E, 4, JIT_OFFSET_D(OP->DST.REG), JIT_R15);
+            JIT_TEST(E, 4, JIT_R15);
+            JIT_SET_FLAGS(E, false);
+            break;
+
+        case M68K_OP_MOVE_RR:
+        case M68K_OP_MOVE:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+
+            if(OP->DST.MODE == M68K_EA_DN)
+            {
+                JIT_STORE_REG(E, OP->SIZE, JIT_OFFSET_D(OP->DST.REG), JIT_R15);
+            }
+
+            else
+            {
+                JIT_EMIT_ADDRESS(E, &OP->DST, OP->SIZE);
+                JIT_MOV(E, JIT_RSI, JIT_R15);
+                JIT_EMIT_WRITE(E, OP->SIZE);
+            }
+
+            JIT_TEST(E, OP->SIZE, JIT_R15);
+            JIT_SET_FLAGS(E, false);
+            break;
+
+        case M68K_OP_MOVEA:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+            JIT_SIGN_EXTEND(E, OP->SIZE, JIT_R15);
+            JIT_STORE_REG(E, 4, JIT_OFFSET_A(OP->DST.REG), JIT_R15);
+            break;
+
+        case M68K_OP_LEA:
+            JIT_EMIT_ADDRESS(E, &OP->SRC, 4);
+            JIT_STORE_REG(E, 4, JIT_OFFSET_A(OP->DST.REG), JIT_RDI);
+            break;
+
+        case M68K_OP_CLR:
+            if(OP->DST.MODE == M68K_EA_DN)
+            {
+                JIT_MEM(E, OP->SIZE == 2, false, false, OP->SIZE == 1 ? 0xC6 : 0xC7, 0, JIT_RBX, JIT_NONE, JIT_OFFSET_D(OP->DST.REG));
+                JIT_IMMEDIATE(E, OP->SIZE, 0);
+            }
+
+            else
+            {
+                JIT_EMIT_ADDRESS(E, &OP->DST, OP->SIZE);
+                JIT_MOV_IMM(E, JIT_RSI, 0);
+                JIT_EMIT_WRITE(E, OP->SIZE);
+            }
+
+            /* XOR LEAVES ZERO SET, AND SIGN, CARRY AND OVERFLOW CLEAR */
+
+            JIT_RR(E, false, false, false, 0x31, JIT_RAX, JIT_RAX);
+            JIT_SET_FLAGS(E, false);
+            break;
+
+        case M68K_OP_TST:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+            JIT_TEST(E, OP->SIZE, JIT_R15);
+            JIT_SET_FLAGS(E, false);
+            break;
+
+        case M68K_OP_ADDQ:
+        case M68K_OP_SUBQ:
+            if(OP->DST.MODE == M68K_EA_DN)
+            {
+                JIT_ALU_MEM_IMM(E, OP->KIND == M68K_OP_ADDQ ? JIT_ADD : JIT_SUB, OP->SIZE, JIT_RBX, JIT_OFFSET_D(OP->DST.REG), OP->SRC.EXT);
+                JIT_SET_FLAGS(E, true);
+                break;
+            }
+
+            /* THE RESULT IS COMPUTED IN R15, AND THE FLAGS FOLDED BEFORE IT */
+            /* IS WRITTEN BACK, AS THE WRITE MAY CALL INTO C */
+
+            JIT_EMIT_ADDRESS(E, &OP->DST, OP->SIZE);
+            JIT_MOV(E, JIT_R14, JIT_RDI);
+            JIT_EMIT_READ(E, OP->SIZE);
+            JIT_MOV(E, JIT_R15, JIT_RAX);
+            JIT_RR(E, OP->SIZE == 2, false, false, OP->SIZE == 1 ? 0x80 : 0x81, (OP->KIND == M68K_OP_ADDQ ? JIT_ADD : JIT_SUB) >> 3, JIT_R15);
+            JIT_IMMEDIATE(E, OP->SIZE, OP->SRC.EXT);
+            JIT_SET_FLAGS(E, true);
+            JIT_FLUSH_FLAGS(E);
+
+            JIT_MOV(E, JIT_RDI, JIT_R14);
+            JIT_MOV(E, JIT_RSI, JIT_R15);
+            JIT_EMIT_WRITE(E, OP->SIZE);
+            break;
+
+        case M68K_OP_ADDQ_A:
+            JIT_LOAD(E, 4, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_A(OP->DST.REG));
+            JIT_MEM(E, false, false, false, 0x8D, JIT_RAX, JIT_RAX, JIT_NONE, (S32)OP->SRC.EXT);
+            JIT_STORE(E, 4, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_A(OP->DST.REG));
+            break;
+
+        /* THE HOST'S ADD, SUB, CMP, AND AND OR AT THE SAME WIDTH PRODUCE */
+        /* EXACTLY THE 68K'S CONDITION CODES */
+
+        case M68K_OP_ADD:
+        case M68K_OP_SUB:
+        case M68K_OP_CMP:
+        case M68K_OP_AND:
+        case M68K_OP_OR:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+            JIT_ALU_MEM(E, ALU[OP->KIND], OP->SIZE, JIT_RBX, JIT_OFFSET_D(OP->DST.REG), JIT_R15);
+            JIT_SET_FLAGS(E, OP->KIND == M68K_OP_ADD || OP->KIND == M68K_OP_SUB);
+            break;
+
+        /* ADDRESS ARITHMETIC LEAVES THE FLAGS ALONE, SO IS DONE WITH LEA */
+
+        case M68K_OP_ADDA:
+        case M68K_OP_SUBA:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+            JIT_SIGN_EXTEND(E, OP->SIZE, JIT_R15);
+            JIT_LOAD(E, 4, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_A(OP->DST.REG));
+
+            if(OP->KIND == M68K_OP_ADDA)
+            {
+                JIT_MEM(E, false, false, false, 0x8D, JIT_RAX, JIT_RAX, JIT_R15, 0);
+            }
+
+            else
+            {
+                JIT_RR(E, false, false, false, 0xF7, 2, JIT_R15);
+                JIT_MEM(E, false, false, false, 0x8D, JIT_RAX, JIT_RAX, JIT_R15, 1);
+            }
+
+            JIT_STORE(E, 4, JIT_RAX, JIT_RBX, JIT_NONE, JIT_OFFSET_A(OP->DST.REG));
+            break;
+
+        case M68K_OP_CMPA:
+            JIT_EMIT_SOURCE(E, &OP->SRC, OP->SIZE);
+            JIT_SIGN_EXTEND(E, OP->SIZE, JIT_R15);
+            JIT_ALU_MEM(E, JIT_CMP, 4, JIT_RBX, JIT_OFFSET_A(OP->DST.REG), JIT_R15);
+            JIT_SET_FLAGS(E, false);
+            break;
+
+        case M68K_OP_BCC:
+            if(OP->COND == CONDITION_TRUE)
+            {
+                JIT_FLUSH_FLAGS(E);
+                JIT_EXIT(E, OP->DST.EXT, CYCLES);
+                break;
+            }
+
+            JIT_EMIT_CONDITION(E, OP->COND);
+            BRANCH = JIT_JCC(E, JIT_CC_NE);
+            JIT_EXIT(E, OP->NEXT_PC, CYCLES);
+            JIT_PATCH(E, BRANCH);
+            JIT_EXIT(E, OP->DST.EXT, CYCLES + 10 - OP->CYCLES);
+            break;
+
+        case M68K_OP_BSR:
+            JIT_EMIT_PUSH_PC(E, OP->NEXT_PC);
+            JIT_EXIT(E, OP->DST.EXT, CYCLES);
+            break;
+
+        /* THE COUNTER HAS EXPIRED WHEN DECREMENTING IT BORROWS */
+
+        case M68K_OP_DBCC:
+            if(OP->COND != CONDITION_FALSE)
+            {
+                JIT_EMIT_CONDITION(E, OP->COND);
+                BRANCH = JIT_JCC(E, 0x4);
+                JIT_EXIT(E, OP->NEXT_PC, CYCLES + 2);
+                JIT_PATCH(E, BRANCH);
+            }
+
+            else
+            {
+                JIT_FLUSH_FLAGS(E);
+            }
+
+            JIT_ALU_MEM_IMM(E, JIT_SUB, 2, JIT_RBX, JIT_OFFSET_D(OP->DST.REG), 1);
+            BRANCH = JIT_JCC(E, JIT_CC_B);
+            JIT_EXIT(E, OP->SRC.EXT, CYCLES);
+            JIT_PATCH(E, BRANCH);
+            JIT_EXIT(E, OP->NEXT_PC, CYCLES + 4);
+            break;
+
+        case M68K_OP_JMP:
+            JIT_EMIT_ADDRESS(E, &OP->DST, 4);
+            JIT_MOV(E, JIT_R15, JIT_RDI);
+            JIT_FLUSH_FLAGS(E);
+            JIT_EXIT_DYNAMIC(E, JIT_R15, CYCLES);
+            break;
+
+        case M68K_OP_JSR:
+            JIT_EMIT_ADDRESS(E, &OP->DST, 4);
+            JIT_MOV(E, JIT_R15, JIT_RDI);
+            JIT_EMIT_PUSH_PC(E, OP->NEXT_PC);
+            JIT_EXIT_DYNAMIC(E, JIT_R15, CYCLES);
+            break;
+
+        case M68K_OP_RTS:
+            JIT_LOAD(E, 4, JIT_RDI, JIT_RBX, JIT_NONE, JIT_OFFSET_A(7));
+            JIT_ALU_MEM_IMM(E, JIT_ADD, 4, JIT_RBX, JIT_OFFSET_A(7), 4);
+            JIT_EMIT_READ(E, 4);
+            JIT_EXIT_DYNAMIC(E, JIT_RAX, CYCLES);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* TRANSLATE THE DECODED BLOCK AT PC, RETURNING NULL IF THERE IS NOTHING TO */
+/* COMPILE - RUNNING OUT OF ROOM FLUSHES EVERY COMPILED BLOCK AND STARTS AFRESH */
+
+static M68K_JIT_CODE JIT_COMPILE(U32 PC, U16* OP_COUNT)
+{
+    const M68K_CACHE_BLOCK* BLOCK = M68K_CACHE_DECODE(PC);
+    JIT_EMITTER E;
+    U8* START;
+    U32 CYCLES = 0;
+    unsigned INDEX;
+
+    *OP_COUNT = 0;
+
+    if(BLOCK->OP_COUNT == 0)
+        return NULL;
+
+    if(JIT.CODE_USED + M68K_JIT_BLOCK_MAX_BYTES > M68K_JIT_CODE_SIZE)
+    {
+        JIT_RESET();
+        JIT.FLUSHES++;
+    }
+
+    START = JIT.CODE_BASE + JIT.CODE_USED;
+
+    E.CODE = START;
+    E.LIMIT = START + M68K_JIT_BLOCK_MAX_BYTES;
+    E.OVERFLOW = false;
+    E.FLAGS_LIVE = false;
+    E.FLAGS_EXTEND = false;
+
+    /* THE CALLEE SAVED REGISTERS ALSO LEAVE THE STACK ALIGNED FOR CALLS */
+
+    JIT_PUSH(&E, JIT_RBX);
+    JIT_PUSH(&E, JIT_R12);
+    JIT_PUSH(&E, JIT_R13);
+    JIT_PUSH(&E, JIT_R14);
+    JIT_PUSH(&E, JIT_R15);
+    JIT_RR(&E, false, true, false, 0x89, JIT_RDI, JIT_RBX);
+    JIT_MOV_IMM64(&E, JIT_R12, (U64)(uintptr_t)MD_GET_WORK_RAM());
+    JIT_MOV_IMM64(&E, JIT_R13, (U64)(uintptr_t)M68K_CACHE_STATE()->RAM_CODE_PAGES);
+
+    for (INDEX = 0; INDEX < BLOCK->OP_COUNT; INDEX++)
+    {
+        CYCLES += BLOCK->OPS[INDEX].CYCLES;
+        JIT_EMIT_OP(&E, &BLOCK->OPS[INDEX], CYCLES);
+    }
+
+    /* BLOCKS WHICH DON'T END IN A BRANCH FALL THROUGH TO THE NEXT */
+
+    if(BLOCK->OPS[BLOCK->OP_COUNT].KIND == M68K_OP_END)
+    {
+        JIT_FLUSH_FLAGS(&E);
+        JIT_EXIT(&E, BLOCK->OPS[BLOCK->OP_COUNT].NEXT_PC, CYCLES);
+    }
+
+    if(E.OVERFLOW)
+        return NULL;
+
+    JIT.CODE_USED += (UNK)(E.CODE - START);
+    JIT.CODE_USED = (JIT.CODE_USED + 15) & ~(UNK)15;
+    JIT.COMPILED++;
+
+    *OP_COUNT = BLOCK->OP_COUNT;
+    return (M68K_JIT_CODE)(void*)START;
+}
+
+/* THE CARTRIDGE'S BANK REGISTERS DECIDE WHAT SITS BEHIND A ROM ADDRESS */
+
+static U32 JIT_BANK_KEY(void)
+{
+    const MD_CART* CART = MD_GET_CONSOLE()->MD_CART;
+
+    return (CART->CARTRIDGE_BANKS[0] & 0xFF) | ((CART->CARTRIDGE_BANKS[1] & 0xFF) << 8) |
+           ((CART->CARTRIDGE_BANKS[2] & 0xFF) << 16) | ((CART->CARTRIDGE_BANKS[3] & 0xFF) << 24);
+}
+
+//================================================
+//              EXECUTION
+//================================================
+
+static void JIT_LEAVE(void)
+{
+    M68K_CACHE_LEAVE();
+    JIT.RUNNING = false;
+
+    if(JIT.FLUSH_PENDING)
+        JIT_RESET();
+}
+
+bool M68K_JIT_INIT(void)
+{
+    void* CODE;
+
+    JIT.ENTRIES = MD_ALLOC(sizeof(M68K_JIT_ENTRY) * M68K_JIT_ENTRIES);
+
+    if(JIT.CODE_BASE == NULL)
+    {
+        CODE = mmap(NULL, M68K_JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if(CODE == MAP_FAILED)
+        {
+            fprintf(stderr, "Failed to map JIT code buffer, using the cached interpreter\n");
+            return false;
+        }
+
+        JIT.CODE_BASE = CODE;
+    }
+
+    JIT_RESET();
+    return true;
+}
+
+void M68K_JIT_SHUTDOWN(void)
+{
+    if(JIT.CODE_BASE != NULL)
+        munmap(JIT.CODE_BASE, M68K_JIT_CODE_SIZE);
+
+    memset(&JIT, 0, sizeof(JIT));
+}
+
+int M68K_JIT_EXEC(int CYCLES)
+{
+    M68K_JIT_ENTRY* ENTRY;
+    M68K_JIT_CODE CODE;
+    M68K_JIT_EXIT EXIT;
+    U16 OP_COUNT;
+    U32 BANK;
+    U32 PC;
+    int USED = 0;
+    int STEP;
+    bool STEPPED = false;
+
+    if(JIT.CODE_BASE == NULL)
+        return M68K_CACHE_EXEC(CYCLES);
+
+    const M68K_CACHE* CACHE = M68K_CACHE_STATE();
+
+    BANK = JIT_BANK_KEY();
+    M68K_CACHE_ENTER();
+    JIT.RUNNING = true;
+
+    while (USED < CYCLES && !CACHE->END_SLICE)
+    {
+        PC = M68K_CACHE_PC & 0xFFFFFF;
+
+        if(PC < M68K_JIT_ROM_END)
+        {
+            ENTRY = &JIT.ENTRIES[(PC >> 1) & (M68K_JIT_ENTRIES - 1)];
+
+            if(ENTRY->START != PC || ENTRY->BANK != BANK)
+            {
+                ENTRY->START = PC;
+                ENTRY->BANK = BANK;
+                ENTRY->HEAT = 0;
+                ENTRY->CODE = NULL;
+            }
+
+            /* COMPILING MAY FLUSH EVERY ENTRY, THIS ONE INCLUDED */
+
+            if(ENTRY->CODE == NULL && ++ENTRY->HEAT == M68K_JIT_THRESHOLD)
+            {
+                CODE = JIT_COMPILE(PC, &OP_COUNT);
+
+                ENTRY->START = PC;
+                ENTRY->BANK = BANK;
+                ENTRY->HEAT = M68K_JIT_THRESHOLD;
+                ENTRY->OP_COUNT = OP_COUNT;
+                ENTRY->CODE = CODE;
+            }
+
+            if(ENTRY->CODE != NULL)
+            {
+                /* COMPILED CODE TAKES IT'S FLAGS FROM SR, NOT THE CACHE'S PENDING ONES */
+
+                if(STEPPED)
+                {
+                    M68K_CACHE_SYNC();
+                    STEPPED = false;
+                }
+
+                EXIT = ENTRY->CODE(&CPU);
+                M68K_CACHE_PC = EXIT.PC;
+                USED += EXIT.CYCLES;
+
+                PROFILE_COUNT(PROFILE_M68K_INSTRUCTIONS, ENTRY->OP_COUNT);
+                continue;
+            }
+        }
+
+        /* COLD CODE, WORK RAM AND ANYTHING THE RECOMPILER DOESN'T HANDLE */
+
+        STEP = M68K_CACHE_STEP();
+        STEPPED = true;
+
+        if(STEP == 0)
+        {
+            JIT_LEAVE();
+            return CYCLES;
+        }
+
+        USED += STEP;
+    }
+
+    JIT_LEAVE();
+    return USED;
+}
+
+#else
+
+bool M68K_JIT_INIT(void)
+{
+    return false;
+}
+
+void M68K_JIT_SHUTDOWN(void) {}
+
+int M68K_JIT_EXEC(int CYCLES)
+{
+    return M68K_CACHE_EXEC(CYCLES);
+}
+
+#endif
+
+/* SEE M68K_CACHE_FLUSH - THE SAME RULE HOLDS FOR COMPILED CODE */
+
+void M68K_JIT_FLUSH(void)
+{
+    if(JIT.RUNNING)
+    {
+        JIT.FLUSH_PENDING = true;
+        MD_END_SLICE();
+        return;
+    }
+
+    JIT_RESET();
+}
+
+const M68K_JIT* M68K_JIT_STATE(void)
+{
+    return &JIT;
+}
@@ -0,0 +1,309 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS HASHING THE CONSOLE'S OUTPUT FOR REGRESSION CHECKS */
+/* SEE hash.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "hash.h"
+#include "md.h"
+#include "vdp.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_HASH
+
+#define     HASH_PRIME_1        0x9E3779B185EBCA87ULL
+#define     HASH_PRIME_2        0xC2B2AE3D27D4EB4FULL
+#define     HASH_PRIME_3        0x165667B19E3779F9ULL
+#define     HASH_PRIME_4        0x85EBCA77C2B2AE63ULL
+#define     HASH_PRIME_5        0x27D4EB2F165667C5ULL
+
+#define     HASH_ROTATE(X, R)   (((X) << (R)) | ((X) >> (64 - (R))))
+
+static HASH_BASE MD_HASH;
+
+/*===============================================================================*/
+/*                              XXH64                                            */
+/*===============================================================================*/
+
+/* INPUT IS READ IN HOST ORDER, WHICH IS LITTLE ENDIAN ON EVERYTHING WE BUILD FOR */
+
+static inline U64 HASH_READ_64(const U8* PTR)
+{
+    U64 VALUE;
+    memcpy(&VALUE, PTR, sizeof(VALUE));
+    return VALUE;
+}
+
+static inline U32 HASH_READ_32(const U8* PTR)
+{
+    U32 VALUE;
+    memcpy(&VALUE, PTR, sizeof(VALUE));
+    return VALUE;
+}
+
+static inline U64 HASH_ROUND(U64 LANE, U64 INPUT)
+{
+    LANE += INPUT * HASH_PRIME_2;
+    LANE = HASH_ROTATE(LANE, 31);
+    return LANE * HASH_PRIME_1;
+}
+
+static inline U64 HASH_MERGE(U64 ACC, U64 LANE)
+{
+    ACC ^= HASH_ROUND(0, LANE);
+    return ACC * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+/* EACH OF THE FOUR LANES TAKES EVERY FOURTH WORD - THEY DON'T DEPEND ON ONE */
+/* ANOTHER, SO THE CPU RUNS ALL FOUR ROUNDS SIDE BY SIDE */
+
+static const U8* HASH_STRIPES(U64* LANE, const U8* PTR, const U8* END)
+{
+    U64 L0 = LANE[0], L1 = LANE[1], L2 = LANE[2], L3 = LANE[3];
+
+    while (PTR + 32 <= END)
+    {
+        L0 = HASH_ROUND(L0, HASH_READ_64(PTR));
+        L1 = HASH_ROUND(L1, HASH_READ_64(PTR + 8));
+        L2 = HASH_ROUND(L2, HASH_READ_64(PTR + 16));
+        L3 = HASH_ROUND(L3, HASH_READ_64(PTR + 24));
+        PTR += 32;
+    }
+
+    LANE[0] = L0; LANE[1] = L1; LANE[2] = L2; LANE[3] = L3;
+    return PTR;
+}
+
+void HASH_RESET(HASH_STATE* STATE, U64 SEED)
+{
+    memset(STATE, 0, sizeof(*STATE));
+
+    STATE->LANE[0] = SEED + HASH_PRIME_1 + HASH_PRIME_2;
+    STATE->LANE[1] = SEED + HASH_PRIME_2;
+    STATE->LANE[2] = SEED;
+    STATE->LANE[3] = SEED - HASH_PRIME_1;
+}
+
+void HASH_UPDATE(HASH_STATE* STATE, const void* DATA, UNK LENGTH)
+{
+    const U8* PTR = DATA;
+    const U8* END = PTR + LENGTH;
+    UNK FILL;
+
+    STATE->TOTAL += LENGTH;
+
+    /* TOP UP A PART FILLED STRIPE FIRST */
+
+    if(STATE->SIZE > 0)
+    {
+        FILL = 32 - STATE->SIZE;
+
+        if(LENGTH < FILL)
+        {
+            memcpy(STATE->BUFFER + STATE->SIZE, PTR, LENGTH);
+            STATE->SIZE += (U32)LENGTH;
+            return;
+        }
+
+        memcpy(STATE->BUFFER + STATE->SIZE, PTR, FILL);
+        HASH_STRIPES(STATE->LANE, STATE->BUFFER, STATE->BUFFER + 32);
+        PTR += FILL;
+        STATE->SIZE = 0;
+    }
+
+    PTR = HASH_STRIPES(STATE->LANE, PTR, END);
+
+    memcpy(STATE->BUFFER, PTR, (UNK)(END - PTR));
+    STATE->SIZE = (U32)(END - PTR);
+}
+
+U64 HASH_DIGEST(const HASH_STATE* STATE)
+{
+    const U8* PTR = STATE->BUFFER;
+    const U8* END = PTR + STATE->SIZE;
+    U64 ACC;
+
+    if(STATE->TOTAL >= 32)
+    {
+        ACC = HASH_ROTATE(STATE->LANE[0], 1) + HASH_ROTATE(STATE->LANE[1], 7) +
+              HASH_ROTATE(STATE->LANE[2], 12) + HASH_ROTATE(STATE->LANE[3], 18);
+
+        ACC = HASH_MERGE(ACC, STATE->LANE[0]);
+        ACC = HASH_MERGE(ACC, STATE->LANE[1]);
+        ACC = HASH_MERGE(ACC, STATE->LANE[2]);
+        ACC = HASH_MERGE(ACC, STATE->LANE[3]);
+    }
+
+    else
+    {
+        ACC = STATE->LANE[2] + HASH_PRIME_5;
+    }
+
+    ACC += STATE->TOTAL;
+
+    /* FOLD IN THE TAIL, EIGHT, FOUR AND THEN ONE BYTE AT A TIME */
+
+    for (; PTR + 8 <= END; PTR += 8)
+    {
+        ACC ^= HASH_ROUND(0, HASH_READ_64(PTR));
+        ACC = HASH_ROTATE(ACC, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+
+    if(PTR + 4 <= END)
+    {
+        ACC ^= (U64)HASH_READ_32(PTR) * HASH_PRIME_1;
+        ACC = HASH_ROTATE(ACC, 23) * HASH_PRIME_2 + HASH_PRIME_3;
+        PTR += 4;
+    }
+
+    for (; PTR < END; PTR++)
+    {
+        ACC ^= (*PTR) * HASH_PRIME_5;
+        ACC = HASH_ROTATE(ACC, 11) * HASH_PRIME_1;
+    }
+
+    ACC ^= ACC >> 33;
+    ACC *= HASH_PRIME_2;
+    ACC ^= ACC >> 29;
+    ACC *= HASH_PRIME_3;
+    ACC ^= ACC >> 32;
+
+    return ACC;
+}
+
+U64 HASH_XXH64(const void* DATA, UNK LENGTH, U64 SEED)
+{
+    HASH_STATE STATE;
+
+    HASH_RESET(&STATE, SEED);
+    HASH_UPDATE(&STATE, DATA, LENGTH);
+
+    return HASH_DIGEST(&STATE);
+}
+
+/*===============================================================================*/
+/*                          PER FRAME HASHES                                     */
+/*===============================================================================*/
+
+/* ONLY THE VISIBLE PART OF EACH ROW IS HASHED, SO THE PADDING OUT TO THE */
+/* PITCH CAN NEVER MAKE TWO IDENTICAL FRAMES DIFFER */
+
+static U64 HASH_FRAMEBUFFER_ROWS(void)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    HASH_STATE STATE;
+    int ROW;
+
+    HASH_RESET(&STATE, HASH_SEED);
+    HASH_UPDATE(&STATE, &BMP->WIDTH, sizeof(BMP->WIDTH));
+    HASH_UPDATE(&STATE, &BMP->HEIGHT, sizeof(BMP->HEIGHT));
+
+    for (ROW = 0; ROW < BMP->HEIGHT; ROW++)
+    {
+        HASH_UPDATE(&STATE, BMP->DATA + ROW * BMP->PITCH, (UNK)BMP->WIDTH * sizeof(U32));
+    }
+
+    return HASH_DIGEST(&STATE);
+}
+
+/* MEMORY SELECTS WHETHER VRAM, CRAM, VSRAM AND WORK RAM ARE HASHED AS WELL */
+
+int HASH_OPEN(const char* PATH, unsigned INTERVAL, bool MEMORY)
+{
+    HASH_BASE* HASH = &MD_HASH;
+
+    memset(HASH, 0, sizeof(*HASH));
+
+    HASH->FILE = fopen(PATH, "w");
+    if(HASH->FILE == NULL)
+    {
+        fprintf(stderr, "Failed to open hash log: %s\n", PATH);
+        return -1;
+    }
+
+    HASH->INTERVAL = INTERVAL ? INTERVAL : 1;
+    HASH->MEMORY = MEMORY;
+    HASH_RESET(&HASH->AUDIO, HASH_SEED);
+
+    fprintf(HASH->FILE, "# frame framebuffer audio%s\n", MEMORY ? " vram cram vsram work_ram" : "");
+
+    printf("Hashing every %u frames to: %s\n", HASH->INTERVAL, PATH);
+    return 0;
+}
+
+/* CALLED FOR EVERY SAMPLE, AHEAD OF ANY FAST FORWARD DECIMATION */
+
+void HASH_SAMPLE(S16 SAMPLE)
+{
+    HASH_BASE* HASH = &MD_HASH;
+
+    if(HASH->FILE == NULL || HASH->SAMPLE_COUNT >= HASH_MAX_SAMPLES)
+        return;
+
+    HASH->SAMPLES[HASH->SAMPLE_COUNT++] = SAMPLE;
+}
+
+/* WHETHER THE FRAME ABOUT TO RUN WILL BE HASHED - IF SO, IT MUST BE DRAWN */
+
+bool HASH_DUE(void)
+{
+    HASH_BASE* HASH = &MD_HASH;
+
+    return HASH->FILE != NULL && (MD_GET_CONSOLE()->FRAME_COUNT + 1) % HASH->INTERVAL == 0;
+}
+
+/* CALLED ONCE EVERY FRAME HAS BEEN RUN */
+
+void HASH_FRAME(void)
+{
+    HASH_BASE* HASH = &MD_HASH;
+    U32 FRAME = MD_GET_CONSOLE()->FRAME_COUNT;
+
+    if(HASH->FILE == NULL)
+        return;
+
+    HASH_UPDATE(&HASH->AUDIO, HASH->SAMPLES, HASH->SAMPLE_COUNT * sizeof(S16));
+    HASH->SAMPLE_COUNT = 0;
+
+    if(FRAME % HASH->INTERVAL != 0)
+        return;
+
+    fprintf(HASH->FILE, "%u %016llx %016llx", FRAME,
+            (unsigned long long)HASH_FRAMEBUFFER_ROWS(),
+            (unsigned long long)HASH_DIGEST(&HASH->AUDIO));
+
+    if(HASH->MEMORY)
+    {
+        fprintf(HASH->FILE, " %016llx %016llx %016llx %016llx",
+                (unsigned long long)HASH_XXH64(VDP->VRAM, sizeof(VDP->VRAM), HASH_SEED),
+                (unsigned long long)HASH_XXH64(VDP->CRAM, sizeof(VDP->CRAM), HASH_SEED),
+                (unsigned long long)HASH_XXH64(VDP->VSRAM, sizeof(VDP->VSRAM), HASH_SEED),
+                (unsigned long long)HASH_XXH64(MD_GET_WORK_RAM(), 0x10000, HASH_SEED));
+    }
+
+    fputc('\n', HASH->FILE);
+
+    HASH_RESET(&HASH->AUDIO, HASH_SEED);
+    HASH->LINES++;
+}
+
+void HASH_CLOSE(void)
+{
+    HASH_BASE* HASH = &MD_HASH;
+
+    if(HASH->FILE != NULL)
+    {
+        fclose(HASH->FILE);
+        printf("Hash log written: %u lines\n", HASH->LINES);
+    }
+
+    memset(HASH, 0, sizeof(*HASH));
+}
+
+#endif
@@ -0,0 +1,441 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE FUNCTIONALITY OF THE I/O BLOCK AT $A10000 */
+/* ENCOMPASSING THE VERSION REGISTER, THE THREE CONTROL PORTS AND THE */
+/* PERIPHERALS WHICH CAN BE PLUGGED INTO THEM */
+
+/* NESTED INCLUDES */
+
+#include "io.h"
+#include "md.h"
+#include "cartridge.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_IO
+
+static IO_BASE* IO;
+
+/*===============================================================================*/
+/*                          LOCK-FREE INPUT SNAPSHOT                             */
+/*===============================================================================*/
+
+/* THE HOST AND THE EMULATION THREAD SHARE A TRIPLE BUFFER OF INPUT SNAPSHOTS */
+/* THE HOST OWNS THE BACK SLOT, THE EMULATOR OWNS THE FRONT SLOT, AND THE */
+/* MIDDLE SLOT IS HANDED BETWEEN THEM BY AN ATOMIC EXCHANGE */
+
+/* NEITHER SIDE EVER WAITS ON THE OTHER - THE EMULATOR SIMPLY PICKS UP */
+/* WHICHEVER SNAPSHOT WAS PUBLISHED MOST RECENTLY */
+
+#define     IO_SNAPSHOT_FRESH       0x04
+#define     IO_SNAPSHOT_INDEX       0x03
+
+static IO_INPUT_SNAPSHOT IO_SNAPSHOT[3];
+static U32 IO_SNAPSHOT_READY = 1;
+static U32 IO_SNAPSHOT_BACK = 0;
+static U32 IO_SNAPSHOT_FRONT = 2;
+
+void IO_PUBLISH_INPUT(const IO_INPUT_SNAPSHOT* INPUT)
+{
+    U32 PREVIOUS;
+
+    IO_SNAPSHOT[IO_SNAPSHOT_BACK] = *INPUT;
+
+    PREVIOUS = __atomic_exchange_n(&IO_SNAPSHOT_READY, IO_SNAPSHOT_BACK | IO_SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    IO_SNAPSHOT_BACK = PREVIOUS & IO_SNAPSHOT_INDEX;
+}
+
+/* CALLED BY THE EMULATION THREAD ONCE PER FRAME */
+/* THE INPUT SEEN BY THE GAME THEREFORE NEVER CHANGES PART WAY THROUGH A FRAME */
+
+void IO_LATCH_INPUT(void)
+{
+    U32 PREVIOUS;
+
+    if(__atomic_load_n(&IO_SNAPSHOT_READY, __ATOMIC_ACQUIRE) & IO_SNAPSHOT_FRESH)
+    {
+        PREVIOUS = __atomic_exchange_n(&IO_SNAPSHOT_READY, IO_SNAPSHOT_FRONT, __ATOMIC_ACQ_REL);
+        IO_SNAPSHOT_FRONT = PREVIOUS & IO_SNAPSHOT_INDEX;
+    }
+
+    IO->INPUT = IO_SNAPSHOT[IO_SNAPSHOT_FRONT];
+}
+
+const IO_INPUT_SNAPSHOT* IO_CURRENT_INPUT(void)
+{
+    return &IO->INPUT;
+}
+
+/* REPLACE THE LATCHED INPUT FOR THE CURRENT FRAME (MOVIE PLAYBACK) */
+
+void IO_OVERRIDE_INPUT(const IO_INPUT_SNAPSHOT* INPUT)
+{
+    IO->INPUT = *INPUT;
+}
+
+/*===============================================================================*/
+/*                          PERIPHERAL DEVICES                                   */
+/*===============================================================================*/
+
+/* EVERY DEVICE SEES THE LINES AS DRIVEN BY THE CONSOLE - ANY LINE WHICH IS */
+/* CONFIGURED AS AN INPUT IS PULLED HIGH */
+
+static U8 IO_DRIVE_LINES(U8 DATA, U8 MASK)
+{
+    return (DATA & MASK) | (~MASK & 0x7F);
+}
+
+/* THE THREE BUTTON PAD MULTIPLEXES IT'S EIGHT BUTTONS OVER TH */
+/* TH = 1: ?1CBRLDU */
+/* TH = 0: ?0SA00DU */
+
+static U8 IO_PAD3_READ(IO_PORT* PORT)
+{
+    U16 PAD = IO->INPUT.PAD[PORT->PLAYER];
+
+    if(PORT->LINES & IO_LINE_TH)
+        return IO_LINE_TH | (~PAD & 0x3F);
+
+    return (~(PAD >> 2) & 0x30) | (~PAD & 0x03);
+}
+
+static void IO_PAD3_WRITE(IO_PORT* PORT, U8 DATA, U8 MASK)
+{
+    PORT->LINES = IO_DRIVE_LINES(DATA, MASK);
+}
+
+static void IO_PAD_RESET(IO_PORT* PORT)
+{
+    PORT->LINES = 0x7F;
+    PORT->PHASE = 0;
+    PORT->TH_TIMEOUT = 0;
+}
+
+/* THE SIX BUTTON PAD COUNTS THE NUMBER OF TIMES TH HAS BEEN PULLED LOW */
+/* ON THE THIRD AND FOURTH PULSE IT EXPOSES THE ID AND THE EXTRA BUTTONS */
+
+/* IF TH IS LEFT ALONE FOR ~1.5MS THE COUNTER RESETS (SEE IO_END_LINE) */
+
+static U8 IO_PAD6_READ(IO_PORT* PORT)
+{
+    U16 PAD = IO->INPUT.PAD[PORT->PLAYER];
+    U8 START_A = ~(PAD >> 2) & 0x30;
+
+    if(PORT->LINES & IO_LINE_TH)
+    {
+        if(PORT->PHASE == 3)
+            return IO_LINE_TH | (~((PAD & 0x30) | ((PAD >> 8) & 0x0F)) & 0x3F);
+
+        return IO_LINE_TH | (~PAD & 0x3F);
+    }
+
+    switch (PORT->PHASE)
+    {
+        case 3:
+            return START_A;
+
+        case 4:
+            return START_A | 0x0F;
+
+        default:
+            return START_A | (~PAD & 0x03);
+    }
+}
+
+static void IO_PAD6_WRITE(IO_PORT* PORT, U8 DATA, U8 MASK)
+{
+    U8 LINES = IO_DRIVE_LINES(DATA, MASK);
+
+    if((PORT->LINES & IO_LINE_TH) && !(LINES & IO_LINE_TH))
+    {
+        if(PORT->PHASE < 5)
+            PORT->PHASE++;
+    }
+
+    if((PORT->LINES ^ LINES) & IO_LINE_TH)
+        PORT->TH_TIMEOUT = IO_PAD6_TIMEOUT_LINES;
+
+    PORT->LINES = LINES;
+}
+
+/* THE TEAM PLAYER (MULTITAP) AND THE MEGA MOUSE BOTH TRANSFER THEIR DATA */
+/* AS A STREAM OF NIBBLES - TH STARTS THE TRANSFER, EVERY TR TOGGLE REQUESTS */
+/* THE NEXT NIBBLE AND TL ACKNOWLEDGES IT BY MIRRORING TR */
+
+static U8 IO_NIBBLE_ACK(IO_PORT* PORT, U8 NIBBLE)
+{
+    return ((PORT->LINES & IO_LINE_TR) >> 1) | (NIBBLE & 0x0F);
+}
+
+static void IO_NIBBLE_WRITE(IO_PORT* PORT, U8 DATA, U8 MASK)
+{
+    U8 LINES = IO_DRIVE_LINES(DATA, MASK);
+
+    if(LINES & IO_LINE_TH)
+    {
+        PORT->PHASE = 0;
+    }
+
+    else if((PORT->LINES ^ LINES) & IO_LINE_TR)
+    {
+        if(PORT->PHASE < 0xFF)
+            PORT->PHASE++;
+    }
+
+    /* THE MOUSE LATCHES IT'S MOVEMENT AS SOON AS A TRANSFER BEGINS */
+
+    if((PORT->LINES & IO_LINE_TH) && !(LINES & IO_LINE_TH))
+    {
+        PORT->MOUSE_X = IO->INPUT.MOUSE_X;
+        PORT->MOUSE_Y = IO->INPUT.MOUSE_Y;
+    }
+
+    PORT->LINES = LINES;
+}
+
+/* TEAM PLAYER NIBBLE STREAM: */
+/* F, 0, 0, TYPE A..D, THEN TWO NIBBLES (RLDU, SACB) PER THREE BUTTON PAD */
+
+static U8 IO_MULTITAP_READ(IO_PORT* PORT)
+{
+    U8 INDEX = PORT->PHASE;
+    U16 PAD;
+
+    if(PORT->LINES & IO_LINE_TH)
+        return IO_LINE_TH | IO_LINE_TR | IO_LINE_TL | 0x03;
+
+    if(INDEX == 0)
+        return IO_NIBBLE_ACK(PORT, 0x0F);
+
+    if(INDEX < 3)
+        return IO_NIBBLE_ACK(PORT, 0x00);
+
+    /* EVERY SUB-PORT REPORTS A THREE BUTTON PAD */
+
+    if(INDEX < 7)
+        return IO_NIBBLE_ACK(PORT, 0x00);
+
+    INDEX -= 7;
+
+    if(INDEX >= 8)
+        return IO_NIBBLE_ACK(PORT, 0x0F);
+
+    PAD = IO->INPUT.PAD[(PORT->PLAYER + (INDEX >> 1)) % IO_MAX_PLAYERS];
+
+    return IO_NIBBLE_ACK(PORT, (INDEX & 1) ? ~(PAD >> 4) : ~PAD);
+}
+
+/* MEGA MOUSE NIBBLE STREAM: */
+/* B, F, F, OVERFLOW/SIGN, BUTTONS, X HI, X LO, Y HI, Y LO */
+
+static U8 IO_MOUSE_READ(IO_PORT* PORT)
+{
+    S16 X = PORT->MOUSE_X;
+    S16 Y = -PORT->MOUSE_Y;
+    U8 FLAGS = 0;
+
+    if(PORT->LINES & IO_LINE_TH)
+        return IO_LINE_TL;
+
+    if(X < -255 || X > 255) FLAGS |= 0x04;
+    if(Y < -255 || Y > 255) FLAGS |= 0x08;
+    if(X < 0) FLAGS |= 0x01;
+    if(Y < 0) FLAGS |= 0x02;
+
+    switch (PORT->PHASE)
+    {
+        case 0: return IO_NIBBLE_ACK(PORT, 0x0B);
+        case 1: return IO_NIBBLE_ACK(PORT, 0x0F);
+        case 2: return IO_NIBBLE_ACK(PORT, 0x0F);
+        case 3: return IO_NIBBLE_ACK(PORT, FLAGS);
+        case 4: return IO_NIBBLE_ACK(PORT, IO->INPUT.MOUSE_BUTTONS);
+        case 5: return IO_NIBBLE_ACK(PORT, (U8)X >> 4);
+        case 6: return IO_NIBBLE_ACK(PORT, (U8)X);
+        case 7: return IO_NIBBLE_ACK(PORT, (U8)Y >> 4);
+        case 8: return IO_NIBBLE_ACK(PORT, (U8)Y);
+        default: return IO_NIBBLE_ACK(PORT, 0x00);
+    }
+}
+
+static U8 IO_NONE_READ(IO_PORT* PORT)
+{
+    (void)PORT;
+    return 0x7F;
+}
+
+static const IO_DEVICE IO_DEVICES[IO_DEVICE_COUNT] =
+{
+    { IO_DEVICE_NONE,       IO_NONE_READ,       IO_PAD3_WRITE,      IO_PAD_RESET },
+    { IO_DEVICE_PAD3,       IO_PAD3_READ,       IO_PAD3_WRITE,      IO_PAD_RESET },
+    { IO_DEVICE_PAD6,       IO_PAD6_READ,       IO_PAD6_WRITE,      IO_PAD_RESET },
+    { IO_DEVICE_MULTITAP,   IO_MULTITAP_READ,   IO_NIBBLE_WRITE,    IO_PAD_RESET },
+    { IO_DEVICE_MOUSE,      IO_MOUSE_READ,      IO_NIBBLE_WRITE,    IO_PAD_RESET },
+};
+
+/*===============================================================================*/
+/*                          I/O BLOCK                                            */
+/*===============================================================================*/
+
+void IO_INIT(void)
+{
+    IO = MD_ALLOC(sizeof(IO_BASE));
+
+    IO_SET_VERSION(true, false);
+    IO_SET_DEVICE(0, IO_DEVICE_PAD3);
+    IO_SET_DEVICE(1, IO_DEVICE_PAD3);
+    IO_SET_DEVICE(2, IO_DEVICE_NONE);
+    IO_RESET();
+}
+
+/* EXPOSE THE PORT STATE FOR SAVE STATES */
+
+IO_BASE* IO_GET_STATE(void)
+{
+    return IO;
+}
+
+void IO_RESET(void)
+{
+    unsigned INDEX;
+
+    for (INDEX = 0; INDEX < IO_PORT_COUNT; INDEX++)
+    {
+        IO_PORT* PORT = &IO->PORT[INDEX];
+
+        PORT->DATA = 0;
+        PORT->CTRL = 0;
+        PORT->TX_DATA = 0xFF;
+        PORT->RX_DATA = 0x00;
+        PORT->S_CTRL = 0x00;
+        PORT->DEVICE->RESET(PORT);
+    }
+}
+
+/* THE VERSION REGISTER REPORTS THE REGION OF THE CONSOLE AND WHETHER */
+/* AN EXPANSION UNIT (MEGA CD) IS ATTACHED */
+
+void IO_SET_VERSION(bool OVERSEAS, bool PAL)
+{
+    IO->VERSION = IO_VERSION_NO_EXPANSION | IO_VERSION_HW_REVISION;
+
+    if(OVERSEAS) IO->VERSION |= IO_VERSION_OVERSEAS;
+    if(PAL) IO->VERSION |= IO_VERSION_PAL;
+}
+
+void IO_SET_DEVICE(unsigned PORT, IO_DEVICE_TYPE TYPE)
+{
+    if(PORT >= IO_PORT_COUNT || TYPE >= IO_DEVICE_COUNT)
+        return;
+
+    IO->PORT[PORT].DEVICE = &IO_DEVICES[TYPE];
+    IO->PORT[PORT].PLAYER = PORT;
+    IO->PORT[PORT].DEVICE->RESET(&IO->PORT[PORT]);
+}
+
+/* PICK THE DEVICES FOR EACH PORT BASED ON THE I/O SUPPORT STRING */
+/* WITHIN THE CARTRIDGE HEADER (SEE MD_GET_ROM_INFO) */
+
+void IO_SELECT_PERIPHERALS(S16 PERIPHERALS)
+{
+    IO_DEVICE_TYPE PAD = (PERIPHERALS & ROM_PERIPHERAL_PAD6) ? IO_DEVICE_PAD6 : IO_DEVICE_PAD3;
+    bool HAS_PAD = (PERIPHERALS & (ROM_PERIPHERAL_PAD3 | ROM_PERIPHERAL_PAD6)) != 0;
+
+    if((PERIPHERALS & ROM_PERIPHERAL_MOUSE) && !HAS_PAD)
+        IO_SET_DEVICE(0, IO_DEVICE_MOUSE);
+    else
+        IO_SET_DEVICE(0, PAD);
+
+    if(PERIPHERALS & ROM_PERIPHERAL_MULTITAP)
+        IO_SET_DEVICE(1, IO_DEVICE_MULTITAP);
+    else if((PERIPHERALS & ROM_PERIPHERAL_MOUSE) && HAS_PAD)
+        IO_SET_DEVICE(1, IO_DEVICE_MOUSE);
+    else
+        IO_SET_DEVICE(1, PAD);
+}
+
+/* THE REGISTERS ARE ONLY DECODED ON ODD ADDRESSES, EVERY REGISTER */
+/* IS A WORD APART: */
+
+/* $01 VERSION, $03-$07 DATA, $09-$0D CTRL, $0F-$1F SERIAL (TX, RX, SCTRL) */
+
+unsigned IO_READ_BYTE(unsigned ADDRESS)
+{
+    unsigned REG = (ADDRESS >> 1) & 0x0F;
+    IO_PORT* PORT;
+
+    if(REG == 0)
+        return IO->VERSION;
+
+    if(REG < 4)
+    {
+        PORT = &IO->PORT[REG - 1];
+        return (PORT->DATA & (PORT->CTRL | 0x80)) | (PORT->DEVICE->READ(PORT) & ~PORT->CTRL & 0x7F);
+    }
+
+    if(REG < 7)
+        return IO->PORT[REG - 4].CTRL;
+
+    PORT = &IO->PORT[(REG - 7) / 3];
+
+    switch ((REG - 7) % 3)
+    {
+        case 0: return PORT->TX_DATA;
+        case 1: return PORT->RX_DATA;
+        default: return PORT->S_CTRL & 0xF8;
+    }
+}
+
+void IO_WRITE_BYTE(unsigned ADDRESS, unsigned DATA)
+{
+    unsigned REG = (ADDRESS >> 1) & 0x0F;
+    IO_PORT* PORT;
+
+    if(REG == 0)
+        return;
+
+    if(REG < 4)
+    {
+        PORT = &IO->PORT[REG - 1];
+        PORT->DATA = DATA;
+        PORT->DEVICE->WRITE(PORT, PORT->DATA, PORT->CTRL);
+        return;
+    }
+
+    if(REG < 7)
+    {
+        PORT = &IO->PORT[REG - 4];
+        PORT->CTRL = DATA;
+        PORT->DEVICE->WRITE(PORT, PORT->DATA, PORT->CTRL);
+        return;
+    }
+
+    PORT = &IO->PORT[(REG - 7) / 3];
+
+    switch ((REG - 7) % 3)
+    {
+        case 0: PORT->TX_DATA = DATA; break;
+        case 1: break;
+        default: PORT->S_CTRL = DATA & 0xF8; break;
+    }
+}
+
+/* CALLED AT THE END OF EVERY SCANLINE TO AGE THE SIX BUTTON PAD'S TH COUNTER */
+
+void IO_END_LINE(void)
+{
+    unsigned INDEX;
+
+    for (INDEX = 0; INDEX < IO_PORT_COUNT; INDEX++)
+    {
+        IO_PORT* PORT = &IO->PORT[INDEX];
+
+        if(PORT->TH_TIMEOUT && --PORT->TH_TIMEOUT == 0)
+            PORT->PHASE = 0;
+    }
+}
+
+#endif
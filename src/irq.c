@@ -0,0 +1,253 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE DELIVERY OF INTERRUPTS TO THE 68000 */
+/* SEE irq.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "irq.h"
+#include "md.h"
+#include "vdp.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_IRQ
+
+static IRQ_BASE* IRQ;
+
+/* THE HIGHEST INTERRUPT THE VDP IS ASSERTING, TAKING IT'S ENABLES INTO ACCOUNT */
+
+unsigned IRQ_VDP_LEVEL(void)
+{
+    if(VDP->VINT && (VDP->VDP_REG[1] & IRQ_VINT_ENABLE))
+        return IRQ_LEVEL_VINT;
+
+    if(VDP->HINT && (VDP->VDP_REG[0] & IRQ_HINT_ENABLE))
+        return IRQ_LEVEL_HINT;
+
+    return 0;
+}
+
+/* THE EXTERNAL INTERRUPT ONLY SHOWS THROUGH IF NOTHING ON THE VDP BEATS IT */
+
+static unsigned IRQ_COMBINE(unsigned LEVEL)
+{
+    if(LEVEL < IRQ_LEVEL_EXTERNAL && IRQ->EXTERNAL && (VDP->VDP_REG[11] & IRQ_EXTERNAL_ENABLE))
+        return IRQ_LEVEL_EXTERNAL;
+
+    return LEVEL;
+}
+
+/* HAND THE LEVEL OVER TO THE 68K - lib68k ONLY TAKES THE EXCEPTION IF IT */
+/* BEATS THE MASK IN SR, OTHERWISE IT STAYS ASSERTED UNTIL THE MASK DROPS */
+
+/* ONLY EVER CALLED BETWEEN SLICES, NEVER FROM WITHIN AN INSTRUCTION */
+
+static void IRQ_PRESENT(unsigned LEVEL)
+{
+    IRQ->DELAYED = false;
+    IRQ->LEVEL = LEVEL;
+    CPU.INT_LEVEL = LEVEL;
+
+    if(LEVEL == 7 || LEVEL > ((CPU.STATUS_REGISTER >> 8) & 7))
+        M68K_CHECK_IRQ();
+}
+
+/* VDP->SET_IRQ - RAISED BY THE SCHEDULER ITSELF AT THE DEADLINE */
+
+static void IRQ_SET(unsigned LEVEL)
+{
+    IRQ_PRESENT(IRQ_COMBINE(LEVEL));
+}
+
+/* VDP->SET_IRQ_DELAY - AN ENABLE BIT WAS WRITTEN PART WAY THROUGH A SLICE */
+
+/* DROPPING THE LEVEL TAKES EFFECT STRAIGHT AWAY, BUT A NEWLY UNMASKED */
+/* INTERRUPT IS HELD BACK UNTIL THE 68K HAS RUN ONE MORE INSTRUCTION - THE */
+/* SLICE IS ENDED HERE SO THAT IS THE NEXT INSTRUCTION, NOT THE NEXT DEADLINE */
+
+static void IRQ_SET_DELAY(unsigned LEVEL)
+{
+    LEVEL = IRQ_COMBINE(LEVEL);
+    IRQ->LEVEL = LEVEL;
+
+    if(LEVEL <= CPU.INT_LEVEL)
+    {
+        CPU.INT_LEVEL = LEVEL;
+        return;
+    }
+
+    IRQ->DELAYED = true;
+    MD_END_SLICE();
+}
+
+/* lib68k'S INTERRUPT ACKNOWLEDGE CYCLE - CLEARS WHATEVER WAS TAKEN AND */
+/* PRESENTS ANYTHING STILL PENDING BENEATH IT */
+
+static S32 IRQ_ACKNOWLEDGE(unsigned LEVEL)
+{
+    switch (LEVEL)
+    {
+        case IRQ_LEVEL_VINT:
+            VDP->VINT = 0;
+            VDP->STATUS &= ~IRQ_STATUS_VINT_PENDING;
+            break;
+
+        case IRQ_LEVEL_HINT:
+            VDP->HINT = 0;
+            break;
+
+        case IRQ_LEVEL_EXTERNAL:
+            IRQ->EXTERNAL = false;
+            break;
+
+        default:
+            break;
+    }
+
+    IRQ->DELIVERED++;
+    IRQ->LEVEL = IRQ_COMBINE(IRQ_VDP_LEVEL());
+    CPU.INT_LEVEL = IRQ->LEVEL;
+
+    return EXCEPTION_INTERRUPT_AUTOVECTOR + LEVEL;
+}
+
+//================================================
+//              SCHEDULER
+//================================================
+
+void IRQ_INIT(void)
+{
+    IRQ = MD_ALLOC(sizeof(IRQ_BASE));
+    IRQ_RESET();
+}
+
+void IRQ_RESET(void)
+{
+    memset(IRQ, 0, sizeof(IRQ_BASE));
+
+    IRQ->HINT_CYCLE = IRQ_NO_DEADLINE;
+    IRQ->VINT_CYCLE = IRQ_NO_DEADLINE;
+    IRQ->HINT_COUNTER = VDP->VDP_REG[10];
+
+    VDP->SET_IRQ = IRQ_SET;
+    VDP->SET_IRQ_DELAY = IRQ_SET_DELAY;
+
+    CPU.INT_LEVEL = 0;
+    CPU.INTERRUPT_CALLBACK = IRQ_ACKNOWLEDGE;
+}
+
+/* WORK OUT WHICH INTERRUPTS FALL DUE ON THIS LINE, AND WHEN */
+
+/* THE H-INT COUNTER IS DECREMENTED ON EVERY LINE UP TO AND INCLUDING THE */
+/* FIRST LINE OF VBLANK, FIRING AS IT UNDERFLOWS - FOR THE REST OF VBLANK */
+/* IT IS HELD AT THE VALUE IN REGISTER 10 */
+
+void IRQ_BEGIN_LINE(int LINE)
+{
+    int HEIGHT = (VDP->VDP_REG[1] & 0x08) ? 240 : VDP_ACTIVE_HEIGHT;
+    bool H40 = VDP->VDP_REG[12] & 0x01;
+
+    if(LINE <= HEIGHT)
+    {
+        if(--IRQ->HINT_COUNTER < 0)
+        {
+            IRQ->HINT_COUNTER = VDP->VDP_REG[10];
+            IRQ->HINT_CYCLE = IRQ_HINT_MCYCLE / MD_M68K_DIVIDER;
+        }
+    }
+
+    else
+    {
+        IRQ->HINT_COUNTER = VDP->VDP_REG[10];
+    }
+
+    if(LINE == 0)
+        VDP->STATUS &= ~IRQ_STATUS_VBLANK;
+
+    if(LINE == HEIGHT)
+    {
+        VDP->STATUS |= IRQ_STATUS_VBLANK;
+        IRQ->VINT_CYCLE = (H40 ? IRQ_VINT_MCYCLE_H40 : IRQ_VINT_MCYCLE_H32) / MD_M68K_DIVIDER;
+        VDP->VINT_CYCLES = IRQ->VINT_CYCLE;
+    }
+
+    /* ANYTHING DUE BEFORE THE CYCLES CARRIED OVER FROM THE LAST LINE */
+
+    IRQ_ADVANCE(0);
+}
+
+/* HOW FAR THE 68K MAY RUN BEFORE SOMETHING NEEDS PRESENTING TO IT */
+
+int IRQ_NEXT_DEADLINE(int LIMIT)
+{
+    int DEADLINE = LIMIT;
+
+    if(IRQ->DELAYED)
+        return IRQ->CYCLE + 1;
+
+    if(IRQ->HINT_CYCLE < DEADLINE)    DEADLINE = IRQ->HINT_CYCLE;
+    if(IRQ->VINT_CYCLE < DEADLINE)    DEADLINE = IRQ->VINT_CYCLE;
+
+    return DEADLINE;
+}
+
+/* ACCOUNT FOR THE CYCLES THE 68K JUST RAN, RAISING ANYTHING NOW DUE */
+
+void IRQ_ADVANCE(int CYCLES)
+{
+    bool RAISED = false;
+
+    IRQ->CYCLE += CYCLES;
+
+    if(IRQ->CYCLE >= IRQ->HINT_CYCLE)
+    {
+        IRQ->HINT_CYCLE = IRQ_NO_DEADLINE;
+        VDP->HINT = 1;
+        RAISED = true;
+    }
+
+    if(IRQ->CYCLE >= IRQ->VINT_CYCLE)
+    {
+        IRQ->VINT_CYCLE = IRQ_NO_DEADLINE;
+        VDP->VINT = 1;
+        VDP->STATUS |= IRQ_STATUS_VINT_PENDING;
+        RAISED = true;
+    }
+
+    if(RAISED)
+        VDP->SET_IRQ(IRQ_VDP_LEVEL());
+
+    /* A PENDING LEVEL THE MASK NOW LETS THROUGH - THE CACHED CORES END THE */
+    /* SLICE WHEREVER SR'S MASK MOVES, SO THIS IS WHERE A LOWERED MASK IS CAUGHT */
+
+    else if(IRQ->DELAYED || IRQ->LEVEL > ((CPU.STATUS_REGISTER >> 8) & 7))
+        IRQ_PRESENT(IRQ->LEVEL);
+}
+
+void IRQ_END_LINE(int LINE_CYCLES)
+{
+    IRQ->CYCLE -= LINE_CYCLES;
+    IRQ->HINT_CYCLE = IRQ_NO_DEADLINE;
+    IRQ->VINT_CYCLE = IRQ_NO_DEADLINE;
+}
+
+/* LATCHED BY THE I/O BLOCK WHEN TH INTERRUPTS ARE ENABLED ON A PORT */
+/* THIS MAY ARRIVE MID-SLICE, SO IS TREATED AS A DELAYED RAISE */
+
+void IRQ_EXTERNAL(bool ASSERTED)
+{
+    IRQ->EXTERNAL = ASSERTED;
+    IRQ_SET_DELAY(IRQ_VDP_LEVEL());
+}
+
+IRQ_BASE* IRQ_GET_STATE(void)
+{
+    return IRQ;
+}
+
+#endif
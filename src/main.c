@@ -13,60 +13,165 @@
 
 #include "md.h"
 #include "cartridge.h"
+#include "rom.h"
 #include "vdp.h"
+#include "io.h"
+#include "movie.h"
+#include "capture.h"
+#include "hash.h"
+#include "tmss.h"
+#include "sram.h"
+#include "profile.h"
+#include "audio.h"
+#include "present.h"
+#include "scale.h"
+#include "timing.h"
 
-VDP_BASE* VDP;
+/* FAST FORWARD RUNS SEVERAL CONSOLE FRAMES FOR EVERY ONE THE HOST PRESENTS */
+/* ONLY THE LAST OF THEM IS DRAWN, AND THE AUDIO IS DECIMATED TO MATCH */
 
-/* A MASTER FUNCTION TO LOAD THE CARTRIDGE INFORMATION */
-/* THIS IS DONE BY SEEKING INTO THE CONTENTS OF THE HEADER */
-/* THEN EVALUATING SUCH */
+#define     MAIN_DEFAULT_TURBO          4
+#define     MAIN_MAX_TURBO              AUDIO_MAX_DECIMATION
 
-/* ALLOCATING THE APPROPRIATE SIZE FOR EACH */
+/* HOW MANY FRAMES IN A ROW MAY GO UNDRAWN WHEN THE HOST FALLS BEHIND */
 
-int MD_CART_LOAD(char* FILENAME, MD_CART* CART) 
+#define     MAIN_DEFAULT_FRAMESKIP      4
+
+/* SAMPLE THE HOST KEYBOARD AND MOUSE INTO AN INPUT SNAPSHOT */
+/* THE SNAPSHOT IS PUBLISHED WITHOUT LOCKING, SO POLLING NEVER STALLS EMULATION */
+
+void POLL_INPUT(void)
 {
-    FILE* ROM;
-    UNK SIZE;
+    static const struct { int KEY; U16 BUTTON; } KEYMAP[] =
+    {
+        { SDL_SCANCODE_UP,      IO_PAD_UP },
+        { SDL_SCANCODE_DOWN,    IO_PAD_DOWN },
+        { SDL_SCANCODE_LEFT,    IO_PAD_LEFT },
+        { SDL_SCANCODE_RIGHT,   IO_PAD_RIGHT },
+        { SDL_SCANCODE_A,       IO_PAD_A },
+        { SDL_SCANCODE_S,       IO_PAD_B },
+        { SDL_SCANCODE_D,       IO_PAD_C },
+        { SDL_SCANCODE_Q,       IO_PAD_X },
+        { SDL_SCANCODE_W,       IO_PAD_Y },
+        { SDL_SCANCODE_E,       IO_PAD_Z },
+        { SDL_SCANCODE_RETURN,  IO_PAD_START },
+        { SDL_SCANCODE_RSHIFT,  IO_PAD_MODE },
+    };
+
+    IO_INPUT_SNAPSHOT INPUT;
+    const U8* KEYS = SDL_GetKeyboardState(NULL);
+    int MOUSE_X, MOUSE_Y;
+    U32 BUTTONS;
+    UNK INDEX;
+
+    memset(&INPUT, 0, sizeof(INPUT));
+
+    for (INDEX = 0; INDEX < sizeof(KEYMAP) / sizeof(KEYMAP[0]); INDEX++)
+    {
+        if(KEYS[KEYMAP[INDEX].KEY])
+            INPUT.PAD[0] |= KEYMAP[INDEX].BUTTON;
+    }
+
+    BUTTONS = SDL_GetRelativeMouseState(&MOUSE_X, &MOUSE_Y);
+
+    INPUT.MOUSE_X = (S16)MOUSE_X;
+    INPUT.MOUSE_Y = (S16)MOUSE_Y;
+    INPUT.MOUSE_BUTTONS = (BUTTONS & SDL_BUTTON_LMASK ? 0x01 : 0) |
+                          (BUTTONS & SDL_BUTTON_RMASK ? 0x02 : 0) |
+                          (BUTTONS & SDL_BUTTON_MMASK ? 0x04 : 0);
+
+    IO_PUBLISH_INPUT(&INPUT);
+}
 
-    printf("Opening ROM file: %s\n", FILENAME);
+/* RUNS ON SDL'S AUDIO THREAD - EVERYTHING IT TOUCHES IS IN THE LOCK-FREE RING */
 
-    ROM = fopen(FILENAME, "rb");
-    if (ROM == NULL) 
+static void AUDIO_CALLBACK(void* USER, U8* STREAM, int LENGTH)
+{
+    (void)USER;
+    AUDIO_PULL((S16*)STREAM, (UNK)LENGTH / sizeof(S16));
+}
+
+static SDL_AudioDeviceID OPEN_AUDIO(void)
+{
+    SDL_AudioSpec WANT;
+    SDL_AudioSpec HAVE;
+    SDL_AudioDeviceID DEVICE;
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
     {
-        printf("Failed to open ROM file: %s\n", FILENAME);
-        return -1;
+        printf("Audio unavailable: %s\n", SDL_GetError());
+        return 0;
     }
 
-    fseek(ROM, 0, SEEK_END);
-    SIZE = ftell(ROM);
-    rewind(ROM);
+    SDL_zero(WANT);
+    WANT.freq = (int)AUDIO_SAMPLE_RATE();
+    WANT.format = AUDIO_S16SYS;
+    WANT.channels = 1;
+    WANT.samples = 512;
+    WANT.callback = AUDIO_CALLBACK;
 
-    CART->ROM_SIZE = SIZE;
-    CART->ROM_DATA = (unsigned char*)malloc(SIZE);
+    /* NO CHANGES ALLOWED - SDL CONVERTS THE LINE RATE TO WHATEVER THE DEVICE WANTS */
 
-    if (CART->ROM_DATA == NULL) 
+    DEVICE = SDL_OpenAudioDevice(NULL, 0, &WANT, &HAVE, 0);
+
+    if (DEVICE == 0)
     {
-        printf("Memory Allocation failed for ROM\n");
-        fclose(ROM);
-        return -1;
+        printf("Audio unavailable: %s\n", SDL_GetError());
+        return 0;
     }
 
-    fread(CART->ROM_DATA, 1, SIZE, ROM);
+    SDL_PauseAudioDevice(DEVICE, 0);
+    return DEVICE;
+}
 
-    GET_CHECKSUM(CART->ROM_DATA, SIZE, FILENAME);
+/* UPLOAD ONLY THE RUNS OF ROWS WHICH CHANGED SINCE THE FRAME THE TEXTURE */
+/* ALREADY HOLDS - A STATIC SCREEN UPLOADS NOTHING AT ALL */
 
-    fclose(ROM);
-    printf("ROM Loaded Successfully. Size: %lu bytes\n", SIZE);
+/* EACH RUN IS LOCKED ON IT'S OWN, SO THE DRIVER ONLY EVER RECEIVES THE */
+/* ROWS THAT WERE ACTUALLY WRITTEN - A VDP ROW COVERS FACTOR ROWS OF THE SCALED SLOT */
 
-    printf("First 16 bytes of ROM:\n");
-    for (int i = 0; i < 16; i++) 
+static void UPLOAD_FRAME(SDL_Texture* TEXTURE, const PRESENT_SLOT* SLOT, U32* UPLOADED)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    SCALE_BASE* SCALE = SCALE_GET_STATE();
+    int FACTOR = (int)SCALE->FACTOR;
+    SDL_Rect RECT;
+    void* PIXELS;
+    int PITCH;
+    int ROW = 0;
+    int LINE;
+
+    while (ROW < BMP->HEIGHT)
     {
-        printf("%02X ", CART->ROM_DATA[i]);
+        if (SLOT->ROW_FRAME[ROW] <= *UPLOADED)
+        {
+            ROW++;
+            continue;
+        }
+
+        RECT.x = 0;
+        RECT.y = ROW * FACTOR;
+        RECT.w = SCALE->WIDTH;
+
+        while (ROW < BMP->HEIGHT && SLOT->ROW_FRAME[ROW] > *UPLOADED)
+        {
+            ROW++;
+        }
+
+        RECT.h = ROW * FACTOR - RECT.y;
+
+        if (SDL_LockTexture(TEXTURE, &RECT, &PIXELS, &PITCH) != 0)
+            continue;
+
+        for (LINE = 0; LINE < RECT.h; LINE++)
+        {
+            memcpy((U8*)PIXELS + LINE * PITCH, SLOT->DATA + (RECT.y + LINE) * SCALE->PITCH, (UNK)SCALE->WIDTH * 4);
+        }
+
+        SDL_UnlockTexture(TEXTURE);
     }
-    
-    printf("\n");
 
-    return 0;
+    *UPLOADED = SLOT->FRAME;
 }
 
 void INIT_CHIPS(struct CPU_68K* CPU) 
@@ -79,19 +184,376 @@ void INIT_CHIPS(struct CPU_68K* CPU)
     }
 }
 
+/* COMMAND LINE OPTIONS - EVERYTHING BAR THE ROM PATH IS OPTIONAL */
+
+typedef struct MD_OPTIONS
+{
+    char* ROM_PATH;
+    char* TMSS_PATH;
+    bool SKIP_TMSS;
+    const char* ROM_CACHE_DIR;
+    TIMING_REGION REGION;
+    char* MOVIE_RECORD_PATH;
+    char* MOVIE_PLAY_PATH;
+    char* CAPTURE_PATH;
+    char* HASH_PATH;
+    unsigned HASH_INTERVAL;
+    bool HASH_MEMORY;
+    char* STATS_DUMP_PATH;
+    unsigned STATS_INTERVAL;
+    unsigned TURBO_SPEED;
+    unsigned FRAMESKIP;
+    unsigned SCALE;
+    SCALE_FILTER FILTER;
+    MD_CPU_CORE CPU_CORE;
+
+} MD_OPTIONS;
+
+static void PRINT_USAGE(const char* NAME)
+{
+    printf("HARRY CLARK - SEGA MEGA DRIVE EMULATOR\n");
+    fprintf(stderr, "Usage: %s [OPTIONS] <ROM_PATH>\n", NAME);
+    fprintf(stderr, "  --tmss <FILE>       Boot through a 2KB TMSS boot ROM, as on later consoles\n");
+    fprintf(stderr, "  --skip-tmss         Keep the TMSS registers but boot straight into the cartridge\n");
+    fprintf(stderr, "  --rom-cache         Share unpacked ROMs between instances through %s (never pruned)\n", ROM_CACHE_DEFAULT_DIR);
+    fprintf(stderr, "  --rom-cache-dir <D> As --rom-cache, keeping the shared ROMs in directory D\n");
+    fprintf(stderr, "  --region <REGION>   Console to run as: auto (default, from the ROM header), jp, us or eu\n");
+    fprintf(stderr, "  --record <FILE>     Record controller input and resets to a movie\n");
+    fprintf(stderr, "  --play <FILE>       Replay a movie, exiting once it finishes\n");
+    fprintf(stderr, "  --capture <NAME>    Losslessly capture every frame and it's audio to NAME.mdcv and NAME.wav\n");
+    fprintf(stderr, "  --hash <FILE>       Write framebuffer and audio hashes to FILE for regression checks\n");
+    fprintf(stderr, "  --hash-interval <N> Frames between each line of hashes (default 1)\n");
+    fprintf(stderr, "  --hash-memory       Hash VRAM, CRAM, VSRAM and work RAM as well\n");
+    fprintf(stderr, "  --stats <N>         Print averaged performance counters every N frames\n");
+    fprintf(stderr, "  --stats-dump <FILE> Write per-frame counters as CSV (or JSON for .json)\n");
+    fprintf(stderr, "  --cpu <CORE>        68K core to run: interp (default), cached or jit\n");
+    fprintf(stderr, "  --turbo <N>         Fast forward speed while TAB is toggled on (default %d)\n", MAIN_DEFAULT_TURBO);
+    fprintf(stderr, "  --frameskip <N>     Most frames to leave undrawn when falling behind, 0 to disable (default %d)\n", MAIN_DEFAULT_FRAMESKIP);
+    fprintf(stderr, "  --scale <N>         Whole number window scale, 1 (default) to %d\n", SCALE_MAX_FACTOR);
+    fprintf(stderr, "  --filter <FILTER>   Filter over the scaled output: none (default), scanline or smooth\n");
+}
+
+static int PARSE_OPTIONS(int argc, char* argv[], MD_OPTIONS* OPTIONS)
+{
+    int INDEX;
+
+    memset(OPTIONS, 0, sizeof(*OPTIONS));
+
+    OPTIONS->TURBO_SPEED = MAIN_DEFAULT_TURBO;
+    OPTIONS->FRAMESKIP = MAIN_DEFAULT_FRAMESKIP;
+    OPTIONS->SCALE = 1;
+    OPTIONS->HASH_INTERVAL = 1;
+    OPTIONS->FILTER = SCALE_FILTER_NONE;
+
+    for (INDEX = 1; INDEX < argc; INDEX++)
+    {
+        if (strcmp(argv[INDEX], "--tmss") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->TMSS_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--skip-tmss") == 0)
+        {
+            OPTIONS->SKIP_TMSS = true;
+        }
+
+        else if (strcmp(argv[INDEX], "--rom-cache") == 0)
+        {
+            OPTIONS->ROM_CACHE_DIR = ROM_CACHE_DEFAULT_DIR;
+        }
+
+        else if (strcmp(argv[INDEX], "--rom-cache-dir") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->ROM_CACHE_DIR = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--region") == 0 && INDEX + 1 < argc)
+        {
+            INDEX++;
+
+            if (strcmp(argv[INDEX], "jp") == 0)
+            {
+                OPTIONS->REGION = TIMING_REGION_JP;
+            }
+
+            else if (strcmp(argv[INDEX], "us") == 0)
+            {
+                OPTIONS->REGION = TIMING_REGION_US;
+            }
+
+            else if (strcmp(argv[INDEX], "eu") == 0)
+            {
+                OPTIONS->REGION = TIMING_REGION_EU;
+            }
+
+            else if (strcmp(argv[INDEX], "auto") != 0)
+            {
+                fprintf(stderr, "Unknown region: %s\n", argv[INDEX]);
+                return -1;
+            }
+        }
+
+        else if (strcmp(argv[INDEX], "--record") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->MOVIE_RECORD_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--play") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->MOVIE_PLAY_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--capture") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->CAPTURE_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--hash") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->HASH_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--hash-interval") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->HASH_INTERVAL = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+
+            if (OPTIONS->HASH_INTERVAL < 1)
+            {
+                fprintf(stderr, "Hash interval must be at least 1\n");
+                return -1;
+            }
+        }
+
+        else if (strcmp(argv[INDEX], "--hash-memory") == 0)
+        {
+            OPTIONS->HASH_MEMORY = true;
+        }
+
+        else if (strcmp(argv[INDEX], "--stats") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->STATS_INTERVAL = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+        }
+
+        else if (strcmp(argv[INDEX], "--stats-dump") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->STATS_DUMP_PATH = argv[++INDEX];
+        }
+
+        else if (strcmp(argv[INDEX], "--cpu") == 0 && INDEX + 1 < argc)
+        {
+            INDEX++;
+
+            if (strcmp(argv[INDEX], "cached") == 0)
+            {
+                OPTIONS->CPU_CORE = MD_CORE_CACHED;
+            }
+
+            else if (strcmp(argv[INDEX], "jit") == 0)
+            {
+                OPTIONS->CPU_CORE = MD_CORE_JIT;
+            }
+
+            else if (strcmp(argv[INDEX], "interp") != 0)
+            {
+                fprintf(stderr, "Unknown CPU core: %s\n", argv[INDEX]);
+                return -1;
+            }
+        }
+
+        else if (strcmp(argv[INDEX], "--turbo") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->TURBO_SPEED = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+
+            if (OPTIONS->TURBO_SPEED < 2 || OPTIONS->TURBO_SPEED > MAIN_MAX_TURBO)
+            {
+                fprintf(stderr, "Turbo speed must be between 2 and %d\n", MAIN_MAX_TURBO);
+                return -1;
+            }
+        }
+
+        else if (strcmp(argv[INDEX], "--frameskip") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->FRAMESKIP = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+        }
+
+        else if (strcmp(argv[INDEX], "--scale") == 0 && INDEX + 1 < argc)
+        {
+            OPTIONS->SCALE = (unsigned)strtoul(argv[++INDEX], NULL, 10);
+
+            if (OPTIONS->SCALE < 1 || OPTIONS->SCALE > SCALE_MAX_FACTOR)
+            {
+                fprintf(stderr, "Scale must be between 1 and %d\n", SCALE_MAX_FACTOR);
+                return -1;
+            }
+        }
+
+        else if (strcmp(argv[INDEX], "--filter") == 0 && INDEX + 1 < argc)
+        {
+            INDEX++;
+
+            if (strcmp(argv[INDEX], "scanline") == 0)
+            {
+                OPTIONS->FILTER = SCALE_FILTER_SCANLINE;
+            }
+
+            else if (strcmp(argv[INDEX], "smooth") == 0)
+            {
+                OPTIONS->FILTER = SCALE_FILTER_SMOOTH;
+            }
+
+            else if (strcmp(argv[INDEX], "none") != 0)
+            {
+                fprintf(stderr, "Unknown filter: %s\n", argv[INDEX]);
+                return -1;
+            }
+        }
+
+        else if (argv[INDEX][0] == '-')
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[INDEX]);
+            return -1;
+        }
+
+        else
+        {
+            OPTIONS->ROM_PATH = argv[INDEX];
+        }
+    }
+
+    if (OPTIONS->ROM_PATH == NULL || (OPTIONS->MOVIE_RECORD_PATH && OPTIONS->MOVIE_PLAY_PATH))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* SHARED BETWEEN THE PRESENTER (THE MAIN THREAD) AND THE EMULATION THREAD */
+/* THE PRESENTER WRITES THE TURBO AND RESET REQUESTS, EITHER SIDE MAY QUIT */
+
+static int MAIN_QUIT = 0;
+static int MAIN_TURBO = 0;
+static int MAIN_RESET = NONE;
+
+/* THE EMULATION THREAD PACES ITSELF OFF THE CLOCK RATHER THAN VSYNC */
+
+/* EACH PASS RUNS ONE CONSOLE FRAME, OR TURBO_SPEED OF THEM WHILE FAST */
+/* FORWARDING - ONLY THE LAST OF THEM IS DRAWN AND PUBLISHED */
+
+/* WHILE CAPTURING, EVERY FRAME IS DRAWN SO THAT EVERY FRAME CAN BE CAPTURED */
+/* AND LIKEWISE ANY FRAME WHICH IS DUE TO BE HASHED */
+
+static int EMULATION_THREAD(void* DATA)
+{
+    const MD_OPTIONS* OPTIONS = DATA;
+    MD* CONSOLE = MD_GET_CONSOLE();
+    MD_RESET_MODE RESET_REQUEST;
+    unsigned SPEED;
+    unsigned FRAME;
+    unsigned SKIPPED = 0;
+    bool SKIP;
+    U64 FREQUENCY = SDL_GetPerformanceFrequency();
+    U64 PERIOD = FREQUENCY * TIMING_GET_PROFILE()->FRAME_MCYCLES / TIMING_GET_PROFILE()->MASTER_CLOCK;
+    U64 DEADLINE = SDL_GetPerformanceCounter() + PERIOD;
+    U64 NOW;
+
+    while (!__atomic_load_n(&MAIN_QUIT, __ATOMIC_ACQUIRE))
+    {
+        SPEED = __atomic_load_n(&MAIN_TURBO, __ATOMIC_RELAXED) ? OPTIONS->TURBO_SPEED : 1;
+        AUDIO_SET_DECIMATION(SPEED);
+
+        /* MORE THAN A WHOLE FRAME BEHIND MEANS THE HOST ISN'T KEEPING UP - */
+        /* THIS PASS ISN'T DRAWN, SO THE NEXT ONE CAN CATCH UP */
+
+        NOW = SDL_GetPerformanceCounter();
+        SKIP = NOW > DEADLINE + PERIOD && SKIPPED < OPTIONS->FRAMESKIP;
+        SKIPPED = SKIP ? SKIPPED + 1 : 0;
+
+        for (FRAME = 0; FRAME < SPEED; FRAME++)
+        {
+            bool DRAW = !SKIP && FRAME == SPEED - 1;
+
+            PROFILE_FRAME_BEGIN();
+
+            IO_LATCH_INPUT();
+
+            /* THE MOVIE EITHER RECORDS THIS FRAME'S INPUT AND RESETS */
+            /* OR REPLACES THEM WITH THE RECORDED ONES */
+
+            RESET_REQUEST = __atomic_exchange_n(&MAIN_RESET, NONE, __ATOMIC_ACQ_REL);
+            RESET_REQUEST = MOVIE_UPDATE(RESET_REQUEST);
+
+            if (RESET_REQUEST != NONE)
+            {
+                MD_RESET(RESET_REQUEST);
+            }
+
+            VDP_SET_RENDER(DRAW || CAPTURE_ACTIVE() || HASH_DUE());
+            MD_RUN_FRAME();
+
+            PROFILE_BEGIN(PROFILE_CAPTURE);
+            CAPTURE_FRAME();
+            HASH_FRAME();
+            PROFILE_END(PROFILE_CAPTURE);
+
+            if (DRAW)
+            {
+                PROFILE_BEGIN(PROFILE_PRESENT);
+                PRESENT_PUBLISH();
+                PROFILE_END(PROFILE_PRESENT);
+            }
+
+            PROFILE_FRAME_END();
+
+            if (MOVIE_FINISHED())
+            {
+                printf("Movie playback finished after %u frames\n", CONSOLE->FRAME_COUNT);
+                __atomic_store_n(&MAIN_QUIT, 1, __ATOMIC_RELEASE);
+                return 0;
+            }
+        }
+
+        /* AFTER A LONG STALL, START AFRESH RATHER THAN RACING TO MAKE IT UP */
+
+        DEADLINE += PERIOD;
+        NOW = SDL_GetPerformanceCounter();
+
+        if (NOW > DEADLINE + PERIOD * (OPTIONS->FRAMESKIP + 1))
+        {
+            DEADLINE = NOW;
+        }
+
+        if (NOW < DEADLINE)
+        {
+            SDL_Delay((U32)((DEADLINE - NOW) * 1000 / FREQUENCY));
+        }
+    }
+
+    return 0;
+}
+
 int main(int argc, char* argv[]) 
 {
-    if (argc < 2) 
+    MD_OPTIONS OPTIONS;
+
+    if (PARSE_OPTIONS(argc, argv, &OPTIONS) != 0) 
     {
-        printf("HARRY CLARK - SEGA MEGA DRIVE EMULATOR\n");
-        fprintf(stderr, "Usage: %s <ROM_PATH>\n", argv[0]);
+        PRINT_USAGE(argv[0]);
         return -1;
     }
 
-    char* ROM_PATH = argv[1];
+    char* ROM_PATH = OPTIONS.ROM_PATH;
+
+    /* THE WINDOW, TEXTURE AND PRESENTED FRAMEBUFFERS ARE ALL SIZED FOR THE SCALED OUTPUT */
 
-    int QUIT = 0;
-    SDL_Window* WINDOW = SDL_CreateWindow("HARRY CLARK - MDEMU", 0, 0, 320, 240, SDL_WINDOW_SHOWN);
+    SCALE_INIT(OPTIONS.SCALE, OPTIONS.FILTER);
+
+    U32 UPLOADED = 0;
+    const PRESENT_SLOT* SLOT;
+    SDL_AudioDeviceID AUDIO_DEVICE;
+    SDL_Texture* TEXTURE;
+    SDL_Thread* THREAD;
+    SDL_Window* WINDOW = SDL_CreateWindow("HARRY CLARK - MDEMU", 0, 0, SCALE_GET_STATE()->WIDTH, SCALE_GET_STATE()->HEIGHT, SDL_WINDOW_SHOWN);
     SDL_Renderer* RENDERER = SDL_CreateRenderer(WINDOW, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     SDL_Event EV;
 
@@ -101,46 +563,177 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    MD* CONSOLE = (MD*)malloc(sizeof(MD));
-    memset(CONSOLE, 0, sizeof(MD));
+    /* THE CONSOLE, CARTRIDGE AND VDP ARE ALL CARVED OUT OF THE CONSOLE ARENA */
+
+    MD_INIT();
+    MD* CONSOLE = MD_GET_CONSOLE();
+
+    /* THE FRAMEBUFFER IS MIRRORED IN A STREAMING TEXTURE, ONLY EVER UPDATED A FEW ROWS AT A TIME */
+
+    TEXTURE = SDL_CreateTexture(RENDERER, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                SCALE_GET_STATE()->WIDTH, SCALE_GET_STATE()->HEIGHT);
 
-    CONSOLE->MD_CART = (MD_CART*)malloc(sizeof(MD_CART));
-    memset(CONSOLE->MD_CART, 0, sizeof(MD_CART));
+    if (TEXTURE == NULL)
+    {
+        printf("Failed to create texture: %s\n", SDL_GetError());
+        MD_FREE();
+        return -1;
+    }
 
-    VDP_INIT();
     INIT_CHIPS(&CPU);
+    ROM_CACHE_SET_DIR(OPTIONS.ROM_CACHE_DIR);
 
     if (MD_CART_LOAD((char*)ROM_PATH, CONSOLE->MD_CART) != 0) 
     {
         printf("Failed to load ROM from: %s\n", ROM_PATH);
-        free(CONSOLE->MD_CART);
-        free(CONSOLE);
-        free(VDP);
+        MD_FREE();
+        return -1;
+    }
+
+    /* THE BOOT ROM IS OVERLAID ON THE CARTRIDGE BY THE HARD RESET BELOW */
+
+    if (OPTIONS.TMSS_PATH != NULL && TMSS_LOAD_BOOT_ROM(OPTIONS.TMSS_PATH) != 0)
+    {
+        MD_FREE();
+        return -1;
+    }
+
+    TMSS_SET_SKIP(OPTIONS.SKIP_TMSS);
+
+    /* ANY SAVE MEMORY THE HEADER DECLARES IS MAPPED FROM A FILE BESIDE THE ROM */
+
+    SRAM_OPEN(ROM_PATH);
+
+    /* MOVIES ARE KEYED TO THE ROM THROUGH THE HEADER CHECKSUM */
+    /* AND ALWAYS BEGIN FROM POWER ON */
+
+    if (OPTIONS.MOVIE_RECORD_PATH != NULL && MOVIE_RECORD_OPEN(OPTIONS.MOVIE_RECORD_PATH, MD_ROM_HEADER()->CHECKSUM) != 0)
+    {
+        MD_FREE();
+        return -1;
+    }
+
+    if (OPTIONS.MOVIE_PLAY_PATH != NULL && MOVIE_PLAY_OPEN(OPTIONS.MOVIE_PLAY_PATH, MD_ROM_HEADER()->CHECKSUM) != 0)
+    {
+        MD_FREE();
+        return -1;
+    }
+
+    /* THE REGION IS PICKED FROM THE HEADER BY THE HARD RESET, UNLESS GIVEN */
+
+    TIMING_SET_REGION(OPTIONS.REGION);
+
+    MD_RESET(MODE_HARD);
+    MD_SET_CPU_CORE(OPTIONS.CPU_CORE);
+
+    /* COUNTERS ARE ONLY COLLECTED IN A PROFILE BUILD (make PROFILE=1) */
+
+    PROFILE_INIT();
+    PROFILE_SET_REPORT_INTERVAL(OPTIONS.STATS_INTERVAL);
+
+    if (OPTIONS.STATS_DUMP_PATH != NULL)
+    {
+        PROFILE_OPEN_DUMP(OPTIONS.STATS_DUMP_PATH);
+    }
+
+    /* THE CAPTURE'S QUEUE AND WRITER THREAD ARE SET UP AHEAD OF THE SEAL */
+
+    if (OPTIONS.CAPTURE_PATH != NULL && CAPTURE_OPEN(OPTIONS.CAPTURE_PATH) != 0)
+    {
+        MOVIE_CLOSE();
+        MD_FREE();
         return -1;
     }
 
-    while (!QUIT) 
+    if (OPTIONS.HASH_PATH != NULL && HASH_OPEN(OPTIONS.HASH_PATH, OPTIONS.HASH_INTERVAL, OPTIONS.HASH_MEMORY) != 0)
+    {
+        CAPTURE_CLOSE();
+        MOVIE_CLOSE();
+        MD_FREE();
+        return -1;
+    }
+
+    /* THE SCALED OUTPUT GOES TO ONE OF THREE FRAMEBUFFERS HANDED TO THE PRESENTER */
+
+    PRESENT_INIT();
+
+    /* FROM HERE ON OUT, THE EMULATION LOOP MUST NOT ALLOCATE */
+
+    MD_SEAL();
+
+    AUDIO_DEVICE = OPEN_AUDIO();
+
+    THREAD = SDL_CreateThread(EMULATION_THREAD, "emulation", &OPTIONS);
+
+    if (THREAD == NULL)
+    {
+        printf("Failed to start the emulation thread: %s\n", SDL_GetError());
+        __atomic_store_n(&MAIN_QUIT, 1, __ATOMIC_RELEASE);
+    }
+
+    /* THE MAIN THREAD ONLY HANDLES EVENTS, SAMPLES INPUT AND PRESENTS - */
+    /* IT IS THE ONLY THING WHICH EVER WAITS ON VSYNC */
+
+    while (!__atomic_load_n(&MAIN_QUIT, __ATOMIC_ACQUIRE)) 
     {
         while (SDL_PollEvent(&EV)) 
         {
             if (EV.type == SDL_QUIT) 
             {
-                QUIT = 1;
+                __atomic_store_n(&MAIN_QUIT, 1, __ATOMIC_RELEASE);
+            }
+
+            /* F1 PRESSES THE RESET BUTTON, F2 POWER CYCLES THE CONSOLE */
+            /* TAB TOGGLES FAST FORWARD */
+
+            if (EV.type == SDL_KEYDOWN && !EV.key.repeat)
+            {
+                if (EV.key.keysym.scancode == SDL_SCANCODE_F1) __atomic_store_n(&MAIN_RESET, MODE_SOFT, __ATOMIC_RELEASE);
+                if (EV.key.keysym.scancode == SDL_SCANCODE_F2) __atomic_store_n(&MAIN_RESET, MODE_HARD, __ATOMIC_RELEASE);
+                if (EV.key.keysym.scancode == SDL_SCANCODE_TAB) __atomic_store_n(&MAIN_TURBO, !MAIN_TURBO, __ATOMIC_RELAXED);
             }
         }
 
+        POLL_INPUT();
+
+        SLOT = PRESENT_ACQUIRE();
+
+        if (SLOT != NULL)
+        {
+            UPLOAD_FRAME(TEXTURE, SLOT, &UPLOADED);
+        }
+
         SDL_RenderClear(RENDERER);
+        SDL_RenderCopy(RENDERER, TEXTURE, NULL, NULL);
         SDL_RenderPresent(RENDERER);
     }
 
+    if (THREAD != NULL)
+    {
+        SDL_WaitThread(THREAD, NULL);
+    }
+
+    /* THE CALLBACK READS FROM THE ARENA, SO IT MUST BE STOPPED FIRST */
+
+    if (AUDIO_DEVICE != 0)
+    {
+        SDL_CloseAudioDevice(AUDIO_DEVICE);
+    }
+
+    MOVIE_CLOSE();
+    CAPTURE_CLOSE();
+    HASH_CLOSE();
+    SRAM_CLOSE();
+    PROFILE_CLOSE();
+
     if (CONSOLE->MD_CART->ROM_DATA != NULL) 
     {
-        free(CONSOLE->MD_CART->ROM_DATA);
+        ROM_RELEASE((U8*)CONSOLE->MD_CART->ROM_DATA);
     }
-    free(CONSOLE->MD_CART);
-    free(CONSOLE);
-    free(VDP);
 
+    MD_FREE();
+
+    SDL_DestroyTexture(TEXTURE);
     SDL_DestroyRenderer(RENDERER);
     SDL_DestroyWindow(WINDOW);
     SDL_Quit();
@@ -8,14 +8,37 @@
 
 #include "md.h"
 #include "common.h"
+#include "mem.h"
+#include "io.h"
+#include "irq.h"
+#include "psg.h"
+#include "audio.h"
+#include "present.h"
+#include "capture.h"
+#include "hash.h"
+#include "tmss.h"
+#include "sram.h"
+#include "timing.h"
+#include "render.h"
+#include "profile.h"
+#include "cache.h"
+#include "jit.h"
 
 #ifdef USE_MD
 
 static MD* MD_CONSOLE;
 static MD_CART* MD_CARTRIDGE;
+static PSG_BASE* MD_PSG;
+static MD_ARENA MD_CONSOLE_ARENA;
+static MD_CPU_CORE MD_CORE = MD_CORE_INTERPRETER;
+static int MD_SLICE_CLAMPED;
+
+/* HELD IN HOST WORD ORDER, AS THE ROM AND VRAM ARE (SEE mem.h) */
 
 static U8 WORK_RAM[0x10000];
 
+CPU_68K_MEMORY M68K_MEMORY_MAP[256];
+
 /* INITIALISE THE CONSOLE THROUGH THE PRE-REQUISTIES */
 /* ESTABLISHED IN THE CORRESPONDING HEADER FILES */
 
@@ -23,9 +46,72 @@ static U8 WORK_RAM[0x10000];
 /* THE MEMORY MANAGEMENT UNIT FOR ALLOWING THE CONSOLE TO BEGIN */
 /* IT'S INITIAL COMMUNICATIONS BETWEEN M68K AND Z80 ON STARTUP */
 
+/* ALL OF THE RUNTIME STATE FOR THE CONSOLE IS CARVED OUT OF A SINGLE ARENA */
+/* ALLOCATED HERE, SUCH THAT THE BUS HANDLERS AND PER-INSTRUCTION PATHS NEVER */
+/* HAVE TO REACH FOR THE HEAP ONCE EMULATION HAS STARTED */
+
+/* THE PRESENTER'S FRAMEBUFFERS DEPEND ON THE SCALE, SO THEY'RE SIZED ON TOP */
+
 void MD_INIT(void)
 {    
+    if(MD_ARENA_INIT(&MD_CONSOLE_ARENA, MD_ARENA_DEFAULT_SIZE + PRESENT_ARENA_SIZE()) != 0)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    MD_CONSOLE = MD_ALLOC(sizeof(MD));
+    MD_CARTRIDGE = MD_ALLOC(sizeof(MD_CART));
+    MD_CONSOLE->MD_CART = MD_CARTRIDGE;
+
+    MD_PSG = MD_ALLOC(sizeof(PSG_BASE));
+    PSG_CONST_INIT(MD_PSG);
+    PSG_STATE_INIT(MD_PSG);
+
+    VDP_INIT();
+    IO_INIT();
+    IRQ_INIT();
+    TMSS_INIT();
+    SRAM_INIT();
+    TIMING_INIT();
+    AUDIO_INIT();
     M68K_INIT();
+    M68K_CACHE_INIT();
+    M68K_JIT_INIT();
+}
+
+/* HAND OUT A BLOCK OF THE CONSOLE ARENA TO A SUBSYSTEM DURING INITIALISATION */
+
+void* MD_ALLOC(UNK SIZE)
+{
+    return MD_ARENA_ALLOC(&MD_CONSOLE_ARENA, SIZE);
+}
+
+MD* MD_GET_CONSOLE(void)
+{
+    return MD_CONSOLE;
+}
+
+U8* MD_GET_WORK_RAM(void)
+{
+    return WORK_RAM;
+}
+
+/* ONCE EVERY SUBSYSTEM HAS BEEN INITIALISED AND THE CARTRIDGE LOADED */
+/* SEAL THE ARENA - ANY LATER ALLOCATION IS A BUG IN THE HOT PATH */
+
+void MD_SEAL(void)
+{
+    MD_ARENA_SEAL(&MD_CONSOLE_ARENA);
+}
+
+void MD_FREE(void)
+{
+    M68K_JIT_SHUTDOWN();
+    MD_ARENA_FREE(&MD_CONSOLE_ARENA);
+
+    MD_CONSOLE = NULL;
+    MD_CARTRIDGE = NULL;
+    MD_PSG = NULL;
 }
 
 
@@ -39,14 +125,12 @@ void MD_INIT(void)
 /* A1, A2 & A3 ENCOMPASS THE INITIAL STEPS FOR HARDWARE COROUTINE CHECKS */
 /* AS THESE ARE THE MAIN 3 REGISTERS THAT COMMUNICATE WITH THE BUS */
 
-/* D7 ACTS AS THE STACK POINTER TO DETERMINE WHERE THE DATA SHOULD GO TOWARDS */
+/* EITHER WAY, THE STACK POINTER AND PC ARE RELOADED FROM THE VECTOR TABLE */
 
 /* SEE 68K INSTRUCTION REF. https://md.railgun.works/index.php?title=68k_Instruction_Reference */
 
-void MD_RESET(void)
+void MD_RESET(MD_RESET_MODE MODE)
 {
-    MD_RESET_MODE MODE = 0;
-
     switch (MODE)
     {
         /* SOFT RESET EVOKES THE METHODS USED TO */
@@ -58,9 +142,7 @@ void MD_RESET(void)
         /* IN RELATION TO THE BOOT RAM GOVERNED BY IT'S DESIGNATED DATA REGISTER */
 
         case MODE_SOFT:
-            CPU.PC = MD_CONSOLE->BOOT_RAM;
-            CPU.STACK_POINTER = 0x2700;
-            CPU.REGISTER_BASE[7] = MD_CONSOLE->BOOT_RAM;
+            CPU.STATUS_REGISTER = 0x2700;
             break;
 
         /* HARD RESET ENVOKES THAT ALL ASPECTS OF THE CONSOLE NEED TO BE */
@@ -73,16 +155,259 @@ void MD_RESET(void)
         /* BACK TO DEFAULT */
 
         case MODE_HARD:
-            CPU.PC = MD_CONSOLE->BOOT_RAM;
-            CPU.STACK_POINTER = 0x2700;
-            CPU.REGISTER_BASE[7] = MD_CONSOLE->BOOT_RAM;
+            CPU.STATUS_REGISTER = 0x2700;
             memset(MD_CONSOLE->BOOT_RAM, 0x00, sizeof(MD_CONSOLE->BOOT_RAM));
             memset(MD_CONSOLE->ZRAM, 0x00, sizeof(MD_CONSOLE->ZRAM));
+
+            /* THE REGION IS SETTLED AT POWER ON, FROM THE CARTRIDGE NOW INSERTED */
+
+            TIMING_APPLY();
+            IO_RESET();
             break;
 
         default:
             break;
     } 
+
+    IRQ_RESET();
+
+    /* A POWER CYCLE PUTS THE TMSS BOOT ROM BACK OVER THE CARTRIDGE */
+    /* AND RETURNS THE SAVE MEMORY TO IT'S POWER ON MAPPING */
+
+    if(MODE == MODE_HARD)
+    {
+        SRAM_RESET();
+    }
+
+    TMSS_RESET(MODE == MODE_HARD);
+
+    /* THE 68K FETCHES IT'S SUPERVISOR STACK POINTER AND PC FROM THE FIRST */
+    /* TWO VECTORS - OF THE BOOT ROM OR THE CARTRIDGE, WHICHEVER IS NOW MAPPED */
+
+    CPU.ADDRESS_REGISTER[7] = M68K_READ_32(0x000000);
+    CPU.PC = M68K_READ_32(0x000004) & 0xFFFFFF;
+
+    /* NOTHING DECODED BEFORE THE RESET CAN BE TRUSTED AFTERWARDS */
+
+    M68K_CACHE_FLUSH();
+    M68K_JIT_FLUSH();
+}
+
+void MD_SET_CPU_CORE(MD_CPU_CORE CORE)
+{
+    MD_CORE = CORE;
+    M68K_CACHE_FLUSH();
+    M68K_JIT_FLUSH();
+}
+
+static int MD_EXEC_68K(int CYCLES)
+{
+    switch (MD_CORE)
+    {
+        case MD_CORE_CACHED:    return M68K_CACHE_EXEC(CYCLES);
+        case MD_CORE_JIT:       return M68K_JIT_EXEC(CYCLES);
+        default:                break;
+    }
+
+    MD_SLICE_CLAMPED = 0;
+    CYCLES = M68K_EXEC(&CPU, CYCLES);
+
+    return CYCLES - MD_SLICE_CLAMPED;
+}
+
+/* CUT THE CURRENT SLICE SHORT SO THE SCHEDULER GETS A LOOK IN BEFORE THE DEADLINE */
+
+/* lib68k RUNS UNTIL IT'S REMAINING CYCLES ARE SPENT, SO THOSE ARE CLAMPED TO */
+/* NOTHING - AND TAKEN BACK OFF WHAT IT REPORTS ONCE IT RETURNS - WHEREAS THE */
+/* CACHED CORES STOP AT THE END OF THE BLOCK */
+
+void MD_END_SLICE(void)
+{
+    if(MD_CORE != MD_CORE_INTERPRETER)
+    {
+        M68K_CACHE_END_SLICE(true);
+        return;
+    }
+
+    if(CPU.INSTRUCTION_CYCLES > 0)
+    {
+        MD_SLICE_CLAMPED += CPU.INSTRUCTION_CYCLES;
+        CPU.INSTRUCTION_CYCLES = 0;
+    }
+}
+
+/* RUN THE CONSOLE FOR A SINGLE FRAME, ONE SCANLINE AT A TIME */
+/* EACH LINE GIVES THE 68K IT'S SHARE OF MASTER CYCLES BEFORE THE VDP */
+/* RENDERS IT AND THE I/O PORTS AGE THEIR TIMERS */
+
+/* THE 68K'S SHARE IS RUN IN SLICES WHICH END AT EACH INTERRUPT DEADLINE */
+/* (SEE irq.h), SO AN INTERRUPT IS TAKEN AT IT'S OWN CYCLE RATHER THAN */
+/* WHEREVER THE LINE HAPPENS TO END */
+
+/* THE INPUT FOR THE FRAME MUST HAVE BEEN LATCHED BEFOREHAND (SEE IO_LATCH_INPUT) */
+
+/* WHEN BUILT WITH MD_PROFILE, THE TIME SPENT IN EACH SUBSYSTEM AND THE */
+/* CYCLES THEY CONSUMED ARE ACCUMULATED INTO THE CURRENT PROFILE FRAME */
+
+void MD_RUN_FRAME(void)
+{
+    IRQ_BASE* IRQ = IRQ_GET_STATE();
+    int LINE;
+    int CYCLES;
+    int DEADLINE;
+
+    for (LINE = 0; LINE < VDP->LINES_PER_FRAME; LINE++)
+    {
+        PROFILE_BEGIN(PROFILE_CPU);
+
+        IRQ_BEGIN_LINE(LINE);
+
+        while (IRQ->CYCLE < MD_M68K_CYCLES_PER_LINE)
+        {
+            DEADLINE = IRQ_NEXT_DEADLINE(MD_M68K_CYCLES_PER_LINE);
+            CYCLES = MD_EXEC_68K(DEADLINE - IRQ->CYCLE);
+
+            /* A CORE WHICH REPORTS NOTHING RUN IS TREATED AS HAVING STALLED */
+
+            if(CYCLES <= 0)
+                CYCLES = DEADLINE - IRQ->CYCLE;
+
+            PROFILE_COUNT(PROFILE_M68K_CYCLES, CYCLES);
+            IRQ_ADVANCE(CYCLES);
+        }
+
+        IRQ_END_LINE(MD_M68K_CYCLES_PER_LINE);
+
+        PROFILE_END(PROFILE_CPU);
+
+        PROFILE_BEGIN(PROFILE_VDP);
+        VDP_LINE(LINE);
+        PROFILE_END(PROFILE_VDP);
+
+        PROFILE_BEGIN(PROFILE_AUDIO);
+        PSG_UPDATE(MD_PSG);
+        AUDIO_PUSH(MD_PSG->SAMPLE_BUFFER);
+        CAPTURE_AUDIO(MD_PSG->SAMPLE_BUFFER);
+        HASH_SAMPLE(MD_PSG->SAMPLE_BUFFER);
+        PROFILE_END(PROFILE_AUDIO);
+
+        IO_END_LINE();
+    }
+
+    MD_CONSOLE->FRAME_COUNT++;
+    SRAM_FRAME(MD_CONSOLE->FRAME_COUNT);
+}
+
+/* SAVE STATES COPY EACH SUBSYSTEM'S STATE BACK TO BACK INTO A CALLER */
+/* PROVIDED BUFFER - NOTHING IS ALLOCATED, SO THEY ARE SAFE TO TAKE MID-RUN */
+
+/* THE STRUCTURES ARE COPIED AS THEY SIT IN MEMORY, SO A STATE IS ONLY */
+/* VALID FOR THE BUILD WHICH PRODUCED IT */
+
+typedef struct MD_STATE_HEADER
+{
+    U32 MAGIC;
+    U32 VERSION;
+    U32 FRAME_COUNT;
+    U8 ZSTATE;
+    U8 TMSS[4];
+    U8 TMSS_BOOT;
+
+} MD_STATE_HEADER;
+
+#define     MD_STATE_COPY_OUT(PTR, DATA, LEN)       do { memcpy((PTR), (DATA), (LEN)); (PTR) += (LEN); } while (0)
+#define     MD_STATE_COPY_IN(PTR, DATA, LEN)        do { memcpy((DATA), (PTR), (LEN)); (PTR) += (LEN); } while (0)
+
+UNK MD_STATE_SIZE(void)
+{
+    return sizeof(MD_STATE_HEADER) + sizeof(CPU) + sizeof(WORK_RAM) +
+           sizeof(VDP_BASE) + sizeof(IO_BASE) + sizeof(IRQ_BASE) + sizeof(PSG_BASE);
+}
+
+UNK MD_SAVE_STATE(U8* BUFFER, UNK SIZE)
+{
+    MD_STATE_HEADER HEADER;
+    U8* PTR = BUFFER;
+
+    if(SIZE < MD_STATE_SIZE())
+        return 0;
+
+    memset(&HEADER, 0, sizeof(HEADER));
+    HEADER.MAGIC = MD_STATE_MAGIC;
+    HEADER.VERSION = MD_STATE_VERSION;
+    HEADER.FRAME_COUNT = MD_CONSOLE->FRAME_COUNT;
+    HEADER.ZSTATE = MD_CONSOLE->ZSTATE;
+    HEADER.TMSS_BOOT = TMSS_GET_STATE()->BOOT_MAPPED;
+    memcpy(HEADER.TMSS, MD_CONSOLE->TMSS, sizeof(HEADER.TMSS));
+
+    MD_STATE_COPY_OUT(PTR, &HEADER, sizeof(HEADER));
+    MD_STATE_COPY_OUT(PTR, &CPU, sizeof(CPU));
+    MD_STATE_COPY_OUT(PTR, WORK_RAM, sizeof(WORK_RAM));
+    MD_STATE_COPY_OUT(PTR, VDP, sizeof(VDP_BASE));
+    MD_STATE_COPY_OUT(PTR, IO_GET_STATE(), sizeof(IO_BASE));
+    MD_STATE_COPY_OUT(PTR, IRQ_GET_STATE(), sizeof(IRQ_BASE));
+    MD_STATE_COPY_OUT(PTR, MD_PSG, sizeof(PSG_BASE));
+
+    return (UNK)(PTR - BUFFER);
+}
+
+int MD_LOAD_STATE(const U8* BUFFER, UNK SIZE)
+{
+    MD_STATE_HEADER HEADER;
+    const U8* PTR = BUFFER;
+    S32* FIFO_TIMING;
+    U8* H_COUNTER_TABLE;
+    void(*SET_IRQ)(unsigned LEVEL);
+    void(*SET_IRQ_DELAY)(unsigned LEVEL);
+    S32(*INTERRUPT_CALLBACK)(unsigned INTERRUPT);
+
+    if(SIZE < MD_STATE_SIZE())
+        return -1;
+
+    MD_STATE_COPY_IN(PTR, &HEADER, sizeof(HEADER));
+
+    if(HEADER.MAGIC != MD_STATE_MAGIC || HEADER.VERSION != MD_STATE_VERSION)
+        return -1;
+
+    /* THE VDP'S TABLES AND THE CALLBACKS BELONG TO THIS RUN, NOT THE STATE */
+
+    FIFO_TIMING = VDP->FIFO_TIMING;
+    H_COUNTER_TABLE = VDP->H_COUNTER_TABLE;
+    SET_IRQ = VDP->SET_IRQ;
+    SET_IRQ_DELAY = VDP->SET_IRQ_DELAY;
+    INTERRUPT_CALLBACK = CPU.INTERRUPT_CALLBACK;
+
+    MD_STATE_COPY_IN(PTR, &CPU, sizeof(CPU));
+    MD_STATE_COPY_IN(PTR, WORK_RAM, sizeof(WORK_RAM));
+    MD_STATE_COPY_IN(PTR, VDP, sizeof(VDP_BASE));
+    MD_STATE_COPY_IN(PTR, IO_GET_STATE(), sizeof(IO_BASE));
+    MD_STATE_COPY_IN(PTR, IRQ_GET_STATE(), sizeof(IRQ_BASE));
+    MD_STATE_COPY_IN(PTR, MD_PSG, sizeof(PSG_BASE));
+
+    VDP->FIFO_TIMING = FIFO_TIMING;
+    VDP->H_COUNTER_TABLE = H_COUNTER_TABLE;
+    VDP->SET_IRQ = SET_IRQ;
+    VDP->SET_IRQ_DELAY = SET_IRQ_DELAY;
+    CPU.INTERRUPT_CALLBACK = INTERRUPT_CALLBACK;
+
+    MD_CONSOLE->FRAME_COUNT = HEADER.FRAME_COUNT;
+    MD_CONSOLE->ZSTATE = HEADER.ZSTATE;
+    memcpy(MD_CONSOLE->TMSS, HEADER.TMSS, sizeof(HEADER.TMSS));
+
+    /* THE CARTRIDGE WINDOW IS PUT BACK AS IT WAS, WHICH ALSO FLUSHES ANY DECODED CODE */
+
+    TMSS_RESTORE(HEADER.TMSS_BOOT);
+
+    /* THE FRAMEBUFFER, THE PALETTE AND THE LINE RENDERERS NO LONGER MATCH THE RESTORED VDP */
+
+    RENDER_SYNC();
+    VDP_INVALIDATE();
+
+    /* WORK RAM WAS REPLACED WHOLESALE, SO ANY CODE DECODED FROM IT IS STALE */
+
+    M68K_CACHE_FLUSH();
+    M68K_JIT_FLUSH();
+    return 0;
 }
 
 /* THE BANK SWITCH FUNCTIONS LOOKS INTO THE CORRESPODENCE STORED IN */
@@ -107,15 +432,8 @@ void MD_RESET(void)
 
 void MD_SAVE_REGISTER_STATE(struct CPU_68K* CPU_68K)
 {
-    int INDEX;
-
-    /* STORE THE MAIN 15 REGISTERS; DATA AND ADDRESS (MAIN M68000 CPU) */
-
-    for (INDEX = 0; INDEX < 8; INDEX++)
-        CPU_68K->REGISTER_BASE[INDEX] = CPU_68K->DATA_REGISTER[INDEX];
-
-    for (INDEX = 0; INDEX < 7; INDEX++)
-        CPU_68K->REGISTER_BASE[INDEX] = CPU_68K->ADDRESS_REGISTER[INDEX];
+    /* THE MAIN 15 REGISTERS; DATA AND ADDRESS (MAIN M68000 CPU) ARE ALREADY HELD */
+    /* BY VALUE AT THE HEAD OF THE STRUCTURE, SO ONLY THE STACK NEEDS SORTING OUT */
 
     /* THIS CHECKS TO SEE IF AND WHEN THE STACK POINTER COMES INTO INITIALISATION */
     /* THE STACK POINTER GOVERNS A 32 BIT UNSIGNED VALUE WHICH INCLUDES A 16 BIT SIGNED OPERAND */
@@ -124,20 +442,10 @@ void MD_SAVE_REGISTER_STATE(struct CPU_68K* CPU_68K)
     /* ONCE THE STACK HAS BEEN INITIALISED ON STARTUP (0x2000), A7 WILL */
     /* BEGIN TO LOAD CONTENTS FROM THE HEADER */
 
-    if(CPU_68K->STACK_POINTER && 0x2000)
-    {
-        CPU_68K->STACK_POINTER = CPU_68K->ADDRESS_REGISTER[7];
-        CPU_68K->USER_STACK = CPU_68K->ADDRESS_STACK_POINTER;
-    }
-    
+    if(CPU_68K->STATUS_REGISTER & 0x2000)
+        CPU_68K->INTERRUPT_SP = CPU_68K->ADDRESS_REGISTER[7];
     else
-    {
-        CPU_68K->STACK_POINTER = CPU_68K->ADDRESS_STACK_POINTER;
         CPU_68K->USER_STACK = CPU_68K->ADDRESS_REGISTER[7];
-    }
-
-    CPU_68K->PC += *(int*)malloc(sizeof(CPU_68K->PC));
-    CPU_68K->STATUS_REGISTER += *(U16*)malloc(sizeof(CPU_68K->STATUS_REGISTER));
 
     memset(CPU_68K, 0x00, sizeof(*CPU_68K));
 }
@@ -178,47 +486,6 @@ int MD_CART_UPDATE_BANKING(struct CPU_68K* CPU_68K, int BANKS)
     return BANKS_UPDATED;
 }
 
-/* INITIALISE THE CARTRIDGE COUROUTINE */
-/* BY ESTABLISHING THE VARIABLE ROM SIZE, ALLOCATING MEMORY */
-/* FOR THE ROM IMAGE AND DETERMINING VARIOUS INSTANCES OF THE BUFFER */
-
-/* WHILE THE FUNCTION IS AN INT, IT WILL BE VOID AS THERE WILL BE NO LOCAL */
-/* RETURN TYPE, JUST FOR BASIC CONDITIONS */
-
-int MD_CART_INIT(struct MD_CART* CART, unsigned char* DATA, unsigned long *SIZE)
-{
-    /* ASSUME TO BEGIN WITH THAT THERE IS NO CURRENT ROM */
-    /* BEING LOADED ONTO THE STACK */
-
-    CART->ROM_BASE = DATA;
-    CART->ROM_SIZE = SIZE;
-
-    /* CHECK TO DETERMINE IF THE FILE IS TOO BIG */
-    /* IN THE LUCKLIHOOD OF AN INCOMPLETE FILE TYPE */
-
-    if(CART->ROM_SIZE == MD_CART_ROM_SIZE)
-    {
-        return -2;
-    }
-
-    /* ALLOCATE INITAL SPACE FOR THE CARTRIDGE */
-
-    CART->ROM_BASE += *(unsigned char*)malloc(sizeof(CART->ROM_SIZE));
-
-    /* STORE THE INITIAL 512KB FOR SSE2 */
-    /* THIS IS BY ALIGNING 16 BYTES OF ADDRESSABLE VECTOR TYPES TO THE HEADER */
-    
-    memcpy(CART->ROM_DATA, CART->ROM_BASE, CART->ROM_SIZE);
-
-    /* AFTER ALLOCATING THE PROVIDED MEMORY TO THE STACK */
-    /* BEGIN BY INITIALISAING THE MEMORY MAP OF THE CARTRIDGE */
-
-    MD_CART_MEMORY_MAP();
-
-    free(CART);
-    return 0;
-}
-
 /* DISCERN THE MEMORY MAP FOR THE CARTRIDGE'S ROM SIZE */
 /* THIS IS BY TAKING INTO ACCOUNT SEVERAL FACTORS SUCH AS */
 /* SETTING THE ROM MAP, SETTING MAPPER REGISTER BASED ON BANKING TYPE */
@@ -243,9 +510,6 @@ void MD_CART_MEMORY_MAP(void)
         case MAPPER_READONLY:
             for (INDEX = 0; INDEX < 8; INDEX++)
                 MD_CARTRIDGE->CARTRIDGE_BANKS[INDEX] = MD_CART_BANK_RO;
-
-            memcpy(&MD_CARTRIDGE->REGISTER_READ, &CPU.REGISTER_BASE, sizeof(MD_CARTRIDGE->REGISTER_READ));
-
             break;
     }
 }
@@ -254,8 +518,6 @@ unsigned int Z80_READ(unsigned int ADDRESS)
 {
     unsigned int DATA = 0;
 
-    CPU.INSTRUCTION_CYCLES = malloc(M68K_LOW_BITMASK);
-
     switch((ADDRESS >> 13) & 3)
     {
         default:
@@ -267,9 +529,7 @@ unsigned int Z80_READ(unsigned int ADDRESS)
 
 void Z80_WRITE(unsigned int ADDRESS, unsigned int DATA)
 {
-    CPU.INSTRUCTION_CYCLES = malloc(M68K_LOW_BITMASK);
-
-    switch((ADDRESS > 13) & 3)
+    switch((ADDRESS >> 13) & 3)
     {
         case 0x7F:
             M68K_WRITE_8(ADDRESS, DATA);
@@ -280,12 +540,17 @@ void Z80_WRITE(unsigned int ADDRESS, unsigned int DATA)
     }
 }
 
+/* THE CONTROL BUS ($A10000 - $A1FFFF) HOUSES THE I/O PORTS AT THE VERY START */
+/* EVERYTHING ELSE WITHIN THE RANGE IS FORWARDED ONTO THE 68K'S OWN HANDLERS */
+
 unsigned int CTRL_READ_BYTE(unsigned int ADDRESS)
 {
     switch ((ADDRESS >> 8) & 0xFF)
     {
-        case 0x00 & 0xE0:
-            return M68K_READ_8(ADDRESS);
+        case 0x00:
+            if(!(ADDRESS & 0xE0))
+                return IO_READ_BYTE(ADDRESS);
+            break;
     }
 
     return M68K_READ_8(ADDRESS);
@@ -294,20 +559,51 @@ unsigned int CTRL_READ_BYTE(unsigned int ADDRESS)
 
 void CTRL_WRITE_BYTE(unsigned int ADDRESS, unsigned int DATA)
 {
-    DATA &= 8;
-    switch ((ADDRESS >> DATA) & 0xFF)
+    switch ((ADDRESS >> 8) & 0xFF)
     {
-        case 0x00 & 0xE1:
-            M68K_READ_8(ADDRESS);
+        /* ONLY THE ODD BYTE OF EACH I/O REGISTER IS DECODED */
+
+        case 0x00:
+            if((ADDRESS & 0xE1) == 0x01)
+                IO_WRITE_BYTE(ADDRESS, DATA & 0xFF);
+            return;
+
+        /* THE SRAM SWAP AND WRITE PROTECT AT $A130F1 */
+
+        case 0x30:
+            if((ADDRESS & 0xFF) == 0xF1)
+            {
+                SRAM_CONTROL(DATA);
+                return;
+            }
+            break;
+
+        /* THE TMSS SIGNATURE AND CARTRIDGE SELECT */
+
+        case 0x40:
+        case 0x41:
+            TMSS_WRITE_BYTE(ADDRESS, DATA);
+            return;
     }
+
+    M68K_WRITE_8(ADDRESS, DATA);
 }
 
 unsigned int CTRL_READ_WORD(unsigned int ADDRESS)
 {
+    unsigned DATA;
+
     switch ((ADDRESS >> 8) & 0xFF)      
     {
-        case 0x00 & 0xE0:
-            return M68K_READ_8(ADDRESS);
+        /* THE I/O REGISTERS ARE MIRRORED ACROSS BOTH BYTES OF THE WORD */
+
+        case 0x00:
+            if(!(ADDRESS & 0xE0))
+            {
+                DATA = IO_READ_BYTE(ADDRESS);
+                return (DATA << 8) | DATA;
+            }
+            break;
     }
 
     return M68K_READ_16(ADDRESS);
@@ -315,12 +611,28 @@ unsigned int CTRL_READ_WORD(unsigned int ADDRESS)
 
 void CTRL_WRITE_WORD(unsigned int ADDRESS, unsigned int DATA)
 {
-    DATA &= 8;
-    switch ((ADDRESS >> DATA) & 0xFF)
+    switch ((ADDRESS >> 8) & 0xFF)
     {
-        case 0x00 & 0xE1:
-            M68K_READ_8(ADDRESS);
+        case 0x00:
+            if(!(ADDRESS & 0xE0))
+                IO_WRITE_BYTE(ADDRESS, DATA & 0xFF);
+            return;
+
+        case 0x30:
+            if((ADDRESS & 0xFE) == 0xF0)
+            {
+                SRAM_CONTROL(DATA & 0xFF);
+                return;
+            }
+            break;
+
+        case 0x40:
+        case 0x41:
+            TMSS_WRITE_WORD(ADDRESS, DATA);
+            return;
     }
+
+    M68K_WRITE_16(ADDRESS, DATA);
 }
 
 
@@ -0,0 +1,183 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE FUNCTIONALITY ENCOMPASSING */
+/* THE MEMORY UTILITIES BETWEEN COMPONENTS AND THE CONNECTIONS BETWEEN THEM */
+
+/* NESTED INCLUDES */
+
+#include "mem.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdlib.h>
+#include <string.h>
+
+#if MD_SWAP_SIMD
+#include <emmintrin.h>
+#endif
+
+#ifdef USE_MD_ARENA
+
+/* ALLOCATE THE BACKING STORE FOR THE ARENA IN ONE GO */
+/* THE BLOCK IS CLEARED SUCH THAT EVERY SUBSYSTEM STARTS FROM A KNOWN STATE */
+
+int MD_ARENA_INIT(MD_ARENA* ARENA, UNK SIZE)
+{
+    ARENA->BASE = malloc(SIZE);
+    ARENA->SIZE = 0;
+    ARENA->OFFSET = 0;
+    ARENA->SEALED = false;
+
+    if(ARENA->BASE == NULL)
+    {
+        fprintf(stderr, "Could not allocate %lu bytes for the console arena\n", (unsigned long)SIZE);
+        return -1;
+    }
+
+    memset(ARENA->BASE, 0, SIZE);
+    ARENA->SIZE = SIZE;
+    return 0;
+}
+
+/* BUMP ALLOCATE FROM THE ARENA, KEEPING EVERY BLOCK CACHE LINE ALIGNED */
+/* SO THAT HOT STRUCTURES NEVER STRADDLE A LINE THEY DON'T OWN */
+
+void* MD_ARENA_ALLOC(MD_ARENA* ARENA, UNK SIZE)
+{
+    UNK OFFSET = (ARENA->OFFSET + (MD_ARENA_ALIGN - 1)) & ~(UNK)(MD_ARENA_ALIGN - 1);
+
+    if(ARENA->SEALED)
+    {
+        fprintf(stderr, "Attempted to allocate %lu bytes from a sealed arena\n", (unsigned long)SIZE);
+        abort();
+    }
+
+    if(ARENA->BASE == NULL || OFFSET + SIZE > ARENA->SIZE)
+    {
+        fprintf(stderr, "Console arena exhausted (%lu of %lu bytes used)\n",
+                (unsigned long)ARENA->OFFSET, (unsigned long)ARENA->SIZE);
+        abort();
+    }
+
+    ARENA->OFFSET = OFFSET + SIZE;
+    return ARENA->BASE + OFFSET;
+}
+
+/* MARK THE END OF INITIALISATION - FROM HERE ON OUT, THE EMULATION LOOP */
+/* MUST ONLY EVER USE MEMORY THAT HAS ALREADY BEEN HANDED OUT */
+
+void MD_ARENA_SEAL(MD_ARENA* ARENA)
+{
+    ARENA->SEALED = true;
+    MD_HEAP_GUARD_ARM(true);
+}
+
+void MD_ARENA_FREE(MD_ARENA* ARENA)
+{
+    MD_HEAP_GUARD_ARM(false);
+
+    free(ARENA->BASE);
+    ARENA->BASE = NULL;
+    ARENA->SIZE = 0;
+    ARENA->OFFSET = 0;
+    ARENA->SEALED = false;
+}
+
+/*===============================================================================*/
+/*                          DEBUG HEAP GUARD                                     */
+/*===============================================================================*/
+
+/* WHEN BUILT WITH MD_HEAP_GUARD, THE LINKER REDIRECTS EVERY MALLOC FAMILY CALL */
+/* FROM OUR OWN OBJECTS THROUGH THESE WRAPPERS */
+
+/* CALLS MADE FROM INSIDE SHARED LIBRARIES (SDL'S OWN ALLOCATIONS FOR INSTANCE) */
+/* ARE NOT REDIRECTED, SO THE GUARD ONLY EVER FIRES ON THE EMULATOR ITSELF */
+
+#if defined(MD_HEAP_GUARD)
+
+static volatile bool HEAP_GUARD_ARMED = false;
+
+extern void* __real_malloc(UNK SIZE);
+extern void* __real_calloc(UNK COUNT, UNK SIZE);
+extern void* __real_realloc(void* PTR, UNK SIZE);
+
+static void HEAP_GUARD_TRIP(const char* FUNC, UNK SIZE)
+{
+    fprintf(stderr, "HEAP GUARD: %s(%lu) called after the console arena was sealed\n",
+            FUNC, (unsigned long)SIZE);
+    abort();
+}
+
+void* __wrap_malloc(UNK SIZE)
+{
+    if(HEAP_GUARD_ARMED) HEAP_GUARD_TRIP("malloc", SIZE);
+    return __real_malloc(SIZE);
+}
+
+void* __wrap_calloc(UNK COUNT, UNK SIZE)
+{
+    if(HEAP_GUARD_ARMED) HEAP_GUARD_TRIP("calloc", COUNT * SIZE);
+    return __real_calloc(COUNT, SIZE);
+}
+
+void* __wrap_realloc(void* PTR, UNK SIZE)
+{
+    if(HEAP_GUARD_ARMED) HEAP_GUARD_TRIP("realloc", SIZE);
+    return __real_realloc(PTR, SIZE);
+}
+
+void MD_HEAP_GUARD_ARM(bool ARMED)
+{
+    HEAP_GUARD_ARMED = ARMED;
+}
+
+#else
+
+void MD_HEAP_GUARD_ARM(bool ARMED)
+{
+    (void)ARMED;
+}
+
+#endif
+#endif
+
+/*===============================================================================*/
+/*                          HOST WORD ORDER                                      */
+/*===============================================================================*/
+
+#ifdef USE_MD_WORD_ORDER
+
+/* TURN A BIG ENDIAN IMAGE INTO HOST WORDS IN PLACE, OR BACK AGAIN - ON A */
+/* BIG ENDIAN HOST THE TWO ARE ALREADY ONE AND THE SAME */
+
+void MD_SWAP_WORDS(void* DATA, UNK SIZE)
+{
+    U8* PTR = DATA;
+    UNK INDEX = 0;
+    U8 BYTE;
+
+    if(!MD_BYTE_XOR)
+        return;
+
+#if MD_SWAP_SIMD
+    __m128i WORDS;
+
+    for (; INDEX + 16 <= SIZE; INDEX += 16)
+    {
+        WORDS = _mm_loadu_si128((const __m128i*)(PTR + INDEX));
+        WORDS = _mm_or_si128(_mm_slli_epi16(WORDS, 8), _mm_srli_epi16(WORDS, 8));
+        _mm_storeu_si128((__m128i*)(PTR + INDEX), WORDS);
+    }
+#endif
+
+    for (; INDEX + 2 <= SIZE; INDEX += 2)
+    {
+        BYTE = PTR[INDEX];
+        PTR[INDEX] = PTR[INDEX + 1];
+        PTR[INDEX + 1] = BYTE;
+    }
+}
+
+#endif
@@ -0,0 +1,311 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE FUNCTIONALITY OF INPUT MOVIES */
+/* A MOVIE RECORDS THE CONTROLLER STATE OF EVERY FRAME ALONGSIDE ANY RESET */
+/* EVENTS, SUCH THAT A RUN CAN BE REPLAYED DETERMINISTICALLY FROM POWER ON */
+
+/* NESTED INCLUDES */
+
+#include "movie.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_MOVIE
+
+#define     MOVIE_HEADER_SIZE       20
+#define     MOVIE_RUN_SIZE          (3 + (IO_MAX_PLAYERS * 2) + 5)
+
+static MOVIE MD_MOVIE;
+
+/*===============================================================================*/
+/*                          SERIALISATION                                        */
+/*===============================================================================*/
+
+static void MOVIE_PUT_16(U8* DEST, U16 VALUE)
+{
+    DEST[0] = VALUE & 0xFF;
+    DEST[1] = VALUE >> 8;
+}
+
+static void MOVIE_PUT_32(U8* DEST, U32 VALUE)
+{
+    MOVIE_PUT_16(DEST, VALUE & 0xFFFF);
+    MOVIE_PUT_16(DEST + 2, VALUE >> 16);
+}
+
+static U16 MOVIE_GET_16(const U8* SRC)
+{
+    return SRC[0] | (SRC[1] << 8);
+}
+
+static U32 MOVIE_GET_32(const U8* SRC)
+{
+    return MOVIE_GET_16(SRC) | ((U32)MOVIE_GET_16(SRC + 2) << 16);
+}
+
+static bool MOVIE_INPUT_EQUAL(const IO_INPUT_SNAPSHOT* A, const IO_INPUT_SNAPSHOT* B)
+{
+    return memcmp(A->PAD, B->PAD, sizeof(A->PAD)) == 0 &&
+           A->MOUSE_X == B->MOUSE_X &&
+           A->MOUSE_Y == B->MOUSE_Y &&
+           A->MOUSE_BUTTONS == B->MOUSE_BUTTONS;
+}
+
+static void MOVIE_WRITE_HEADER(MOVIE* MOVIE, U32 RUN_COUNT)
+{
+    U8 HEADER[MOVIE_HEADER_SIZE];
+
+    memcpy(HEADER, MOVIE_MAGIC, 4);
+    MOVIE_PUT_16(HEADER + 4, MOVIE_VERSION);
+    MOVIE_PUT_16(HEADER + 6, IO_MAX_PLAYERS);
+    MOVIE_PUT_16(HEADER + 8, MOVIE->CART_CHECKSUM);
+    MOVIE_PUT_16(HEADER + 10, 0);
+    MOVIE_PUT_32(HEADER + 12, MOVIE->FRAME_COUNT);
+    MOVIE_PUT_32(HEADER + 16, RUN_COUNT);
+
+    fwrite(HEADER, 1, sizeof(HEADER), MOVIE->FILE);
+}
+
+static void MOVIE_WRITE_RUN(MOVIE* MOVIE, const MOVIE_RUN* RUN)
+{
+    U8 DATA[MOVIE_RUN_SIZE];
+    U8* PTR = DATA;
+    int INDEX;
+
+    MOVIE_PUT_16(PTR, RUN->COUNT); PTR += 2;
+    *PTR++ = RUN->EVENT;
+
+    for (INDEX = 0; INDEX < IO_MAX_PLAYERS; INDEX++, PTR += 2)
+        MOVIE_PUT_16(PTR, RUN->INPUT.PAD[INDEX]);
+
+    MOVIE_PUT_16(PTR, (U16)RUN->INPUT.MOUSE_X); PTR += 2;
+    MOVIE_PUT_16(PTR, (U16)RUN->INPUT.MOUSE_Y); PTR += 2;
+    *PTR = RUN->INPUT.MOUSE_BUTTONS;
+
+    fwrite(DATA, 1, sizeof(DATA), MOVIE->FILE);
+    MOVIE->RUN_COUNT++;
+}
+
+static void MOVIE_READ_RUN(const U8* DATA, MOVIE_RUN* RUN)
+{
+    int INDEX;
+
+    memset(RUN, 0, sizeof(*RUN));
+
+    RUN->COUNT = MOVIE_GET_16(DATA); DATA += 2;
+    RUN->EVENT = *DATA++;
+
+    for (INDEX = 0; INDEX < IO_MAX_PLAYERS; INDEX++, DATA += 2)
+        RUN->INPUT.PAD[INDEX] = MOVIE_GET_16(DATA);
+
+    RUN->INPUT.MOUSE_X = (S16)MOVIE_GET_16(DATA); DATA += 2;
+    RUN->INPUT.MOUSE_Y = (S16)MOVIE_GET_16(DATA); DATA += 2;
+    RUN->INPUT.MOUSE_BUTTONS = *DATA;
+}
+
+/*===============================================================================*/
+/*                          RECORDING AND PLAYBACK                               */
+/*===============================================================================*/
+
+/* THE HEADER IS WRITTEN UP FRONT AND PATCHED WITH THE FINAL COUNTS ON CLOSE */
+
+int MOVIE_RECORD_OPEN(const char* PATH, U16 CART_CHECKSUM)
+{
+    MOVIE* MOVIE = &MD_MOVIE;
+
+    memset(MOVIE, 0, sizeof(*MOVIE));
+
+    MOVIE->FILE = fopen(PATH, "wb");
+    if(MOVIE->FILE == NULL)
+    {
+        fprintf(stderr, "Failed to open movie for recording: %s\n", PATH);
+        return -1;
+    }
+
+    MOVIE->MODE = MOVIE_RECORD;
+    MOVIE->CART_CHECKSUM = CART_CHECKSUM;
+    MOVIE_WRITE_HEADER(MOVIE, 0);
+
+    printf("Recording movie: %s\n", PATH);
+    return 0;
+}
+
+/* THE WHOLE MOVIE IS DECODED UP FRONT, BEFORE THE CONSOLE ARENA IS SEALED */
+/* SUCH THAT PLAYBACK NEVER TOUCHES THE DISK OR THE HEAP */
+
+int MOVIE_PLAY_OPEN(const char* PATH, U16 CART_CHECKSUM)
+{
+    MOVIE* MOVIE = &MD_MOVIE;
+    U8 HEADER[MOVIE_HEADER_SIZE];
+    U8 DATA[MOVIE_RUN_SIZE];
+    U32 INDEX;
+
+    memset(MOVIE, 0, sizeof(*MOVIE));
+
+    MOVIE->FILE = fopen(PATH, "rb");
+    if(MOVIE->FILE == NULL)
+    {
+        fprintf(stderr, "Failed to open movie for playback: %s\n", PATH);
+        return -1;
+    }
+
+    if(fread(HEADER, 1, sizeof(HEADER), MOVIE->FILE) != sizeof(HEADER) ||
+       memcmp(HEADER, MOVIE_MAGIC, 4) != 0 ||
+       MOVIE_GET_16(HEADER + 4) != MOVIE_VERSION ||
+       MOVIE_GET_16(HEADER + 6) != IO_MAX_PLAYERS)
+    {
+        fprintf(stderr, "Not a valid movie file: %s\n", PATH);
+        MOVIE_CLOSE();
+        return -1;
+    }
+
+    MOVIE->CART_CHECKSUM = MOVIE_GET_16(HEADER + 8);
+    MOVIE->FRAME_COUNT = MOVIE_GET_32(HEADER + 12);
+    MOVIE->RUN_COUNT = MOVIE_GET_32(HEADER + 16);
+
+    if(MOVIE->CART_CHECKSUM != CART_CHECKSUM)
+    {
+        fprintf(stderr, "Movie was recorded against a different ROM (0x%04X, expected 0x%04X)\n",
+                MOVIE->CART_CHECKSUM, CART_CHECKSUM);
+    }
+
+    MOVIE->RUNS = malloc((MOVIE->RUN_COUNT ? MOVIE->RUN_COUNT : 1) * sizeof(MOVIE_RUN));
+    if(MOVIE->RUNS == NULL)
+    {
+        fprintf(stderr, "Memory Allocation failed for movie\n");
+        MOVIE_CLOSE();
+        return -1;
+    }
+
+    for (INDEX = 0; INDEX < MOVIE->RUN_COUNT; INDEX++)
+    {
+        if(fread(DATA, 1, sizeof(DATA), MOVIE->FILE) != sizeof(DATA))
+        {
+            fprintf(stderr, "Movie is truncated after %u runs: %s\n", INDEX, PATH);
+            MOVIE->RUN_COUNT = INDEX;
+            break;
+        }
+
+        MOVIE_READ_RUN(DATA, &MOVIE->RUNS[INDEX]);
+    }
+
+    fclose(MOVIE->FILE);
+    MOVIE->FILE = NULL;
+    MOVIE->MODE = MOVIE_PLAYBACK;
+
+    printf("Playing movie: %s (%u frames, %u runs)\n", PATH, MOVIE->FRAME_COUNT, MOVIE->RUN_COUNT);
+    return 0;
+}
+
+/* CALLED ONCE PER FRAME, AFTER THE HOST INPUT HAS BEEN LATCHED */
+
+/* WHEN RECORDING, THE LATCHED INPUT AND ANY REQUESTED RESET ARE APPENDED */
+/* WHEN PLAYING BACK, BOTH ARE REPLACED BY WHAT THE MOVIE HOLDS FOR THIS FRAME */
+
+/* RETURNS THE RESET WHICH SHOULD BE APPLIED BEFORE THE FRAME RUNS */
+
+MD_RESET_MODE MOVIE_UPDATE(MD_RESET_MODE REQUEST)
+{
+    MOVIE* MOVIE = &MD_MOVIE;
+    const MOVIE_RUN* RUN;
+    U8 EVENT = 0;
+
+    switch (MOVIE->MODE)
+    {
+        case MOVIE_RECORD:
+        {
+            const IO_INPUT_SNAPSHOT* INPUT = IO_CURRENT_INPUT();
+
+            if(REQUEST == MODE_SOFT) EVENT = MOVIE_EVENT_SOFT_RESET;
+            if(REQUEST == MODE_HARD) EVENT = MOVIE_EVENT_HARD_RESET;
+
+            /* EXTEND THE CURRENT RUN IF NOTHING HAS CHANGED */
+
+            if(MOVIE->FRAME > 0 && EVENT == 0 && MOVIE->CURRENT.COUNT < MOVIE_MAX_RUN &&
+               MOVIE_INPUT_EQUAL(&MOVIE->CURRENT.INPUT, INPUT))
+            {
+                MOVIE->CURRENT.COUNT++;
+            }
+
+            else
+            {
+                if(MOVIE->FRAME > 0)
+                    MOVIE_WRITE_RUN(MOVIE, &MOVIE->CURRENT);
+
+                MOVIE->CURRENT.COUNT = 1;
+                MOVIE->CURRENT.EVENT = EVENT;
+                MOVIE->CURRENT.INPUT = *INPUT;
+            }
+
+            MOVIE->FRAME++;
+            MOVIE->FRAME_COUNT = MOVIE->FRAME;
+            return REQUEST;
+        }
+
+        case MOVIE_PLAYBACK:
+        {
+            if(MOVIE->RUN_INDEX >= MOVIE->RUN_COUNT)
+                return NONE;
+
+            RUN = &MOVIE->RUNS[MOVIE->RUN_INDEX];
+
+            /* EVENTS ONLY FIRE ON THE FIRST FRAME OF THEIR RUN */
+
+            if(MOVIE->RUN_FRAME == 0)
+                EVENT = RUN->EVENT;
+
+            IO_OVERRIDE_INPUT(&RUN->INPUT);
+
+            if(++MOVIE->RUN_FRAME >= RUN->COUNT)
+            {
+                MOVIE->RUN_FRAME = 0;
+                MOVIE->RUN_INDEX++;
+            }
+
+            MOVIE->FRAME++;
+
+            if(EVENT & MOVIE_EVENT_HARD_RESET) return MODE_HARD;
+            if(EVENT & MOVIE_EVENT_SOFT_RESET) return MODE_SOFT;
+            return NONE;
+        }
+
+        default:
+            return REQUEST;
+    }
+}
+
+bool MOVIE_FINISHED(void)
+{
+    return MD_MOVIE.MODE == MOVIE_PLAYBACK && MD_MOVIE.RUN_INDEX >= MD_MOVIE.RUN_COUNT;
+}
+
+/* FLUSH THE FINAL RUN AND PATCH THE HEADER WITH THE TOTALS */
+
+void MOVIE_CLOSE(void)
+{
+    MOVIE* MOVIE = &MD_MOVIE;
+
+    if(MOVIE->MODE == MOVIE_RECORD && MOVIE->FILE != NULL)
+    {
+        if(MOVIE->FRAME > 0)
+            MOVIE_WRITE_RUN(MOVIE, &MOVIE->CURRENT);
+
+        rewind(MOVIE->FILE);
+        MOVIE_WRITE_HEADER(MOVIE, MOVIE->RUN_COUNT);
+
+        printf("Movie recorded: %u frames, %u runs\n", MOVIE->FRAME_COUNT, MOVIE->RUN_COUNT);
+    }
+
+    if(MOVIE->FILE != NULL)
+        fclose(MOVIE->FILE);
+
+    free(MOVIE->RUNS);
+    memset(MOVIE, 0, sizeof(*MOVIE));
+}
+
+#endif
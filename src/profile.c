@@ -0,0 +1,275 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE BUILT-IN PERFORMANCE COUNTERS */
+/* EVERY FRAME COLLECTS EVENT COUNTS (INSTRUCTIONS, VDP WRITES, DMA BYTES...) */
+/* AND THE TIME SPENT WITHIN EACH SUBSYSTEM, MEASURED WITH THE TIMESTAMP COUNTER */
+
+#define _POSIX_C_SOURCE 199309L
+
+/* NESTED INCLUDES */
+
+#include "profile.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef USE_PROFILE
+
+static const char* PROFILE_COUNTER_NAME[PROFILE_COUNTER_COUNT] =
+{
+    "m68k_instructions",
+    "m68k_cycles",
+    "vdp_writes",
+    "dma_bytes",
+    "audio_samples",
+    "vdp_lines_drawn",
+};
+
+static const char* PROFILE_SECTION_NAME[PROFILE_SECTION_COUNT] =
+{
+    "cpu_ms",
+    "vdp_ms",
+    "audio_ms",
+    "present_ms",
+    "capture_ms",
+};
+
+/* TIMESTAMP TICKS PER MILLISECOND, CALIBRATED AGAINST THE MONOTONIC CLOCK */
+
+static F64 PROFILE_TICKS_PER_MS = 1.0e6;
+
+U64 PROFILE_CLOCK_NS(void)
+{
+    struct timespec TIME;
+
+    clock_gettime(CLOCK_MONOTONIC, &TIME);
+    return (U64)TIME.tv_sec * 1000000000ULL + (U64)TIME.tv_nsec;
+}
+
+F64 PROFILE_TICKS_TO_MS(U64 TICKS)
+{
+    return (F64)TICKS / PROFILE_TICKS_PER_MS;
+}
+
+#if defined(MD_PROFILE)
+
+PROFILE_FRAME PROFILE_CURRENT;
+
+static PROFILE_FRAME PROFILE_LAST;
+static PROFILE_FRAME PROFILE_INTERVAL;
+static unsigned PROFILE_REPORT_INTERVAL = 0;
+static U32 PROFILE_FRAME_INDEX = 0;
+static U64 PROFILE_FRAME_START_TICKS = 0;
+
+static FILE* PROFILE_DUMP = NULL;
+static bool PROFILE_DUMP_JSON = false;
+static bool PROFILE_DUMP_FIRST = true;
+
+bool PROFILE_ENABLED(void)
+{
+    return true;
+}
+
+/* MEASURE HOW MANY TIMESTAMP TICKS ELAPSE OVER ~10MS OF WALL TIME - ONLY */
+/* A PROFILING BUILD PAYS FOR THIS AT START UP */
+
+void PROFILE_INIT(void)
+{
+    U64 START_NS = PROFILE_CLOCK_NS();
+    U64 START_TICKS = PROFILE_TICKS();
+    U64 ELAPSED_NS;
+
+    do
+    {
+        ELAPSED_NS = PROFILE_CLOCK_NS() - START_NS;
+
+    } while (ELAPSED_NS < 10000000ULL);
+
+    PROFILE_TICKS_PER_MS = (F64)(PROFILE_TICKS() - START_TICKS) * 1.0e6 / (F64)ELAPSED_NS;
+}
+
+void PROFILE_FRAME_START(void)
+{
+    memset(&PROFILE_CURRENT, 0, sizeof(PROFILE_CURRENT));
+    PROFILE_CURRENT.FRAME = PROFILE_FRAME_INDEX;
+    PROFILE_FRAME_START_TICKS = PROFILE_TICKS();
+}
+
+const PROFILE_FRAME* PROFILE_LAST_FRAME(void)
+{
+    return &PROFILE_LAST;
+}
+
+static void PROFILE_WRITE_DUMP(const PROFILE_FRAME* FRAME)
+{
+    int INDEX;
+
+    if(PROFILE_DUMP_JSON)
+    {
+        fprintf(PROFILE_DUMP, "%s\n  {\"frame\": %u", PROFILE_DUMP_FIRST ? "" : ",", FRAME->FRAME);
+
+        for (INDEX = 0; INDEX < PROFILE_COUNTER_COUNT; INDEX++)
+            fprintf(PROFILE_DUMP, ", \"%s\": %llu", PROFILE_COUNTER_NAME[INDEX], (unsigned long long)FRAME->COUNTER[INDEX]);
+
+        for (INDEX = 0; INDEX < PROFILE_SECTION_COUNT; INDEX++)
+            fprintf(PROFILE_DUMP, ", \"%s\": %.4f", PROFILE_SECTION_NAME[INDEX], PROFILE_TICKS_TO_MS(FRAME->TICKS[INDEX]));
+
+        fprintf(PROFILE_DUMP, ", \"frame_ms\": %.4f}", PROFILE_TICKS_TO_MS(FRAME->FRAME_TICKS));
+    }
+
+    else
+    {
+        fprintf(PROFILE_DUMP, "%u", FRAME->FRAME);
+
+        for (INDEX = 0; INDEX < PROFILE_COUNTER_COUNT; INDEX++)
+            fprintf(PROFILE_DUMP, ",%llu", (unsigned long long)FRAME->COUNTER[INDEX]);
+
+        for (INDEX = 0; INDEX < PROFILE_SECTION_COUNT; INDEX++)
+            fprintf(PROFILE_DUMP, ",%.4f", PROFILE_TICKS_TO_MS(FRAME->TICKS[INDEX]));
+
+        fprintf(PROFILE_DUMP, ",%.4f\n", PROFILE_TICKS_TO_MS(FRAME->FRAME_TICKS));
+    }
+
+    PROFILE_DUMP_FIRST = false;
+}
+
+/* PRINT THE AVERAGE OF EVERY COUNTER ACROSS THE LAST REPORTING INTERVAL */
+
+static void PROFILE_WRITE_REPORT(unsigned FRAMES)
+{
+    F64 FRAME_MS = PROFILE_TICKS_TO_MS(PROFILE_INTERVAL.FRAME_TICKS) / FRAMES;
+    int INDEX;
+
+    printf("[STATS] frame %u: %.3f ms/frame (%.1f fps)", PROFILE_FRAME_INDEX, FRAME_MS, FRAME_MS > 0.0 ? 1000.0 / FRAME_MS : 0.0);
+
+    for (INDEX = 0; INDEX < PROFILE_SECTION_COUNT; INDEX++)
+        printf(" %s=%.3f", PROFILE_SECTION_NAME[INDEX], PROFILE_TICKS_TO_MS(PROFILE_INTERVAL.TICKS[INDEX]) / FRAMES);
+
+    for (INDEX = 0; INDEX < PROFILE_COUNTER_COUNT; INDEX++)
+        printf(" %s=%llu", PROFILE_COUNTER_NAME[INDEX], (unsigned long long)(PROFILE_INTERVAL.COUNTER[INDEX] / FRAMES));
+
+    printf("\n");
+}
+
+void PROFILE_FRAME_FINISH(void)
+{
+    int INDEX;
+
+    PROFILE_CURRENT.FRAME_TICKS = PROFILE_TICKS() - PROFILE_FRAME_START_TICKS;
+    PROFILE_LAST = PROFILE_CURRENT;
+
+    for (INDEX = 0; INDEX < PROFILE_COUNTER_COUNT; INDEX++)
+        PROFILE_INTERVAL.COUNTER[INDEX] += PROFILE_CURRENT.COUNTER[INDEX];
+
+    for (INDEX = 0; INDEX < PROFILE_SECTION_COUNT; INDEX++)
+        PROFILE_INTERVAL.TICKS[INDEX] += PROFILE_CURRENT.TICKS[INDEX];
+
+    PROFILE_INTERVAL.FRAME_TICKS += PROFILE_CURRENT.FRAME_TICKS;
+    PROFILE_FRAME_INDEX++;
+
+    if(PROFILE_DUMP != NULL)
+        PROFILE_WRITE_DUMP(&PROFILE_CURRENT);
+
+    if(PROFILE_REPORT_INTERVAL && (PROFILE_FRAME_INDEX % PROFILE_REPORT_INTERVAL) == 0)
+    {
+        PROFILE_WRITE_REPORT(PROFILE_REPORT_INTERVAL);
+        memset(&PROFILE_INTERVAL, 0, sizeof(PROFILE_INTERVAL));
+    }
+}
+
+void PROFILE_SET_REPORT_INTERVAL(unsigned FRAMES)
+{
+    PROFILE_REPORT_INTERVAL = FRAMES;
+    memset(&PROFILE_INTERVAL, 0, sizeof(PROFILE_INTERVAL));
+}
+
+/* THE DUMP FORMAT IS PICKED FROM THE EXTENSION - .json PRODUCES AN ARRAY */
+/* OF PER-FRAME OBJECTS, ANYTHING ELSE PRODUCES CSV */
+
+int PROFILE_OPEN_DUMP(const char* PATH)
+{
+    const char* EXTENSION = strrchr(PATH, '.');
+    int INDEX;
+
+    PROFILE_DUMP = fopen(PATH, "w");
+    if(PROFILE_DUMP == NULL)
+    {
+        fprintf(stderr, "Failed to open stats dump: %s\n", PATH);
+        return -1;
+    }
+
+    PROFILE_DUMP_JSON = EXTENSION != NULL && strcmp(EXTENSION, ".json") == 0;
+    PROFILE_DUMP_FIRST = true;
+
+    if(PROFILE_DUMP_JSON)
+    {
+        fprintf(PROFILE_DUMP, "[");
+        return 0;
+    }
+
+    fprintf(PROFILE_DUMP, "frame");
+
+    for (INDEX = 0; INDEX < PROFILE_COUNTER_COUNT; INDEX++)
+        fprintf(PROFILE_DUMP, ",%s", PROFILE_COUNTER_NAME[INDEX]);
+
+    for (INDEX = 0; INDEX < PROFILE_SECTION_COUNT; INDEX++)
+        fprintf(PROFILE_DUMP, ",%s", PROFILE_SECTION_NAME[INDEX]);
+
+    fprintf(PROFILE_DUMP, ",frame_ms\n");
+    return 0;
+}
+
+void PROFILE_CLOSE(void)
+{
+    if(PROFILE_DUMP == NULL)
+        return;
+
+    if(PROFILE_DUMP_JSON)
+        fprintf(PROFILE_DUMP, "\n]\n");
+
+    fclose(PROFILE_DUMP);
+    PROFILE_DUMP = NULL;
+}
+
+#else
+
+/* PROFILING WAS NOT COMPILED IN - THE API REMAINS SO CALLERS DON'T NEED */
+/* THEIR OWN PRE-PROCESSOR GUARDS, BUT REPORTS NOTHING */
+
+static PROFILE_FRAME PROFILE_EMPTY;
+
+bool PROFILE_ENABLED(void)
+{
+    return false;
+}
+
+void PROFILE_INIT(void) {}
+void PROFILE_FRAME_START(void) {}
+void PROFILE_FRAME_FINISH(void) {}
+
+const PROFILE_FRAME* PROFILE_LAST_FRAME(void)
+{
+    return &PROFILE_EMPTY;
+}
+
+void PROFILE_SET_REPORT_INTERVAL(unsigned FRAMES)
+{
+    if(FRAMES)
+        fprintf(stderr, "Stats requested, but profiling was not compiled in (make PROFILE=1)\n");
+}
+
+int PROFILE_OPEN_DUMP(const char* PATH)
+{
+    fprintf(stderr, "Cannot write %s, profiling was not compiled in (make PROFILE=1)\n", PATH);
+    return -1;
+}
+
+void PROFILE_CLOSE(void) {}
+
+#endif
+#endif
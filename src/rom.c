@@ -0,0 +1,530 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS READING ROM IMAGES OFF OF THE DISK */
+/* SEE rom.h FOR AN OVERVIEW */
+
+#define _DEFAULT_SOURCE
+
+/* NESTED INCLUDES */
+
+#include "rom.h"
+#include "hash.h"
+
+/* SYSTEM INCLUDES */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if ROM_SIMD
+#include <emmintrin.h>
+#endif
+
+#ifdef USE_ROM_INPUT
+
+static ROM_STREAM ROM_INPUT;
+static ROM_CACHE_BASE ROM_CACHE;
+
+/* ONE SMD BLOCK AT A TIME IS INFLATED HERE, SMALL ENOUGH TO STAY IN CACHE */
+
+static U8 ROM_BLOCK[ROM_SMD_BLOCK];
+
+static inline U32 ROM_LE16(const U8* PTR)
+{
+    return PTR[0] | (PTR[1] << 8);
+}
+
+static inline U32 ROM_LE32(const U8* PTR)
+{
+    return PTR[0] | (PTR[1] << 8) | (PTR[2] << 16) | ((U32)PTR[3] << 24);
+}
+
+//================================================
+//              CONTAINERS
+//================================================
+
+/* THE LAST FOUR BYTES OF A GZIP FILE ARE IT'S UNCOMPRESSED SIZE */
+
+static int ROM_OPEN_GZIP(ROM_STREAM* STREAM, UNK FILE_SIZE)
+{
+    U8 TRAILER[4];
+
+    if(FILE_SIZE < 18 || fseek(STREAM->FILE, -4, SEEK_END) != 0 || fread(TRAILER, 1, 4, STREAM->FILE) != 4)
+        return -1;
+
+    STREAM->SIZE = ROM_LE32(TRAILER);
+    STREAM->REMAINING = FILE_SIZE;
+    rewind(STREAM->FILE);
+
+    /* 16 ON TOP OF THE WINDOW SIZE TELLS ZLIB TO EXPECT THE GZIP WRAPPER */
+
+    if(inflateInit2(&STREAM->ZLIB, 16 + MAX_WBITS) != Z_OK)
+        return -1;
+
+    STREAM->FORMAT = ROM_FORMAT_GZIP;
+    STREAM->INFLATING = true;
+    return 0;
+}
+
+/* THE CENTRAL DIRECTORY AT THE END OF A ZIP ALWAYS HAS THE REAL SIZES, */
+/* WHICH THE LOCAL HEADERS LEAVE OUT WHEN THE ARCHIVER WAS STREAMING - THE */
+/* FIRST ENTRY WHICH ISN'T A DIRECTORY IS TAKEN TO BE THE ROM */
+
+static int ROM_OPEN_ZIP(ROM_STREAM* STREAM, UNK FILE_SIZE)
+{
+    U8 ENTRY[46];
+    U8 LOCAL[30];
+    UNK TAIL = FILE_SIZE < ROM_CHUNK_SIZE ? FILE_SIZE : ROM_CHUNK_SIZE;
+    UNK INDEX;
+    U32 OFFSET = 0, COUNT = 0, METHOD = 0, COMPRESSED = 0, SIZE = 0, HEADER = 0;
+    bool FOUND = false;
+
+    /* FIND THE END OF CENTRAL DIRECTORY RECORD, BEHIND ANY TRAILING COMMENT */
+
+    if(fseek(STREAM->FILE, (long)(FILE_SIZE - TAIL), SEEK_SET) != 0 || fread(STREAM->INPUT, 1, TAIL, STREAM->FILE) != TAIL)
+        return -1;
+
+    for (INDEX = TAIL >= 22 ? TAIL - 22 : 0; INDEX > 0 && memcmp(STREAM->INPUT + INDEX, "PK\5\6", 4) != 0; INDEX--);
+
+    if(memcmp(STREAM->INPUT + INDEX, "PK\5\6", 4) != 0)
+        return -1;
+
+    COUNT = ROM_LE16(STREAM->INPUT + INDEX + 10);
+    OFFSET = ROM_LE32(STREAM->INPUT + INDEX + 16);
+
+    if(fseek(STREAM->FILE, (long)OFFSET, SEEK_SET) != 0)
+        return -1;
+
+    while (COUNT-- > 0 && fread(ENTRY, 1, sizeof(ENTRY), STREAM->FILE) == sizeof(ENTRY) && memcmp(ENTRY, "PK\1\2", 4) == 0)
+    {
+        METHOD = ROM_LE16(ENTRY + 10);
+        COMPRESSED = ROM_LE32(ENTRY + 20);
+        SIZE = ROM_LE32(ENTRY + 24);
+        HEADER = ROM_LE32(ENTRY + 42);
+
+        if(SIZE > 0)
+        {
+            FOUND = true;
+            break;
+        }
+
+        fseek(STREAM->FILE, (long)(ROM_LE16(ENTRY + 28) + ROM_LE16(ENTRY + 30) + ROM_LE16(ENTRY + 32)), SEEK_CUR);
+    }
+
+    if(!FOUND || (METHOD != 0 && METHOD != Z_DEFLATED))
+        return -1;
+
+    /* SKIP THE LOCAL HEADER, IT'S NAME AND IT'S EXTRA FIELD TO REACH THE DATA */
+
+    if(fseek(STREAM->FILE, (long)HEADER, SEEK_SET) != 0 || fread(LOCAL, 1, sizeof(LOCAL), STREAM->FILE) != sizeof(LOCAL) ||
+       memcmp(LOCAL, "PK\3\4", 4) != 0)
+        return -1;
+
+    if(fseek(STREAM->FILE, (long)(ROM_LE16(LOCAL + 26) + ROM_LE16(LOCAL + 28)), SEEK_CUR) != 0)
+        return -1;
+
+    STREAM->SIZE = SIZE;
+    STREAM->REMAINING = COMPRESSED;
+
+    if(METHOD == 0)
+    {
+        STREAM->FORMAT = ROM_FORMAT_ZIP_STORED;
+        return 0;
+    }
+
+    /* A NEGATIVE WINDOW SIZE IS A BARE DEFLATE STREAM, WITH NO WRAPPER */
+
+    if(inflateInit2(&STREAM->ZLIB, -MAX_WBITS) != Z_OK)
+        return -1;
+
+    STREAM->FORMAT = ROM_FORMAT_ZIP_DEFLATE;
+    STREAM->INFLATING = true;
+    return 0;
+}
+
+static int ROM_OPEN_STREAM(ROM_STREAM* STREAM, const char* PATH)
+{
+    U8 MAGIC[4] = { 0 };
+    long FILE_SIZE;
+
+    memset(&STREAM->ZLIB, 0, sizeof(STREAM->ZLIB));
+    STREAM->INFLATING = false;
+
+    STREAM->FILE = fopen(PATH, "rb");
+    if(STREAM->FILE == NULL)
+        return -1;
+
+    fseek(STREAM->FILE, 0, SEEK_END);
+    FILE_SIZE = ftell(STREAM->FILE);
+    rewind(STREAM->FILE);
+
+    if(FILE_SIZE <= 0)
+        return -1;
+
+    if(fread(MAGIC, 1, sizeof(MAGIC), STREAM->FILE) == sizeof(MAGIC))
+    {
+        if(MAGIC[0] == 0x1F && MAGIC[1] == 0x8B)
+            return ROM_OPEN_GZIP(STREAM, (UNK)FILE_SIZE);
+
+        if(memcmp(MAGIC, "PK\3\4", 4) == 0)
+            return ROM_OPEN_ZIP(STREAM, (UNK)FILE_SIZE);
+    }
+
+    rewind(STREAM->FILE);
+
+    STREAM->FORMAT = ROM_FORMAT_RAW;
+    STREAM->SIZE = (UNK)FILE_SIZE;
+    STREAM->REMAINING = (UNK)FILE_SIZE;
+    return 0;
+}
+
+/* FILL DST WITH THE NEXT LENGTH BYTES OF THE IMAGE - FEWER ARE ONLY EVER */
+/* RETURNED WHEN THE FILE RUNS OUT OR THE COMPRESSED DATA IS DAMAGED */
+
+static UNK ROM_READ(ROM_STREAM* STREAM, U8* DST, UNK LENGTH)
+{
+    z_stream* ZLIB = &STREAM->ZLIB;
+    UNK READ;
+    int RESULT;
+
+    if(!STREAM->INFLATING)
+    {
+        READ = fread(DST, 1, LENGTH < STREAM->REMAINING ? LENGTH : STREAM->REMAINING, STREAM->FILE);
+        STREAM->REMAINING -= READ;
+        return READ;
+    }
+
+    ZLIB->next_out = DST;
+    ZLIB->avail_out = (uInt)LENGTH;
+
+    while (ZLIB->avail_out > 0)
+    {
+        if(ZLIB->avail_in == 0)
+        {
+            READ = fread(STREAM->INPUT, 1, ROM_CHUNK_SIZE < STREAM->REMAINING ? ROM_CHUNK_SIZE : STREAM->REMAINING, STREAM->FILE);
+            if(READ == 0)
+                break;
+
+            STREAM->REMAINING -= READ;
+            ZLIB->next_in = STREAM->INPUT;
+            ZLIB->avail_in = (uInt)READ;
+        }
+
+        RESULT = inflate(ZLIB, Z_NO_FLUSH);
+
+        if(RESULT == Z_STREAM_END)
+            break;
+
+        if(RESULT != Z_OK && RESULT != Z_BUF_ERROR)
+            break;
+    }
+
+    return LENGTH - ZLIB->avail_out;
+}
+
+static void ROM_CLOSE_STREAM(ROM_STREAM* STREAM)
+{
+    if(STREAM->INFLATING)
+        inflateEnd(&STREAM->ZLIB);
+
+    if(STREAM->FILE != NULL)
+        fclose(STREAM->FILE);
+
+    STREAM->FILE = NULL;
+    STREAM->INFLATING = false;
+}
+
+//================================================
+//              SMD
+//================================================
+
+/* THE FIRST HALF OF EACH BLOCK HOLDS THE ODD BYTES, THE SECOND HALF THE EVEN */
+/* ONES - INTERLEAVING SIXTEEN OF EACH IS A SINGLE UNPACK INSTRUCTION EITHER WAY */
+
+void ROM_SMD_DEINTERLEAVE(U8* DST, const U8* SRC)
+{
+    const U8* ODD = SRC;
+    const U8* EVEN = SRC + ROM_SMD_HALF;
+    int INDEX = 0;
+
+#if ROM_SIMD
+    __m128i LOW, HIGH;
+
+    for (; INDEX < ROM_SMD_HALF; INDEX += 16)
+    {
+        LOW = _mm_loadu_si128((const __m128i*)(EVEN + INDEX));
+        HIGH = _mm_loadu_si128((const __m128i*)(ODD + INDEX));
+
+        _mm_storeu_si128((__m128i*)(DST + INDEX * 2), _mm_unpacklo_epi8(LOW, HIGH));
+        _mm_storeu_si128((__m128i*)(DST + INDEX * 2 + 16), _mm_unpackhi_epi8(LOW, HIGH));
+    }
+#endif
+
+    for (; INDEX < ROM_SMD_HALF; INDEX++)
+    {
+        DST[INDEX * 2] = EVEN[INDEX];
+        DST[INDEX * 2 + 1] = ODD[INDEX];
+    }
+}
+
+/* SMD DUMPS ARE A 512 BYTE HEADER AND WHOLE BLOCKS - THE HEADER OPENS WITH */
+/* THE BLOCK COUNT (THE LOW BYTE OF IT, FOR 4MB AND UP) AND CARRIES THE TYPE */
+/* BYTES $AA $BB AT OFFSET 8. A PLAIN IMAGE OF THE SAME SIZE WOULD HAVE IT'S */
+/* OWN "SEGA" HEADER SITTING WHERE THE SMD HEADER IS */
+
+static bool ROM_IS_SMD(const U8* HEADER, UNK SIZE)
+{
+    if(SIZE < ROM_SMD_HEADER + ROM_SMD_BLOCK || (SIZE - ROM_SMD_HEADER) % ROM_SMD_BLOCK != 0)
+        return false;
+
+    if(HEADER[8] != 0xAA || HEADER[9] != 0xBB || HEADER[0] != (U8)((SIZE - ROM_SMD_HEADER) / ROM_SMD_BLOCK))
+        return false;
+
+    return memcmp(HEADER + 0x100, "SEGA", 4) != 0;
+}
+
+//================================================
+//              LOADING
+//================================================
+
+/* THE IMAGE IS HANDED BACK IN A BUFFER OF IT'S OWN, WHICH THE CARTRIDGE KEEPS */
+
+int ROM_LOAD(const char* PATH, U8** DATA, UNK* SIZE)
+{
+    ROM_STREAM* STREAM = &ROM_INPUT;
+    U8 HEADER[ROM_SMD_HEADER];
+    UNK HEAD, LENGTH, OFFSET;
+    U8* IMAGE = NULL;
+    bool SMD;
+
+    *DATA = NULL;
+    *SIZE = 0;
+
+    if(ROM_OPEN_STREAM(STREAM, PATH) != 0 || STREAM->SIZE == 0 || STREAM->SIZE > ROM_MAX_SIZE)
+    {
+        ROM_CLOSE_STREAM(STREAM);
+        return -1;
+    }
+
+    /* THE FIRST 512 BYTES DECIDE WHETHER THIS IS AN SMD DUMP */
+
+    HEAD = ROM_READ(STREAM, HEADER, STREAM->SIZE < ROM_SMD_HEADER ? STREAM->SIZE : ROM_SMD_HEADER);
+    SMD = HEAD == ROM_SMD_HEADER && ROM_IS_SMD(HEADER, STREAM->SIZE);
+    LENGTH = SMD ? STREAM->SIZE - ROM_SMD_HEADER : STREAM->SIZE;
+
+    IMAGE = malloc(LENGTH);
+    if(IMAGE == NULL)
+    {
+        ROM_CLOSE_STREAM(STREAM);
+        return -1;
+    }
+
+    if(SMD)
+    {
+        for (OFFSET = 0; OFFSET < LENGTH; OFFSET += ROM_SMD_BLOCK)
+        {
+            if(ROM_READ(STREAM, ROM_BLOCK, ROM_SMD_BLOCK) != ROM_SMD_BLOCK)
+                break;
+
+            ROM_SMD_DEINTERLEAVE(IMAGE + OFFSET, ROM_BLOCK);
+        }
+    }
+
+    else
+    {
+        memcpy(IMAGE, HEADER, HEAD);
+        OFFSET = HEAD + ROM_READ(STREAM, IMAGE + HEAD, LENGTH - HEAD);
+    }
+
+    ROM_CLOSE_STREAM(STREAM);
+
+    if(OFFSET != LENGTH)
+    {
+        fprintf(stderr, "ROM image is truncated or damaged: %s\n", PATH);
+        free(IMAGE);
+        return -1;
+    }
+
+    if(SMD)
+        printf("SMD dump de-interleaved: %lu blocks\n", (unsigned long)(LENGTH / ROM_SMD_BLOCK));
+
+    *DATA = IMAGE;
+    *SIZE = LENGTH;
+    return 0;
+}
+
+/* AN IMAGE FROM THE CACHE IS A MAPPING, ANYTHING ELSE CAME FROM THE HEAP */
+
+void ROM_RELEASE(U8* DATA)
+{
+    if(DATA == NULL)
+        return;
+
+    if(ROM_CACHE.MAPPING != NULL && DATA == ROM_CACHE.MAPPING + ROM_CACHE_DATA_OFFSET)
+    {
+        munmap(ROM_CACHE.MAPPING, ROM_CACHE.MAPPING_SIZE);
+        ROM_CACHE.MAPPING = NULL;
+        ROM_CACHE.MAPPING_SIZE = 0;
+        return;
+    }
+
+    free(DATA);
+}
+
+//================================================
+//              SHARED CACHE
+//================================================
+
+/* THE CACHE IS OFF UNTIL A DIRECTORY IS GIVEN */
+
+void ROM_CACHE_SET_DIR(const char* DIR)
+{
+    ROM_CACHE.DIR = DIR;
+}
+
+/* THE KEY IS THE HASH OF THE FILE AS IT SITS ON THE DISK - READING IT */
+/* THROUGH ONCE IS FAR CHEAPER THAN INFLATING OR DE-INTERLEAVING IT */
+
+static int ROM_CACHE_KEY(const char* PATH, U64* KEY)
+{
+    HASH_STATE STATE;
+    FILE* FILE;
+    UNK READ;
+
+    FILE = fopen(PATH, "rb");
+    if(FILE == NULL)
+        return -1;
+
+    HASH_RESET(&STATE, ROM_CACHE_VERSION);
+
+    while ((READ = fread(ROM_INPUT.INPUT, 1, ROM_CHUNK_SIZE, FILE)) > 0)
+    {
+        HASH_UPDATE(&STATE, ROM_INPUT.INPUT, READ);
+    }
+
+    fclose(FILE);
+
+    *KEY = HASH_DIGEST(&STATE);
+    return 0;
+}
+
+static void ROM_CACHE_PATH(char* PATH, UNK LENGTH, U64 KEY)
+{
+    snprintf(PATH, LENGTH, "%s/%016llx.mdrom", ROM_CACHE.DIR, (unsigned long long)KEY);
+}
+
+/* MAP AN ENTRY FOR THE FILE, IF ONE EXISTS - THE MAPPING IS READ ONLY, SO */
+/* THE PAGES ARE SHARED WITH EVERY OTHER INSTANCE FOR AS LONG AS THEY RUN */
+
+int ROM_CACHE_ATTACH(const char* PATH, U8** DATA, UNK* SIZE, U16* CHECKSUM, ROM_INFO* INFO)
+{
+    ROM_CACHE_HEADER* HEADER;
+    char ENTRY[4096];
+    struct stat STAT;
+    U8* MAPPING;
+    int FILE;
+
+    ROM_CACHE.KEYED = false;
+
+    if(ROM_CACHE.DIR == NULL || ROM_CACHE_KEY(PATH, &ROM_CACHE.KEY) != 0)
+        return -1;
+
+    ROM_CACHE.KEYED = true;
+    ROM_CACHE_PATH(ENTRY, sizeof(ENTRY), ROM_CACHE.KEY);
+
+    FILE = open(ENTRY, O_RDONLY);
+    if(FILE < 0)
+        return -1;
+
+    if(fstat(FILE, &STAT) != 0 || (UNK)STAT.st_size <= ROM_CACHE_DATA_OFFSET)
+    {
+        close(FILE);
+        return -1;
+    }
+
+    MAPPING = mmap(NULL, (UNK)STAT.st_size, PROT_READ, MAP_SHARED, FILE, 0);
+    close(FILE);
+
+    if(MAPPING == MAP_FAILED)
+        return -1;
+
+    /* ENTRIES ARE ONLY EVER RENAMED INTO PLACE WHOLE, SO CHECKING THE */
+    /* HEADER AGAINST THE KEY AND THE FILE'S SIZE IS ENOUGH */
+
+    HEADER = (ROM_CACHE_HEADER*)MAPPING;
+
+    if(memcmp(HEADER->MAGIC, ROM_CACHE_MAGIC, 4) != 0 || HEADER->VERSION != ROM_CACHE_VERSION ||
+       HEADER->KEY != ROM_CACHE.KEY || (UNK)HEADER->SIZE + ROM_CACHE_DATA_OFFSET != (UNK)STAT.st_size)
+    {
+        munmap(MAPPING, (UNK)STAT.st_size);
+        return -1;
+    }
+
+    ROM_CACHE.MAPPING = MAPPING;
+    ROM_CACHE.MAPPING_SIZE = (UNK)STAT.st_size;
+
+    *DATA = MAPPING + ROM_CACHE_DATA_OFFSET;
+    *SIZE = HEADER->SIZE;
+    *CHECKSUM = HEADER->CHECKSUM;
+    *INFO = HEADER->INFO;
+
+    printf("ROM attached from cache: %s\n", ENTRY);
+    return 0;
+}
+
+/* AFTER A MISS, WRITE THE UNPACKED IMAGE OUT UNDER A TEMPORARY NAME AND */
+/* RENAME IT INTO PLACE - INSTANCES RACING TO STORE THE SAME ROM EACH WRITE */
+/* A COMPLETE COPY, AND WHICHEVER RENAME LANDS LAST WINS */
+
+void ROM_CACHE_STORE(const U8* DATA, UNK SIZE, U16 CHECKSUM, const ROM_INFO* INFO)
+{
+    ROM_CACHE_HEADER HEADER;
+    char ENTRY[4096];
+    char TEMP[4096];
+    U8 PAGE[ROM_CACHE_DATA_OFFSET];
+    int FILE;
+    bool WRITTEN;
+
+    if(ROM_CACHE.DIR == NULL || !ROM_CACHE.KEYED)
+        return;
+
+    if(mkdir(ROM_CACHE.DIR, 0755) != 0 && errno != EEXIST)
+        return;
+
+    memset(&HEADER, 0, sizeof(HEADER));
+    memcpy(HEADER.MAGIC, ROM_CACHE_MAGIC, 4);
+    HEADER.VERSION = ROM_CACHE_VERSION;
+    HEADER.KEY = ROM_CACHE.KEY;
+    HEADER.SIZE = (U32)SIZE;
+    HEADER.CHECKSUM = CHECKSUM;
+    HEADER.INFO = *INFO;
+
+    memset(PAGE, 0, sizeof(PAGE));
+    memcpy(PAGE, &HEADER, sizeof(HEADER));
+
+    ROM_CACHE_PATH(ENTRY, sizeof(ENTRY), ROM_CACHE.KEY);
+    snprintf(TEMP, sizeof(TEMP), "%s.%ld.tmp", ENTRY, (long)getpid());
+
+    FILE = open(TEMP, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(FILE < 0)
+        return;
+
+    WRITTEN = write(FILE, PAGE, sizeof(PAGE)) == (ssize_t)sizeof(PAGE) && write(FILE, DATA, SIZE) == (ssize_t)SIZE;
+    close(FILE);
+
+    if(!WRITTEN || rename(TEMP, ENTRY) != 0)
+    {
+        unlink(TEMP);
+        return;
+    }
+
+    printf("ROM stored in cache: %s\n", ENTRY);
+}
+
+#endif
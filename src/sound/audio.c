@@ -0,0 +1,155 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE HAND OFF OF SAMPLES FROM THE SOUND CHIPS TO THE HOST */
+/* SEE audio.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "audio.h"
+#include "md.h"
+#include "vdp.h"
+#include "timing.h"
+#include "profile.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_AUDIO
+
+static AUDIO_BASE* AUDIO;
+
+void AUDIO_INIT(void)
+{
+    AUDIO = MD_ALLOC(sizeof(AUDIO_BASE));
+    AUDIO->RING = MD_ALLOC(AUDIO_RING_SIZE * sizeof(S16));
+
+    AUDIO_RESET();
+}
+
+/* ONLY SAFE BEFORE THE HOST HAS STARTED PULLING - THE TAIL BELONGS TO THE CONSUMER */
+
+void AUDIO_RESET(void)
+{
+    memset(AUDIO->RING, 0, AUDIO_RING_SIZE * sizeof(S16));
+
+    AUDIO->HEAD = 0;
+    AUDIO->TAIL = 0;
+    AUDIO->DECIMATION = 1;
+    AUDIO->PENDING = 0;
+    AUDIO->ACCUMULATOR = 0;
+    AUDIO->LAST = 0;
+    AUDIO->DROPPED = 0;
+    AUDIO->UNDERRUNS = 0;
+}
+
+/* ANY PART FILLED GROUP IS THROWN AWAY, SO THE NEXT SAMPLE OUT IS */
+/* ALWAYS AN AVERAGE OF THE NEW FACTOR */
+
+void AUDIO_SET_DECIMATION(unsigned FACTOR)
+{
+    if(FACTOR < 1)                      FACTOR = 1;
+    if(FACTOR > AUDIO_MAX_DECIMATION)   FACTOR = AUDIO_MAX_DECIMATION;
+
+    if(FACTOR == AUDIO->DECIMATION)
+        return;
+
+    AUDIO->DECIMATION = FACTOR;
+    AUDIO->PENDING = 0;
+    AUDIO->ACCUMULATOR = 0;
+}
+
+//================================================
+//              PRODUCER
+//================================================
+
+void AUDIO_PUSH(S16 SAMPLE)
+{
+    U32 HEAD = AUDIO->HEAD;
+    U32 TAIL;
+
+    AUDIO->ACCUMULATOR += SAMPLE;
+
+    if(++AUDIO->PENDING < AUDIO->DECIMATION)
+        return;
+
+    SAMPLE = (S16)(AUDIO->ACCUMULATOR / (S32)AUDIO->DECIMATION);
+    AUDIO->PENDING = 0;
+    AUDIO->ACCUMULATOR = 0;
+
+    /* A FULL RING MEANS THE HOST IS BEHIND - DROP THE NEWEST SAMPLE */
+    /* RATHER THAN TEARING THROUGH WHAT IT HASN'T PLAYED YET */
+
+    TAIL = __atomic_load_n(&AUDIO->TAIL, __ATOMIC_ACQUIRE);
+
+    if(HEAD - TAIL >= AUDIO_RING_SIZE)
+    {
+        AUDIO->DROPPED++;
+        return;
+    }
+
+    AUDIO->RING[HEAD & AUDIO_RING_MASK] = SAMPLE;
+    __atomic_store_n(&AUDIO->HEAD, HEAD + 1, __ATOMIC_RELEASE);
+
+    PROFILE_COUNT(PROFILE_AUDIO_SAMPLES, 1);
+}
+
+//================================================
+//              CONSUMER
+//================================================
+
+/* FILL THE HOST'S BUFFER, HOLDING THE LAST SAMPLE ACROSS ANY SHORTFALL */
+/* SO AN UNDERRUN IS A FLAT SPOT RATHER THAN A CLICK - RETURNS HOW MANY */
+/* OF THE SAMPLES WERE REAL */
+
+UNK AUDIO_PULL(S16* BUFFER, UNK COUNT)
+{
+    U32 TAIL = AUDIO->TAIL;
+    U32 HEAD = __atomic_load_n(&AUDIO->HEAD, __ATOMIC_ACQUIRE);
+    UNK AVAILABLE = HEAD - TAIL;
+    UNK INDEX;
+
+    if(AVAILABLE > COUNT)
+        AVAILABLE = COUNT;
+
+    for (INDEX = 0; INDEX < AVAILABLE; INDEX++)
+    {
+        BUFFER[INDEX] = AUDIO->RING[(TAIL + INDEX) & AUDIO_RING_MASK];
+    }
+
+    if(AVAILABLE > 0)
+        AUDIO->LAST = BUFFER[AVAILABLE - 1];
+
+    if(AVAILABLE < COUNT)
+        AUDIO->UNDERRUNS++;
+
+    for (INDEX = AVAILABLE; INDEX < COUNT; INDEX++)
+    {
+        BUFFER[INDEX] = AUDIO->LAST;
+    }
+
+    __atomic_store_n(&AUDIO->TAIL, TAIL + (U32)AVAILABLE, __ATOMIC_RELEASE);
+
+    return AVAILABLE;
+}
+
+UNK AUDIO_AVAILABLE(void)
+{
+    return __atomic_load_n(&AUDIO->HEAD, __ATOMIC_ACQUIRE) - __atomic_load_n(&AUDIO->TAIL, __ATOMIC_ACQUIRE);
+}
+
+/* ONE SAMPLE IS PRODUCED PER SCANLINE - THE LINE RATE OF THE CONSOLE'S PROFILE */
+
+unsigned AUDIO_SAMPLE_RATE(void)
+{
+    return TIMING_GET_PROFILE()->SAMPLE_RATE;
+}
+
+AUDIO_BASE* AUDIO_GET_STATE(void)
+{
+    return AUDIO;
+}
+
+#endif
@@ -10,6 +10,10 @@
 
 #include "psg.h"
 
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
 #undef USE_PSG
 
 /* INITIALISE THE CONSTANT STRUCTURE OF THE PSG */
@@ -39,12 +43,12 @@ void PSG_CONST_INIT(PSG_BASE* PSG_BASE)
     PSG_BASE->VOLUME[0xF][1] = 0;
 }
 
-/* AND OF COURSE, FREE ANY AND ALL UNWANTED MEMORY */
-/* FROM THE STRUCTURE WHEN NOT IN USE */
+/* AND OF COURSE, CLEAR ANY AND ALL STATE FROM THE STRUCTURE WHEN NOT IN USE */
+/* THE STORAGE ITSELF BELONGS TO THE CONSOLE ARENA, SO IT IS NEVER FREED HERE */
 
 void PSG_FREE(PSG_BASE* PSG_BASE)
 {
-    free(PSG_BASE);
+    memset(PSG_BASE, 0, sizeof(*PSG_BASE));
 }
 
 /* INITIALISE THE STATE MACHINE OF THE PSG */
@@ -55,17 +59,15 @@ void PSG_STATE_INIT(PSG_BASE* PSG_BASE)
     /* ASSUME THE COUNT OF THE AMOUNT OF TONE CHANNELS WITHIN */
     /* THE PSG'S INFRASTRUCTURE */
 
-    /* WE ASCERTAIN THE LENGTH OF EACH RESPECTIVE NODE */
-    /* IN ACCORDANCE WITH A CAST PERPETUATING THE SIZE */
-
-    struct PSG_TONE** TONES[4];
+    /* EACH TONE IS STORED INLINE, SO RESETTING THEM IS A MATTER OF */
+    /* CLEARING THEIR COUNTERS IN PLACE */
 
-    for (size_t i = 0; i < PSG_STATE_COUNT(TONES); i++)
+    for (size_t i = 0; i < PSG_STATE_COUNT(PSG_BASE->TONES); i++)
     {
-        TONES[i] = (U16*)malloc(PSG_BASE->PSG_STATE.COUNTDOWN = 0);
-        TONES[i] = (U16*)malloc(PSG_BASE->PSG_STATE.COUNTDOWN_MASTER_CONTROL = 0);
-        TONES[i] = (U8*)malloc(PSG_BASE->PSG_STATE.ATTENUATION = 0);
-        TONES[i] = (U8*)malloc(PSG_BASE->PSG_STATE.OUTPUT = 0);
+        PSG_BASE->TONES[i].COUNTDOWN = 0;
+        PSG_BASE->TONES[i].COUNTDOWN_MASTER_CONTROL = 0;
+        PSG_BASE->TONES[i].ATTENUATION = 0x0F;
+        PSG_BASE->TONES[i].OUTPUT = 0;
     }
 }
 
@@ -74,11 +76,10 @@ void PSG_STATE_INIT(PSG_BASE* PSG_BASE)
 
 void PSG_UPDATE(PSG_BASE* PSG_BASE)
 {
-    struct PSG_TONE* TONES[4];
     unsigned INDEX;
     unsigned CHANNEL_INDEX;
 
-    for (INDEX = 0; INDEX < sizeof(TONES); INDEX++)
+    for (INDEX = 0; INDEX < PSG_TONE_COUNT; INDEX++)
     {
         /* ASSUME THAT THE CURRENT INDEXXING FOR THE TONE CHANNELING */
         /* HASN'T BEEN DISABLED, ALLOCATE CORRESPONDING CASTING FOR THE SAMPLES */ 
@@ -114,7 +115,7 @@ void PSG_UPDATE(PSG_BASE* PSG_BASE)
                         break;
 
                     case 3:
-                        PSG_BASE->PSG_STATE.COUNTDOWN += (PSG_BASE->PSG_STATE.COUNTDOWN_MASTER_CONTROL != 0) ? sizeof(TONES) : 0;
+                        PSG_BASE->PSG_STATE.COUNTDOWN += (PSG_BASE->PSG_STATE.COUNTDOWN_MASTER_CONTROL != 0) ? PSG_TONE_COUNT : 0;
                 
                     default:
                         break;
@@ -0,0 +1,473 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS BATTERY BACKED CARTRIDGE SAVES */
+/* SEE sram.h FOR AN OVERVIEW */
+
+#define _DEFAULT_SOURCE
+
+/* NESTED INCLUDES */
+
+#include "sram.h"
+#include "md.h"
+#include "mem.h"
+#include "tmss.h"
+#include "cache.h"
+#include "jit.h"
+
+/* SYSTEM INCLUDES */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef USE_SRAM
+
+static SRAM_BASE* SRAM;
+
+/* THE MAPPER'S VIEW OF THE HEADER - INFO HOLDS THE FLAGS AND KIND BYTES */
+/* RETURNS ZERO WHEN THE CARTRIDGE DECLARES NO SAVE MEMORY AT ALL */
+
+static U32 SRAM_HEADER_INFO(U32* INFO, U32* START, U32* END)
+{
+    MD_CART* CART = MD_GET_CONSOLE()->MD_CART;
+    const U8* ROM = (const U8*)CART->ROM_DATA;
+
+    if(CART->ROM_DATA == NULL || CART->ROM_SIZE < SRAM_HEADER + SRAM_HEADER_SIZE)
+        return 0;
+
+    if(MD_READ_BYTE(ROM, SRAM_HEADER) != 'R' || MD_READ_BYTE(ROM, SRAM_HEADER + 1) != 'A')
+        return 0;
+
+    *INFO = MD_READ_WORD(ROM, SRAM_HEADER + 2);
+    *START = MD_READ_LONG(ROM, SRAM_HEADER + 4);
+    *END = MD_READ_LONG(ROM, SRAM_HEADER + 8);
+
+    return *END >= *START;
+}
+
+void SRAM_INIT(void)
+{
+    SRAM = MD_ALLOC(sizeof(SRAM_BASE));
+    SRAM->FILE = -1;
+
+    MD_GET_CONSOLE()->MD_CART->ROM_SRAM_INIT = SRAM_HEADER_INFO;
+}
+
+//================================================
+//              SAVE FILE
+//================================================
+
+/* THE SAVE SITS NEXT TO THE ROM, WITH IT'S EXTENSION SWAPPED FOR .srm */
+
+static char* SRAM_SAVE_PATH(const char* ROM_PATH)
+{
+    const char* SLASH = strrchr(ROM_PATH, '/');
+    const char* DOT = strrchr(ROM_PATH, '.');
+    UNK LENGTH = (DOT != NULL && (SLASH == NULL || DOT > SLASH)) ? (UNK)(DOT - ROM_PATH) : strlen(ROM_PATH);
+    char* PATH = malloc(LENGTH + 5);
+
+    if(PATH != NULL)
+    {
+        memcpy(PATH, ROM_PATH, LENGTH);
+        memcpy(PATH + LENGTH, ".srm", 5);
+    }
+
+    return PATH;
+}
+
+/* MAP THE SAVE FILE SHARED, SO EVERY WRITE LANDS IN THE PAGE CACHE - A */
+/* FRESH FILE IS FILLED WITH $FF, AS AN ERASED EEPROM OR UNTOUCHED SRAM READS */
+
+static U8* SRAM_MAP_FILE(const char* PATH, UNK SIZE)
+{
+    struct stat INFO;
+    U8* DATA;
+    UNK OLD_SIZE;
+
+    SRAM->FILE = open(PATH, O_RDWR | O_CREAT, 0644);
+    if(SRAM->FILE < 0)
+        return NULL;
+
+    OLD_SIZE = (fstat(SRAM->FILE, &INFO) == 0) ? (UNK)INFO.st_size : 0;
+
+    if(OLD_SIZE < SIZE && ftruncate(SRAM->FILE, (off_t)SIZE) != 0)
+        return NULL;
+
+    DATA = mmap(NULL, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, SRAM->FILE, 0);
+    if(DATA == MAP_FAILED)
+        return NULL;
+
+    if(OLD_SIZE < SIZE)
+        memset(DATA + OLD_SIZE, 0xFF, SIZE - OLD_SIZE);
+
+    return DATA;
+}
+
+/* MUST BE CALLED ONCE THE CARTRIDGE IS LOADED AND BEFORE THE ARENA IS */
+/* SEALED - A SAVE WHICH CAN'T BE MAPPED STILL WORKS, IT JUST ISN'T KEPT */
+
+int SRAM_OPEN(const char* ROM_PATH)
+{
+    MD_CART* CART = MD_GET_CONSOLE()->MD_CART;
+    U32 INFO, START, END;
+    char* PATH;
+
+    if(CART->ROM_SRAM_INIT == NULL || !CART->ROM_SRAM_INIT(&INFO, &START, &END))
+        return 0;
+
+    START &= 0xFFFFFF;
+    END &= 0xFFFFFF;
+
+    SRAM->START = START;
+    SRAM->END = END;
+    SRAM->BASE = START & ~(U32)(SRAM_PAGE_SIZE - 1);
+
+    if((INFO & 0xFF) == SRAM_KIND_EEPROM)
+    {
+        SRAM->TYPE = SRAM_EEPROM;
+        SRAM->SIZE = SRAM_EEPROM_SIZE;
+        SRAM->LATCH = MD_ALLOC(SRAM_PAGE_SIZE);
+        memset(SRAM->LATCH, 0, SRAM_PAGE_SIZE);
+    }
+
+    else
+    {
+        SRAM->TYPE = SRAM_PARALLEL;
+        SRAM->SIZE = ((END | (SRAM_PAGE_SIZE - 1)) + 1) - SRAM->BASE;
+
+        if(SRAM->SIZE > SRAM_MAX_SIZE)
+            SRAM->SIZE = SRAM_MAX_SIZE;
+    }
+
+    PATH = SRAM_SAVE_PATH(ROM_PATH);
+    SRAM->DATA = (PATH != NULL) ? SRAM_MAP_FILE(PATH, SRAM->SIZE) : NULL;
+
+    if(SRAM->DATA == NULL)
+    {
+        fprintf(stderr, "Could not map the save file, saves won't be kept: %s\n", PATH != NULL ? PATH : ROM_PATH);
+
+        if(SRAM->FILE >= 0)
+            close(SRAM->FILE);
+
+        SRAM->FILE = -1;
+        SRAM->DATA = MD_ALLOC(SRAM->SIZE);
+        memset(SRAM->DATA, 0xFF, SRAM->SIZE);
+    }
+
+    else
+    {
+        printf("Save %s mapped: %s ($%06X - $%06X)\n", SRAM->TYPE == SRAM_EEPROM ? "EEPROM" : "SRAM", PATH, START, END);
+    }
+
+    free(PATH);
+
+    CART->REGISTER_READ = SRAM_READ_BYTE;
+    CART->REGISTER_WRITE = SRAM_WRITE_BYTE;
+    return 0;
+}
+
+//================================================
+//              MAPPING
+//================================================
+
+/* A WORD ACCESS DRIVES BOTH BYTES OF THE BUS - THE EEPROM'S LINES AND */
+/* ODD-BYTE SRAM ONLY EVER SEE THE ONE THEY ARE WIRED TO */
+
+static unsigned SRAM_READ_WORD(unsigned ADDRESS)
+{
+    return (SRAM_READ_BYTE(ADDRESS & ~1U) << 8) | SRAM_READ_BYTE(ADDRESS | 1);
+}
+
+static void SRAM_WRITE_WORD(unsigned ADDRESS, unsigned DATA)
+{
+    SRAM_WRITE_BYTE(ADDRESS & ~1U, (DATA >> 8) & 0xFF);
+    SRAM_WRITE_BYTE(ADDRESS | 1, DATA & 0xFF);
+}
+
+/* PUT THE SAVE'S PAGES IN OR OUT OF THE CARTRIDGE WINDOW - CALLED WHENEVER */
+/* THE WINDOW CHANGES, AND LEFT ALONE WHILE THE TMSS BOOT ROM COVERS IT */
+
+/* EVERY WRITE IS ROUTED THROUGH SRAM_WRITE_BYTE - WHICH HONOURS THE WRITE */
+/* PROTECT, DRIVES THE EEPROM AND MARKS THE SAVE DIRTY FOR SRAM_FRAME. */
+/* PARALLEL SRAM IS READ THROUGH THE MAPPER TOO, AS THE FILE IS BIG ENDIAN - */
+/* THE PAGES UNDERNEATH STAY THOSE OF THE ROM. ONLY THE EEPROM'S LATCH, */
+/* WHICH NEVER REACHES THE FILE, IS MAPPED IN DIRECTLY */
+
+/* THE CALLER THROWS AWAY ANY BLOCK DECODED FROM THE OLD PAGES */
+
+void SRAM_MAP(void)
+{
+    TMSS_BASE* TMSS = TMSS_GET_STATE();
+    U32 PAGE = SRAM->BASE >> 16;
+    U32 LAST;
+
+    if(SRAM->TYPE == SRAM_NONE || TMSS->BOOT_MAPPED)
+        return;
+
+    if(SRAM->TYPE == SRAM_EEPROM)
+    {
+        M68K_MEMORY_MAP[PAGE].MEMORY_BASE = (unsigned*)SRAM->LATCH;
+        M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_8 = SRAM_WRITE_BYTE;
+        M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_16 = SRAM_WRITE_WORD;
+        return;
+    }
+
+    for (LAST = PAGE + (U32)(SRAM->SIZE >> 16); PAGE < LAST; PAGE++)
+    {
+        if(SRAM->ENABLED)
+        {
+            M68K_MEMORY_MAP[PAGE].MEMORY_READ_8 = SRAM_READ_BYTE;
+            M68K_MEMORY_MAP[PAGE].MEMORY_READ_16 = SRAM_READ_WORD;
+            M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_8 = SRAM_WRITE_BYTE;
+            M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_16 = SRAM_WRITE_WORD;
+        }
+
+        else if(PAGE < TMSS_PAGES)
+        {
+            M68K_MEMORY_MAP[PAGE].MEMORY_READ_8 = NULL;
+            M68K_MEMORY_MAP[PAGE].MEMORY_READ_16 = NULL;
+            M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_8 = TMSS_ROM_WRITE;
+            M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_16 = TMSS_ROM_WRITE;
+        }
+    }
+}
+
+/* SRAM WHICH DOESN'T OVERLAP THE ROM IS ALWAYS THERE - OTHERWISE THE */
+/* GAME HAS TO SWAP IT IN ITSELF THROUGH $A130F1 */
+
+void SRAM_RESET(void)
+{
+    SRAM->ENABLED = MD_GET_CONSOLE()->MD_CART->ROM_SIZE <= SRAM->START;
+    SRAM->PROTECTED = false;
+
+    memset(&SRAM->EEPROM, 0, sizeof(SRAM->EEPROM));
+    SRAM->EEPROM.SDA = 1;
+    SRAM->EEPROM.SCL = 1;
+    SRAM->EEPROM.SDA_OUT = 1;
+
+    if(SRAM->LATCH != NULL)
+        MD_WRITE_BYTE(SRAM->LATCH, (SRAM->START - SRAM->BASE) | 1, 1 << SRAM_EEPROM_SDA_BIT);
+}
+
+void SRAM_CONTROL(unsigned DATA)
+{
+    bool ENABLED = (DATA & SRAM_CONTROL_ENABLE) != 0;
+
+    SRAM->PROTECTED = (DATA & SRAM_CONTROL_PROTECT) != 0;
+
+    if(SRAM->TYPE != SRAM_PARALLEL || ENABLED == SRAM->ENABLED)
+        return;
+
+    SRAM->ENABLED = ENABLED;
+    SRAM_MAP();
+
+    /* CODE MAY HAVE BEEN DECODED FROM THE ROM NOW SWAPPED OUT, OR THE SRAM */
+
+    M68K_CACHE_FLUSH();
+    M68K_JIT_FLUSH();
+}
+
+//================================================
+//              SERIAL EEPROM
+//================================================
+
+/* THE 68K DRIVES BOTH LINES BY HAND - SCL RISING SAMPLES SDA, SCL FALLING */
+/* MOVES ON TO THE NEXT BIT, AND SDA CHANGING WHILE SCL IS HIGH IS A START */
+/* (FALLING) OR A STOP (RISING). EACH BYTE IS EIGHT BITS AND AN ACKNOWLEDGE */
+
+/* THE X24C01 TAKES NO DEVICE SELECT - THE FIRST BYTE IS THE 7 BIT WORD */
+/* ADDRESS AND THE READ FLAG, AND SEQUENTIAL WRITES WRAP WITHIN A 4 BYTE PAGE */
+
+static void SRAM_EEPROM_BYTE(SRAM_I2C* EEPROM)
+{
+    switch (EEPROM->STATE)
+    {
+        case SRAM_I2C_ADDRESS:
+            EEPROM->ADDRESS = (EEPROM->BUFFER >> 1) & (SRAM_EEPROM_SIZE - 1);
+            EEPROM->STATE = (EEPROM->BUFFER & 1) ? SRAM_I2C_READ : SRAM_I2C_WRITE;
+            EEPROM->ACK = true;
+            break;
+
+        case SRAM_I2C_WRITE:
+            SRAM->DATA[EEPROM->ADDRESS] = EEPROM->BUFFER;
+            EEPROM->ADDRESS = (EEPROM->ADDRESS & ~SRAM_EEPROM_PAGE_MASK) | ((EEPROM->ADDRESS + 1) & SRAM_EEPROM_PAGE_MASK);
+            EEPROM->ACK = true;
+
+            SRAM->DIRTY = true;
+            SRAM->LAST_WRITE = MD_GET_CONSOLE()->FRAME_COUNT;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void SRAM_EEPROM_WRITE(unsigned DATA)
+{
+    SRAM_I2C* EEPROM = &SRAM->EEPROM;
+    U8 SDA = (DATA >> SRAM_EEPROM_SDA_BIT) & 1;
+    U8 SCL = (DATA >> SRAM_EEPROM_SCL_BIT) & 1;
+
+    if(EEPROM->SCL && SCL && SDA != EEPROM->SDA)
+    {
+        /* START - THE NEXT FALLING EDGE OF SCL BEGINS THE FIRST BIT */
+
+        if(!SDA)
+        {
+            EEPROM->STATE = SRAM_I2C_ADDRESS;
+            EEPROM->CYCLE = 8;
+            EEPROM->ACK = false;
+        }
+
+        else
+        {
+            EEPROM->STATE = SRAM_I2C_STANDBY;
+        }
+
+        EEPROM->SDA_OUT = 1;
+    }
+
+    else if(!EEPROM->SCL && SCL && EEPROM->STATE != SRAM_I2C_STANDBY)
+    {
+        if(EEPROM->CYCLE < 8 && EEPROM->STATE != SRAM_I2C_READ)
+        {
+            EEPROM->BUFFER = (EEPROM->BUFFER << 1) | SDA;
+
+            if(EEPROM->CYCLE == 7)
+                SRAM_EEPROM_BYTE(EEPROM);
+        }
+
+        /* THE MASTER ACKNOWLEDGING A READ BYTE ASKS FOR THE NEXT ONE */
+
+        else if(EEPROM->CYCLE == 8 && EEPROM->STATE == SRAM_I2C_READ && !EEPROM->ACK)
+        {
+            if(SDA)
+            {
+                EEPROM->STATE = SRAM_I2C_WAIT_STOP;
+            }
+
+            else
+            {
+                EEPROM->ADDRESS = (EEPROM->ADDRESS + 1) & (SRAM_EEPROM_SIZE - 1);
+            }
+        }
+    }
+
+    else if(EEPROM->SCL && !SCL && EEPROM->STATE != SRAM_I2C_STANDBY)
+    {
+        EEPROM->CYCLE = (EEPROM->CYCLE + 1) % 9;
+        EEPROM->SDA_OUT = 1;
+
+        if(EEPROM->CYCLE == 8 && EEPROM->ACK)
+        {
+            EEPROM->SDA_OUT = 0;
+        }
+
+        else if(EEPROM->CYCLE == 0)
+        {
+            EEPROM->ACK = false;
+        }
+
+        if(EEPROM->CYCLE < 8 && EEPROM->STATE == SRAM_I2C_READ)
+        {
+            EEPROM->SDA_OUT = (SRAM->DATA[EEPROM->ADDRESS] >> (7 - EEPROM->CYCLE)) & 1;
+        }
+    }
+
+    EEPROM->SDA = SDA;
+    EEPROM->SCL = SCL;
+
+    /* THE ONLY THING THE PAGE EVER READS BACK */
+
+    MD_WRITE_BYTE(SRAM->LATCH, (SRAM->START - SRAM->BASE) | 1, EEPROM->SDA_OUT << SRAM_EEPROM_SDA_BIT);
+}
+
+//================================================
+//              CARTRIDGE MAPPER
+//================================================
+
+/* EVERY ACCESS TO THE SAVE'S PAGES LANDS HERE, BAR READS OF THE EEPROM'S */
+/* LATCH (SEE SRAM_MAP). PARALLEL SRAM IS HELD BIG ENDIAN, BYTE FOR BYTE */
+
+unsigned SRAM_READ_BYTE(unsigned ADDRESS)
+{
+    ADDRESS &= 0xFFFFFF;
+
+    if(SRAM->TYPE == SRAM_EEPROM)
+        return MD_READ_BYTE(SRAM->LATCH, ADDRESS & (SRAM_PAGE_SIZE - 1));
+
+    if(SRAM->TYPE == SRAM_PARALLEL && SRAM->ENABLED && ADDRESS >= SRAM->BASE && ADDRESS - SRAM->BASE < SRAM->SIZE)
+        return SRAM->DATA[ADDRESS - SRAM->BASE];
+
+    return 0xFF;
+}
+
+void SRAM_WRITE_BYTE(unsigned ADDRESS, unsigned DATA)
+{
+    ADDRESS &= 0xFFFFFF;
+
+    if(ADDRESS < SRAM->START || ADDRESS > SRAM->END)
+        return;
+
+    if(SRAM->TYPE == SRAM_EEPROM)
+    {
+        SRAM_EEPROM_WRITE(DATA);
+        return;
+    }
+
+    /* THE FILE IS CAPPED AT SRAM_MAX_SIZE, HOWEVER FAR THE HEADER'S END REACHES */
+
+    if(!SRAM->ENABLED || SRAM->PROTECTED || ADDRESS < SRAM->BASE || ADDRESS - SRAM->BASE >= SRAM->SIZE)
+        return;
+
+    SRAM->DATA[ADDRESS - SRAM->BASE] = DATA & 0xFF;
+    SRAM->DIRTY = true;
+    SRAM->LAST_WRITE = MD_GET_CONSOLE()->FRAME_COUNT;
+}
+
+//================================================
+//              PERSISTENCE
+//================================================
+
+/* ONCE A GAME HAS STOPPED WRITING FOR A WHILE, ASK THE KERNEL TO START */
+/* WRITING THE SAVE BACK - MS_ASYNC ONLY SCHEDULES IT, SO THIS NEVER BLOCKS */
+
+void SRAM_FRAME(U32 FRAME)
+{
+    if(!SRAM->DIRTY || FRAME - SRAM->LAST_WRITE < SRAM_QUIET_FRAMES)
+        return;
+
+    if(SRAM->FILE >= 0)
+        msync(SRAM->DATA, SRAM->SIZE, MS_ASYNC);
+
+    SRAM->DIRTY = false;
+}
+
+/* THE ONLY PLACE WHICH WAITS ON THE DISK, ONCE THE EMULATOR IS DONE */
+
+void SRAM_CLOSE(void)
+{
+    if(SRAM == NULL || SRAM->FILE < 0)
+        return;
+
+    msync(SRAM->DATA, SRAM->SIZE, MS_SYNC);
+    munmap(SRAM->DATA, SRAM->SIZE);
+    close(SRAM->FILE);
+
+    SRAM->FILE = -1;
+    SRAM->DATA = NULL;
+    SRAM->TYPE = SRAM_NONE;
+}
+
+SRAM_BASE* SRAM_GET_STATE(void)
+{
+    return SRAM;
+}
+
+#endif
@@ -0,0 +1,168 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE REGION OF THE CONSOLE AND IT'S VIDEO TIMING */
+/* SEE timing.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "timing.h"
+#include "vdp.h"
+#include "io.h"
+#include "render.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdio.h>
+
+#ifdef USE_TIMING
+
+/* EVERY SCALAR IS A CONSTANT EXPRESSION, FOLDED BY THE COMPILER */
+
+#define     TIMING_PROFILE_ENTRY(NAME, PAL, CLOCK, LINES, RATE, V28, V30) \
+            { NAME, PAL, CLOCK, LINES, RATE, (LINES) * VDP_MAX_CYCLES_PER_LINE, \
+              ((CLOCK) + VDP_MAX_CYCLES_PER_LINE / 2) / VDP_MAX_CYCLES_PER_LINE, { V28, V30 }, { { 0 } } }
+
+static TIMING_PROFILE TIMING_PROFILES[TIMING_STANDARD_COUNT] =
+{
+    TIMING_PROFILE_ENTRY("NTSC", false, VDP_CLOCK_NTSC, VDP_NTSC_TIMING, 60, TIMING_V_JUMP_NTSC_V28, TIMING_V_JUMP_NTSC_V30),
+    TIMING_PROFILE_ENTRY("PAL", true, VDP_CLOCK_PAL, VDP_PAL_TIMING, 50, TIMING_V_JUMP_PAL_V28, TIMING_V_JUMP_PAL_V30),
+};
+
+static TIMING_BASE TIMING =
+{
+    TIMING_REGION_AUTO,
+    TIMING_REGION_US,
+    &TIMING_PROFILES[TIMING_NTSC],
+};
+
+/* PAST THE JUMP, THE COUNTER PICKS UP SUCH THAT THE LAST LINE READS $1FF */
+
+void TIMING_INIT(void)
+{
+    TIMING_PROFILE* PROFILE;
+    unsigned STANDARD;
+    unsigned V30;
+    unsigned LINE;
+
+    for (STANDARD = 0; STANDARD < TIMING_STANDARD_COUNT; STANDARD++)
+    {
+        PROFILE = &TIMING_PROFILES[STANDARD];
+
+        for (V30 = 0; V30 < 2; V30++)
+        {
+            for (LINE = 0; LINE < PROFILE->LINES_PER_FRAME; LINE++)
+            {
+                PROFILE->V_COUNTER[V30][LINE] = (LINE <= PROFILE->V_JUMP[V30])
+                    ? LINE
+                    : (LINE + 0x200 - PROFILE->LINES_PER_FRAME) & 0x1FF;
+            }
+        }
+    }
+}
+
+void TIMING_SET_REGION(TIMING_REGION REGION)
+{
+    TIMING.OVERRIDE = REGION;
+}
+
+//================================================
+//              REGION DETECTION
+//================================================
+
+/* OLDER CARTRIDGES SPELL THE REGIONS OUT AS J, U AND E, NEWER ONES PACK */
+/* THEM INTO ONE HEX DIGIT - THE LETTERS ARE LOOKED FOR FIRST, SINCE A LONE */
+/* "E" MEANS EUROPE RATHER THAN EVERYWHERE BAR JAPAN */
+
+/* WHERE A GAME RUNS IN SEVERAL REGIONS, THE AMERICAS ARE PREFERRED, THEN */
+/* JAPAN, THEN EUROPE - FAVOURING 60HZ, WHICH EVERY GAME IS TUNED FOR */
+
+static U8 TIMING_REGION_CODE(const unsigned char* REGION)
+{
+    U8 CODE = 0;
+    unsigned char DIGIT;
+    UNK INDEX;
+
+    for (INDEX = 0; INDEX < TIMING_REGION_LEN; INDEX++)
+    {
+        switch (REGION[INDEX])
+        {
+            case 'J': CODE |= TIMING_CODE_JP; break;
+            case 'U': CODE |= TIMING_CODE_US; break;
+            case 'E': CODE |= TIMING_CODE_EU; break;
+            default: break;
+        }
+    }
+
+    if(CODE != 0)
+        return CODE;
+
+    DIGIT = REGION[0];
+
+    if(DIGIT >= '0' && DIGIT <= '9') return DIGIT - '0';
+    if(DIGIT >= 'A' && DIGIT <= 'F') return DIGIT - 'A' + 10;
+
+    return 0;
+}
+
+TIMING_REGION TIMING_DETECT_REGION(const ROM_INFO* INFO)
+{
+    U8 CODE = TIMING_REGION_CODE(INFO->REGION);
+
+    if(CODE & TIMING_CODE_US) return TIMING_REGION_US;
+    if(CODE & TIMING_CODE_JP) return TIMING_REGION_JP;
+    if(CODE & (TIMING_CODE_EU | TIMING_CODE_ASIA_PAL)) return TIMING_REGION_EU;
+
+    return TIMING_REGION_US;
+}
+
+//================================================
+//              PROFILE SELECTION
+//================================================
+
+/* A POWER ON PROPERTY OF THE CONSOLE - THE VDP'S FRAME LENGTH AND THE */
+/* VERSION REGISTER ARE SET FROM IT, AND EVERYTHING ELSE READS THE PROFILE */
+
+void TIMING_APPLY(void)
+{
+    TIMING.REGION = (TIMING.OVERRIDE != TIMING_REGION_AUTO) ? TIMING.OVERRIDE : TIMING_DETECT_REGION(MD_ROM_HEADER());
+    TIMING.PROFILE = &TIMING_PROFILES[TIMING.REGION == TIMING_REGION_EU ? TIMING_PAL : TIMING_NTSC];
+
+    VDP->VDP_PAL = TIMING.PROFILE->PAL;
+    VDP->PAL = TIMING.PROFILE->PAL;
+    VDP->LINES_PER_FRAME = TIMING.PROFILE->LINES_PER_FRAME;
+    VDP->VC_MAX = TIMING.PROFILE->LINES_PER_FRAME - 1;
+
+    // ONLY A PAL CONSOLE CAN SHOW A 30 CELL TALL DISPLAY
+
+    RENDER_SELECT();
+
+    IO_SET_VERSION(TIMING.REGION != TIMING_REGION_JP, TIMING.PROFILE->PAL);
+
+    printf("Region: %s (%s)%s\n", TIMING_REGION_NAME(TIMING.REGION), TIMING.PROFILE->NAME,
+        TIMING.OVERRIDE != TIMING_REGION_AUTO ? " - overridden" : "");
+}
+
+const TIMING_PROFILE* TIMING_GET_PROFILE(void)
+{
+    return TIMING.PROFILE;
+}
+
+TIMING_REGION TIMING_GET_REGION(void)
+{
+    return TIMING.REGION;
+}
+
+const char* TIMING_REGION_NAME(TIMING_REGION REGION)
+{
+    switch (REGION)
+    {
+        case TIMING_REGION_JP: return "JP";
+        case TIMING_REGION_US: return "US";
+        case TIMING_REGION_EU: return "EU";
+        default: return "AUTO";
+    }
+}
+
+#endif
@@ -0,0 +1,240 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE TRADEMARK SECURITY SYSTEM (TMSS) */
+/* SEE tmss.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "tmss.h"
+#include "md.h"
+#include "mem.h"
+#include "cache.h"
+#include "jit.h"
+#include "sram.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef USE_TMSS
+
+static TMSS_BASE* TMSS;
+
+void TMSS_INIT(void)
+{
+    TMSS = MD_ALLOC(sizeof(TMSS_BASE));
+    TMSS->MIRROR = MD_ALLOC(TMSS_PAGE_SIZE);
+    TMSS->TAIL = MD_ALLOC(TMSS_PAGE_SIZE);
+
+    memset(TMSS->MIRROR, 0, TMSS_PAGE_SIZE);
+}
+
+/* THE CONSOLE ONLY HAS TMSS HARDWARE IF IT HAS A BOOT ROM TO RUN - WITHOUT */
+/* ONE, IT BEHAVES AS AN ORIGINAL MODEL 1 AND IGNORES THE REGISTERS ENTIRELY */
+
+int TMSS_LOAD_BOOT_ROM(const char* PATH)
+{
+    MD* CONSOLE = MD_GET_CONSOLE();
+    FILE* FILE;
+    UNK SIZE;
+    UNK OFFSET;
+
+    FILE = fopen(PATH, "rb");
+    if(FILE == NULL)
+    {
+        fprintf(stderr, "Failed to open TMSS boot ROM: %s\n", PATH);
+        return -1;
+    }
+
+    SIZE = fread(CONSOLE->BOOT_ROM, 1, TMSS_BOOT_ROM_SIZE, FILE);
+    fclose(FILE);
+
+    if(SIZE != TMSS_BOOT_ROM_SIZE)
+    {
+        fprintf(stderr, "TMSS boot ROM must be %d bytes: %s\n", TMSS_BOOT_ROM_SIZE, PATH);
+        return -1;
+    }
+
+    for (OFFSET = 0; OFFSET < TMSS_PAGE_SIZE; OFFSET += TMSS_BOOT_ROM_SIZE)
+    {
+        memcpy(TMSS->MIRROR + OFFSET, CONSOLE->BOOT_ROM, TMSS_BOOT_ROM_SIZE);
+    }
+
+    /* THE MIRROR IS READ JUST AS THE CARTRIDGE IS, IN HOST WORD ORDER */
+
+    MD_SWAP_WORDS(TMSS->MIRROR, TMSS_PAGE_SIZE);
+
+    CONSOLE->IS_TMSS = true;
+
+    printf("TMSS boot ROM loaded: %s\n", PATH);
+    return 0;
+}
+
+/* BOOT STRAIGHT INTO THE CARTRIDGE - THE REGISTERS STILL WORK, SO */
+/* A CARTRIDGE WHICH WRITES "SEGA" ITSELF RUNS AS IT WOULD HAVE DONE */
+
+void TMSS_SET_SKIP(bool SKIP)
+{
+    TMSS->SKIP = SKIP;
+}
+
+//================================================
+//              PAGE SWAPS
+//================================================
+
+/* THE IMAGE IS MAPPED A WHOLE PAGE AT A TIME - A PARTIAL LAST PAGE (OR AN */
+/* IMAGE SMALLER THAN ONE) IS PADDED OUT IN THE TAIL PAGE, AS THE IMAGE ITSELF */
+/* MAY BE A READ ONLY MAPPING. THE WINDOW PAST THE END OF THE IMAGE MIRRORS IT, */
+/* AS THE CARTRIDGE'S OWN ADDRESS DECODING WOULD */
+
+static void TMSS_BUILD_CART_PAGES(void)
+{
+    MD_CART* CART = MD_GET_CONSOLE()->MD_CART;
+    U8* ROM = (U8*)CART->ROM_DATA;
+    U32 WHOLE = CART->ROM_SIZE / TMSS_PAGE_SIZE;
+    U32 REMAINDER = CART->ROM_SIZE % TMSS_PAGE_SIZE;
+    U32 COUNT = WHOLE + (REMAINDER != 0);
+    U32 PAGE;
+
+    if(ROM != NULL && REMAINDER != 0)
+    {
+        memcpy(TMSS->TAIL, ROM + WHOLE * TMSS_PAGE_SIZE, REMAINDER);
+        memset(TMSS->TAIL + REMAINDER, 0xFF, TMSS_PAGE_SIZE - REMAINDER);
+    }
+
+    for (PAGE = 0; PAGE < TMSS_PAGES; PAGE++)
+    {
+        if(ROM == NULL || COUNT == 0)
+            TMSS->CART[PAGE] = NULL;
+
+        else if(PAGE % COUNT == WHOLE)
+            TMSS->CART[PAGE] = TMSS->TAIL;
+
+        else
+            TMSS->CART[PAGE] = ROM + (PAGE % COUNT) * TMSS_PAGE_SIZE;
+    }
+}
+
+/* WRITES TO EITHER ROM GO NOWHERE - THE CARTRIDGE'S IMAGE MAY WELL BE A */
+/* READ ONLY MAPPING OF THE ROM CACHE (SEE ROM_CACHE_ATTACH) */
+
+void TMSS_ROM_WRITE(unsigned ADDRESS, unsigned DATA)
+{
+    (void)ADDRESS;
+    (void)DATA;
+}
+
+/* THE ONE PLACE THE WINDOW CHANGES - ANY BLOCK DECODED FROM THE OLD */
+/* CONTENTS IS THROWN AWAY ALONGSIDE IT */
+
+static void TMSS_MAP(bool BOOT)
+{
+    U32 PAGE;
+
+    /* BOTH ROMS ARE READ STRAIGHT THROUGH - SAVE MEMORY PUTS IT'S OWN WRITE */
+    /* HANDLERS BACK ON TOP (SEE SRAM_MAP) */
+
+    for (PAGE = 0; PAGE < TMSS_PAGES; PAGE++)
+    {
+        M68K_MEMORY_MAP[PAGE].MEMORY_BASE = (unsigned*)(BOOT ? TMSS->MIRROR : TMSS->CART[PAGE]);
+        M68K_MEMORY_MAP[PAGE].MEMORY_READ_8 = NULL;
+        M68K_MEMORY_MAP[PAGE].MEMORY_READ_16 = NULL;
+        M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_8 = TMSS_ROM_WRITE;
+        M68K_MEMORY_MAP[PAGE].MEMORY_WRITE_16 = TMSS_ROM_WRITE;
+    }
+
+    TMSS->BOOT_MAPPED = BOOT;
+
+    /* ANY SAVE MEMORY SITS BACK ON TOP OF THE CARTRIDGE'S PAGES */
+
+    SRAM_MAP();
+
+    M68K_CACHE_FLUSH();
+    M68K_JIT_FLUSH();
+}
+
+/* A POWER CYCLE PUTS THE BOOT ROM BACK AND FORGETS THE SIGNATURE - THE */
+/* RESET BUTTON LEAVES BOTH WHERE THEY WERE */
+
+void TMSS_RESET(bool HARD)
+{
+    MD* CONSOLE = MD_GET_CONSOLE();
+
+    if(!HARD)
+        return;
+
+    memset(CONSOLE->TMSS, 0, sizeof(CONSOLE->TMSS));
+    TMSS->UNLOCKED = !CONSOLE->IS_TMSS;
+
+    TMSS_BUILD_CART_PAGES();
+    TMSS_MAP(CONSOLE->IS_TMSS && !TMSS->SKIP);
+}
+
+/* PUT THE WINDOW BACK AS A SAVE STATE LEFT IT */
+
+void TMSS_RESTORE(bool BOOT_MAPPED)
+{
+    MD* CONSOLE = MD_GET_CONSOLE();
+
+    TMSS->UNLOCKED = !CONSOLE->IS_TMSS || memcmp(CONSOLE->TMSS, TMSS_SIGNATURE, 4) == 0;
+
+    TMSS_BUILD_CART_PAGES();
+    TMSS_MAP(CONSOLE->IS_TMSS && BOOT_MAPPED);
+}
+
+//================================================
+//              REGISTERS
+//================================================
+
+/* $A14000 - $A14003 LATCH THE SIGNATURE, AND BIT 0 OF $A14101 PICKS */
+/* BETWEEN THE BOOT ROM (0) AND THE CARTRIDGE (1) */
+
+/* REAL HARDWARE LOCKS THE VDP UP UNTIL "SEGA" HAS BEEN WRITTEN - HERE, A */
+/* HANDOVER TO A CARTRIDGE WHICH HASN'T WRITTEN IT IS REPORTED INSTEAD */
+
+void TMSS_WRITE_BYTE(unsigned ADDRESS, unsigned DATA)
+{
+    MD* CONSOLE = MD_GET_CONSOLE();
+    bool BOOT;
+
+    if(!CONSOLE->IS_TMSS)
+        return;
+
+    if((ADDRESS & 0xFFFC) == 0x4000)
+    {
+        CONSOLE->TMSS[ADDRESS & 3] = DATA & 0xFF;
+        TMSS->UNLOCKED = memcmp(CONSOLE->TMSS, TMSS_SIGNATURE, 4) == 0;
+        return;
+    }
+
+    if((ADDRESS & 0xFFFF) == 0x4101)
+    {
+        BOOT = !(DATA & TMSS_CART_ENABLE);
+
+        if(BOOT == TMSS->BOOT_MAPPED)
+            return;
+
+        if(!BOOT && !TMSS->UNLOCKED)
+        {
+            fprintf(stderr, "TMSS: cartridge mapped in before \"SEGA\" was written to $A14000 - the VDP would be locked\n");
+        }
+
+        TMSS_MAP(BOOT);
+    }
+}
+
+void TMSS_WRITE_WORD(unsigned ADDRESS, unsigned DATA)
+{
+    TMSS_WRITE_BYTE(ADDRESS & ~1, (DATA >> 8) & 0xFF);
+    TMSS_WRITE_BYTE(ADDRESS | 1, DATA & 0xFF);
+}
+
+TMSS_BASE* TMSS_GET_STATE(void)
+{
+    return TMSS;
+}
+
+#endif
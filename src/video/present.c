@@ -0,0 +1,140 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS HANDING FINISHED FRAMES FROM THE EMULATION THREAD */
+/* TO THE HOST'S PRESENTER - SEE present.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "present.h"
+#include "md.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_PRESENT
+
+static PRESENT_BASE* PRESENT;
+
+/* THE SLOTS ARE SIZED FOR THE SCALED OUTPUT, SO SCALE_INIT COMES FIRST */
+
+/* HOW MUCH OF THE CONSOLE ARENA PRESENT_INIT WILL TAKE - A 4X SCALE ALONE */
+/* IS SEVERAL TIMES THE SIZE OF EVERYTHING ELSE, SO THE ARENA GROWS TO SUIT */
+
+UNK PRESENT_ARENA_SIZE(void)
+{
+    SCALE_BASE* SCALE = SCALE_GET_STATE();
+
+    return sizeof(PRESENT_BASE) + PRESENT_SLOTS * ((UNK)SCALE->PITCH * SCALE->HEIGHT + MD_ARENA_ALIGN) + MD_ARENA_ALIGN;
+}
+
+/* EVERY ROW STARTS OUT ONE FRAME AHEAD OF THE PRESENTER, SO THE FIRST */
+/* FRAME IT TAKES IS UPLOADED IN FULL */
+
+void PRESENT_INIT(void)
+{
+    SCALE_BASE* SCALE = SCALE_GET_STATE();
+    UNK SIZE = (UNK)SCALE->PITCH * SCALE->HEIGHT;
+    int INDEX, ROW;
+
+    PRESENT = MD_ALLOC(sizeof(PRESENT_BASE));
+    memset(PRESENT, 0, sizeof(PRESENT_BASE));
+
+    for (INDEX = 0; INDEX < PRESENT_SLOTS; INDEX++)
+    {
+        PRESENT->SLOT[INDEX].DATA = MD_ALLOC(SIZE);
+        PRESENT->SLOT[INDEX].FRAME = 1;
+
+        memset(PRESENT->SLOT[INDEX].DATA, 0, SIZE);
+
+        for (ROW = 0; ROW < VDP_SCREEN_HEIGHT; ROW++)
+        {
+            PRESENT->SLOT[INDEX].ROW_FRAME[ROW] = 1;
+        }
+    }
+
+    PRESENT->BACK = 0;
+    PRESENT->READY = 1;
+    PRESENT->FRONT = 2;
+    PRESENT->FRAME = 1;
+
+    SCALE->DATA = PRESENT->SLOT[PRESENT->BACK].DATA;
+}
+
+//================================================
+//              EMULATION THREAD
+//================================================
+
+/* HAND THE FRAME JUST DRAWN TO THE PRESENTER, AND CARRY ON IN WHICHEVER */
+/* SLOT COMES BACK - A FRAME IN WHICH NOTHING WAS REDRAWN ISN'T HANDED OVER */
+
+/* THE VDP ONLY REDRAWS LINES WHICH CHANGED, SO THE NEW BACK SLOT IS FIRST */
+/* BROUGHT UP TO DATE WITH THE ROWS IT MISSED WHILE IT WAS AWAY */
+
+void PRESENT_PUBLISH(void)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    SCALE_BASE* SCALE = SCALE_GET_STATE();
+    UNK ROW_BYTES = (UNK)SCALE->PITCH * SCALE->FACTOR;
+    PRESENT_SLOT* DONE;
+    PRESENT_SLOT* NEXT;
+    U32 PREVIOUS;
+    int ROW;
+
+    if(!BMP->CHANGED)
+        return;
+
+    DONE = &PRESENT->SLOT[PRESENT->BACK];
+    DONE->FRAME = ++PRESENT->FRAME;
+
+    for (ROW = 0; ROW < BMP->HEIGHT; ROW++)
+    {
+        if(BMP->DIRTY[ROW])
+        {
+            DONE->ROW_FRAME[ROW] = DONE->FRAME;
+            BMP->DIRTY[ROW] = 0;
+        }
+    }
+
+    BMP->CHANGED = 0;
+
+    PREVIOUS = __atomic_exchange_n(&PRESENT->READY, PRESENT->BACK | PRESENT_FRESH, __ATOMIC_ACQ_REL);
+    PRESENT->BACK = PREVIOUS & PRESENT_INDEX;
+
+    NEXT = &PRESENT->SLOT[PRESENT->BACK];
+
+    for (ROW = 0; ROW < BMP->HEIGHT; ROW++)
+    {
+        if(NEXT->ROW_FRAME[ROW] != DONE->ROW_FRAME[ROW])
+        {
+            memcpy(NEXT->DATA + ROW * ROW_BYTES, DONE->DATA + ROW * ROW_BYTES, ROW_BYTES);
+            NEXT->ROW_FRAME[ROW] = DONE->ROW_FRAME[ROW];
+        }
+    }
+
+    SCALE->DATA = NEXT->DATA;
+}
+
+//================================================
+//              PRESENTER
+//================================================
+
+/* THE NEWEST FINISHED FRAME, OR NULL IF NOTHING HAS BEEN PUBLISHED SINCE */
+/* THE LAST CALL - IT STAYS THE PRESENTER'S UNTIL THE NEXT ONE IS TAKEN */
+
+const PRESENT_SLOT* PRESENT_ACQUIRE(void)
+{
+    U32 PREVIOUS;
+
+    if(!(__atomic_load_n(&PRESENT->READY, __ATOMIC_ACQUIRE) & PRESENT_FRESH))
+        return NULL;
+
+    PREVIOUS = __atomic_exchange_n(&PRESENT->READY, PRESENT->FRONT, __ATOMIC_ACQ_REL);
+    PRESENT->FRONT = PREVIOUS & PRESENT_INDEX;
+
+    return &PRESENT->SLOT[PRESENT->FRONT];
+}
+
+#endif
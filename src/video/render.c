@@ -0,0 +1,614 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS DRAWING THE VDP'S DISPLAY A LINE AT A TIME */
+/* SEE render.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "render.h"
+#include "vdp.h"
+#include "scroll.h"
+#include "mem.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#ifdef USE_RENDER
+
+/* THE KERNELS BELOW TAKE THEIR MODES AS CONSTANT ARGUMENTS - THEY MUST BE */
+/* INLINED INTO EACH VARIANT FOR THOSE TESTS TO BE FOLDED AWAY, WHATEVER */
+/* THE OPTIMISATION LEVEL */
+
+#if defined(__GNUC__)
+    #define     RENDER_INLINE               static inline __attribute__((always_inline))
+#else
+    #define     RENDER_INLINE               static inline
+#endif
+
+/* THE LEVEL OF EACH 3 BIT CHANNEL OUT OF 14 - SHADOW IS HALF OF NORMAL, */
+/* AND HIGHLIGHT HALF AGAIN ON TOP */
+
+#define     RENDER_LEVEL(LEVEL)         ((LEVEL) * 255 / 14)
+
+static U32 PIXEL[0x100];
+static U32 PIXEL_LUT[3][0x200];
+static U8 PIXEL_LINE_BUFFER[RENDER_BUFFERS][RENDER_LINE_SIZE];
+static U8 RENDER_LUT[RENDER_LUT_COUNT][RENDER_LUT_SIZE];
+static unsigned RENDER_MODE;
+
+void(*RENDER_BG)(int LINE);
+U32(*RENDER_OBJ)(int LINE);
+
+//================================================
+//           LAYER MERGE TABLES
+//================================================
+
+/* PLANE A OVER PLANE B - THE OPAQUE PIXEL WITH THE HIGHER PRIORITY WINS, */
+/* PLANE A ON A TIE. THE RESULT KEEPS THE WINNER'S PRIORITY, AND WHETHER */
+/* EITHER PLANE HAD IT'S PRIORITY BIT SET FOR SHADOW/HIGHLIGHT */
+
+static U8 RENDER_MERGE_BG_PIXEL(unsigned B, unsigned A)
+{
+    unsigned OUT;
+
+    if((A & RENDER_OPAQUE) && ((A & RENDER_PRIORITY) || !(B & RENDER_OPAQUE) || !(B & RENDER_PRIORITY)))
+        OUT = A;
+
+    else if(B & RENDER_OPAQUE)
+        OUT = B;
+
+    else
+        OUT = RENDER_BACKDROP;
+
+    return (OUT & (RENDER_PRIORITY | RENDER_INDEX)) | (((A | B) & RENDER_PRIORITY) << 1);
+}
+
+/* A SPRITE SHOWS OVER THE PLANES UNLESS IT IS LOW PRIORITY AND THE PLANES' */
+/* VISIBLE PIXEL IS HIGH */
+
+/* UNDER SHADOW/HIGHLIGHT, THE PLANES ARE SHADOWED UNLESS EITHER HAS IT'S */
+/* PRIORITY BIT SET, AND THE LAST TWO COLOURS OF SPRITE PALETTE 3 ARE NEVER */
+/* DRAWN - THEY HIGHLIGHT OR SHADOW WHATEVER IS BENEATH THEM INSTEAD */
+
+static U8 RENDER_MERGE_OBJ_PIXEL(unsigned BG, unsigned SPRITE, bool SH)
+{
+    unsigned COLOUR = (BG & RENDER_OPAQUE) ? BG & RENDER_INDEX : RENDER_BACKDROP;
+    unsigned INTENSITY = RENDER_NORMAL;
+    bool VISIBLE = (SPRITE & RENDER_OPAQUE) && ((SPRITE & RENDER_PRIORITY) || !(BG & RENDER_PRIORITY));
+
+    if(SH && !(BG & RENDER_EITHER_HIGH))
+        INTENSITY = RENDER_SHADOW;
+
+    if(!VISIBLE)
+        return INTENSITY | COLOUR;
+
+    if(SH && (SPRITE & RENDER_INDEX) == 0x3E)
+        return (INTENSITY + RENDER_NORMAL) | COLOUR;
+
+    if(SH && (SPRITE & RENDER_INDEX) == 0x3F)
+        return RENDER_SHADOW | COLOUR;
+
+    if(SPRITE & RENDER_PRIORITY)
+        INTENSITY = RENDER_NORMAL;
+
+    return INTENSITY | (SPRITE & RENDER_INDEX);
+}
+
+/* EVERY PAIRING OF PIXELS IS RESOLVED ONCE HERE, SO MERGING A LINE IS ONE */
+/* LOOKUP PER PIXEL WITH NOTHING TO BRANCH ON */
+
+void RENDER_INIT(void)
+{
+    unsigned BELOW, ABOVE;
+
+    for (BELOW = 0; BELOW < 0x100; BELOW++)
+    {
+        for (ABOVE = 0; ABOVE < 0x80; ABOVE++)
+        {
+            RENDER_LUT[RENDER_LUT_BG][RENDER_LUT_INDEX(BELOW, ABOVE)] = RENDER_MERGE_BG_PIXEL(BELOW, ABOVE);
+            RENDER_LUT[RENDER_LUT_OBJ][RENDER_LUT_INDEX(BELOW, ABOVE)] = RENDER_MERGE_OBJ_PIXEL(BELOW, ABOVE, false);
+            RENDER_LUT[RENDER_LUT_SH][RENDER_LUT_INDEX(BELOW, ABOVE)] = RENDER_MERGE_OBJ_PIXEL(BELOW, ABOVE, true);
+        }
+    }
+}
+
+//================================================
+//           PALETTE
+//================================================
+
+void RENDER_RESET(void)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+
+    // CLEAR DISPLAY SETTINGS
+
+    memset(BMP->DATA, 0, BMP->PITCH * BMP->HEIGHT);
+
+    // CLEAR LINE BUFFER
+
+    memset(PIXEL_LINE_BUFFER, 0, sizeof(PIXEL_LINE_BUFFER));
+
+    // CLEAR COLOUR PALETTE
+
+    memset(PIXEL, 0, sizeof(PIXEL));
+}
+
+/* INITIALISES MODE 5 SUPPORT FOR PALETTE DEFINITION */
+/* EVERY 9 BIT CRAM COLOUR (BBBGGGRRR) AT EACH OF THE THREE INTENSITIES */
+
+void PALETTE_INIT(void)
+{
+    int R, G, B, I;
+
+    for(I = 0; I < 0x200; I++)
+    {
+        R = (I >> 0) & 7;
+        G = (I >> 3) & 7;
+        B = (I >> 6) & 7;
+
+        PIXEL_LUT[0][I] = (U32)BIT_32_PIXEL(RENDER_LEVEL(R), RENDER_LEVEL(G), RENDER_LEVEL(B));
+        PIXEL_LUT[1][I] = (U32)BIT_32_PIXEL(RENDER_LEVEL(R << 1), RENDER_LEVEL(G << 1), RENDER_LEVEL(B << 1));
+        PIXEL_LUT[2][I] = (U32)BIT_32_PIXEL(RENDER_LEVEL(R + 7), RENDER_LEVEL(G + 7), RENDER_LEVEL(B + 7));
+    }
+}
+
+/* A CRAM ENTRY (0000 BBB0 GGG0 RRR0) AT IT'S THREE INTENSITIES, LOOKED UP */
+/* ONCE HERE RATHER THAN FOR EVERY PIXEL WHICH USES IT */
+
+static void RENDER_PALETTE_SET(unsigned SLOT, unsigned INDEX)
+{
+    unsigned DATA = (VDP->CRAM[INDEX << 1] << 8) | VDP->CRAM[(INDEX << 1) | 1];
+    unsigned COLOUR = ((DATA >> 1) & 0x07) | ((DATA >> 2) & 0x38) | ((DATA >> 3) & 0x1C0);
+
+    PIXEL[RENDER_SHADOW | SLOT] = PIXEL_LUT[0][COLOUR];
+    PIXEL[RENDER_NORMAL | SLOT] = PIXEL_LUT[1][COLOUR];
+    PIXEL[RENDER_HIGHLIGHT | SLOT] = PIXEL_LUT[2][COLOUR];
+}
+
+/* INDEX 0'S SLOT HOLDS WHICHEVER ENTRY REGISTER $07 PICKS AS THE BACKDROP */
+
+void RENDER_PALETTE_WRITE(unsigned INDEX)
+{
+    INDEX &= RENDER_INDEX;
+
+    if(INDEX != RENDER_BACKDROP)
+        RENDER_PALETTE_SET(INDEX, INDEX);
+
+    if(INDEX == (VDP->VDP_REG[7] & RENDER_INDEX))
+        RENDER_PALETTE_SET(RENDER_BACKDROP, INDEX);
+}
+
+void RENDER_BACKDROP_WRITE(void)
+{
+    RENDER_PALETTE_SET(RENDER_BACKDROP, VDP->VDP_REG[7] & RENDER_INDEX);
+}
+
+//================================================
+//           LAYER KERNELS
+//================================================
+
+/* ONE 8 PIXEL ROW OF A NAME TABLE ENTRY'S PATTERN - EVERY PIXEL CARRIES THE */
+/* ENTRY'S PRIORITY AND PALETTE, OPAQUE OR NOT. IN INTERLACE MODE 2, */
+/* PATTERNS ARE 8x16 AND TWICE THE SIZE */
+
+RENDER_INLINE void RENDER_PATTERN(U8* DST, unsigned ENTRY, unsigned ROW, const bool IM2)
+{
+    unsigned ATTR = (ENTRY >> 9) & (RENDER_PRIORITY | 0x30);
+    unsigned ADDRESS;
+    U32 DATA;
+    int PIXEL_INDEX;
+
+    if(ENTRY & 0x1000)
+        ROW ^= IM2 ? 15 : 7;
+
+    ADDRESS = IM2 ? ((ENTRY & 0x3FF) << 6) | (ROW << 2) : ((ENTRY & 0x7FF) << 5) | (ROW << 2);
+    DATA = MD_READ_LONG(VDP->VRAM, ADDRESS & 0xFFFC);
+
+    if(ENTRY & 0x0800)
+    {
+        for (PIXEL_INDEX = 0; PIXEL_INDEX < 8; PIXEL_INDEX++)
+            DST[PIXEL_INDEX] = ATTR | ((DATA >> (PIXEL_INDEX << 2)) & 0x0F);
+    }
+
+    else
+    {
+        for (PIXEL_INDEX = 0; PIXEL_INDEX < 8; PIXEL_INDEX++)
+            DST[PIXEL_INDEX] = ATTR | ((DATA >> (28 - (PIXEL_INDEX << 2))) & 0x0F);
+    }
+}
+
+/* A SCROLLED PLANE, WALKING THE LINE'S FETCH PLAN (SEE scroll.h) */
+
+RENDER_INLINE void RENDER_PLANE(U8* DST, const SCROLL_PLAN* PLAN, const bool IM2)
+{
+    const SCROLL_FETCH* FETCH = PLAN->FETCH;
+    unsigned TILE;
+
+    DST += PLAN->X;
+
+    for (TILE = 0; TILE < PLAN->COUNT; TILE++, FETCH++, DST += 8)
+    {
+        RENDER_PATTERN(DST, MD_READ_WORD(VDP->VRAM, FETCH->ADDRESS), FETCH->ROW, IM2);
+    }
+}
+
+/* THE WINDOW IS NEVER SCROLLED - IT COVERS WHOLE CELLS OF PLANE A, */
+/* FROM A NAME TABLE AS WIDE AS THE DISPLAY MODE'S */
+
+RENDER_INLINE void RENDER_WINDOW(U8* DST, int ROW, unsigned START, unsigned END, const bool H40, const bool IM2)
+{
+    unsigned BASE = VDP->W_BASE & (H40 ? 0xF000 : 0xF800);
+    unsigned WIDTH = H40 ? 64 : 32;
+    unsigned CELL, ENTRY;
+
+    for (CELL = START; CELL < END; CELL++)
+    {
+        ENTRY = MD_READ_WORD(VDP->VRAM, (BASE + (((ROW >> (IM2 ? 4 : 3)) * WIDTH + CELL) << 1)) & 0xFFFE);
+        RENDER_PATTERN(DST + (CELL << 3), ENTRY, ROW & (IM2 ? 15 : 7), IM2);
+    }
+}
+
+/* LAY ONE LINE BUFFER OVER ANOTHER THROUGH A MERGE TABLE */
+
+RENDER_INLINE void RENDER_MERGE(U8* DST, const U8* ABOVE, const U8* LUT, unsigned WIDTH)
+{
+    unsigned X;
+
+    for (X = 0; X < WIDTH; X++)
+    {
+        DST[X] = LUT[RENDER_LUT_INDEX(DST[X], ABOVE[X])];
+    }
+}
+
+//================================================
+//           BACKGROUND VARIANTS
+//================================================
+
+/* WHICH CELLS OF THE LINE THE WINDOW COVERS - EVERY CELL ABOVE OR BELOW */
+/* IT'S VERTICAL EDGE, OTHERWISE THOSE LEFT OR RIGHT OF IT'S HORIZONTAL ONE */
+
+RENDER_INLINE void RENDER_WINDOW_SPAN(int LINE, unsigned CELLS, unsigned* START, unsigned* END)
+{
+    unsigned EDGE = (VDP->VDP_REG[18] & 0x1F) << 3;
+
+    if((VDP->VDP_REG[18] & 0x80) ? (unsigned)LINE >= EDGE : (unsigned)LINE < EDGE)
+    {
+        *START = 0;
+        *END = CELLS;
+        return;
+    }
+
+    EDGE = (VDP->VDP_REG[17] & 0x1F) << 1;
+
+    if(EDGE > CELLS)
+        EDGE = CELLS;
+
+    *START = (VDP->VDP_REG[17] & 0x80) ? EDGE : 0;
+    *END = (VDP->VDP_REG[17] & 0x80) ? CELLS : EDGE;
+}
+
+RENDER_INLINE void RENDER_BG_LINE(int LINE, const bool H40, const bool WINDOW, const bool IM2)
+{
+    U8* OUT = &PIXEL_LINE_BUFFER[RENDER_BUFFER_OUT][RENDER_BORDER];
+    U8* A = &PIXEL_LINE_BUFFER[RENDER_BUFFER_A][RENDER_BORDER];
+    unsigned CELLS = H40 ? 40 : 32;
+    unsigned START = 0, END = 0;
+
+    // IN INTERLACE MODE 2, EACH FIELD DRAWS EVERY OTHER LINE OF 16 LINE TILES
+
+    int ROW = IM2 ? (LINE << 1) | ((VDP->STATUS & RENDER_STATUS_ODD) ? 1 : 0) : LINE;
+
+    SCROLL_LINE(LINE, ROW, H40, IM2);
+    RENDER_PLANE(OUT, SCROLL_GET_PLAN(SCROLL_PLANE_B), IM2);
+
+    if(WINDOW)
+        RENDER_WINDOW_SPAN(LINE, CELLS, &START, &END);
+
+    if(!WINDOW || START != 0 || END != CELLS)
+        RENDER_PLANE(A, SCROLL_GET_PLAN(SCROLL_PLANE_A), IM2);
+
+    if(WINDOW && END > START)
+        RENDER_WINDOW(A, ROW, START, END, H40, IM2);
+
+    RENDER_MERGE(OUT, A, RENDER_LUT[RENDER_LUT_BG], CELLS << 3);
+}
+
+static void RENDER_BG_H32(int LINE)             { RENDER_BG_LINE(LINE, false, false, false); }
+static void RENDER_BG_H40(int LINE)             { RENDER_BG_LINE(LINE, true, false, false); }
+static void RENDER_BG_H32_WINDOW(int LINE)      { RENDER_BG_LINE(LINE, false, true, false); }
+static void RENDER_BG_H40_WINDOW(int LINE)      { RENDER_BG_LINE(LINE, true, true, false); }
+static void RENDER_BG_H32_IM2(int LINE)         { RENDER_BG_LINE(LINE, false, false, true); }
+static void RENDER_BG_H40_IM2(int LINE)         { RENDER_BG_LINE(LINE, true, false, true); }
+static void RENDER_BG_H32_WINDOW_IM2(int LINE)  { RENDER_BG_LINE(LINE, false, true, true); }
+static void RENDER_BG_H40_WINDOW_IM2(int LINE)  { RENDER_BG_LINE(LINE, true, true, true); }
+
+/* WITH THE DISPLAY DISABLED, THE WHOLE LINE IS THE BACKDROP */
+
+static void RENDER_BG_BLANK(int LINE)
+{
+    (void)LINE;
+    memset(&PIXEL_LINE_BUFFER[RENDER_BUFFER_OUT][RENDER_BORDER], RENDER_NORMAL | RENDER_BACKDROP, VDP_SCREEN_WIDTH);
+}
+
+//================================================
+//           SPRITE VARIANTS
+//================================================
+
+/* WALK THE SPRITE LIST AS VDP_SPRITE_STATUS DOES, DRAWING EACH SPRITE ON */
+/* THE LINE - THE FIRST SPRITE TO COVER A PIXEL KEEPS IT. A SPRITE AT X = 0 */
+/* MASKS EVERY SPRITE AFTER IT, UNLESS IT IS THE FIRST ON THE LINE */
+
+/* A DRAWN LINE NEEDS NO SEPARATE STATUS WALK - THE OVERFLOW AND COLLISION */
+/* BITS ARE RAISED HERE, AND THE LINE'S SIGNATURE HANDED BACK (SEE VDP_LINE) */
+
+RENDER_INLINE U32 RENDER_SPRITES(U8* OBJ, int LINE, const bool H40, const bool IM2)
+{
+    int WIDTH = H40 ? VDP_SCREEN_WIDTH : 256;
+    int TILE_HEIGHT = IM2 ? 16 : 8;
+    unsigned MAX_LINE = H40 ? VDP_MAX_SPRITE_LINE : VDP_MAX_SPRITE_LINE_H32;
+    unsigned MAX_TOTAL = H40 ? VDP_MAX_SPRITES : VDP_MAX_SPRITES_H32;
+    unsigned TABLE = VDP->SPRITE_TABLE & (H40 ? 0xFC00 : 0xFE00);
+    unsigned INDEX = 0, TOTAL = 0, COUNT = 0;
+    int DOTS = 0;
+    int Y = IM2 ? ((LINE << 1) | ((VDP->STATUS & RENDER_STATUS_ODD) ? 1 : 0)) + 0x100 : LINE + 0x80;
+    bool MASKED = false;
+    bool COLLIDED = false;
+    U32 SIGNATURE = VDP_SPRITE_SIGNATURE;
+
+    memset(OBJ, 0, WIDTH);
+
+    do
+    {
+        unsigned ADDRESS = (TABLE + (INDEX << 3)) & 0xFFF8;
+        unsigned SIZE = MD_READ_WORD(VDP->VRAM, ADDRESS + 2);
+        unsigned ATTR, PRI_PAL, TILE;
+        int TOP = MD_READ_WORD(VDP->VRAM, ADDRESS) & (IM2 ? 0x3FF : 0x1FF);
+        int TILES_H = ((SIZE >> 10) & 3) + 1;
+        int TILES_V = ((SIZE >> 8) & 3) + 1;
+        int LEFT, ROW, COLUMN, PIXEL_INDEX;
+        U32 DATA;
+        U8* DST;
+
+        INDEX = SIZE & 0x7F;
+
+        if(Y < TOP || Y >= TOP + TILES_V * TILE_HEIGHT)
+            continue;
+
+        for (COLUMN = 0; COLUMN < 8; COLUMN++)
+        {
+            SIGNATURE = (SIGNATURE ^ MD_READ_BYTE(VDP->VRAM, ADDRESS + COLUMN)) * 0x01000193;
+        }
+
+        if(++COUNT > MAX_LINE)
+        {
+            VDP->STATUS |= VDP_STATUS_SPRITE_OVERFLOW;
+            break;
+        }
+
+        // MASKED OR OUT OF DOTS, THE REST ARE ONLY WALKED TO BE COUNTED
+
+        LEFT = (MD_READ_WORD(VDP->VRAM, ADDRESS + 6) & 0x1FF) - 0x80;
+
+        if(LEFT == -0x80 && COUNT > 1)
+            MASKED = true;
+
+        if(MASKED || DOTS >= WIDTH)
+            continue;
+
+        DOTS += TILES_H << 3;
+
+        if(LEFT + (TILES_H << 3) <= 0 || LEFT >= WIDTH)
+            continue;
+
+        ATTR = MD_READ_WORD(VDP->VRAM, ADDRESS + 4);
+        PRI_PAL = (ATTR >> 9) & (RENDER_PRIORITY | 0x30);
+        ROW = Y - TOP;
+
+        if(ATTR & 0x1000)
+            ROW = TILES_V * TILE_HEIGHT - 1 - ROW;
+
+        for (COLUMN = 0; COLUMN < TILES_H; COLUMN++)
+        {
+            // A SPRITE'S PATTERNS ARE CONSECUTIVE, COLUMN BY COLUMN
+
+            TILE = (ATTR & (IM2 ? 0x3FF : 0x7FF)) + ((ATTR & 0x0800) ? TILES_H - 1 - COLUMN : COLUMN) * TILES_V;
+            TILE += IM2 ? ROW >> 4 : ROW >> 3;
+
+            DATA = MD_READ_LONG(VDP->VRAM, (IM2 ? (TILE << 6) | ((ROW & 15) << 2) : (TILE << 5) | ((ROW & 7) << 2)) & 0xFFFC);
+            DST = OBJ + LEFT + (COLUMN << 3);
+
+            for (PIXEL_INDEX = 0; PIXEL_INDEX < 8; PIXEL_INDEX++)
+            {
+                unsigned COLOUR = (ATTR & 0x0800) ? (DATA >> (PIXEL_INDEX << 2)) & 0x0F : (DATA >> (28 - (PIXEL_INDEX << 2))) & 0x0F;
+
+                if(!COLOUR)
+                    continue;
+
+                // TWO OPAQUE PIXELS MEETING ONLY COUNT ON SCREEN, NOT IN THE BORDER
+
+                if(!(DST[PIXEL_INDEX] & RENDER_OPAQUE))
+                    DST[PIXEL_INDEX] = PRI_PAL | COLOUR;
+
+                else if((unsigned)(LEFT + (COLUMN << 3) + PIXEL_INDEX) < (unsigned)WIDTH)
+                    COLLIDED = true;
+            }
+        }
+
+    } while (INDEX != 0 && ++TOTAL < MAX_TOTAL);
+
+    if(COLLIDED)
+        VDP->STATUS |= VDP_STATUS_SPRITE_COLLISION;
+
+    return SIGNATURE;
+}
+
+/* THE SPRITES OVER THE MERGED PLANES, LEAVING FINISHED PIXELS (SEE render.h) */
+/* - SHADOW/HIGHLIGHT ONLY CHANGES WHICH TABLE THEY ARE MERGED THROUGH */
+
+RENDER_INLINE U32 RENDER_OBJ_LINE(int LINE, const bool H40, const bool SH, const bool IM2)
+{
+    U8* OUT = &PIXEL_LINE_BUFFER[RENDER_BUFFER_OUT][RENDER_BORDER];
+    U8* OBJ = &PIXEL_LINE_BUFFER[RENDER_BUFFER_OBJ][RENDER_BORDER];
+    U32 SIGNATURE = RENDER_SPRITES(OBJ, LINE, H40, IM2);
+
+    RENDER_MERGE(OUT, OBJ, RENDER_LUT[SH ? RENDER_LUT_SH : RENDER_LUT_OBJ], H40 ? VDP_SCREEN_WIDTH : 256);
+    return SIGNATURE;
+}
+
+static U32 RENDER_OBJ_H32(int LINE)            { return RENDER_OBJ_LINE(LINE, false, false, false); }
+static U32 RENDER_OBJ_H40(int LINE)            { return RENDER_OBJ_LINE(LINE, true, false, false); }
+static U32 RENDER_OBJ_H32_SH(int LINE)         { return RENDER_OBJ_LINE(LINE, false, true, false); }
+static U32 RENDER_OBJ_H40_SH(int LINE)         { return RENDER_OBJ_LINE(LINE, true, true, false); }
+static U32 RENDER_OBJ_H32_IM2(int LINE)        { return RENDER_OBJ_LINE(LINE, false, false, true); }
+static U32 RENDER_OBJ_H40_IM2(int LINE)        { return RENDER_OBJ_LINE(LINE, true, false, true); }
+static U32 RENDER_OBJ_H32_SH_IM2(int LINE)     { return RENDER_OBJ_LINE(LINE, false, true, true); }
+static U32 RENDER_OBJ_H40_SH_IM2(int LINE)     { return RENDER_OBJ_LINE(LINE, true, true, true); }
+
+/* NO SPRITES ARE FETCHED EITHER, SO THE SIGNATURE IS THAT OF AN EMPTY LINE */
+
+static U32 RENDER_OBJ_BLANK(int LINE)
+{
+    (void)LINE;
+    return VDP_SPRITE_SIGNATURE;
+}
+
+/* INDEXED BY THE MODE BITS EACH PASS DEPENDS ON - H40, THEN THE WINDOW OR */
+/* SHADOW/HIGHLIGHT, THEN INTERLACE MODE 2 */
+
+static void(* const RENDER_BG_VARIANTS[8])(int LINE) =
+{
+    RENDER_BG_H32,          RENDER_BG_H40,
+    RENDER_BG_H32_WINDOW,   RENDER_BG_H40_WINDOW,
+    RENDER_BG_H32_IM2,      RENDER_BG_H40_IM2,
+    RENDER_BG_H32_WINDOW_IM2, RENDER_BG_H40_WINDOW_IM2,
+};
+
+static U32(* const RENDER_OBJ_VARIANTS[8])(int LINE) =
+{
+    RENDER_OBJ_H32,         RENDER_OBJ_H40,
+    RENDER_OBJ_H32_SH,      RENDER_OBJ_H40_SH,
+    RENDER_OBJ_H32_IM2,     RENDER_OBJ_H40_IM2,
+    RENDER_OBJ_H32_SH_IM2,  RENDER_OBJ_H40_SH_IM2,
+};
+
+//================================================
+//           VARIANT SELECTION
+//================================================
+
+/* CALLED WHENEVER A REGISTER WHICH CHANGES THE MODE IS WRITTEN - $01 */
+/* (DISPLAY ENABLE, V30), $0C (H40, INTERLACE, SHADOW/HIGHLIGHT) AND $11/$12 */
+/* (THE WINDOW). ALSO SIZES THE ACTIVE AREA OF THE FRAMEBUFFER TO SUIT, */
+/* CENTRING H32 BETWEEN BORDERS */
+
+void RENDER_SELECT(void)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    unsigned MODE = 0;
+
+    if(VDP->VDP_REG[12] & 0x01)                                 MODE |= RENDER_MODE_H40;
+    if((VDP->VDP_REG[17] & 0x9F) || (VDP->VDP_REG[18] & 0x9F))  MODE |= RENDER_MODE_WINDOW;
+    if((VDP->VDP_REG[12] & 0x06) == 0x06)                       MODE |= RENDER_MODE_IM2;
+    if(VDP->VDP_REG[12] & 0x08)                                 MODE |= RENDER_MODE_SH;
+    if(!(VDP->VDP_REG[1] & 0x40))                               MODE |= RENDER_MODE_BLANK;
+
+    RENDER_MODE = MODE;
+
+    if(MODE & RENDER_MODE_BLANK)
+    {
+        RENDER_BG = RENDER_BG_BLANK;
+        RENDER_OBJ = RENDER_OBJ_BLANK;
+    }
+
+    else
+    {
+        RENDER_BG = RENDER_BG_VARIANTS[MODE & (RENDER_MODE_H40 | RENDER_MODE_WINDOW | RENDER_MODE_IM2)];
+        RENDER_OBJ = RENDER_OBJ_VARIANTS[(MODE & (RENDER_MODE_H40 | RENDER_MODE_IM2)) | ((MODE & RENDER_MODE_SH) ? 0x02 : 0)];
+    }
+
+    BMP->W = (MODE & RENDER_MODE_H40) ? VDP_SCREEN_WIDTH : 256;
+    BMP->X = (VDP_SCREEN_WIDTH - BMP->W) >> 1;
+    BMP->H = ((VDP->VDP_REG[1] & 0x08) && VDP->PAL) ? VDP_SCREEN_HEIGHT : VDP_ACTIVE_HEIGHT;
+}
+
+/* BRING EVERYTHING DERIVED FROM THE REGISTERS AND CRAM BACK IN LINE WITH */
+/* THEM, AFTER THEY HAVE BEEN REPLACED WHOLESALE (POWER ON, A SAVE STATE) */
+
+void RENDER_SYNC(void)
+{
+    unsigned INDEX;
+
+    for (INDEX = 0; INDEX < 0x40; INDEX++)
+    {
+        RENDER_PALETTE_WRITE(INDEX);
+    }
+
+    RENDER_BACKDROP_WRITE();
+    RENDER_SELECT();
+}
+
+unsigned RENDER_GET_MODE(void)
+{
+    return RENDER_MODE;
+}
+
+//================================================
+//           LINE ASSEMBLY
+//================================================
+
+/* HANDS BACK THE SIGNATURE OF THE SPRITES ON THE LINE (SEE VDP_LINE) */
+
+U32 RENDER_LINE(int LINE)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    U8* OUT = &PIXEL_LINE_BUFFER[RENDER_BUFFER_OUT][RENDER_BORDER];
+    U8 BACKDROP = RENDER_NORMAL | RENDER_BACKDROP;
+    U32 SIGNATURE;
+
+    RENDER_BG(LINE);
+    SIGNATURE = RENDER_OBJ(LINE);
+
+    // THE LEFT MOST COLUMN MAY BE BLANKED, HIDING THE TILES SCROLLING IN
+
+    if(VDP->VDP_REG[0] & 0x20)
+    {
+        memset(OUT, BACKDROP, 8);
+    }
+
+    // THE BORDERS EITHER SIDE OF A NARROWER DISPLAY SHOW THE BACKDROP
+
+    if(BMP->X > 0)
+    {
+        memset(OUT - BMP->X, BACKDROP, BMP->X);
+        memset(OUT + BMP->W, BACKDROP, BMP->X);
+    }
+
+    REMAP_LINE(LINE);
+    return SIGNATURE;
+}
+
+/* EACH FINISHED PIXEL BECOMES IT'S COLOUR IN THE FRAMEBUFFER ROW */
+
+void REMAP_LINE(int LINE)
+{
+    VDP_BITMAP* BMP = VDP_GET_BITMAP();
+    const U8* SOURCE = &PIXEL_LINE_BUFFER[RENDER_BUFFER_OUT][RENDER_BORDER - BMP->X];
+    int ROW = (LINE + BMP->Y) % VDP->LINES_PER_FRAME;
+    int WIDTH = BMP->W + (BMP->X << 1);
+    U32* DESTINATION;
+    int X;
+
+    if(ROW >= BMP->HEIGHT)
+        return;
+
+    DESTINATION = (U32*)(BMP->DATA + ROW * BMP->PITCH);
+
+    for (X = 0; X < WIDTH; X++)
+    {
+        DESTINATION[X] = PIXEL[SOURCE[X]];
+    }
+}
+
+#endif
@@ -0,0 +1,225 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS UPSCALING THE VDP'S OUTPUT FOR THE HOST */
+/* SEE scale.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "scale.h"
+#include "vdp.h"
+
+/* SYSTEM INCLUDES */
+
+#include <string.h>
+
+#if SCALE_SIMD
+#include <emmintrin.h>
+#endif
+
+#ifdef USE_SCALE
+
+/* UNTIL SCALE_INIT IS CALLED, THE OUTPUT IS THE SAME SIZE AS THE VDP'S */
+
+static SCALE_BASE SCALE =
+{
+    1, SCALE_FILTER_NONE, NULL,
+    VDP_SCREEN_WIDTH, VDP_SCREEN_HEIGHT, VDP_SCREEN_WIDTH * 4
+};
+
+void SCALE_INIT(unsigned FACTOR, SCALE_FILTER FILTER)
+{
+    if(FACTOR < 1)                  FACTOR = 1;
+    if(FACTOR > SCALE_MAX_FACTOR)   FACTOR = SCALE_MAX_FACTOR;
+
+    SCALE.FACTOR = FACTOR;
+    SCALE.FILTER = FILTER;
+    SCALE.DATA = NULL;
+    SCALE.WIDTH = VDP_SCREEN_WIDTH * FACTOR;
+    SCALE.HEIGHT = VDP_SCREEN_HEIGHT * FACTOR;
+    SCALE.PITCH = SCALE.WIDTH * 4;
+}
+
+SCALE_BASE* SCALE_GET_STATE(void)
+{
+    return &SCALE;
+}
+
+//================================================
+//              SCALAR HELPERS
+//================================================
+
+/* THE ROUNDED UP AVERAGE OF EACH BYTE - MATCHES SSE2'S PAVGB EXACTLY */
+
+static inline U32 SCALE_AVERAGE(U32 A, U32 B)
+{
+    return (A | B) - (((A ^ B) >> 1) & 0x7F7F7F7F);
+}
+
+/* THREE QUARTERS OF EACH COLOUR CHANNEL, LEAVING ALPHA OPAQUE */
+
+static inline U32 SCALE_DIM(U32 PIXEL)
+{
+    return (((PIXEL >> 1) & 0x007F7F7F) + ((PIXEL >> 2) & 0x003F3F3F)) | 0xFF000000;
+}
+
+//================================================
+//              ROW KERNELS
+//================================================
+
+/* EVERY KERNEL WIDENS A ROW OF PIXELS INTO FACTOR COPIES OF EACH - WHEN */
+/* SMOOTHING, THE LAST COPY IS REPLACED WITH THE AVERAGE OF THE PIXEL AND */
+/* THE ONE TO IT'S RIGHT (THE LAST PIXEL ON THE ROW HAS NOTHING TO BLEND WITH) */
+
+/* NEAREST NEIGHBOUR IS THE SAME KERNEL, WITH THE "AVERAGE" BEING THE PIXEL ITSELF */
+
+#if SCALE_SIMD
+
+/* TAKE EACH 32 BIT LANE FROM B WHERE THE MASK IS SET, OTHERWISE FROM A */
+
+#define     SCALE_SELECT(A, B, MASK)        _mm_or_si128(_mm_andnot_si128((MASK), (A)), _mm_and_si128((MASK), (B)))
+
+static int SCALE_ROW_SIMD(U32* DST, const U32* SRC, int WIDTH, unsigned FACTOR, bool SMOOTH)
+{
+    const __m128i LANE_0 = _mm_set_epi32(0, 0, 0, -1);
+    const __m128i LANE_1 = _mm_set_epi32(0, 0, -1, 0);
+    const __m128i LANE_2 = _mm_set_epi32(0, -1, 0, 0);
+    const __m128i LANE_3 = _mm_set_epi32(-1, 0, 0, 0);
+    __m128i* OUT = (__m128i*)DST;
+    __m128i P, A;
+    int X;
+
+    // THE NEIGHBOUR LOAD READS ONE PIXEL AHEAD, SO THE LAST FEW ARE LEFT TO THE CALLER
+
+    for (X = 0; X + 4 < WIDTH; X += 4)
+    {
+        P = _mm_loadu_si128((const __m128i*)(SRC + X));
+        A = SMOOTH ? _mm_avg_epu8(P, _mm_loadu_si128((const __m128i*)(SRC + X + 1))) : P;
+
+        switch (FACTOR)
+        {
+            case 1:
+                _mm_storeu_si128(OUT++, A);
+                break;
+
+            case 2:
+                _mm_storeu_si128(OUT++, _mm_unpacklo_epi32(P, A));
+                _mm_storeu_si128(OUT++, _mm_unpackhi_epi32(P, A));
+                break;
+
+            case 3:
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_epi32(A, _MM_SHUFFLE(0, 0, 0, 0)), LANE_2));
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_epi32(A, _MM_SHUFFLE(1, 1, 1, 1)), LANE_1));
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(3, 3, 3, 2)), _mm_shuffle_epi32(A, _MM_SHUFFLE(3, 2, 2, 2)), _mm_or_si128(LANE_0, LANE_3)));
+                break;
+
+            default:
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_epi32(A, _MM_SHUFFLE(0, 0, 0, 0)), LANE_3));
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(A, _MM_SHUFFLE(1, 1, 1, 1)), LANE_3));
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_epi32(A, _MM_SHUFFLE(2, 2, 2, 2)), LANE_3));
+                _mm_storeu_si128(OUT++, SCALE_SELECT(_mm_shuffle_epi32(P, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_epi32(A, _MM_SHUFFLE(3, 3, 3, 3)), LANE_3));
+                break;
+        }
+    }
+
+    return X;
+}
+
+/* DIM A WHOLE OUTPUT ROW FOR THE SCANLINE FILTER */
+
+static int SCALE_DIM_SIMD(U32* DST, const U32* SRC, int WIDTH)
+{
+    const __m128i HALF = _mm_set1_epi32(0x007F7F7F);
+    const __m128i QUARTER = _mm_set1_epi32(0x003F3F3F);
+    const __m128i ALPHA = _mm_set1_epi32((int)0xFF000000);
+    __m128i P;
+    int X;
+
+    for (X = 0; X + 4 <= WIDTH; X += 4)
+    {
+        P = _mm_loadu_si128((const __m128i*)(SRC + X));
+        P = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(P, 1), HALF), _mm_and_si128(_mm_srli_epi32(P, 2), QUARTER));
+        _mm_storeu_si128((__m128i*)(DST + X), _mm_or_si128(P, ALPHA));
+    }
+
+    return X;
+}
+
+#endif
+
+static void SCALE_ROW(U32* DST, const U32* SRC, int WIDTH, unsigned FACTOR, bool SMOOTH)
+{
+    unsigned COPY;
+    int X = 0;
+    U32 PIXEL;
+
+#if SCALE_SIMD
+    X = SCALE_ROW_SIMD(DST, SRC, WIDTH, FACTOR, SMOOTH);
+    DST += X * FACTOR;
+#endif
+
+    for (; X < WIDTH; X++)
+    {
+        PIXEL = SRC[X];
+
+        for (COPY = 1; COPY < FACTOR; COPY++)
+        {
+            *DST++ = PIXEL;
+        }
+
+        *DST++ = (SMOOTH && X + 1 < WIDTH) ? SCALE_AVERAGE(PIXEL, SRC[X + 1]) : PIXEL;
+    }
+}
+
+static void SCALE_DIM_ROW(U32* DST, const U32* SRC, int WIDTH)
+{
+    int X = 0;
+
+#if SCALE_SIMD
+    X = SCALE_DIM_SIMD(DST, SRC, WIDTH);
+#endif
+
+    for (; X < WIDTH; X++)
+    {
+        DST[X] = SCALE_DIM(SRC[X]);
+    }
+}
+
+//================================================
+//              PER LINE ENTRY
+//================================================
+
+/* WIDEN ONE REMAPPED LINE INTO FACTOR ROWS OF THE TARGET - THE FIRST ROW IS */
+/* BUILT FROM THE SOURCE, THE REST ARE COPIES OF IT WHILE IT'S STILL IN CACHE */
+
+void SCALE_LINE(const U32* SOURCE, int WIDTH, int ROW)
+{
+    U32* FIRST;
+    unsigned COPY;
+    int OUTPUT_WIDTH = WIDTH * SCALE.FACTOR;
+
+    if(SCALE.DATA == NULL || ROW < 0 || (ROW + 1) * (int)SCALE.FACTOR > SCALE.HEIGHT)
+        return;
+
+    FIRST = (U32*)(SCALE.DATA + ROW * SCALE.FACTOR * SCALE.PITCH);
+
+    SCALE_ROW(FIRST, SOURCE, WIDTH, SCALE.FACTOR, SCALE.FILTER == SCALE_FILTER_SMOOTH);
+
+    for (COPY = 1; COPY < SCALE.FACTOR; COPY++)
+    {
+        U32* DST = (U32*)((U8*)FIRST + COPY * SCALE.PITCH);
+
+        if(SCALE.FILTER == SCALE_FILTER_SCANLINE && COPY == SCALE.FACTOR - 1)
+        {
+            SCALE_DIM_ROW(DST, FIRST, OUTPUT_WIDTH);
+        }
+
+        else
+        {
+            memcpy(DST, FIRST, OUTPUT_WIDTH * sizeof(U32));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS SCROLLING THE VDP'S BACKGROUND PLANES */
+/* SEE scroll.h FOR AN OVERVIEW */
+
+/* NESTED INCLUDES */
+
+#include "scroll.h"
+#include "vdp.h"
+#include "mem.h"
+
+#ifdef USE_SCROLL
+
+static SCROLL_BASE SCROLL;
+
+//================================================
+//           SCROLL VALUES
+//================================================
+
+/* THE LINE'S HORIZONTAL SCROLL ENTRY - PLANE A'S WORD FIRST, THEN PLANE B'S */
+
+unsigned SCROLL_HSCROLL_ADDRESS(int LINE)
+{
+    unsigned OFFSET;
+
+    switch (VDP->VDP_REG[11] & 3)
+    {
+        case 1:     OFFSET = (LINE & 7) << 2;       break;
+        case 2:     OFFSET = (LINE & ~7) << 2;      break;
+        case 3:     OFFSET = LINE << 2;             break;
+        default:    OFFSET = 0;                     break;
+    }
+
+    return (VDP->HORI_SCROLL + OFFSET) & 0xFFFC;
+}
+
+/* EVERY VERTICAL SCROLL THE LINE USES, MASKED TO THE PLANE'S HEIGHT IN */
+/* PIXELS - ONLY THE FIRST COLUMN'S IS READ IN FULL SCREEN MODE */
+
+static void SCROLL_RESOLVE(int LINE, bool IM2)
+{
+    unsigned ADDRESS = SCROLL_HSCROLL_ADDRESS(LINE);
+    unsigned MASK = IM2 ? 0x7FF : 0x3FF;
+    unsigned COLUMNS, COLUMN, PLANE, INDEX;
+
+    SCROLL.HSCROLL[SCROLL_PLANE_A] = MD_READ_WORD(VDP->VRAM, ADDRESS);
+    SCROLL.HSCROLL[SCROLL_PLANE_B] = MD_READ_WORD(VDP->VRAM, ADDRESS + 2);
+    SCROLL.COLUMN = (VDP->VDP_REG[11] & 0x04) != 0;
+
+    COLUMNS = SCROLL.COLUMN ? SCROLL_COLUMNS : 1;
+
+    for (PLANE = 0; PLANE < SCROLL_PLANES; PLANE++)
+    {
+        for (COLUMN = 0; COLUMN < COLUMNS; COLUMN++)
+        {
+            INDEX = (COLUMN << 2) | (PLANE << 1);
+            SCROLL.VSCROLL[PLANE][COLUMN] = ((VDP->VSRAM[INDEX] << 8) | VDP->VSRAM[INDEX + 1]) & MASK;
+        }
+    }
+}
+
+//================================================
+//           FETCH PLAN
+//================================================
+
+/* ONE PLANE'S TILES FROM WHICHEVER LANDS ON THE LEFT EDGE - THE PART OF IT */
+/* OFF THE EDGE IS DRAWN INTO THE RENDERER'S BORDER */
+
+/* WITH ONE VERTICAL SCROLL, EVERY TILE COMES FROM THE SAME NAME TABLE ROW, */
+/* SO ONLY THE COLUMN MOVES. PER COLUMN, EACH TILE TAKES THE SCROLL OF THE */
+/* 2 CELL COLUMN IT STARTS IN - THE ONE HANGING OFF THE LEFT, THE FIRST */
+
+static void SCROLL_PLAN_BUILD(SCROLL_PLAN* PLAN, unsigned PLANE, unsigned BASE, int ROW, bool H40, bool IM2)
+{
+    unsigned WIDTH = VDP_PLANE_CELLS[VDP->VDP_REG[16] & 3];
+    unsigned HEIGHT = VDP_PLANE_CELLS[(VDP->VDP_REG[16] >> 4) & 3];
+    unsigned TILE_SHIFT = IM2 ? 4 : 3;
+    unsigned ROW_MASK = (HEIGHT << TILE_SHIFT) - 1;
+    unsigned SCROLL_X = 0u - SCROLL.HSCROLL[PLANE];
+    unsigned COLUMN = (SCROLL_X >> 3) & (WIDTH - 1);
+    unsigned TILE, Y, LINE_BASE;
+    int X;
+
+    PLAN->X = -(int)(SCROLL_X & 7);
+    PLAN->COUNT = (H40 ? 40 : 32) + 1;
+
+    if(!SCROLL.COLUMN)
+    {
+        Y = (ROW + SCROLL.VSCROLL[PLANE][0]) & ROW_MASK;
+        LINE_BASE = BASE + (((Y >> TILE_SHIFT) * WIDTH) << 1);
+
+        for (TILE = 0; TILE < PLAN->COUNT; TILE++, COLUMN = (COLUMN + 1) & (WIDTH - 1))
+        {
+            PLAN->FETCH[TILE].ADDRESS = (LINE_BASE + (COLUMN << 1)) & 0xFFFE;
+            PLAN->FETCH[TILE].ROW = Y & ((1u << TILE_SHIFT) - 1);
+        }
+
+        return;
+    }
+
+    for (TILE = 0, X = PLAN->X; TILE < PLAN->COUNT; TILE++, X += 8, COLUMN = (COLUMN + 1) & (WIDTH - 1))
+    {
+        Y = (ROW + SCROLL.VSCROLL[PLANE][X < 0 ? 0 : (unsigned)(X >> 4) % SCROLL_COLUMNS]) & ROW_MASK;
+
+        PLAN->FETCH[TILE].ADDRESS = (BASE + (((Y >> TILE_SHIFT) * WIDTH + COLUMN) << 1)) & 0xFFFE;
+        PLAN->FETCH[TILE].ROW = Y & ((1u << TILE_SHIFT) - 1);
+    }
+}
+
+/* LINE IS THE DISPLAY LINE, WHICH PICKS THE HORIZONTAL SCROLL - ROW IS THE */
+/* LINE OF THE PLANES IT SHOWS BEFORE VERTICAL SCROLLING, WHICH DIFFERS IN */
+/* INTERLACE MODE 2 */
+
+void SCROLL_LINE(int LINE, int ROW, bool H40, bool IM2)
+{
+    SCROLL_RESOLVE(LINE, IM2);
+
+    SCROLL_PLAN_BUILD(&SCROLL.PLAN[SCROLL_PLANE_A], SCROLL_PLANE_A, VDP->A_BASE, ROW, H40, IM2);
+    SCROLL_PLAN_BUILD(&SCROLL.PLAN[SCROLL_PLANE_B], SCROLL_PLANE_B, VDP->B_BASE, ROW, H40, IM2);
+}
+
+const SCROLL_PLAN* SCROLL_GET_PLAN(unsigned PLANE)
+{
+    return &SCROLL.PLAN[PLANE];
+}
+
+#endif
@@ -14,8 +14,15 @@
 
 #include <68K.h>
 #include "md.h"
+#include "mem.h"
 #include "vdp.h"
 #include "common.h"
+#include "profile.h"
+#include "irq.h"
+#include "scale.h"
+#include "timing.h"
+#include "render.h"
+#include "scroll.h"
 
 /* CREATE AN INSTANCE OF THE VDP BY ALLOCING THE SCREEN BUFFER */
 /* THIS WILL CREATE VIRTUAL MEMORY ASSOCIATED WITH THE BYTEWISE SIZE */
@@ -23,15 +30,20 @@
 
 #undef USE_VDP
 
-static U8 PIXEL[0x100];
-static U8 PIXEL_LUT[3][0x200];
-static U8 PIXEL_LINE_BUFFER[2][0x200];
-
 VDP_BASE* VDP = NULL;
 static VDP_BITMAP* VDP_BMP;
+static bool VDP_RENDER_ENABLED = true;
+static VDP_DIRTY* DIRTY;
+
+#define     VDP_NEWER(A, B)             ((A) > (B) ? (A) : (B))
+#define     VDP_DIRTY_VRAM(ADDRESS)     (DIRTY->BLOCK[((ADDRESS) & 0xFFFF) >> VDP_DIRTY_BLOCK_SHIFT] = DIRTY->STAMP)
+
+// PLANE DIMENSIONS IN CELLS, INDEXED BY THE TWO BIT SIZE FIELDS OF REGISTER 16
+
+const U8 VDP_PLANE_CELLS[4] = { 32, 64, 32, 128 };
+
+static U32 VDP_PLANE_STAMP(int LINE);
 
-void(*RENDER_BG)(int LINE);
-void(*RENDER_OBJ)(int LINE);
 void(*PARSE_SPRITE_TABLE)(int LINE);
 void(*UPDATE_BG_CACHE)(int INDEX);
 
@@ -45,14 +57,12 @@ void(*VDP_CTRL_W)(unsigned DATA);
 //           VDP INITIAL CO-ROUTINES
 //================================================
 
+/* THE VDP'S STATE LIVES IN THE CONSOLE ARENA ALONGSIDE EVERYTHING ELSE */
+/* SEE MD_INIT */
+
 void VDP_INIT(void) 
 {
-    VDP = malloc(sizeof(VDP_BASE));
-    if (VDP == NULL) 
-    {
-        perror("Memory Allocation failed for VDP\n");
-        exit(EXIT_FAILURE);
-    }
+    VDP = MD_ALLOC(sizeof(VDP_BASE));
 
     memset(VDP->VDP_REG, 0, sizeof(VDP->VDP_REG));
     memset(VDP->VRAM, 0, sizeof(VDP->VRAM));
@@ -106,7 +116,7 @@ void VDP_INIT(void)
     VDP->V_COUNTER = 0;
     VDP->VC_MAX = 0;
     VDP->PAL = 0;
-    VDP->LINES_PER_FRAME = VDP->VDP_PAL ? VDP_NTSC_TIMING : VDP_PAL_TIMING;
+    VDP->LINES_PER_FRAME = VDP->VDP_PAL ? VDP_PAL_TIMING : VDP_NTSC_TIMING;
     VDP->VINT_CYCLES = 0;
     VDP->HV_LATCH = 0;
     VDP->FIFO_IDX = 0;
@@ -118,148 +128,355 @@ void VDP_INIT(void)
     }
 
     VDP->VDP_CYCLES = 0;
+    VDP->ADDRESS = 0;
+    VDP->CODE = 0;
+    VDP->PENDING = 0;
+    VDP->DMA_FILL = 0;
+    VDP->FILL_DATA = 0;
     VDP->H_COUNTER_TABLE = NULL;
     VDP->SET_IRQ = NULL;
     VDP->SET_IRQ_DELAY = NULL;
 
+    VDP_CTRL_R = VDP_CTRL_READ;
+    VDP_CTRL_W = VDP_CTRL_WRITE;
+
+    /* THE FRAMEBUFFER IS 32 BITS PER PIXEL, LARGE ENOUGH FOR THE */
+    /* WIDEST (H40) AND TALLEST (V30) DISPLAY MODES */
+
+    VDP_BMP = MD_ALLOC(sizeof(VDP_BITMAP));
+    VDP_BMP->WIDTH = VDP_SCREEN_WIDTH;
+    VDP_BMP->HEIGHT = VDP_SCREEN_HEIGHT;
+    VDP_BMP->PITCH = VDP_SCREEN_WIDTH * 4;
+    VDP_BMP->DATA = MD_ALLOC(VDP_BMP->PITCH * VDP_BMP->HEIGHT);
+    VDP_BMP->X = 0;
+    VDP_BMP->Y = 0;
+    VDP_BMP->W = VDP_SCREEN_WIDTH;
+    VDP_BMP->H = VDP_ACTIVE_HEIGHT;
+    VDP_BMP->PREV_W = VDP_BMP->W;
+    VDP_BMP->PREV_H = VDP_BMP->H;
+    VDP_BMP->CHANGED = 0;
+    memset(VDP_BMP->DIRTY, 0, sizeof(VDP_BMP->DIRTY));
+
+    DIRTY = MD_ALLOC(sizeof(VDP_DIRTY));
+    memset(DIRTY, 0, sizeof(VDP_DIRTY));
+    DIRTY->STAMP = 1;
+    DIRTY->GLOBAL = 1;
+
+    RENDER_INIT();
+    PALETTE_INIT();
+    RENDER_SYNC();
+
     printf("VDP initialized: %p\n", (void*)VDP);
 }
 
-void VDP_RESET(void)
+VDP_BITMAP* VDP_GET_BITMAP(void)
 {
-    memset(VDP->SPRITE_TABLE, 0, sizeof(VDP->SPRITE_TABLE));
-    memset(*(char*) VDP->VRAM, 0, sizeof(VDP->VRAM));
-    memset(*(char*) VDP->CRAM, 0, sizeof(VDP->CRAM));
-    memset(*(char*) VDP->VSRAM, 0, sizeof(VDP->VSRAM));
-    memset(*(char*) VDP->VDP_REG, 0, sizeof(VDP->VDP_REG));
+    return VDP_BMP;
+}
 
-    VDP->HINT = 0;
-    VDP->VINT = 0;
-    VDP->DMA_LEN = 0;
-    VDP->DMA_TYPE = 0;
-    VDP->DMA_END_CYCLES = 0;
+/* ADVANCE THE VDP BY ONE SCANLINE */
+/* LINES WITHIN THE ACTIVE DISPLAY ARE RENDERED, THE REST ARE BLANKING */
 
-    VDP->A_BASE = 0;
-    VDP->B_BASE = 0;
-    VDP->W_BASE = 0;
-    VDP->SPRITE_TABLE = 0;
-    VDP->HORI_SCROLL = 0;
+/* THE SPRITE STATUS BITS ARE WORKED OUT WHETHER OR NOT THE LINE IS DRAWN, */
+/* SO A FRAME SKIPPED BY FAST FORWARD OR FRAMESKIP LOOKS THE SAME TO THE GAME */
 
-}
+/* A LINE IS ONLY REDRAWN IF SOMETHING IT IS BUILT FROM HAS CHANGED SINCE IT */
+/* WAS LAST DRAWN - OTHERWISE THE FRAMEBUFFER ALREADY HOLDS IT */
 
-void RENDER_INIT(void)
+void VDP_LINE(int LINE)
 {
-    int BIT_LAYER, ADDRESS_LAYER;
-    U16 INDEX;
+    U32 NEWEST, SIGNATURE;
+    int ROW;
+
+    VDP->V_COUNTER = LINE;
 
-    /* INITIALISE THE PRIORITY OF LAYERS WITHIN THE PIXEL LOOK UP TABLES */
-    /* READ A LITTLE ENDIAN INTO THE LOOKUP VALUE */
+    // AN INTERLACED DISPLAY ALTERNATES BETWEEN ODD AND EVEN FIELDS
 
-    for(BIT_LAYER = 0; BIT_LAYER < 0x100; BIT_LAYER++)
+    if(LINE == 0)
     {
-        for(ADDRESS_LAYER = 0; ADDRESS_LAYER < 0x100; ADDRESS_LAYER++)
-        {
-            INDEX += (BIT_LAYER << 8) | (ADDRESS_LAYER);
-        }
+        VDP->STATUS = (VDP->VDP_REG[12] & 0x02) ? VDP->STATUS ^ RENDER_STATUS_ODD : VDP->STATUS & ~RENDER_STATUS_ODD;
     }
-}
 
-void RENDER_RESET()
-{
-    // CLEAR DISPLAY SETTINGS
+    if(LINE >= VDP_BMP->H)
+        return;
 
-    memset(VDP_BMP->DATA, 0, VDP_BMP->PITCH * VDP_BMP->HEIGHT);
+    if(!VDP_RENDER_ENABLED || RENDER_BG == NULL)
+    {
+        VDP_SPRITE_STATUS(LINE, &SIGNATURE);
+        return;
+    }
 
-    // CLEAR LINE BUFFER
+    // A CHANGE OF RESOLUTION MOVES EVERY LINE
 
-    memset(PIXEL_LINE_BUFFER, 0, sizeof(PIXEL_LINE_BUFFER));
+    if(VDP_BMP->W != VDP_BMP->PREV_W || VDP_BMP->H != VDP_BMP->PREV_H)
+    {
+        VDP_BMP->PREV_W = VDP_BMP->W;
+        VDP_BMP->PREV_H = VDP_BMP->H;
+        VDP_INVALIDATE();
+    }
 
-    // CLEAR COLOUR PALETTE
+    // THE SPRITES ARE ONLY WALKED UP FRONT WHEN NOTHING ELSE HAS ALREADY
+    // CONDEMNED THE LINE - OTHERWISE THE RENDERER RAISES THEIR STATUS AS IT DRAWS
 
-    memset(PIXEL, 0, sizeof(PIXEL));
-}
+    if(DIRTY->GLOBAL < DIRTY->LINE[LINE] && VDP_PLANE_STAMP(LINE) < DIRTY->LINE[LINE])
+    {
+        NEWEST = VDP_SPRITE_STATUS(LINE, &SIGNATURE);
 
-/* INITIALISES MODE 5 SUPPORT FOR PALETTE DEFINITION */
-/* READS LITTLE ENDIAN INTO THE CRAM LOOKUP TABLE TO INITILAISE BASE COLOUR */
+        if(NEWEST < DIRTY->LINE[LINE] && SIGNATURE == DIRTY->SPRITES[LINE])
+            return;
+    }
 
-void PALETTE_INIT(void)
-{
-    int R, G, B, I;
+    SIGNATURE = RENDER_LINE(LINE);
+    PROFILE_COUNT(PROFILE_VDP_LINES_DRAWN, 1);
+
+    // A WRAPPED STAMP WOULD MAKE STALE LINES LOOK CLEAN - START AFRESH
 
-    for(I = 0; I < 0x200; I++)
+    if(++DIRTY->STAMP == 0)
     {
-        R = (I >> 0) & 7;
-        G = (I >> 3) & 7;
-        B = (I >> 6) & 7;
+        memset(DIRTY->BLOCK, 0, sizeof(DIRTY->BLOCK));
+        memset(DIRTY->LINE, 0, sizeof(DIRTY->LINE));
+        DIRTY->STAMP = 1;
+        DIRTY->GLOBAL = 1;
+    }
+
+    DIRTY->LINE[LINE] = DIRTY->STAMP;
+    DIRTY->SPRITES[LINE] = SIGNATURE;
 
-        // ALL OF THE BITS PER PIXEL - WHY NOT?
+    ROW = (LINE + VDP_BMP->Y) % VDP->LINES_PER_FRAME;
 
-        #undef USE_32BPP
+    if(ROW < VDP_BMP->HEIGHT)
+    {
+        SCALE_LINE((const U32*)(VDP_BMP->DATA + ROW * VDP_BMP->PITCH), VDP_BMP->WIDTH, ROW);
 
-        PIXEL_LUT[0][I] = BIT_32_PIXEL(R, G, B);
-        PIXEL_LUT[1][I] = BIT_32_PIXEL(R, G, B);
-        PIXEL_LUT[2][I] = BIT_32_PIXEL(R, G, B);
+        VDP_BMP->DIRTY[ROW] = 1;
+        VDP_BMP->CHANGED = 1;
     }
 }
 
+/* WHEN DISABLED, ONLY THE SIDE EFFECTS OF A LINE ARE EMULATED - THE */
+/* FRAMEBUFFER KEEPS WHATEVER WAS LAST DRAWN INTO IT */
 
-void RENDER_LINE(int LINE)
+void VDP_SET_RENDER(bool ENABLED)
 {
-    // CHECK IF THE DISPLAY FLAG HAS BEEN SET ACCORDING TO
-    // THE REGISTER VALUE
+    VDP_RENDER_ENABLED = ENABLED;
+}
 
-    if(VDP->VDP_REG[1] & 0x40)
-    {
-        RENDER_BG(LINE);
-        RENDER_OBJ(LINE & 1);
-    }
+/* FORCE EVERY LINE TO BE REDRAWN ON THE NEXT FRAME */
 
-    // CHECK THE LEFT MOST COLUMN TO INIT THE V AND HBLANK
+void VDP_INVALIDATE(void)
+{
+    DIRTY->GLOBAL = DIRTY->STAMP;
+}
 
-    if(VDP->VDP_REG[0] & 0x20)
-    {
-        memset(&PIXEL_LINE_BUFFER[0][0x20], 0x40, 8);
-    }
+//================================================
+//           LINE DEPENDENCY TRACKING
+//================================================
 
-    // PARSE SPRITES FOR THE NEXT LINE
+/* THE NEWEST WRITE TO A ROW OF A NAME TABLE, OR ANY PATTERN IT POINTS AT */
+/* THE WHOLE ROW IS CHECKED, SO HORIZONTAL SCROLLING NEEDS NO SPECIAL CASE */
+
+static U32 VDP_ROW_STAMP(unsigned BASE, unsigned ROW, unsigned CELLS)
+{
+    unsigned ADDRESS = BASE + ROW * CELLS * 2;
+    unsigned CELL, ENTRY;
+    U32 NEWEST = 0;
 
-    if(LINE < (VDP_BMP->H - 1))
+    for (CELL = 0; CELL < CELLS; CELL++, ADDRESS += 2)
     {
-        PARSE_SPRITE_TABLE(LINE);
+        ADDRESS &= 0xFFFE;
+        ENTRY = MD_READ_WORD(VDP->VRAM, ADDRESS);
+
+        NEWEST = VDP_NEWER(NEWEST, DIRTY->BLOCK[ADDRESS >> VDP_DIRTY_BLOCK_SHIFT]);
+        NEWEST = VDP_NEWER(NEWEST, DIRTY->BLOCK[ENTRY & 0x07FF]);
     }
 
-    // CHECK FOR THE HORIZONTAL BORDERS OF THE VIEW
+    return NEWEST;
+}
+
+/* THE NEWEST WRITE TO ANYTHING THE BACKGROUND PLANES DRAW THIS LINE FROM */
+
+/* PER-COLUMN VERTICAL SCROLL AND DOUBLE RESOLUTION INTERLACE PULL FROM TOO */
+/* MANY ROWS TO BE WORTH TRACKING, SO SUCH LINES ARE ALWAYS DIRTY */
+
+static U32 VDP_PLANE_STAMP(int LINE)
+{
+    bool H40 = VDP->VDP_REG[12] & 0x01;
+    unsigned WIDTH = VDP_PLANE_CELLS[VDP->VDP_REG[16] & 3];
+    unsigned HEIGHT = VDP_PLANE_CELLS[(VDP->VDP_REG[16] >> 4) & 3];
+    unsigned SCROLL_A, SCROLL_B;
+    U32 NEWEST;
+
+    if((VDP->VDP_REG[11] & 0x04) || (VDP->VDP_REG[12] & 0x06) == 0x06)
+        return DIRTY->STAMP;
+
+    // THE HORIZONTAL SCROLL ENTRY - WHOLE SCREEN, PER 8 LINES OR PER LINE
+
+    NEWEST = DIRTY->BLOCK[SCROLL_HSCROLL_ADDRESS(LINE) >> VDP_DIRTY_BLOCK_SHIFT];
+
+    // WHICH ROW OF EACH PLANE THE LINE FALLS ON FOLLOWS FROM IT'S VERTICAL SCROLL
+    // (ANY CHANGE TO VSRAM HAS ALREADY INVALIDATED EVERY LINE)
 
-    if(VDP_BMP->X > 0)
+    SCROLL_A = ((VDP->VSRAM[0] << 8) | VDP->VSRAM[1]) & 0x3FF;
+    SCROLL_B = ((VDP->VSRAM[2] << 8) | VDP->VSRAM[3]) & 0x3FF;
+
+    NEWEST = VDP_NEWER(NEWEST, VDP_ROW_STAMP(VDP->A_BASE, ((LINE + SCROLL_A) >> 3) & (HEIGHT - 1), WIDTH));
+    NEWEST = VDP_NEWER(NEWEST, VDP_ROW_STAMP(VDP->B_BASE, ((LINE + SCROLL_B) >> 3) & (HEIGHT - 1), WIDTH));
+
+    // THE WINDOW IS NEVER SCROLLED, AND IS ONLY AS WIDE AS THE SCREEN
+
+    if((VDP->VDP_REG[17] & 0x9F) || (VDP->VDP_REG[18] & 0x9F))
     {
-        memset(&PIXEL_LINE_BUFFER[0][0x20 - VDP_BMP->X], 0x40, VDP_BMP->X);
-        memset(&PIXEL_LINE_BUFFER[0][0x20 + VDP_BMP->W], 0x40, VDP_BMP->W);
-         
+        NEWEST = VDP_NEWER(NEWEST, VDP_ROW_STAMP(VDP->W_BASE & (H40 ? 0xF000 : 0xF800), LINE >> 3, H40 ? 64 : 32));
     }
 
-    // IF THE FIRST LINE HASNT BEEN RENDERED
-
-    memset(&PIXEL_LINE_BUFFER[0][0x20 - VDP_BMP->X], 0x40, VDP_BMP->W + 2 * VDP_BMP->X);
-    REMAP_LINE(LINE);
+    return NEWEST;
 }
 
-// THIS WILL LOOK INTO BEING ABLE TO REMAP THE RENDER COROUTINE
-// AFTER EVERY CONSECTUTIVE LINE RENDER
+/* WALK THE SPRITE ATTRIBUTE TABLE'S LINKED LIST FOR THE SPRITES WHICH */
+/* FALL ON THIS LINE, RAISING THE OVERFLOW BIT ONCE THERE ARE MORE THAN */
+/* THE VDP CAN FETCH, AND THE COLLISION BIT WHEN TWO OPAQUE PIXELS MEET */
+
+/* ONLY NEEDED FOR A LINE WHICH MAY NOT BE DRAWN - RENDER_SPRITES DOES THE */
+/* SAME AS IT DRAWS, SO THE TWO MUST AGREE ON WHAT THEY COUNT AND HASH */
 
-void REMAP_LINE(int LINE)
+/* EACH ENTRY IS 8 BYTES: Y, SIZE, LINK, ATTRIBUTES (PRIORITY, PALETTE, */
+/* FLIP, PATTERN) AND X - WITH Y AND X BOTH OFFSET BY 128 */
+
+/* ALSO HANDS BACK A SIGNATURE OF THE ENTRIES ON THE LINE, AND THE NEWEST */
+/* WRITE TO ANY OF THEIR PATTERNS - SEE VDP_LINE */
+
+// SEE: https://plutiedev.com/sprites
+
+U32 VDP_SPRITE_STATUS(int LINE, U32* SIGNATURE)
 {
-    U8* LINE_SRC_BUFFER = &PIXEL_LINE_BUFFER[0][0x20 - VDP_BMP->X];
-    LINE = (LINE + VDP_BMP->Y) % VDP->LINES_PER_FRAME;
+    U8 COVERAGE[VDP_SCREEN_WIDTH];
+    bool H40 = VDP->VDP_REG[12] & 0x01;
+    int WIDTH = H40 ? VDP_SCREEN_WIDTH : 256;
+    unsigned MAX_LINE = H40 ? VDP_MAX_SPRITE_LINE : VDP_MAX_SPRITE_LINE_H32;
+    unsigned MAX_TOTAL = H40 ? VDP_MAX_SPRITES : VDP_MAX_SPRITES_H32;
+    unsigned TABLE = VDP->SPRITE_TABLE & (H40 ? 0xFC00 : 0xFE00);
+    unsigned INDEX = 0, TOTAL = 0, COUNT = 0;
+    int DOTS = 0;
+    int Y = LINE + 0x80;
+    bool MASKED = false;
+    U32 NEWEST = 0;
+
+    *SIGNATURE = VDP_SPRITE_SIGNATURE;
+
+    if(!(VDP->VDP_REG[1] & 0x40))
+        return 0;
+
+    memset(COVERAGE, 0, WIDTH);
+
+    do
+    {
+        unsigned ADDRESS = (TABLE + (INDEX << 3)) & 0xFFF8;
+        unsigned SIZE = MD_READ_WORD(VDP->VRAM, ADDRESS + 2);
+        int TOP = MD_READ_WORD(VDP->VRAM, ADDRESS) & 0x1FF;
+        int TILES_H = ((SIZE >> 10) & 3) + 1;
+        int TILES_V = ((SIZE >> 8) & 3) + 1;
+        unsigned PATTERN;
 
-    // USE THE DEFAULT PER PIXEL MODE
-    // THE IDEA IS TO TAKE THE DESTINATION BASED ON THE PITCH (RENDER SPEED)
+        INDEX = SIZE & 0x7F;
 
-    // STORE THE SRC LINE IN THE DEST BUFFER
+        if(Y < TOP || Y >= TOP + (TILES_V << 3))
+            continue;
 
-    #undef USE_15BPP
+        // FNV-1A OVER THE WHOLE ENTRY, SO A SPRITE ARRIVING, LEAVING OR CHANGING IS SEEN
 
-    U8* DESTINATION = ((U8*)&VDP_BMP->DATA[(LINE * VDP_BMP->PITCH)]);
-    *DESTINATION++ = PIXEL[*LINE_SRC_BUFFER]++;
+        for (int BYTE = 0; BYTE < 8; BYTE++)
+        {
+            *SIGNATURE = (*SIGNATURE ^ MD_READ_BYTE(VDP->VRAM, ADDRESS + BYTE)) * 0x01000193;
+        }
+
+        // A SPRITE'S PATTERNS ARE CONSECUTIVE, COLUMN BY COLUMN
+
+        PATTERN = MD_READ_WORD(VDP->VRAM, ADDRESS + 4) & 0x07FF;
+
+        for (int TILE = 0; TILE < TILES_H * TILES_V; TILE++)
+        {
+            NEWEST = VDP_NEWER(NEWEST, DIRTY->BLOCK[(PATTERN + TILE) & 0x07FF]);
+        }
+
+        if(++COUNT > MAX_LINE)
+        {
+            VDP->STATUS |= VDP_STATUS_SPRITE_OVERFLOW;
+            break;
+        }
+
+        // ONCE MASKED OR THE LINE'S DOTS ARE USED UP, NOTHING ELSE IS DRAWN TO COLLIDE
+
+        {
+            unsigned ATTR = MD_READ_WORD(VDP->VRAM, ADDRESS + 4);
+            int LEFT = (MD_READ_WORD(VDP->VRAM, ADDRESS + 6) & 0x1FF) - 0x80;
+            int ROW = Y - TOP;
+            int COLUMNS = TILES_H << 3;
+            int COLUMN;
+
+            if(LEFT == -0x80 && COUNT > 1)
+                MASKED = true;
+
+            if(MASKED || DOTS >= WIDTH)
+                continue;
+
+            DOTS += COLUMNS;
+
+            if(ATTR & 0x1000)
+                ROW = (TILES_V << 3) - 1 - ROW;
+
+            for (COLUMN = 0; COLUMN < COLUMNS; COLUMN++)
+            {
+                int X = LEFT + COLUMN;
+                int SOURCE = (ATTR & 0x0800) ? COLUMNS - 1 - COLUMN : COLUMN;
+                unsigned TILE, DATA;
+
+                if(X < 0 || X >= WIDTH)
+                    continue;
+
+                TILE = (ATTR & 0x07FF) + (SOURCE >> 3) * TILES_V + (ROW >> 3);
+                DATA = MD_READ_BYTE(VDP->VRAM, ((TILE << 5) + ((ROW & 7) << 2) + ((SOURCE & 7) >> 1)) & 0xFFFF);
+                DATA = (SOURCE & 1) ? (DATA & 0x0F) : (DATA >> 4);
+
+                if(DATA == 0)
+                    continue;
+
+                if(COVERAGE[X])
+                    VDP->STATUS |= VDP_STATUS_SPRITE_COLLISION;
+
+                COVERAGE[X] = 1;
+            }
+        }
+
+    } while (INDEX != 0 && ++TOTAL < MAX_TOTAL);
+
+    return NEWEST;
+}
+
+void VDP_RESET(void)
+{
+    memset(VDP->SPRITE_TABLE, 0, sizeof(VDP->SPRITE_TABLE));
+    memset(*(char*) VDP->VRAM, 0, sizeof(VDP->VRAM));
+    memset(*(char*) VDP->CRAM, 0, sizeof(VDP->CRAM));
+    memset(*(char*) VDP->VSRAM, 0, sizeof(VDP->VSRAM));
+    memset(*(char*) VDP->VDP_REG, 0, sizeof(VDP->VDP_REG));
+
+    VDP->HINT = 0;
+    VDP->VINT = 0;
+    VDP->DMA_LEN = 0;
+    VDP->DMA_TYPE = 0;
+    VDP->DMA_END_CYCLES = 0;
+    VDP->DMA_FILL = 0;
+    VDP->ADDRESS = 0;
+    VDP->CODE = 0;
+    VDP->PENDING = 0;
+
+    VDP->A_BASE = 0;
+    VDP->B_BASE = 0;
+    VDP->W_BASE = 0;
+    VDP->SPRITE_TABLE = 0;
+    VDP->HORI_SCROLL = 0;
+
+    VDP_INVALIDATE();
 }
 
 // READ THE CORRESPONDING INFO BEING PASSED THROUGH THE 
@@ -268,6 +485,7 @@ void REMAP_LINE(int LINE)
 int VDP_HV_READ(unsigned CYCLES)
 {
     int COUNTER = 0;
+    int LINE;
     unsigned DATA = VDP->HV_LATCH;
 
     // CHECK IF THE HV LATCH HAS BEEN SET/ENABLED
@@ -296,16 +514,21 @@ int VDP_HV_READ(unsigned CYCLES)
         DATA = VDP->H_COUNTER_TABLE[CYCLES % VDP_MAX_CYCLES_PER_LINE];
     }
 
-    COUNTER = VDP->V_COUNTER;
+    LINE = VDP->V_COUNTER;
 
     // CHECK IF THE CURRENT AMOUNT OF CYCLES CORRESPONDS WITH THE MAX CYCLES
 
-    if((CYCLES - VDP->VDP_CYCLES)) { COUNTER = COUNTER + 1 % VDP_MAX_CYCLES_PER_LINE; }
+    if((CYCLES - VDP->VDP_CYCLES)) { LINE = (LINE + 1) % VDP->LINES_PER_FRAME; }
+
+    // THE LINE IS TRANSLATED THROUGH THE PROFILE'S TABLE, WHICH HOLDS WHERE
+    // THE COUNTER JUMPS FOR THIS STANDARD AND DISPLAY HEIGHT (SEE timing.h)
+
+    COUNTER = TIMING_GET_PROFILE()->V_COUNTER[(VDP->VDP_REG[1] >> 3) & 1][LINE];
 
     // RETURN H COUNTER IN LITTLE ENDIAN
     // RETURN V COUNTER VICE VERSA
 
-    DATA |= ((COUNTER & 0xFF) >> 8);
+    DATA |= ((COUNTER & 0xFF) << 8);
 
     fprintf("[%d(%d)][%d(%d)] HVC READ - 0x%x (%x)\n", 
         VDP->V_COUNTER,  // CURRENT COUNTER VALUE
@@ -369,11 +592,356 @@ void VDP_68K_WRITE(unsigned DATA)
 
 // NOW WE WRITE THE CONTENTS OF THE AFOREMENTIONED TO THE BUS
 
+// THE ACCESS CODE LATCHED BY THE CONTROL PORT DETERMINES WHICH
+// OF THE THREE MEMORIES THE WORD LANDS IN - THE ADDRESS THEN ADVANCES
+// BY THE AUTO-INCREMENT REGISTER
+
 void VDP_BUS_WRITE(unsigned DATA)
 {
-    // INIT THE FIFO CYCLES BASED ON THE CURRENT DATA BEING PASSED
+    unsigned ADDRESS = VDP->ADDRESS;
+
+    switch (VDP->CODE & 0x0F)
+    {
+        case VDP_CODE_VRAM_WRITE:
+        {
+            // VRAM IS BYTE ADDRESSED, ODD ADDRESSES SWAP THE HALVES
+
+            if(ADDRESS & 1)
+            {
+                DATA = ((DATA >> 8) | (DATA << 8)) & 0xFFFF;
+            }
+
+            MD_WRITE_WORD(VDP->VRAM, ADDRESS & 0xFFFE, DATA);
+            VDP_DIRTY_VRAM(ADDRESS);
+            break;
+        }
+
+        case VDP_CODE_CRAM_WRITE:
+        {
+            VDP->CRAM[ADDRESS & 0x7E] = DATA >> 8;
+            VDP->CRAM[(ADDRESS & 0x7E) | 1] = DATA & 0xFF;
+            RENDER_PALETTE_WRITE((ADDRESS & 0x7E) >> 1);
+            VDP_INVALIDATE();
+            break;
+        }
 
-    VDP->FIFO_CYCLES[VDP->FIFO_IDX] = DATA;
+        case VDP_CODE_VSRAM_WRITE:
+        {
+            if((ADDRESS & 0x7E) < 0x50)
+            {
+                VDP->VSRAM[ADDRESS & 0x7E] = DATA >> 8;
+                VDP->VSRAM[(ADDRESS & 0x7E) | 1] = DATA & 0xFF;
+                VDP_INVALIDATE();
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    VDP->ADDRESS += VDP->VDP_REG[15];
+    PROFILE_COUNT(PROFILE_VDP_WRITES, 1);
+
+    // A FILL WAS ARMED BY THE CONTROL PORT AND IS KICKED OFF BY THIS DATA WRITE
+
+    if(VDP->DMA_FILL)
+    {
+        VDP->DMA_FILL = 0;
+        VDP->FILL_DATA = DATA;
+        VDP_DMA_FILL(VDP->DMA_LEN);
+    }
+}
+
+// READING THE CONTROL PORT HANDS BACK THE STATUS REGISTER - THE SPRITE
+// OVERFLOW AND COLLISION BITS ARE CLEARED BY THE READ, AS IS THE LATCH
+// HOLDING THE FIRST HALF OF A COMMAND
+
+unsigned VDP_CTRL_READ(unsigned CYCLES)
+{
+    unsigned DATA = VDP->STATUS;
+
+    (void)CYCLES;
+
+    VDP->STATUS &= ~(VDP_STATUS_SPRITE_OVERFLOW | VDP_STATUS_SPRITE_COLLISION);
+    VDP->PENDING = 0;
+
+    return DATA;
+}
+
+// THE CONTROL PORT EITHER WRITES A REGISTER (10XR RRRR DDDD DDDD)
+// OR LATCHES AN ACCESS COMMAND OVER TWO CONSECUTIVE WORDS
+
+// SEE: https://md.railgun.works/index.php?title=VDP#Control_Port
+
+void VDP_CTRL_WRITE(unsigned DATA)
+{
+    if(VDP->PENDING)
+    {
+        VDP->PENDING = 0;
+        VDP->ADDRESS = (VDP->ADDRESS & 0x3FFF) | ((DATA & 0x03) << 14);
+        VDP->CODE = (VDP->CODE & 0x03) | ((DATA >> 2) & 0x3C);
+
+        if(!(VDP->CODE & VDP_CODE_DMA) || !(VDP->VDP_REG[1] & VDP_DMA_ENABLED))
+        {
+            return;
+        }
+
+        // THE UPPER BITS OF THE SOURCE REGISTER SELECT THE KIND OF TRANSFER
+
+        VDP->DMA_LEN = VDP->VDP_REG[19] | (VDP->VDP_REG[20] << 8);
+        VDP->DMA_TYPE = VDP->VDP_REG[23] >> 6;
+
+        if(VDP->DMA_LEN == 0)
+        {
+            VDP->DMA_LEN = 0x10000;
+        }
+
+        switch (VDP->DMA_TYPE)
+        {
+            case 0:
+            case 1:
+            {
+                unsigned SOURCE = ((VDP->VDP_REG[23] & 0x7F) << 17) | (VDP->VDP_REG[22] << 9) | (VDP->VDP_REG[21] << 1);
+
+                if(SOURCE >= 0xE00000)
+                {
+                    VDP_DMA_68K_RAM(VDP->DMA_LEN);
+                }
+
+                else if(SOURCE >= 0xA00000)
+                {
+                    VDP_DMA_68K_IO(VDP->DMA_LEN);
+                }
+
+                else
+                {
+                    VDP_DMA_68K_EXT(VDP->DMA_LEN);
+                }
+                break;
+            }
+
+            case 2:
+                VDP->DMA_FILL = 1;
+                break;
+
+            default:
+                VDP_DMA_COPY(VDP->DMA_LEN);
+                break;
+        }
+
+        return;
+    }
+
+    if((DATA & 0xC000) == 0x8000)
+    {
+        VDP_REG_WRITE((DATA >> 8) & 0x1F, DATA & 0xFF, M68K_CYCLES_REMAINING);
+        return;
+    }
+
+    VDP->ADDRESS = (VDP->ADDRESS & 0xC000) | (DATA & 0x3FFF);
+    VDP->CODE = (VDP->CODE & 0x3C) | ((DATA >> 14) & 0x03);
+    VDP->PENDING = 1;
+}
+
+// WRITE A REGISTER AND RECOMPUTE THE TABLE ADDRESSES WHICH DERIVE FROM IT
+
+void VDP_REG_WRITE(unsigned REG, unsigned DATA, unsigned CYCLES)
+{
+    (void)CYCLES;
+
+    if(REG >= 0x18)
+    {
+        return;
+    }
+
+    if(VDP->VDP_REG[REG] != DATA && (VDP_DIRTY_REG_MASK & (1u << REG)))
+    {
+        VDP_INVALIDATE();
+    }
+
+    VDP->VDP_REG[REG] = DATA;
+
+    switch (REG)
+    {
+        case 2:
+            VDP->A_BASE = (DATA & 0x38) << 10;
+            break;
+
+        case 3:
+            VDP->W_BASE = (DATA & 0x3E) << 10;
+            break;
+
+        case 4:
+            VDP->B_BASE = (DATA & 0x07) << 13;
+            break;
+
+        case 5:
+            VDP->SPRITE_TABLE = (DATA & 0x7F) << 9;
+            break;
+
+        case 7:
+            RENDER_BACKDROP_WRITE();
+            break;
+
+        case 13:
+            VDP->HORI_SCROLL = (DATA & 0x3F) << 10;
+            break;
+
+        /* THE DISPLAY MODES PICK WHICH LINE RENDERERS ARE RUN */
+
+        case 12:
+        case 17:
+        case 18:
+            RENDER_SELECT();
+            break;
+
+        /* FLIPPING AN INTERRUPT ENABLE MAY UNMASK ONE WHICH IS ALREADY PENDING */
+
+        case 0:
+        case 1:
+        case 11:
+            if(VDP->SET_IRQ_DELAY != NULL)
+                VDP->SET_IRQ_DELAY(IRQ_VDP_LEVEL());
+
+            if(REG == 1)
+                RENDER_SELECT();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void VDP_WRITE_WORD(unsigned ADDRESS, unsigned DATA)
+{
+    switch (ADDRESS & 0xFC)
+    {
+        case 0x00:
+        {
+            VDP_68K_WRITE(DATA);
+            return;
+        }
+
+        case 0x04:
+        {
+            VDP_CTRL_W(DATA);
+            return;
+        }
+
+        case 0x10:
+        case 0x14:
+            return;
+
+        default:
+            M68K_WRITE_16(ADDRESS, DATA);
+            break;
+    }
+}
+
+//================================================
+//              DMA TRANSFER KERNELS
+//================================================
+
+// THE SOURCE OF A 68K TRANSFER WRAPS WITHIN A 128KB WINDOW
+// ONCE COMPLETE, THE SOURCE AND LENGTH REGISTERS REFLECT WHERE IT STOPPED
+
+static unsigned VDP_DMA_SOURCE(void)
+{
+    return ((VDP->VDP_REG[23] & 0x7F) << 17) | (VDP->VDP_REG[22] << 9) | (VDP->VDP_REG[21] << 1);
+}
+
+static void VDP_DMA_FINISH(unsigned SOURCE)
+{
+    VDP->VDP_REG[19] = 0;
+    VDP->VDP_REG[20] = 0;
+    VDP->VDP_REG[21] = (SOURCE >> 1) & 0xFF;
+    VDP->VDP_REG[22] = (SOURCE >> 9) & 0xFF;
+    VDP->DMA_LEN = 0;
+}
+
+// WORK RAM IS READ DIRECTLY, SAVING A TRIP THROUGH THE MEMORY MAP PER WORD
+
+void VDP_DMA_68K_RAM(unsigned LEN)
+{
+    unsigned SOURCE = VDP_DMA_SOURCE();
+    U8* RAM = MD_GET_WORK_RAM();
+
+    PROFILE_COUNT(PROFILE_DMA_BYTES, LEN * 2);
+
+    while (LEN--)
+    {
+        VDP_BUS_WRITE(MD_READ_WORD(RAM, SOURCE & 0xFFFE));
+        SOURCE = (SOURCE & 0xFE0000) | ((SOURCE + 2) & 0x1FFFF);
+    }
+
+    VDP_DMA_FINISH(SOURCE);
+}
+
+void VDP_DMA_68K_EXT(unsigned LEN)
+{
+    unsigned SOURCE = VDP_DMA_SOURCE();
+
+    PROFILE_COUNT(PROFILE_DMA_BYTES, LEN * 2);
+
+    while (LEN--)
+    {
+        VDP_BUS_WRITE(M68K_READ_16(SOURCE));
+        SOURCE = (SOURCE & 0xFE0000) | ((SOURCE + 2) & 0x1FFFF);
+    }
+
+    VDP_DMA_FINISH(SOURCE);
+}
+
+// TRANSFERS FROM THE I/O AREA DO NOT RETURN VALID DATA ON HARDWARE
+// THE BUS IS STILL READ SO THE DESTINATION IS WRITTEN WITH WHATEVER IS THERE
+
+void VDP_DMA_68K_IO(unsigned LEN)
+{
+    VDP_DMA_68K_EXT(LEN);
+}
+
+// VRAM COPY MOVES BYTES WITHIN VRAM USING THE LOWER TWO SOURCE REGISTERS
+
+void VDP_DMA_COPY(unsigned LEN)
+{
+    unsigned SOURCE = VDP->VDP_REG[21] | (VDP->VDP_REG[22] << 8);
+
+    PROFILE_COUNT(PROFILE_DMA_BYTES, LEN);
+
+    while (LEN--)
+    {
+        MD_WRITE_BYTE(VDP->VRAM, VDP->ADDRESS, MD_READ_BYTE(VDP->VRAM, SOURCE & 0xFFFF));
+        VDP_DIRTY_VRAM(VDP->ADDRESS);
+        VDP->ADDRESS += VDP->VDP_REG[15];
+        SOURCE++;
+    }
+
+    VDP->VDP_REG[19] = 0;
+    VDP->VDP_REG[20] = 0;
+    VDP->VDP_REG[21] = SOURCE & 0xFF;
+    VDP->VDP_REG[22] = (SOURCE >> 8) & 0xFF;
+    VDP->DMA_LEN = 0;
+}
+
+// VRAM FILL REPEATS THE HIGH BYTE OF THE TRIGGERING DATA WRITE
+
+void VDP_DMA_FILL(unsigned LEN)
+{
+    U8 DATA = VDP->FILL_DATA >> 8;
+
+    PROFILE_COUNT(PROFILE_DMA_BYTES, LEN);
+
+    while (LEN--)
+    {
+        MD_WRITE_BYTE(VDP->VRAM, VDP->ADDRESS ^ 1, DATA);
+        VDP_DIRTY_VRAM(VDP->ADDRESS);
+        VDP->ADDRESS += VDP->VDP_REG[15];
+    }
+
+    VDP->VDP_REG[19] = 0;
+    VDP->VDP_REG[20] = 0;
+    VDP->DMA_LEN = 0;
 }
 
 unsigned VDP_READ_BYTE(unsigned ADDRESS)
@@ -430,9 +998,9 @@ unsigned VDP_READ_WORD(unsigned ADDRESS)
 
         case 0x04:
         {
-            unsigned DATA = VDP_HV_READ(M68K_CYCLE) & 0x3FF;
+            unsigned DATA = VDP_CTRL_R(M68K_CYCLE) & 0x3FF;
             ADDRESS = M68K_PC;
-            DATA |= (*(U16*)(CPU.MEMORY_MAP[((ADDRESS) >> 16) & 0xFF].MEMORY_BASE + ((ADDRESS) & 0xFFFF)) & 0xFC00);
+            DATA |= MD_READ_WORD(M68K_MEMORY_MAP[((ADDRESS) >> 16) & 0xFF].MEMORY_BASE, (ADDRESS) & 0xFFFF) & 0xFC00;
 
             return DATA;
         }
@@ -503,7 +1071,7 @@ void VDP_DEBUG_OUTPUT(void)
     for (int i = 0; i < 256; i++) 
     {
         if (i % 16 == 0) printf("\n0x%04X: ", i);
-        printf("%02X ", VDP->VRAM[i]);
+        printf("%02X ", MD_READ_BYTE(VDP->VRAM, i));
     }
 
     printf("\n\nCRAM Contents:\n");
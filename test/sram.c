@@ -0,0 +1,201 @@
+/* COPYRIGHT (C) HARRY CLARK 2025 */
+
+/* SEGA MEGA DRIVE EMULATOR */
+
+/* THIS FILE PERTAINS TOWARDS THE SAVE MEMORY TEST (make test) */
+
+/* A SYNTHETIC CARTRIDGE DECLARING ODD-BYTE SRAM AT $200001 WRITES A BYTE */
+/* INTO IT FROM THE 68K, THE CONSOLE RUNS UNTIL THE WRITES HAVE GONE QUIET, */
+/* AND THE BYTE MUST THEN BE FOUND IN THE .srm FILE - BIG ENDIAN, AS THE BUS */
+/* SAW IT. THIS COVERS THE WHOLE PATH: THE BUS HANDLERS, THE WRITE PROTECT, */
+/* THE DIRTY FLAG AND THE HAND OFF IN SRAM_FRAME */
+
+/* NESTED INCLUDES */
+
+#include "common.h"
+#include "md.h"
+#include "cartridge.h"
+#include "rom.h"
+#include "sram.h"
+
+/* SYSTEM INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define     TEST_ROM_SIZE               0x20000
+#define     TEST_SRAM_START             0x200001
+#define     TEST_SRAM_END               0x203FFF
+#define     TEST_VALUE                  0x5A
+#define     TEST_PROTECTED_VALUE        0xA5
+#define     TEST_SPIN                   0x218               /* THE BRA.S * CLOSING THE PROGRAM */
+
+static int TEST_FAILED;
+
+#define     TEST_CHECK(COND, WHAT)                                      \
+    do                                                                  \
+    {                                                                   \
+        printf("%s: %s\n", (COND) ? "PASS" : "FAIL", WHAT);             \
+        if(!(COND)) TEST_FAILED = 1;                                    \
+    } while (0)
+
+static void TEST_PUT16(U8* DATA, unsigned OFFSET, U16 VALUE)
+{
+    DATA[OFFSET] = VALUE >> 8;
+    DATA[OFFSET + 1] = VALUE & 0xFF;
+}
+
+static void TEST_PUT32(U8* DATA, unsigned OFFSET, U32 VALUE)
+{
+    TEST_PUT16(DATA, OFFSET, VALUE >> 16);
+    TEST_PUT16(DATA, OFFSET + 2, VALUE & 0xFFFF);
+}
+
+/* WRITE THE TEST VALUE TO THE FIRST SAVE BYTE, WRITE PROTECT THE SRAM, TRY */
+/* TO OVERWRITE THE SECOND, THEN SPIN */
+
+static int TEST_WRITE_ROM(const char* PATH)
+{
+    static const U16 PROGRAM[] =
+    {
+        0x13FC, TEST_VALUE, 0x0020, 0x0001,             /* MOVE.B #TEST_VALUE,$200001     */
+        0x13FC, 0x0003, 0x00A1, 0x30F1,                 /* MOVE.B #$03,$A130F1            */
+        0x13FC, TEST_PROTECTED_VALUE, 0x0020, 0x0003,   /* MOVE.B #TEST_PROTECTED,$200003 */
+        0x60FE,                                         /* BRA.S *                        */
+    };
+
+    U8* ROM = calloc(1, TEST_ROM_SIZE);
+    unsigned INDEX;
+    FILE* OUT;
+    bool WRITTEN;
+
+    if(ROM == NULL)
+        return -1;
+
+    TEST_PUT32(ROM, 0x000, 0x00FFFE00);
+    TEST_PUT32(ROM, 0x004, 0x00000200);
+
+    memcpy(ROM + 0x100, "SEGA MEGA DRIVE ", 16);
+    memcpy(ROM + ROM_DOMESTIC, "MDEMU SRAM TEST", 15);
+    memcpy(ROM + ROM_INTERNATIONAL, "MDEMU SRAM TEST", 15);
+    memcpy(ROM + ROM_SERIAL, "GM 00000000-00", 14);
+    memcpy(ROM + ROM_PERIPHERALS, "J", 1);
+    memcpy(ROM + ROM_REGION, "JUE", 3);
+    TEST_PUT32(ROM, ROM_START, 0);
+    TEST_PUT32(ROM, ROM_END, TEST_ROM_SIZE - 1);
+
+    /* "RA", BATTERY BACKED SRAM ON ODD BYTES, AND IT'S RANGE */
+
+    memcpy(ROM + SRAM_HEADER, "RA", 2);
+    TEST_PUT16(ROM, SRAM_HEADER + 2, 0xF800 | SRAM_KIND_SRAM);
+    TEST_PUT32(ROM, SRAM_HEADER + 4, TEST_SRAM_START);
+    TEST_PUT32(ROM, SRAM_HEADER + 8, TEST_SRAM_END);
+
+    for (INDEX = 0; INDEX < sizeof(PROGRAM) / sizeof(PROGRAM[0]); INDEX++)
+        TEST_PUT16(ROM, 0x200 + INDEX * 2, PROGRAM[INDEX]);
+
+    TEST_PUT16(ROM, ROM_CHECKSUM, GET_CHECKSUM(ROM + 0x200, TEST_ROM_SIZE - 0x200, NULL));
+
+    OUT = fopen(PATH, "wb");
+    WRITTEN = OUT != NULL && fwrite(ROM, 1, TEST_ROM_SIZE, OUT) == TEST_ROM_SIZE;
+
+    if(OUT != NULL)
+        fclose(OUT);
+
+    free(ROM);
+    return WRITTEN ? 0 : -1;
+}
+
+/* THE SAVE AS IT SITS ON THE DISK, WITHOUT GOING THROUGH THE MAPPING */
+
+static int TEST_READ_SAVE(const char* PATH, unsigned OFFSET)
+{
+    FILE* IN = fopen(PATH, "rb");
+    int VALUE = -1;
+
+    if(IN == NULL)
+        return -1;
+
+    if(fseek(IN, (long)OFFSET, SEEK_SET) == 0)
+        VALUE = fgetc(IN);
+
+    fclose(IN);
+    return VALUE;
+}
+
+/* EACH 68K CORE RUNS THE CARTRIDGE ON A FRESH CONSOLE - THE CACHED CORES */
+/* TAKE THE $A130F1 WRITE IN THE MIDDLE OF A DECODED BLOCK, WHICH MUST STILL */
+/* RUN ON TO THE SPIN RATHER THAN LOSE IT'S PLACE WHEN THE MAPPING CHANGES */
+
+static const char* TEST_CORE_NAME[] = { "interp", "cached", "jit" };
+
+static void TEST_RUN(const char* ROM_PATH, const char* SAVE_PATH, MD_CPU_CORE CORE)
+{
+    char WHAT[96];
+    MD* CONSOLE;
+    unsigned FRAME;
+
+    unlink(SAVE_PATH);
+    printf("%s:\n", TEST_CORE_NAME[CORE]);
+
+    MD_INIT();
+    CONSOLE = MD_GET_CONSOLE();
+
+    if(MD_CART_LOAD((char*)ROM_PATH, CONSOLE->MD_CART) != 0)
+    {
+        snprintf(WHAT, sizeof(WHAT), "the test ROM loads: %s", ROM_PATH);
+        TEST_CHECK(false, WHAT);
+        MD_FREE();
+        return;
+    }
+
+    MD_SET_CPU_CORE(CORE);
+    SRAM_OPEN(ROM_PATH);
+    MD_RESET(MODE_HARD);
+    MD_SEAL();
+
+    TEST_CHECK(SRAM_GET_STATE()->TYPE == SRAM_PARALLEL, "the header's SRAM is found");
+
+    MD_RUN_FRAME();
+
+    TEST_CHECK(SRAM_GET_STATE()->DIRTY, "a bus write marks the save dirty");
+    TEST_CHECK(SRAM_GET_STATE()->PROTECTED, "$A130F1 write protects the save");
+    TEST_CHECK((CPU.PC & 0xFFFFFF) == TEST_SPIN, "the program reaches it's spin");
+
+    for (FRAME = 0; FRAME <= SRAM_QUIET_FRAMES; FRAME++)
+        MD_RUN_FRAME();
+
+    TEST_CHECK(!SRAM_GET_STATE()->DIRTY, "the save is handed off once writes go quiet");
+    TEST_CHECK(TEST_READ_SAVE(SAVE_PATH, TEST_SRAM_START - 0x200000) == TEST_VALUE, "the byte is in the .srm, big endian");
+    TEST_CHECK(TEST_READ_SAVE(SAVE_PATH, TEST_SRAM_START - 0x200000 + 2) == 0xFF, "a write protected byte is left alone");
+
+    SRAM_CLOSE();
+    ROM_RELEASE((U8*)CONSOLE->MD_CART->ROM_DATA);
+    MD_FREE();
+
+    unlink(SAVE_PATH);
+}
+
+int main(void)
+{
+    char ROM_PATH[64];
+    char SAVE_PATH[64];
+    MD_CPU_CORE CORE;
+
+    snprintf(ROM_PATH, sizeof(ROM_PATH), "/tmp/mdemu-sram-%ld.bin", (long)getpid());
+    snprintf(SAVE_PATH, sizeof(SAVE_PATH), "/tmp/mdemu-sram-%ld.srm", (long)getpid());
+
+    if(TEST_WRITE_ROM(ROM_PATH) != 0)
+    {
+        fprintf(stderr, "Failed to write the test ROM: %s\n", ROM_PATH);
+        return 1;
+    }
+
+    for (CORE = MD_CORE_INTERPRETER; CORE <= MD_CORE_JIT; CORE++)
+        TEST_RUN(ROM_PATH, SAVE_PATH, CORE);
+
+    unlink(ROM_PATH);
+    return TEST_FAILED;
+}